@@ -71,6 +71,15 @@ function setAccompany(id, accid)
 	end
 end
 
+--- Forget everything about a ship that no longer exists
+function forgetShip(id)
+	AIData[id] = nil
+	local f = Fleets:getShipFleet(id)
+	if f ~= nil then
+		f:remove(id)
+	end
+end
+
 function setHuntHostile(id, tid)
 	if AIData[id] == nil then
 		AIData[id] = { }
@@ -15,7 +15,10 @@ MissionType = {
 	end,
 	Accept = function( missionTable ) end, --- Call this when the Mission is accepted.
 	Reject = function( missionTable ) end, --- Call this when the Mission is rejected after being accepted.
-	Update = function( missionTable ) --- Call this each time that the Mission should be checked.
+	Events = { "ShipDestroyed" }, --- Optional: Call Update when these happen. Also "EnteredRegion", "ExitedRegion" and "DayChanged".
+	UpdatePeriod = 50, --- Optional: Also call Update with the event "Tick" this often (in ticks).
+	--- Without Events or an UpdatePeriod, Update is called every tick.
+	Update = function( missionTable, event, value ) --- Call this each time that the Mission should be checked.
 		return nil --- Return nil when the mission isn't over yet.
 		return true --- Return true when the mission has succeded.
 		return false --- Return false when the mission has failed.
@@ -29,6 +32,9 @@ MissionType = {
 	Failure = function( missionTable ) end, --- Call this if the Mission is a failure.
 }
 
+A Mission that listens for "EnteredRegion" or "ExitedRegion" needs a Region in
+its Mission Table, for example: missionTable.Region = { x=0, y=0, radius=500 }
+
 --]]
 
 -- Missions are generated Mad-Libs style, so here are a bunch of words to fill in the gaps.
@@ -108,6 +114,7 @@ ReturnAmbassador = {
 		--for i=1,#rejections do print(rejections[i]) end
 		UI.newAlert( "The "..missionTable.profession..", "..f('"%s"',choose(rejections)) )
 	end,
+	UpdatePeriod = 50,
 	Update = function( missionTable )
 	end,
 	Land = function( missionTable )
@@ -181,6 +188,7 @@ DestroyPirate = {
 	Reject = function( missionTable )
 		
 	end,
+	Events = { "ShipDestroyed" },
 	Update = function( missionTable )
 		if missionTable.ship == nil then
 			return false -- Error
@@ -281,6 +289,7 @@ CollectArtifacts = {
 		rejectMessage = rejectMessage:format( missionTable.EnemyAlliance, missionTable.Actors )
 		UI.newAlert( rejectMessage  )
 	end,
+	UpdatePeriod = 50,
 	Update = function( missionTable )
 	end,
 	Land = function( missionTable )
@@ -371,6 +380,7 @@ ShippingRoutes = {
 		message = message:format( missionTable.Tonnage, missionTable.Commodity, missionTable.Planet )
 		UI.newAlert( message )
 	end,
+	UpdatePeriod = 50,
 	Update = function( missionTable )
 		-- Check if the Player still has all the cargo
 		local currentCargo, stored, storable = PLAYER:GetCargo()
@@ -448,6 +458,7 @@ DestroyGaryTheGold = {
 		UI.newAlert( "Gary may never be stopped" )
 		local p = Planet.Get( missionTable.planet )
 	end,
+	Events = { "ShipDestroyed" },
 	Update = function( missionTable )
 		local gary = Epiar.getSprite( missionTable.garyID )
 		local escort = Epiar.getSprite( missionTable.escortID )
@@ -541,10 +552,11 @@ ProtectFreighter = {
 		Fleets:unjoin( PLAYER:GetID(), missionTable.freighter )
 		local p = Planet.Get( missionTable.planet )
 	end,
+	Events = { "ShipDestroyed" },
 	Update = function( missionTable )
 		local freighter = Epiar.getSprite( missionTable.freighter )
 		-- Check that the Freighter is still alive
-		if freighter ~= nil then
+		if freighter == nil then
 			return false
 		end
 	end,
@@ -38,12 +38,10 @@ Thanks for playing!
 ]]
 
 -- Generate a Random Lua Seed
+-- math.random is seeded by the engine (options/random/seed), so this puts it
+-- back on the engine's seed after a fixed seed such as a random universe.
 function randomizeseed()
-	math.randomseed(os.time())
-	-- Absorb the first few non-random random results
-	for s =1,10 do
-		math.random();
-	end
+	math.randomseed()
 end
 
 --------------------------------------------------------------------------------
@@ -63,6 +61,18 @@ function createRandomShip(X,Y,Range,models,engines,weapons,alliance)
 	if alliance==nil then
 		alliance = choose(Epiar.alliances())
 	end
+	local name, model, engine, p = chooseRandomShip(models,engines)
+	local X = X + about(Range)
+	local Y = Y + about(Range)
+
+	local s = Ship.new(name, X, Y, model, engine, p, alliance)
+	equipRandomShip(s,p,weapons,alliance)
+
+	return s
+end
+
+--- Chooses the pilot, model, engine and plan of a random ship
+function chooseRandomShip(models,engines)
 	local name = choose( {
 		"Bob", "Joe", "Fred", "Sally", "Frank",
 		"Hillary", "Bruce", "Patrick", "Jimbo", "Richard",
@@ -70,8 +80,6 @@ function createRandomShip(X,Y,Range,models,engines,weapons,alliance)
 		"Helen", "Ken", "Marcus", "Violet", "Ethel",
 		"Gary", "Scott", "Thomas", "Russel", "Steve",
 	} )
-	local X = X + about(Range)
-	local Y = Y + about(Range)
 	local model = choose(models)
 	local engine = choose(engines)
 	local plans = nil
@@ -81,7 +89,6 @@ function createRandomShip(X,Y,Range,models,engines,weapons,alliance)
 		plans = {"Trader", "Patrol", "Bully" }
 	end
 	local pirateModels = { "Fleet Guard", "Kartanal", "Terran Assist", "Patitu", "Terran Corvert Mark I", "Large Vesper", "Raven", "Hammer Freighter"  }
-	local escortModels = { "Fleet Guard", "Terran XV", "Kartanal", "Patitu", "Terran Corvert Mark I"  }
 
 	local p = choose(plans)
 
@@ -95,9 +102,15 @@ function createRandomShip(X,Y,Range,models,engines,weapons,alliance)
 		engine = "Ion Engines"
 	end
 
-	local s = Ship.new(name, X, Y, model, engine, p, alliance)
+	return name, model, engine, p
+end
+
+--- Gives a new random ship its weapons, credits and, for a Pirate, an escort
+function equipRandomShip(s,p,weapons,alliance)
+	local escortModels = { "Fleet Guard", "Terran XV", "Kartanal", "Patitu", "Terran Corvert Mark I"  }
 
 	if p == "Pirate" then
+		local X,Y = s:GetPosition()
 		setHuntHostile(s:GetID(), PLAYER:GetID() )
 		local escort = Ship.new( "An Escort", X-150, Y-150, choose(escortModels), "Ion Engines", "Escort", alliance)
 		setAccompany(escort:GetID(), s:GetID())
@@ -111,8 +124,6 @@ function createRandomShip(X,Y,Range,models,engines,weapons,alliance)
 	local creditsMax = math.random(40,90) * math.sqrt( s:GetTotalCost() )
 	local randCredits = math.random( creditsMax )
 	s:SetCredits(randCredits)
-
-	return s
 end
 
 function attachStandardWeapons(cur_ship,weapons)
@@ -253,8 +264,26 @@ function createRandomShipForPlanet(id)
 		engines = planet:GetEngines()
 		weapons = planet:GetWeapons()
 		alliance = planet:GetAlliance()
-		createRandomShip(x,y,influence,models,engines,weapons)
+		createRandomShip(x,y,influence,models,engines,weapons,alliance)
+	end
+end
+
+--- Gives a traffic ship that moved to another Planet a new pilot and plan
+-- The engine has already stripped the ship, given it a new ID and the
+-- Planet's alliance.
+function recycleShipForPlanet(oldID, id, planetID)
+	forgetShip(oldID)
+	local s = Epiar.getSprite(id)
+	local planet = Epiar.getSprite(planetID)
+	if (s == nil) or (planet == nil) or (planet:GetType() ~= SPRITE_PLANET) then
+		return
 	end
+	local name, model, engine, p = chooseRandomShip(planet:GetModels(), planet:GetEngines())
+	s:SetName(name)
+	s:SetModel(model)
+	s:SetEngine(engine)
+	s:SetStateMachine(p)
+	equipRandomShip(s,p,planet:GetWeapons(),planet:GetAlliance())
 end
 
 
@@ -1,7 +1,7 @@
 /**\file			audio.cpp
  * \author			Maoserr
  * \date			Created: Saturday, February 06, 2010
- * \date			Modified: Saturday, February 06, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Abstraction to SDL_mixer interface.
  * \details
  * This files is responsible for overall Audio system configuration.  To play
@@ -16,6 +16,16 @@
  * \brief This class is responsible for overall Audio system configuration.
  * \details
  * The Audio instance is implemented as a singleton.
+ *
+ * Sound effects with a position are not played straight away.  They are
+ * queued during the frame and started together by Update(), which keeps
+ * only the loudest copy of each sound, skips sounds that are too quiet to
+ * hear, and hands out at most a budget of voices.  When every voice is busy
+ * a new sound takes the voice of the least important one, by priority and
+ * then by loudness, or is dropped if nothing playing is less important.
+ *
+ * The distance and panning effects of each channel are remembered so they
+ * are only changed when a new sound needs different ones.
  * \sa Sound
  * \sa Music
  */
@@ -62,6 +72,12 @@ bool Audio::Initialize( void ){
 	Mix_AllocateChannels( this->max_chan);
 	assert( this->max_chan == static_cast<unsigned int>(this->GetTotalChannels()) );
 
+	// Channels start without any distance effect, and a pan that no sound
+	// uses so that the first sound on each channel sets it.
+	Voice silent = { NULL, SOUND_PRIORITY_AMBIENT, 0, 0, 255 };
+	this->voices.assign( this->max_chan, silent );
+
+	this->initstatus = true;
 	return true;
 }
 
@@ -70,6 +86,9 @@ bool Audio::Initialize( void ){
 bool Audio::Shutdown( void ){
 	/* This is the cleaning up part */
 	this->HaltAll();
+	this->requests.clear();
+	this->voices.clear();
+	this->initstatus = false;
 
 
 #if defined(SDL_MIXER_MAJOR_VERSION) && (SDL_MIXER_MAJOR_VERSION>1) \
@@ -153,62 +172,226 @@ bool Audio::SetSoundVol( float volume ){
 	return true;
 }
 
-/**\brief Retrieves the first available channel.
+/**\brief Retrieves total number of mixing channels.
+ */
+int Audio::GetTotalChannels( void ){
+	return Mix_AllocateChannels( -1 );
+}
+
+/**\brief Limit how many sound effects can play at once.
+ * \param voices The most sounds playing at once, up to the number of channels.
+ * \param cullVolume Sounds quieter than this (Range from 0 - 1) are not played.
  */
-int Audio::GetFreeChannel( void ){
-	/**\todo Optimization: We could consider dynamically allocating.*/
-	// Find first available channel
-	int foundchan = Mix_GroupAvailable( -1 );
-	if ( foundchan != -1 )
-		return foundchan;
+void Audio::SetVoiceBudget( int voices, float cullVolume ){
+	if ( voices < 1 )
+		voices = 1;
+	else if ( voices > static_cast<int>(this->max_chan) )
+		voices = this->max_chan;
+	this->max_voices = voices;
+	this->cull_loudness = static_cast<int>( cullVolume * AUDIO_MAX_VOL );
+}
 
-	// No channels available, halt oldest used one
-	assert( this->lastplayed.size() != 0 );
-	Mix_HaltChannel( this->lastplayed.front() );
+/**\brief Number of channels that are playing right now.
+ */
+int Audio::GetPlayingVoices( void ){
+	if ( !this->initstatus )
+		return 0;
+	return Mix_Playing( -1 );
+}
 
-	return this->lastplayed.front();
+/**\brief How loud a request will be, including the distance fading.
+ */
+static int Loudness( const SoundRequest& request ){
+	return request.volume * (255 - request.distance) / 255;
 }
 
-/**\brief Retrieves total number of mixing channels.
+/**\brief Sort requests so that copies of the same sound are next to each
+ * other, most important first.
  */
-int Audio::GetTotalChannels( void ){
-	return Mix_AllocateChannels( -1 );
+static bool ByChunk( const SoundRequest& a, const SoundRequest& b ){
+	if ( a.chunk != b.chunk )
+		return a.chunk < b.chunk;
+	if ( a.priority != b.priority )
+		return a.priority > b.priority;
+	return Loudness( a ) > Loudness( b );
 }
 
-/**\brief Wrapper for Mix_PlayChannel.
- * \param chan Use -1 for any available channel
- * \param chunk The Mix_Chunk to play
- * \param loop Specify if looping is desired ( chunk will play 1+loop times)
- * \details
- * Plays the chunk on specified channel.
+static bool SameChunk( const SoundRequest& a, const SoundRequest& b ){
+	return a.chunk == b.chunk;
+}
+
+/**\brief Sort requests from most to least important.
+ */
+static bool ByImportance( const SoundRequest& a, const SoundRequest& b ){
+	if ( a.priority != b.priority )
+		return a.priority > b.priority;
+	return Loudness( a ) > Loudness( b );
+}
+
+/**\brief Ask for a sound to start at the end of this frame.
+ * \returns false if the sound is too quiet to be heard.
+ */
+bool Audio::Queue( const SoundRequest& request ){
+	this->stats.requested++;
+	if ( Loudness( request ) < this->cull_loudness ){
+		this->stats.culled++;
+		return false;
+	}
+	this->requests.push_back( request );
+	return true;
+}
+
+/**\brief Start a sound right away instead of waiting for Update().
+ * \returns The channel that the sound is playing on, or -1.
+ */
+int Audio::PlayNow( const SoundRequest& request ){
+	this->stats.requested++;
+	return this->Start( request );
+}
+
+/**\brief Drop every queued request for a sound that is being freed.
+ */
+void Audio::Forget( Mix_Chunk *chunk ){
+	vector<SoundRequest>::iterator req = this->requests.begin();
+	while ( req != this->requests.end() ){
+		if ( req->chunk == chunk )
+			req = this->requests.erase( req );
+		else
+			++req;
+	}
+	for ( unsigned int chan = 0; chan < this->voices.size(); chan++ ){
+		if ( this->voices[chan].chunk == chunk )
+			this->voices[chan].chunk = NULL;
+	}
+}
+
+/**\brief Start the sounds that were queued during this frame.
+ * \details This should be called once per frame.
+ */
+void Audio::Update( void ){
+	if ( this->requests.empty() )
+		return;
+
+	// Only the most important copy of each sound is played
+	sort( this->requests.begin(), this->requests.end(), ByChunk );
+	vector<SoundRequest>::iterator last = unique( this->requests.begin(), this->requests.end(), SameChunk );
+	this->stats.merged += static_cast<Uint32>( this->requests.end() - last );
+	this->requests.erase( last, this->requests.end() );
+
+	sort( this->requests.begin(), this->requests.end(), ByImportance );
+	for ( unsigned int i = 0; i < this->requests.size(); i++ ){
+		this->Start( this->requests[i] );
+	}
+	this->requests.clear();
+}
+
+/**\brief Forget the statistics.
+ */
+void Audio::ResetStats( void ){
+	memset( &this->stats, 0, sizeof(this->stats) );
+}
+
+/**\brief Play a request on the best voice.
+ * \returns The channel that the sound is playing on, or -1.
  */
-int Audio::PlayChannel( int chan, Mix_Chunk *chunk, int loop ){
-	int chan_used;			// Channel that was used to play a sound
+int Audio::Start( const SoundRequest& request ){
+	if ( !this->initstatus )
+		return -1;
+
+	// Looping sounds like engines are only started when they have stopped
+	if ( !request.restart && this->IsPlaying( request.chunk ) ){
+		this->stats.merged++;
+		return -1;
+	}
+
+	int chan = this->FindVoice( request );
 	if ( chan == -1 ){
-		int freechan = this->GetFreeChannel();
-		int chan_vol = Mix_Volume(freechan, -1);
-		// Scale channel volume by global volume
-		int scaled_vol = static_cast<int>(static_cast<float>(chan_vol)*this->sound_vol);
-		Mix_Volume( freechan, scaled_vol );
-		assert( Mix_Volume(freechan, -1) == scaled_vol);
-		chan_used = Mix_PlayChannel( freechan, chunk, loop );
-	}else{
-		int chan_vol = Mix_Volume(chan, -1);
-		// Scale channel volume by global volume
-		int scaled_vol = static_cast<int>(static_cast<float>(chan_vol)*this->sound_vol);
-		Mix_Volume( chan, scaled_vol );
-		assert( Mix_Volume(chan,-1)  == scaled_vol);
-		chan_used = Mix_PlayChannel( chan, chunk, loop );
-	}
-
-	/**\todo This could be optimized.*/
-	this->lastplayed.push_back( chan_used );
-	// Check if queue is full
-	if ( this->lastplayed.size() > this->max_chan ){
-		this->lastplayed.pop_front( );
-		assert( lastplayed.size() <= this->max_chan );
-	}
-	return chan_used;
+		this->stats.dropped++;
+		return -1;
+	}
+
+	Voice& voice = this->voices[chan];
+	if ( voice.distance != request.distance ){
+		if( Mix_SetDistance( chan, request.distance ) == 0 )
+			LogMsg(ERR,"Set distance %d failed on channel %d.", request.distance, chan );
+		voice.distance = request.distance;
+	}
+
+	/**\bug SDL_mixer bug possibly: Need to check whether SDL_mixer is getting
+	 * Left/Right speaker switched around.
+	 */
+	if ( voice.pan != request.pan ){
+		if( Mix_SetPanning( chan, 254 - request.pan, request.pan ) == 0 )
+			LogMsg(ERR,"Set panning %d failed on channel %d.", request.pan - 127, chan );
+		voice.pan = request.pan;
+	}
+
+	// Scale channel volume by global volume
+	Mix_Volume( chan, static_cast<int>(static_cast<float>(request.volume)*this->sound_vol) );
+	if ( Mix_PlayChannel( chan, request.chunk, 0 ) == -1 ){
+		this->stats.dropped++;
+		return -1;
+	}
+
+	voice.chunk = request.chunk;
+	voice.priority = request.priority;
+	voice.loudness = Loudness( request );
+
+	this->stats.played++;
+	int playing = this->GetPlayingVoices();
+	if ( playing > this->stats.peakVoices )
+		this->stats.peakVoices = playing;
+	return chan;
+}
+
+/**\brief Pick the channel for a new sound.
+ * \details A free channel is used while under the voice budget.  Otherwise
+ * the least important sound that is playing is stopped, as long as it is
+ * less important than the new one.
+ * \returns The channel, or -1 if the sound should not be played.
+ */
+int Audio::FindVoice( const SoundRequest& request ){
+	int playing = 0;
+	int freechan = -1;
+	int weakest = -1;
+
+	for ( int chan = 0; chan < static_cast<int>(this->voices.size()); chan++ ){
+		if ( !Mix_Playing( chan ) ){
+			if ( freechan == -1 )
+				freechan = chan;
+			continue;
+		}
+		playing++;
+		if ( (weakest == -1)
+				|| (this->voices[chan].priority < this->voices[weakest].priority)
+				|| ((this->voices[chan].priority == this->voices[weakest].priority)
+					&& (this->voices[chan].loudness < this->voices[weakest].loudness)) )
+			weakest = chan;
+	}
+
+	if ( (freechan != -1) && (playing < this->max_voices) )
+		return freechan;
+
+	if ( weakest == -1 )
+		return -1;
+	const Voice& voice = this->voices[weakest];
+	if ( (voice.priority < request.priority)
+			|| ((voice.priority == request.priority) && (voice.loudness < Loudness( request ))) ){
+		Mix_HaltChannel( weakest );
+		this->stats.stolen++;
+		return weakest;
+	}
+	return -1;
+}
+
+/**\brief Check if any channel is playing a sound.
+ */
+bool Audio::IsPlaying( Mix_Chunk *chunk ){
+	for ( int chan = 0; chan < static_cast<int>(this->voices.size()); chan++ ){
+		if ( (this->voices[chan].chunk == chunk) && Mix_Playing( chan ) )
+			return true;
+	}
+	return false;
 }
 
 /**\brief Empty constructor (use initialization lists to initialize privates.
@@ -220,8 +403,11 @@ Audio::Audio():
 	audio_channels( 2 ),
 	audio_buffers( 1024 ),
 	sound_vol( 1 ),
-	max_chan( 16 )
+	max_chan( 16 ),
+	max_voices( 12 ),
+	cull_loudness( 2 )
 {
+	this->ResetStats();
 }
 
 /**\brief Empty destructor
@@ -1,7 +1,7 @@
 /**\file			audio.h
  * \author			Maoserr
  * \date			Created: Saturday, February 06, 2010
- * \date			Modified: Saturday, February 06, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Abstraction to SDL_mixer interface.
  * \details
  * This files is responsible for overall Audio system configuration.  To play
@@ -16,6 +16,44 @@
 /** Maximum audio volume */
 #define AUDIO_MAX_VOL 128
 
+/** Sounds with a higher priority take voices from sounds with a lower one. */
+typedef enum {
+	SOUND_PRIORITY_AMBIENT,		/**< Engines and other continuous sounds. */
+	SOUND_PRIORITY_EFFECT,		/**< Weapons and explosions of other ships. */
+	SOUND_PRIORITY_PLAYER,		/**< Sounds made by the player. */
+	SOUND_PRIORITY_INTERFACE	/**< Buttons and other sounds without a position. */
+} SoundPriority;
+
+/** A sound that should start playing at the end of this frame. */
+typedef struct {
+	Mix_Chunk *chunk;
+	SoundPriority priority;
+	int volume;						// 0 - AUDIO_MAX_VOL
+	Uint8 distance;					// 0 (near) - 255 (far)
+	Uint8 pan;						// 0 (left) - 254 (right)
+	bool restart;					// Play again even if already playing
+} SoundRequest;
+
+/** What one mixer channel was last asked to play. */
+typedef struct {
+	Mix_Chunk *chunk;
+	SoundPriority priority;
+	int loudness;
+	Uint8 distance;					// Effects registered on the channel
+	Uint8 pan;
+} Voice;
+
+/** Counts of what happened to every requested sound. */
+typedef struct {
+	Uint32 requested;				// Sounds asked for
+	Uint32 merged;					// Duplicates in the same frame
+	Uint32 culled;					// Too quiet or too far away to hear
+	Uint32 dropped;					// No voice was free
+	Uint32 stolen;					// Stopped for a more important sound
+	Uint32 played;					// Started playing
+	int peakVoices;					// Most voices playing at once
+} AudioStats;
+
 class Audio {
 	public:
 		static Audio& Instance();
@@ -26,9 +64,19 @@ class Audio {
 		bool SetSoundVol ( float volume );
 		float GetMusicVol () { return music_vol; }
 		float GetSoundVol () { return sound_vol; }
-		int GetFreeChannel( void );
 		int GetTotalChannels( void );
-		int PlayChannel( int chan, Mix_Chunk *chunk, int loop );
+
+		void SetVoiceBudget( int voices, float cullVolume );
+		int GetVoiceBudget( void ) { return max_voices; }
+		int GetPlayingVoices( void );
+
+		bool Queue( const SoundRequest& request );
+		int PlayNow( const SoundRequest& request );
+		void Forget( Mix_Chunk *chunk );
+		void Update( void );
+
+		const AudioStats& GetStats( void ) { return stats; }
+		void ResetStats( void );
 
 	private:
 		Audio();
@@ -36,6 +84,10 @@ class Audio {
 		Audio& operator=(Audio const&);		// Assignment constructor
 		~Audio();
 
+		int Start( const SoundRequest& request );
+		int FindVoice( const SoundRequest& request );
+		bool IsPlaying( Mix_Chunk *chunk );
+
 		bool initstatus;					// Initialization status
 		int audio_rate;						// Samplerate
 		Uint16 audio_format;				// AUDIO_S16
@@ -44,7 +96,11 @@ class Audio {
 		float music_vol;					// Sound volumes
 		float sound_vol;					// Sound volumes
 		unsigned int max_chan;				// Total number of channels request
-		list<int> lastplayed;				// Queue of last used channels.
+		int max_voices;						// Most sound effects playing at once
+		int cull_loudness;					// Quieter sounds are not played
+		vector<Voice> voices;				// One per channel
+		vector<SoundRequest> requests;		// Sounds waiting for Update()
+		AudioStats stats;
 };
 
 #endif // __H_AUDIO__
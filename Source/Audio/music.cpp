@@ -15,6 +15,32 @@
  * \brief This represents a song object.
  */
 
+/**\class SongJob
+ * \brief Opens a Song in the background.
+ * \see AssetManager, Song::GetAsync
+ */
+class SongJob : public AssetJob {
+	public:
+		SongJob( Song* _song, const string& _filename ):
+			song(_song), filename(_filename), music(NULL) {}
+
+		void Decode( void ) {
+			music = Mix_LoadMUS( filename.c_str() );
+		}
+
+		void Upload( void ) {
+			song->loadJob = NULL;
+			song->song = music;
+			if ( music == NULL )
+				LogMsg(ERR, "Could not load song file: %s in the background.", filename.c_str() );
+		}
+
+	private:
+		Song* song;
+		string filename;
+		Mix_Music* music;
+};
+
 /**\brief Gets the song or loads it.
  * \param filename Song file
  */
@@ -29,13 +55,40 @@ Song *Song::Get( const string& filename ){
 		//	return NULL;
 		//}
 	}
+	if( value ) value->Pin();
+	return value;
+}
+
+/**\brief Gets the song without waiting for it to load.
+ * \details Playing the song will wait for it to finish loading.
+ * \param filename Song file
+ * \sa AssetManager
+ */
+Song *Song::GetAsync( const string& filename ){
+	Song* value;
+	value = (Song*) Resource::Get( filename );
+	if( (value == NULL) && filename != "" ){
+		value = new Song();
+		value->loadJob = new SongJob( value, filename );
+		Resource::Store( filename, (Resource*) value );
+		AssetManager::Queue( value->loadJob );
+	}
+	if( value ) value->Pin();
 	return value;
 }
 
+/**\brief An empty song that will be loaded in the background.
+ */
+Song::Song( void ){
+	this->song = NULL;
+	this->loadJob = NULL;
+}
+
 /**\brief Loads the song based on filename
  * \param filename Song file
  */
 Song::Song( const string& filename ){
+	this->loadJob = NULL;
 	this->song = NULL;
 	this->song = Mix_LoadMUS( filename.c_str() );
 	if ( this->song == NULL )
@@ -46,12 +99,15 @@ Song::Song( const string& filename ){
 /**\brief Destructor to free the music file
  */
 Song::~Song(){
+	if( this->loadJob ) AssetManager::Complete( this->loadJob );
 	if(this->song) Mix_FreeMusic( this->song );
 }
 
 /**\brief Plays the current song.
  */
 bool Song::Play( bool loop ){
+	if ( this->loadJob )
+		AssetManager::Complete( this->loadJob );
 	if ( this->song == NULL )
 		return false;
 
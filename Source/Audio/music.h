@@ -11,15 +11,24 @@
 
 #include "includes.h"
 #include "Audio/audio.h"
+#include "Utilities/assetmanager.h"
+#include "Utilities/resource.h"
 
-class Song {
+class Song : public Resource {
 	public:
 		static Song *Get( const string& filename );
+		static Song *GetAsync( const string& filename );
 		Song( const string& filename );
 		~Song( void );
 		bool Play( bool loop=true );
+
+		string GetTypeName( void ) { return "Song"; }
 	private:
+		friend class SongJob;
+		Song( void );
+
 		Mix_Music *song;
+		AssetJob *loadJob; // The pending background load, or NULL
 };
 
 
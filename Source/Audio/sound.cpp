@@ -1,7 +1,7 @@
 /**\file			sound.cpp
  * \author			Maoserr
  * \date			Created: Saturday, February 06, 2010
- * \date			Modified: Saturday, February 06, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Implements sound playing abilities.
  * \details
  */
@@ -16,6 +16,34 @@
  * \brief This represents a sound object.
  */
 
+/**\class SoundJob
+ * \brief Decodes a Sound in the background.
+ * \see AssetManager, Sound::GetAsync
+ */
+class SoundJob : public AssetJob {
+	public:
+		SoundJob( Sound* _sound, const string& _path ):
+			sound(_sound), path(_path), chunk(NULL) {}
+
+		void Decode( void ) {
+			chunk = Mix_LoadWAV( path.c_str() );
+		}
+
+		void Upload( void ) {
+			sound->loadJob = NULL;
+			sound->sound = chunk;
+			sound->Resized();
+			if( chunk == NULL ) {
+				LogMsg(ERR, "Could not load sound file: '%s' in the background.", path.c_str() );
+			}
+		}
+
+	private:
+		Sound* sound;
+		string path;
+		Mix_Chunk* chunk;
+};
+
 /**\brief Gets the sound or loads it.
  * \param filename Sound file
  */
@@ -36,18 +64,71 @@ Sound *Sound::Get( const string& filename ){
 				Resource::Store( filename, (Resource*) value );
 		//}
 	}
+	value->Pin();
+	return value;
+}
+
+/**\brief Gets the sound without waiting for it to load.
+ * \details The sound is decoded in the background.  Playing it before it is
+ *          ready does nothing.
+ * \param filename Sound file
+ * \sa AssetManager
+ */
+Sound *Sound::GetAsync( const string& filename ){
+	Sound* value = Request( filename );
+	value->Pin();
 	return value;
 }
 
+/**\brief Gets a reference counted sound without waiting for it to load.
+ * \details Like GetAsync, but the sound may be freed once every handle to it
+ *          is gone.
+ * \param filename Sound file
+ * \sa Resource
+ */
+ResourceHandle<Sound> Sound::Acquire( const string& filename ){
+	return ResourceHandle<Sound>( Request( filename ) );
+}
+
+/**\brief Find a sound, or start loading it in the background.
+ * \param filename Sound file
+ */
+Sound *Sound::Request( const string& filename ){
+	Sound* value;
+	value = (Sound*) Resource::Get( filename );
+	if( value == NULL ){
+		value = new Sound();
+		if( value->pathName.OpenRead( filename ) == false ) {
+			LogMsg(ERR, "Could not load sound file: '%s'", filename.c_str() );
+		} else {
+			value->loadJob = new SoundJob( value, value->pathName.GetAbsolutePath() );
+			AssetManager::Queue( value->loadJob );
+		}
+		Resource::Store( filename, (Resource*) value );
+	}
+	return value;
+}
+
+/**\brief An empty sound that will be loaded in the background.
+ */
+Sound::Sound( void ):
+	sound( NULL ),
+	fadefactor( 0.03 ),
+	panfactor( 0.1f ),
+	volume( 128 ),
+	loadJob( NULL )
+{
+}
+
 /**\brief Loads the sound based on filename
  * \param filename Sound file
  */
 Sound::Sound( const string& filename ):
 	sound( NULL ),
-	channel( -1 ),
 	fadefactor( 0.03 ),
 	panfactor( 0.1f ),
-	volume( 128 )
+	volume( 128 ),
+	loadJob( NULL )
 {
 	if( pathName.OpenRead( filename ) == false ) {
 		LogMsg(ERR, "Could not load sound file: '%s'", filename.c_str() );
@@ -66,7 +147,12 @@ Sound::Sound( const string& filename ):
 /**\brief Destructor to free the sound file.
  */
 Sound::~Sound(){
+	if( loadJob ) {
+		AssetManager::Complete( loadJob );
+	}
+
 	// Halts any channel this sound is playing on
+	Audio::Instance().Forget( this->sound );
 	for ( int i = 0; i < Audio::Instance().GetTotalChannels(); i++ ){
 		if ( Mix_GetChunk( i ) == this->sound)
 			Mix_HaltChannel( i );
@@ -75,89 +161,77 @@ Sound::~Sound(){
 }
 
 /**\brief Plays the sound.
+ * \details Sounds without a position are for the interface, so they start
+ * right away instead of waiting for Audio::Update().
  */
 bool Sound::Play( void ){
+	if( this->loadJob && !AssetManager::Poll( this->loadJob ) )
+		return false;			// Still loading
 	if ( this->sound == NULL )
 		return false;
 
 	// Disable panning and distance
-	int freechan = Audio::Instance().GetFreeChannel();
-	Mix_SetDistance( freechan, 0 );
-	Mix_SetPanning( freechan, 127, 127 );
-	Mix_Volume( freechan, this->volume );
-	this->channel = Audio::Instance().PlayChannel( freechan, this->sound, 0 );
-	if ( channel == -1 )
+	SoundRequest request = { this->sound, SOUND_PRIORITY_INTERFACE, this->volume, 0, 127, true };
+	if ( Audio::Instance().PlayNow( request ) == -1 )
 		return false;
-	
+
 	return true;
 }
 
 /**\brief Plays the sound at a specified coordinate from origin.
+ * \details The sound is started by the next Audio::Update(), unless it is
+ * too quiet or a more important sound takes its voice.
+ * \returns false if the sound will not be played.
  */
-bool Sound::Play( Coordinate offset ){
-	if ( this->sound == NULL )
+bool Sound::Play( Coordinate offset, SoundPriority priority ){
+	SoundRequest request = { this->sound, priority, this->volume, 0, 127, true };
+	if ( !this->Locate( offset, request ) )
 		return false;
 
-	// Distance fading
-	double dist = this->fadefactor * offset.GetMagnitude();
-	if ( dist > 255 )
-		return false;			// Sound is out of range
-	Uint8 sounddist = static_cast<Uint8>( dist );
-
-	// Left-Right panning
-	float panx = this->panfactor * static_cast<float>(offset.GetX())+127.f;
-	Uint8 soundpan = 127;
-	if ( panx < 0 )
-		soundpan = 0;
-	else if ( panx > 254 )
-		soundpan = 254;
-	else
-		soundpan = static_cast<Uint8>( panx );
-
-	int freechan = Audio::Instance().GetFreeChannel();
-	if( Mix_SetDistance( freechan, sounddist ) == 0 )
-		LogMsg(ERR,"Set distance %d failed on channel %d.", sounddist, freechan );
-	//else
-	//	LogMsg(INFO,"Distance set to %d on channel %d.", sounddist, freechan );
-
-	/**\bug SDL_mixer bug possibly: Need to check whether SDL_mixer is getting
-	 * Left/Right speaker switched around.
-	 */
-	if( Mix_SetPanning( freechan, 254 - soundpan, soundpan ) == 0 )
-		LogMsg(ERR,"Set panning %d failed on channel %d.", soundpan - 127, freechan );
-	//else
-	//	LogMsg(INFO,"Panning set to %d on channel %d.", soundpan - 127, freechan );
-
-	Mix_Volume( freechan, this->volume );
-	this->channel = Audio::Instance().PlayChannel( freechan, this->sound, 0 );
-
-	if ( channel == -1 )
-		return false;
-	
-	return true;
+	return Audio::Instance().Queue( request );
 }
 
 /**\brief Plays the sound if not playing, but do not restart if already playing.
  * \details
  * This is sort of a roundabout way to implement engine sounds.
  */
-bool Sound::PlayNoRestart( Coordinate offset ){
-	if ( this->sound == NULL )
+bool Sound::PlayNoRestart( Coordinate offset, SoundPriority priority ){
+	SoundRequest request = { this->sound, priority, this->volume, 0, 127, false };
+	if ( !this->Locate( offset, request ) )
 		return false;
 
-	if ( (this->channel != -1) &&
-			Mix_Playing( this->channel ) &&
-			(Mix_GetChunk( this->channel ) == this->sound ) )
+	return Audio::Instance().Queue( request );
+}
+
+/**\brief Works out the distance fading and panning of a positional sound.
+ * \returns false if the sound is not loaded yet.
+ */
+bool Sound::Locate( Coordinate offset, SoundRequest& request ){
+	if( this->loadJob && !AssetManager::Poll( this->loadJob ) )
+		return false;			// Still loading
+	if ( this->sound == NULL )
 		return false;
 
-	this->Play( offset );
+	// Distance fading; sounds that are out of range are culled by the Audio
+	double dist = this->fadefactor * offset.GetMagnitude();
+	request.distance = ( dist > 255 ) ? 255 : static_cast<Uint8>( dist );
+
+	// Left-Right panning
+	float panx = this->panfactor * static_cast<float>(offset.GetX())+127.f;
+	if ( panx < 0 )
+		request.pan = 0;
+	else if ( panx > 254 )
+		request.pan = 254;
+	else
+		request.pan = static_cast<Uint8>( panx );
+
 	return true;
 }
 
 /**\brief Sets the volume for this sound only (for next time it is played).
  */
 bool Sound::SetVolume( float volume ){
-	if ( this->sound == NULL )
+	if ( (this->sound == NULL) && (this->loadJob == NULL) )
 		return false;
 
 	this->volume = static_cast<int>( volume * 128.f );
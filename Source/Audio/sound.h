@@ -1,7 +1,7 @@
 /**\file			sound.h
  * \author			Maoserr
  * \date			Created: Monday, February 08, 2010
- * \date			Modified: Monday, February 08, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Implements sound playing abilities.
  * \details
  */
@@ -9,6 +9,8 @@
 #ifndef __H_SOUND__
 #define __H_SOUND__
 
+#include "Audio/audio.h"
+#include "Utilities/assetmanager.h"
 #include "Utilities/coordinate.h"
 #include "Utilities/file.h"
 #include "Utilities/resource.h"
@@ -16,22 +18,32 @@
 class Sound : public Resource {
 	public:
 		static Sound *Get( const string& filename );
+		static Sound *GetAsync( const string& filename );
+		static ResourceHandle<Sound> Acquire( const string& filename );
 		Sound( const string& filename );
 		~Sound( void );
 		bool Play( void );
-		bool Play( Coordinate offset );
-		bool PlayNoRestart( Coordinate offset );
+		bool Play( Coordinate offset, SoundPriority priority = SOUND_PRIORITY_EFFECT );
+		bool PlayNoRestart( Coordinate offset, SoundPriority priority = SOUND_PRIORITY_AMBIENT );
 		bool SetVolume( float volume );
 		void SetFactors( double fade, float pan );
 		string GetPath( void ) { return pathName.GetRelativePath(); }
 
+		string GetTypeName( void ) { return "Sound"; }
+		long GetMemorySize( void ) { return sound ? sound->alen : 0; }
+
 	private:
+		friend class SoundJob;
+		Sound( void );
+		static Sound *Request( const string& filename );
+		bool Locate( Coordinate offset, SoundRequest& request );
+
 		Mix_Chunk *sound;
 		File pathName;
-		int channel;		/* Last channel the sound is playing on. */
 		double fadefactor;	// Scale factor to fade by as distance drops off
 		float panfactor;	// Scale factor to pan by, higher = more sensitive
 		int volume;			// Volume for this sound
+		AssetJob *loadJob;	// The pending background load, or NULL
 };
 
 
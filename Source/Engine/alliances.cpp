@@ -1,7 +1,7 @@
 /**\file			alliances.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -53,32 +53,44 @@ Alliance::Alliance( string _name, short int _attackSize, float _aggressiveness,
     SetName(_name);
 }
 
-/**\brief Parser to parse the XML file.
+enum {
+	ALLIANCE_AGGRESSIVENESS,
+	ALLIANCE_ATTACKSIZE,
+	ALLIANCE_CURRENCY,
+	ALLIANCE_COLOR
+};
+
+static const ComponentField allianceFields[] = {
+	{ "aggressiveness", ALLIANCE_AGGRESSIVENESS, FIELD_REQUIRED },
+	{ "attackSize", ALLIANCE_ATTACKSIZE, FIELD_REQUIRED },
+	{ "currency", ALLIANCE_CURRENCY, FIELD_REQUIRED },
+	{ "color", ALLIANCE_COLOR, FIELD_REQUIRED },
+	{ NULL, 0, 0 }
+};
+
+/**\brief The XML fields of an Alliance.
  */
-bool Alliance::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
-
-	if( (attr = FirstChildNamed(node,"aggressiveness")) ){
-		value = NodeToString(doc,attr);
-		aggressiveness = static_cast<float>(atof( value.c_str() ) / 10.);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"attackSize")) ) {
-		value = NodeToString(doc,attr);
-		attackSize = (short int)atof( value.c_str() );
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"currency")) ) {
-		value = NodeToString(doc,attr);
-		currency = value;
-	} else return false;
+const ComponentField* Alliance::GetFields( void ) {
+	return allianceFields;
+}
 
-	if( (attr = FirstChildNamed(node,"color")) ) {
-		value = NodeToString(doc,attr);
-		color = Color(value);
-	} else return false;
-	
+/**\brief Parse one XML field of an Alliance.
+ */
+bool Alliance::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case ALLIANCE_AGGRESSIVENESS:
+			aggressiveness = static_cast<float>(atof( value.c_str() ) / 10.);
+			break;
+		case ALLIANCE_ATTACKSIZE:
+			attackSize = (short int)atof( value.c_str() );
+			break;
+		case ALLIANCE_CURRENCY:
+			currency = value;
+			break;
+		case ALLIANCE_COLOR:
+			color = Color(value);
+			break;
+	}
 	return true;
 }
 
@@ -100,6 +112,30 @@ xmlNodePtr Alliance::ToXMLNode(string componentName){
 
 	return section;
 }
+
+/**\brief Write this Alliance to a binary cache.
+ */
+bool Alliance::Serialize( BinaryWriter& out ) {
+	out.WriteShort( attackSize );
+	out.WriteFloat( aggressiveness );
+	out.WriteString( currency );
+	out.WriteFloat( color.r );
+	out.WriteFloat( color.g );
+	out.WriteFloat( color.b );
+	return true;
+}
+
+/**\brief Read this Alliance from a binary cache.
+ */
+bool Alliance::Deserialize( BinaryReader& in ) {
+	attackSize = in.ReadShort();
+	aggressiveness = in.ReadFloat();
+	currency = in.ReadString();
+	color.r = in.ReadFloat();
+	color.g = in.ReadFloat();
+	color.b = in.ReadFloat();
+	return !in.Failed();
+}
 /**\fn Alliance::GetAttackSize()
  * \brief Returns the size of the fleet.
  */
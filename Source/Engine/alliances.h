@@ -1,7 +1,7 @@
 /**\file			alliances.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -19,8 +19,11 @@ class Alliance : public Component {
 		Alliance();
   		Alliance& operator= (const Alliance&);
 		Alliance( string _name, short int _attackSize, float _aggressiveness, string _currency, Color _color);
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 
 		short int GetAttackSize(void){ return attackSize; }
 		float GetAggressiveness(void){ return aggressiveness; }
@@ -1,7 +1,7 @@
 /**\file			calendar.cpp
  * \author		Christopher Thielen (chris@epiar.net)
  * \date			Created: Sunday, June 24, 2012
- * \date			Modified: Sunday, June 24, 2012
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -9,6 +9,7 @@
 #include "includes.h"
 #include "Engine/calendar.h"
 #include "Engine/hud.h"
+#include "Engine/mission.h"
 
 /**\class Calendar
  * \brief A stardate system.
@@ -49,7 +50,7 @@ void Calendar::Update(void) {
   AdjustEpoch();
   
   if((old_period != period) || (old_epoch != epoch)) {
-    Hud::Alert("Day changed to %s", Now().c_str());
+    DayChanged();
   }
 }
 
@@ -67,16 +68,43 @@ void Calendar::AdvanceFromJump(float distance) {
   AdjustEpoch();
 
   if((old_period != period) || (old_epoch != epoch)) {  
-    Hud::Alert("Day changed to %s", Now().c_str());
+    DayChanged();
   }
 }
 
+/**\brief Writes the date and the ticks into the current period.
+ *
+ */
+void Calendar::Snapshot(BinaryWriter& out) {
+  out.WriteInt(period);
+  out.WriteInt(epoch);
+  out.WriteInt(ticker);
+}
+
+/**\brief Reads the date written by Snapshot.
+ *
+ */
+bool Calendar::Restore(BinaryReader& in) {
+  period = in.ReadInt();
+  epoch = in.ReadInt();
+  ticker = in.ReadInt();
+  return !in.Failed();
+}
+
 void Calendar::AdvanceFromLand() {
   period++;
   
   AdjustEpoch();
   
+  DayChanged();
+}
+
+/**\brief Tell the Player and the Missions that the day has changed.
+ *
+ */
+void Calendar::DayChanged() {
   Hud::Alert("Day changed to %s", Now().c_str());
+  Mission::Post(MISSION_DAY_CHANGED, period);
 }
 
 void Calendar::AdjustEpoch() {
@@ -1,7 +1,7 @@
 /**\file			calendar.h
  * \author		Christopher Thielen (chris@epiar.net)
  * \date			Created: Sunday, June 24, 2012
- * \date			Modified: Sunday, June 24, 2012
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  *            This represents "space time". The idea is
@@ -14,6 +14,7 @@
 #define __h_calendar__
 
 #include "includes.h"
+#include "Utilities/binary.h"
 #include "Utilities/quadtree.h"
 #include "Utilities/timer.h"
 
@@ -29,6 +30,9 @@ class Calendar {
     void Update(void);    
     void AdvanceFromJump(float distance);
     void AdvanceFromLand();
+
+    void Snapshot(BinaryWriter& out);
+    bool Restore(BinaryReader& in);
     
     string Now(void);
     
@@ -40,6 +44,7 @@ class Calendar {
     int ticker;
     
     void AdjustEpoch();
+    void DayChanged();
 };
 
 #endif // __h_calendar__
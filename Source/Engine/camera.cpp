@@ -1,7 +1,7 @@
 /**\file			camera.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -179,14 +179,13 @@ void Camera::Update( SpriteManager *sprites ) {
 /**\brief "Shakes" the camera based on the duration, intensity, source specified
  */
 void Camera::Shake( Uint32 duration, int intensity, Coordinate* source ) {
-	Trig *trig = Trig::Instance();
 	float angle;
 	//Coordinate position = focusSprite->GetWorldPosition() - *source;
 	Coordinate position = *source;
 	angle = position.GetAngle();
 
-	cameraShakeXOffset = (int)(intensity * trig->GetCos(angle));
-	cameraShakeYOffset = (int)(intensity * trig->GetSin(angle));	
+	cameraShakeXOffset = (int)(intensity * Trig::GetCos(angle));
+	cameraShakeYOffset = (int)(intensity * Trig::GetSin(angle));	
 
 	cameraShakeDur = duration;
 
@@ -1,7 +1,7 @@
 /**\file			commodities.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Wednesday, April 21, 2010
- * \date			Modified:
+ * \date			Modified:Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -40,16 +40,29 @@ Commodity::Commodity( string _name, int _msrp )
 	SetName(_name);
 }
 
-/**\brief Parser to parse the XML file.
- */
-bool Commodity::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
+enum {
+	COMMODITY_MSRP
+};
+
+static const ComponentField commodityFields[] = {
+	{ "msrp", COMMODITY_MSRP, FIELD_REQUIRED },
+	{ NULL, 0, 0 }
+};
 
-	if( (attr = FirstChildNamed(node,"msrp")) ){
-		msrp = atoi(NodeToString(doc,attr).c_str());
-	} else return false;
+/**\brief The XML fields of a Commodity.
+ */
+const ComponentField* Commodity::GetFields( void ) {
+	return commodityFields;
+}
 
+/**\brief Parse one XML field of a Commodity.
+ */
+bool Commodity::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case COMMODITY_MSRP:
+			msrp = atoi( value.c_str() );
+			break;
+	}
 	return true;
 }
 
@@ -67,6 +80,20 @@ xmlNodePtr Commodity::ToXMLNode(string componentName){
 	return section;
 }
 
+/**\brief Write this Commodity to a binary cache.
+ */
+bool Commodity::Serialize( BinaryWriter& out ) {
+	out.WriteInt( msrp );
+	return true;
+}
+
+/**\brief Read this Commodity from a binary cache.
+ */
+bool Commodity::Deserialize( BinaryReader& in ) {
+	msrp = in.ReadInt();
+	return !in.Failed();
+}
+
 /**\class Commodities
  * \brief Collection of Commodity objects.
  */
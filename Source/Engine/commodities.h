@@ -1,7 +1,7 @@
 /**\file			commodities.h
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Wednesday, April 21, 2010
- * \date			Modified:
+ * \date			Modified:Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -19,8 +19,11 @@ class Commodity : public Component {
 		Commodity(string _name, int _msrp);
 		~Commodity(void);
 
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 
 		int GetMSRP(void) {return msrp;}
 	private:
@@ -1,7 +1,7 @@
 /**\file			engines.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -35,7 +35,7 @@ Engine& Engine::operator= (const Engine& other) {
 
 	name = other.name;
 	thrustsound = other.thrustsound;
-	forceOutput = other.forceOutput;
+	stats.forceOutput = other.stats.forceOutput;
 	foldDrive = other.foldDrive;
 	flareAnimation = other.flareAnimation;
 	return *this;
@@ -62,49 +62,63 @@ Engine::Engine( string _name, Image* _pic, string _description, Sound* _thrustso
 	SetForceOutput(_forceOutput);
 }
 
-/**\brief Parser to parse the XML file
+enum {
+	ENGINE_DESCRIPTION,
+	ENGINE_FORCEOUTPUT,
+	ENGINE_MSRP,
+	ENGINE_FOLDDRIVE,
+	ENGINE_FLAREANIMATION,
+	ENGINE_THRUSTSOUND,
+	ENGINE_PICNAME
+};
+
+static const ComponentField engineFields[] = {
+	{ "description", ENGINE_DESCRIPTION, 0 },
+	{ "forceOutput", ENGINE_FORCEOUTPUT, FIELD_REQUIRED },
+	{ "msrp", ENGINE_MSRP, FIELD_REQUIRED },
+	{ "foldDrive", ENGINE_FOLDDRIVE, FIELD_REQUIRED },
+	{ "flareAnimation", ENGINE_FLAREANIMATION, FIELD_REQUIRED },
+	{ "thrustSound", ENGINE_THRUSTSOUND, FIELD_REQUIRED },
+	{ "picName", ENGINE_PICNAME, FIELD_REQUIRED },
+	{ NULL, 0, 0 }
+};
+
+/**\brief The XML fields of an Engine.
  */
-bool Engine::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
+const ComponentField* Engine::GetFields( void ) {
+	return engineFields;
+}
 
-	if( (attr = FirstChildNamed(node,"description")) ){
-		value = NodeToString(doc,attr);
-		SetDescription( value );
-	} else {
-		LogMsg( WARN, "%s does not have a description.", GetName().c_str() );
+/**\brief Parse one XML field of an Engine.
+ */
+bool Engine::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case ENGINE_DESCRIPTION:
+			SetDescription( value );
+			break;
+		case ENGINE_FORCEOUTPUT:
+			SetForceOutput( static_cast<float> (atof( value.c_str() )));
+			break;
+		case ENGINE_MSRP:
+			SetMSRP( (short int)atoi( value.c_str() ));
+			break;
+		case ENGINE_FOLDDRIVE:
+			foldDrive = (atoi( value.c_str() ) != 0);
+			break;
+		case ENGINE_FLAREANIMATION:
+			flareAnimation = value;
+			break;
+		case ENGINE_THRUSTSOUND:
+			thrustsound = Sound::Acquire( value );
+			break;
+		case ENGINE_PICNAME: {
+			ResourceHandle<Image> pic = Image::Acquire( value );
+			// This image can be accessed by either the path or the Engine Name
+			Image::Store(name, pic);
+			SetPicture(pic);
+			break;
+		}
 	}
-
-	if( (attr = FirstChildNamed(node,"forceOutput")) ){
-		value = NodeToString(doc,attr);
-		SetForceOutput( static_cast<float> (atof( value.c_str() )));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"msrp")) ){
-		value = NodeToString(doc,attr);
-		SetMSRP( (short int)atoi( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"foldDrive")) ){
-		value = NodeToString(doc,attr);
-		foldDrive = (atoi( value.c_str() ) != 0);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"flareAnimation")) ){
-		flareAnimation = NodeToString(doc,attr);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"thrustSound")) ){
-		thrustsound = Sound::Get( NodeToString(doc,attr) );
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
-		// This image can be accessed by either the path or the Engine Name
-		Image::Store(name, pic);
-		SetPicture(pic);
-	} else return false;
-
 	return true;
 }
 
@@ -129,6 +143,34 @@ xmlNodePtr Engine::ToXMLNode(string componentName) {
 	return section;
 }
 
+/**\brief Write this Engine to a binary cache.
+ */
+bool Engine::Serialize( BinaryWriter& out ) {
+	if( (thrustsound == NULL) || !Outfit::Serialize( out ) ) {
+		return false;
+	}
+	out.WriteBool( foldDrive );
+	out.WriteString( flareAnimation );
+	out.WriteString( thrustsound->GetPath() );
+	return true;
+}
+
+/**\brief Read this Engine from a binary cache.
+ */
+bool Engine::Deserialize( BinaryReader& in ) {
+	if( !Outfit::Deserialize( in ) ) {
+		return false;
+	}
+	foldDrive = in.ReadBool();
+	flareAnimation = in.ReadString();
+	string soundName = in.ReadString();
+	if( in.Failed() ) {
+		return false;
+	}
+	thrustsound = Sound::Acquire( soundName );
+	return true;
+}
+
 /**\fn Engine::GetFlareAnimation()
  * \brief Gets the animation.
  */
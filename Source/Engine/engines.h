@@ -1,7 +1,7 @@
 /**\file			engines.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -22,15 +22,18 @@ class Engine : public Outfit {
 		Engine& operator= (const Engine&);
 		Engine( string _name, Image* _pic, string _description, Sound* _sound, float _forceOutput, short int _msrp, bool _foldDrive, string _flareAnimation);
 
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 
 		string GetFlareAnimation( void ) { return flareAnimation; }
 		short int GetFoldDrive( void ) { return foldDrive; }
 		Sound* GetSound() { return thrustsound; }
 
 	private:
-		Sound *thrustsound;
+		ResourceHandle<Sound> thrustsound;
 		bool foldDrive;
 		string flareAnimation;
 };
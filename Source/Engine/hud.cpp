@@ -1,7 +1,7 @@
 /**\file			hud.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created  : Sunday, July 23, 2006
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Handles the Heads-Up-Display
  * \details
  */
@@ -20,6 +20,17 @@
 #include "Utilities/timer.h"
 #include "Engine/camera.h"
 
+static Option<Uint32> alertDrop( "options/timing/alert-drop" );
+static Option<Uint32> alertFade( "options/timing/alert-fade" );
+static Option<Uint32> targetZoom( "options/timing/target-zoom" );
+
+static const XMLPathID skinStatusBarFont = XMLFile::Intern( "Skin/HUD/StatusBar/Font" );
+static const XMLPathID skinStatusBarSize = XMLFile::Intern( "Skin/HUD/StatusBar/Size" );
+static const XMLPathID skinStatusBarColor = XMLFile::Intern( "Skin/HUD/StatusBar/Color" );
+static const XMLPathID skinAlertFont = XMLFile::Intern( "Skin/HUD/Alert/Font" );
+static const XMLPathID skinAlertColor = XMLFile::Intern( "Skin/HUD/Alert/Color" );
+static const XMLPathID skinAlertSize = XMLFile::Intern( "Skin/HUD/Alert/Size" );
+
 /* Length of the hull integrity bar (pixels) + 6px (the left+right side imgs) */
 #define HULL_INTEGRITY_BAR  65
 
@@ -46,6 +57,9 @@ Color Hud::AlertColor = WHITE;
 
 int Radar::visibility = QUADRANTSIZE;
 bool Radar::largeMode = false;
+Map* Radar::largeMap = NULL;
+vector<Sprite*> Radar::blips;
+LineBatch Radar::batch;
 
 Font *StatusBar::font = NULL;
 
@@ -80,7 +94,7 @@ AlertMessage::AlertMessage( string message, Uint32 start )
  * \return true if expired
  */
 bool MessageExpired(const AlertMessage& msg){
-	return (Timer::GetTicks() - msg.start > OPTION(Uint32,"options/timing/alert-drop"));
+	return (Timer::GetTicks() - msg.start > alertDrop);
 }
 
 /**\class StatusBar
@@ -101,9 +115,9 @@ StatusBar::StatusBar(string _title, int _width, QuadPosition _pos, string _updat
 	assert(pos<=4);
 
 	if( font == NULL ) {
-		font = Font::Get( SKIN("Skin/HUD/StatusBar/Font") );
-		font->SetSize( convertTo<int>(SKIN("Skin/HUD/StatusBar/Size")) );
-		font->SetColor( SKIN("Skin/HUD/StatusBar/Color") );
+		font = Font::Get( SKIN(skinStatusBarFont) );
+		font->SetSize( skinfile->GetInt(skinStatusBarSize) );
+		font->SetColor( SKIN(skinStatusBarColor) );
 	}
 }
 
@@ -247,9 +261,9 @@ void StatusBar::SetName( string n )
  * \brief Heads-Up-Display. */
 
 void Hud::Init( void ) {
-	AlertFont = new Font( SKIN("Skin/HUD/Alert/Font") );
-	AlertColor = Color( SKIN("Skin/HUD/Alert/Color") );
-	AlertFont->SetSize( convertTo<int>( SKIN("Skin/HUD/Alert/Size") ) );
+	AlertFont = new Font( SKIN(skinAlertFont) );
+	AlertColor = Color( SKIN(skinAlertColor) );
+	AlertFont->SetSize( skinfile->GetInt(skinAlertSize) );
 }
 
 void Hud::Close( void ) {
@@ -324,14 +338,14 @@ void Hud::DrawMessages() {
 	int now = Timer::GetTicks();
 	list<AlertMessage>::reverse_iterator i;
 	Uint32 age;
-	Uint32 alertFade = OPTION(Uint32,"options/timing/alert-fade");
-	Uint32 alertDrop = OPTION(Uint32,"options/timing/alert-drop");
-	
+	Uint32 fade = alertFade;
+	Uint32 drop = alertDrop;
+
 	for( i= AlertMessages.rbegin(), j=1; (i != AlertMessages.rend()) && (j <= MAX_ALERTS); ++i,++j ){
 		//printf("[%d] %s\n", j, (*i).message.c_str() );
 		age = now - (*i).start;
-		if(age > alertFade){
-			AlertFont->SetColor( AlertColor, 1.f - float((age-alertFade))/float(alertDrop-alertFade) );
+		if(age > fade){
+			AlertFont->SetColor( AlertColor, 1.f - float((age-fade))/float(drop-fade) );
 		} else {
 			AlertFont->SetColor( AlertColor, 1.f);
 		}
@@ -411,9 +425,9 @@ void Hud::DrawTarget( SpriteManager* sprites ) {
 		int r = target->GetRadarSize();
 		Color c = target->GetRadarColor();
 
-		if( (Timer::GetTicks() - timeTargeted) < OPTION(Uint32, "options/timing/target-zoom")) {
-			r += Video::GetHalfHeight() - Video::GetHalfHeight()*(Timer::GetTicks()-timeTargeted)/OPTION(Uint32,"options/timing/target-zoom");
-			int max = Video::GetHalfHeight() * (1 - (Timer::GetTicks()-timeTargeted)/OPTION(Uint32,"options/timing/target-zoom") );
+		if( (Timer::GetTicks() - timeTargeted) < targetZoom) {
+			r += Video::GetHalfHeight() - Video::GetHalfHeight()*(Timer::GetTicks()-timeTargeted)/targetZoom;
+			int max = Video::GetHalfHeight() * (1 - (Timer::GetTicks()-timeTargeted)/targetZoom );
 			for( ; r < max; r = (r*11)/10) {
 				c = c * .9f;
 				edge += 3;
@@ -659,7 +673,13 @@ int Hud::setTarget(lua_State *L) {
 }
 
 /**\class Radar
- * \brief Hud Element that displays nearby objects. */
+ * \brief Hud Element that displays nearby objects.
+ * \details The Sprites in range are found into a vector that is kept between
+ *          frames, and every blip is drawn in one LineBatch.  The blinking
+ *          target is drawn on its own since its line is wider.
+ *
+ *          In large mode the radar is a Map widget, which is remembered
+ *          until it is closed rather than searched for in the UI. */
 
 /**\brief Empty constructor.
  */
@@ -672,10 +692,9 @@ Radar::Radar( void ) {
 void Radar::SetVisibility( int visibility ) {
 	Radar::visibility = visibility;
 	if( largeMode ) {
-		Map* map = (Map*)UI::Search("/Map/");
-		assert( map );
-		if( map ) {
-			map->SetScale( 300.0 / (2*visibility) );
+		assert( largeMap );
+		if( largeMap ) {
+			largeMap->SetScale( 300.0 / (2*visibility) );
 		}
 	}
 }
@@ -684,6 +703,7 @@ void Radar::StartLargeMode( Camera* camera, SpriteManager* sprites ) {
 	largeMode = true;
 	Map* map = new Map( Video::GetWidth() - 300, 0, 300, 300, camera->GetFocusCoordinate(), sprites );
 	map->RegisterAction( Action_MouseLeave, new VoidAction( Radar::StopLargeMode ) );
+	map->RegisterAction( Action_Close, new VoidAction( Radar::LargeMapClosed ) );
 	map->SetFilter(
 		DRAW_ORDER_PLAYER   |
 		DRAW_ORDER_PLANET   |
@@ -691,10 +711,20 @@ void Radar::StartLargeMode( Camera* camera, SpriteManager* sprites ) {
 		DRAW_ORDER_SHIP );
 	map->SetScale( 300.0 / (2*visibility) );
 	UI::Add(map);
+	largeMap = map;
 }
 
 void Radar::StopLargeMode() {
-	UI::Close( UI::Search( "/Map/" ) );
+	if( largeMap ) {
+		UI::Close( largeMap );
+	}
+	largeMode = false;
+}
+
+/**\brief Forget the large mode Map once the UI deletes it.
+ */
+void Radar::LargeMapClosed() {
+	largeMap = NULL;
 	largeMode = false;
 }
 
@@ -709,49 +739,53 @@ void Radar::Draw( Camera* camera, SpriteManager* sprites ) {
 	if(largeMode) {
 		if( visibility <= QUADRANTSIZE )
 		{
-			Map* map = (Map*)UI::Search( "/Map/" );
-			assert(map); // large mode should only be on when there is a map.
-			if(map) {
-				map->SetCenter( focus );
-				map->SetScale( 300.0 / (2*visibility) );
+			assert(largeMap); // large mode should only be on when there is a map.
+			if(largeMap) {
+				largeMap->SetCenter( focus );
+				largeMap->SetScale( 300.0 / (2*visibility) );
 			}
 		}
 		return;
 	}
 
-	list<Sprite*> *spriteList = sprites->GetSpritesNear(camera->GetFocusCoordinate(), (float)visibility);
-	for( list<Sprite*>::const_iterator iter = spriteList->begin(); iter != spriteList->end(); iter++)
+	Sprite *target = NULL;
+	Coordinate targetBlip;
+	int targetSize = 0;
+	bool blink = (Timer::GetTicks() % 1000 < 100);
+
+	// The blips do not overlap in any way that depends on their order
+	sprites->FindSpritesNear( focus, (float)visibility, &blips );
+	batch.Clear();
+	for( vector<Sprite*>::const_iterator iter = blips.begin(); iter != blips.end(); ++iter )
 	{
 		Coordinate blip;
 		Sprite *sprite = *iter;
 		
-		//if( sprite->GetDrawOrder() == DRAW_ORDER_PLAYER ) continue;
-		
 		// Calculate the blip coordinate for this sprite
 		Coordinate wpos = sprite->GetWorldPosition();
 		WorldToBlip( focus, wpos, blip );
 		
-		// Use the OpenGL Crop Rectangle to ensure that the blip is on the radar
-		
 		/* Convert to screen coords */
-		blip.SetX( blip.GetX() + radar_mid_x );
-		blip.SetY( blip.GetY() + radar_mid_y );
+		int x = TO_INT( blip.GetX() + radar_mid_x );
+		int y = TO_INT( blip.GetY() + radar_mid_y );
 		
 		radarSize = int((sprite->GetRadarSize() / float(visibility)) * (RADAR_HEIGHT/4.0));
 		
-		if( radarSize >= 1 ) {
-			if(sprite->GetID() == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
-				Video::DrawCircle( blip, radarSize, 2, WHITE );
-			else
-				Video::DrawCircle( blip, radarSize, 1, sprite->GetRadarColor() );
+		if( blink && (sprite->GetID() == Hud::GetTarget()) ) {
+			target = sprite;
+			targetBlip = Coordinate( x, y );
+			targetSize = (radarSize >= 1) ? radarSize : 1;
+		} else if( radarSize >= 1 ) {
+			batch.AddCircle( x, y, radarSize, sprite->GetRadarColor() );
 		} else {
-			if(sprite->GetID() == Hud::GetTarget() && Timer::GetTicks() % 1000 < 100)
-				Video::DrawCircle( blip, 1, 2, WHITE );
-			else
-				Video::DrawPoint( blip, sprite->GetRadarColor() );
+			batch.AddPoint( x, y, sprite->GetRadarColor() );
 		}
 	}
-	delete spriteList;
+	batch.Draw();
+
+	if( target ) {
+		Video::DrawCircle( targetBlip, targetSize, 2, WHITE );
+	}
 }
 
 /**\brief Gets the radar position based on world coordinate
@@ -1,7 +1,7 @@
 /**\file			hud.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created  : Sunday, July 23, 2006
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Handles the Heads-Up-Display
  * \details
  */
@@ -12,12 +12,15 @@
 #include "includes.h"
 #include "Graphics/image.h"
 #include "Graphics/font.h"
+#include "Graphics/video.h"
 #include "Utilities/lua.h"
 #include "Utilities/quadtree.h"
 #include "Input/input.h"
 #include "Engine/camera.h"
 #include "Sprites/spritemanager.h"
 
+class Map;
+
 #define EPIAR_HUD_TABLE "Epiar.HUD"
 #define EPIAR_HUD "HUD"
 #define MAX_STATUS_BARS 20
@@ -143,9 +146,13 @@ class Radar {
 	private:
 		static void WorldToBlip( Coordinate focus, Coordinate &w, Coordinate &b );
 		static void StopLargeMode();
+		static void LargeMapClosed();
 	
 		static int visibility;
 		static bool largeMode;
+		static Map* largeMap; ///< The Map shown in large mode, NULL otherwise.
+		static vector<Sprite*> blips; ///< Reused for the Sprites found each frame.
+		static LineBatch batch; ///< Reused for the blips drawn each frame.
 };
 
 #endif // __h_hud__
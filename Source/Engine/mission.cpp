@@ -1,7 +1,7 @@
 /**\file			mission.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Tuesday, August 24, 2010
- * \date			Modified: Tuesday, August 24, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			
  * \details
  */
@@ -11,6 +11,7 @@
 #include "Utilities/lua.h"
 #include "Utilities/log.h"
 #include "Utilities/components.h"
+#include "Sprites/spritemanager.h"
 
 /**\class Mission
  * \brief A Goal for the Player to complete for rewards.
@@ -37,7 +38,9 @@ MissionType = {
 	end,
 	Accept = function( missionTable ) end, --- Call this when the Mission is accepted.
 	Reject = function( missionTable ) end, --- Call this when the Mission is rejected after being accepted.
-	Update = function( missionTable ) --- Call this each time that the Mission should be checked.
+	Events = { "ShipDestroyed" }, --- Optional: the events that call Update (see below).
+	UpdatePeriod = 50, --- Optional: also call Update every this many ticks.
+	Update = function( missionTable, event, value ) --- Call this each time that the Mission should be checked.
 		return nil --- Return nil when the mission isn't over yet.
 		return true --- Return true when the mission has succeded.
 		return false --- Return false when the mission has failed.
@@ -56,11 +59,29 @@ MissionType = {
  * This table is generated by calling the MissionTable's Create function.
  * This table is sent as a message to each MissionTable function.
  * The MissionTable functions are free to modify this table as much as they want.
- * The Mission variable does not inspect this table except when saving the table to xml.
+ * The Mission variable does not inspect this table except to find its Region and when saving the table to xml.
  * This table is stored in the current lua state and only retrieved PushMissionTable.
  *
  * The C++ Mission class mostly interfaces with the MissionTypes by sending it MissionTables.
  *
+ * Update is only called when something the Mission cares about happens.  The
+ * MissionType lists those things in Events:
+ * - "ShipDestroyed": A ship was destroyed.  The value is its ID.
+ * - "EnteredRegion" and "ExitedRegion": The Player entered or left the
+ *   circle in the MissionTable's Region = { x=, y=, radius= }.  The Region is
+ *   read when the Mission is created and again after it is accepted.
+ * - "DayChanged": The Calendar reached a new period.  The value is the period.
+ *
+ * With an UpdatePeriod, Update is also called with the event "Tick" every that
+ * many ticks.  The ticks of different Missions are spread out so that they do
+ * not all run on the same tick.  Landing always calls Land.
+ *
+ * A MissionType with neither Events nor an UpdatePeriod has its Update called
+ * every tick, as every Mission used to.
+ *
+ * Events are queued as they happen and sent from the Player's next Update, so
+ * a Mission never runs in the middle of another system's update.
+ *
  * More information is found on the Epiar Wiki:
  * - http://epiar.net/trac/wiki/MissionCreation
  * - http://epiar.net/trac/wiki/MissionLifetime
@@ -68,22 +89,76 @@ MissionType = {
  * \see Resources/Scripts/missions.lua
  */
 
+list<Mission*> Mission::active;
+
 /**\brief Mission Constructor
+ * \details The Mission Type should already have been checked by ValidateMission.
  */
 Mission::Mission( lua_State *_L, string _type, int _tableReference)
 	:L(_L)
 	,type(_type)
 	,tableReference(_tableReference)
+	,typeReference(LUA_NOREF)
+	,everyTick(true)
+	,events(0)
+	,period(0)
+	,countdown(0)
+	,regionTrigger(0)
+	,ran(false)
+	,progress(0)
 {
+	if( Mission::GetMissionType(L, type) == 1 ) {
+		typeReference = luaL_ref(L, LUA_REGISTRYINDEX);
+	} else {
+		lua_pop(L, 1);
+	}
+	Subscribe();
+	active.push_back( this );
 }
 
 /**\brief Mission Destructor
+ * \todo Remove the SpriteManager Instance access.
  */
 Mission::~Mission()
 {
+	active.remove( this );
+	if( regionTrigger != 0 ) {
+		SpriteManager::Instance()->GetTriggers()->Remove( regionTrigger );
+	}
+	luaL_unref(L, LUA_REGISTRYINDEX, typeReference);
 	luaL_unref(L, LUA_REGISTRYINDEX, tableReference);
 }
 
+/**\brief Queue an event for every Mission that listens for it.
+ */
+void Mission::Post( MissionEvent event, int value )
+{
+	list<Mission*>::iterator m;
+	for( m = active.begin(); m != active.end(); ++m ) {
+		if( (*m)->events & event ) {
+			(*m)->pending.push_back( make_pair( event, value ) );
+		}
+	}
+}
+
+/**\brief The Player has entered the Region.
+ */
+void Mission::Entered( int trigger, Sprite* sprite, lua_State *L )
+{
+	if( events & MISSION_ENTERED_REGION ) {
+		pending.push_back( make_pair( MISSION_ENTERED_REGION, sprite->GetID() ) );
+	}
+}
+
+/**\brief The Player has left the Region.
+ */
+void Mission::Exited( int trigger, Sprite* sprite, lua_State *L )
+{
+	if( events & MISSION_EXITED_REGION ) {
+		pending.push_back( make_pair( MISSION_EXITED_REGION, sprite->GetID() ) );
+	}
+}
+
 
 bool Mission::ValidateMission( lua_State *L, string type, int tableReference, int expectedVersion ){
 	int i;
@@ -205,15 +280,109 @@ bool Mission::Reject()
 bool Mission::Accept()
 {
 	LogMsg(INFO, "Accepting Mission '%s'", GetName().c_str());
-	return RunFunction( "Accept", false );
+	bool failed = RunFunction( "Accept", false );
+	// Accept may have placed the Region
+	Subscribe();
+	return failed;
 }
 
-/**\brief 
+/**\brief Run Update for each event that has happened since the last call.
+ * \details This should be called once per tick.
  * \returns True if the Mission is over (success, failure, or error) and should be deleted.
  */
 bool Mission::Update()
 {
-	return RunFunction( "Update", true );
+	if( everyTick ) {
+		return RunFunction( "Update", true, MISSION_TICK );
+	}
+
+	while( !pending.empty() ) {
+		pair<MissionEvent,int> event = pending.front();
+		pending.pop_front();
+		if( RunFunction( "Update", true, event.first, event.second ) ) {
+			return true;
+		}
+	}
+
+	if( (period > 0) && (--countdown <= 0) ) {
+		countdown = period;
+		return RunFunction( "Update", true, MISSION_TICK );
+	}
+	return false;
+}
+
+/**\brief Add some bytes to a 32 bit FNV-1a hash.
+ */
+static Uint32 HashBytes( Uint32 hash, const void* data, size_t length ) {
+	const unsigned char* bytes = static_cast<const unsigned char*>( data );
+	for( size_t i = 0; i < length; ++i ) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**\brief Hash a Lua value, following nested tables down to a depth.
+ */
+static Uint32 HashLuaValue( lua_State *L, int index, Uint32 hash, int depth ) {
+	int type = lua_type( L, index );
+	hash = HashBytes( hash, &type, sizeof(type) );
+	switch( type ) {
+		case LUA_TNUMBER: {
+			lua_Number number = lua_tonumber( L, index );
+			hash = HashBytes( hash, &number, sizeof(number) );
+			break;
+		}
+		case LUA_TBOOLEAN: {
+			int boolean = lua_toboolean( L, index );
+			hash = HashBytes( hash, &boolean, sizeof(boolean) );
+			break;
+		}
+		case LUA_TSTRING: {
+			size_t length;
+			const char* text = lua_tolstring( L, index, &length );
+			hash = HashBytes( hash, text, length );
+			break;
+		}
+		case LUA_TTABLE:
+			if( depth <= 0 ) {
+				break;
+			}
+			if( index < 0 ) {
+				index = lua_gettop( L ) + index + 1;
+			}
+			lua_pushnil( L );
+			while( lua_next( L, index ) != 0 ) {
+				hash = HashLuaValue( L, -2, hash, depth - 1 );
+				hash = HashLuaValue( L, -1, hash, depth - 1 );
+				lua_pop( L, 1 );
+			}
+			break;
+	}
+	return hash;
+}
+
+/**\brief Check whether the Mission Table changed since the last check.
+ * \details The table is only hashed when Lua has run since the last check,
+ *          so this is cheap for Missions that are waiting for an event.
+ * \returns true if the Mission made progress that has not been saved.
+ */
+bool Mission::Progressed()
+{
+	if( !ran ) {
+		return false;
+	}
+	ran = false;
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, tableReference);
+	Uint32 hash = HashLuaValue( L, -1, 2166136261u, 4 );
+	lua_pop(L, 1);
+
+	if( hash == progress ) {
+		return false;
+	}
+	progress = hash;
+	return true;
 }
 
 /**\brief 
@@ -261,15 +430,109 @@ int Mission::GetVersion()
 	return version;
 }
 
+/**\brief Read which events this Mission listens for.
+ * \details This reads the Events and UpdatePeriod of the Mission Type and the
+ *          Region of the Mission Table.
+ * \todo Remove the SpriteManager Instance access.
+ */
+void Mission::Subscribe()
+{
+	const int initialStackTop = lua_gettop(L);
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, typeReference);
+	if( ! lua_istable(L, initialStackTop + 1) ) {
+		lua_settop(L, initialStackTop );
+		return;
+	}
+
+	events = 0;
+	lua_pushstring(L, "Events" );
+	lua_gettable(L, initialStackTop + 1);
+	bool listed = lua_istable(L, initialStackTop + 2);
+	if( listed ) {
+		int count = static_cast<int>( lua_objlen(L, initialStackTop + 2) );
+		for( int e = 1; e <= count; ++e ) {
+			lua_rawgeti(L, initialStackTop + 2, e);
+			string name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
+			lua_pop(L, 1);
+			int event;
+			for( event = MISSION_SHIP_DESTROYED; event <= MISSION_TICK; event <<= 1 ) {
+				if( name == GetEventName( event ) ) {
+					events |= event;
+					break;
+				}
+			}
+			if( event > MISSION_TICK ) {
+				LogMsg(WARN, "The Mission '%s' listens for the unknown event '%s'.", type.c_str(), name.c_str() );
+			}
+		}
+	}
+	lua_settop(L, initialStackTop + 1);
+
+	lua_pushstring(L, "UpdatePeriod" );
+	lua_gettable(L, initialStackTop + 1);
+	int newPeriod = lua_isnumber(L, initialStackTop + 2) ? static_cast<int>( lua_tonumber(L, initialStackTop + 2) ) : 0;
+	if( newPeriod != period ) {
+		period = ( newPeriod < 0 ) ? 0 : newPeriod;
+		// Spread the ticks of the Missions out
+		countdown = ( period > 0 ) ? 1 + tableReference % period : 0;
+	}
+	everyTick = !listed && (period == 0);
+	lua_settop(L, initialStackTop);
+
+	// The Region
+	Triggers* triggers = SpriteManager::Instance()->GetTriggers();
+	float x = 0.0f, y = 0.0f, radius = 0.0f;
+	if( events & (MISSION_ENTERED_REGION | MISSION_EXITED_REGION) ) {
+		PushMissionTable();
+		lua_pushstring(L, "Region" );
+		lua_gettable(L, initialStackTop + 1);
+		if( lua_istable(L, initialStackTop + 2) ) {
+			lua_getfield(L, initialStackTop + 2, "x" );
+			lua_getfield(L, initialStackTop + 2, "y" );
+			lua_getfield(L, initialStackTop + 2, "radius" );
+			x = static_cast<float>( lua_tonumber(L, initialStackTop + 3) );
+			y = static_cast<float>( lua_tonumber(L, initialStackTop + 4) );
+			radius = static_cast<float>( lua_tonumber(L, initialStackTop + 5) );
+		}
+		lua_settop(L, initialStackTop);
+	}
+	if( regionTrigger != 0 ) {
+		triggers->Remove( regionTrigger );
+		regionTrigger = 0;
+	}
+	if( radius > 0.0f ) {
+		regionTrigger = triggers->Add( Coordinate( x, y ), radius, DRAW_ORDER_PLAYER, this );
+	}
+}
+
+/**\brief The name of an event in the Events of a Mission Type.
+ */
+const char* Mission::GetEventName( int event )
+{
+	switch( event ) {
+		case MISSION_SHIP_DESTROYED: return "ShipDestroyed";
+		case MISSION_ENTERED_REGION: return "EnteredRegion";
+		case MISSION_EXITED_REGION: return "ExitedRegion";
+		case MISSION_DAY_CHANGED: return "DayChanged";
+		case MISSION_TICK: return "Tick";
+	}
+	return "";
+}
+
 /**\brief
+ * \param event When this is set, the name of the event and the value are
+ *        passed to the function after the Mission Table.
  * \returns true when this Mission is complete
  */
-bool Mission::RunFunction(string functionName, bool checkCompletion)
+bool Mission::RunFunction(string functionName, bool checkCompletion, int event, int value)
 {
 	const int initialStackTop = lua_gettop(L);
 
-	if( Mission::GetMissionType(L, type) != 1 ) {
-		LogMsg(ERR, "Something bad happened?"); // TODO
+	// The Mission Type is only looked up once
+	lua_rawgeti(L, LUA_REGISTRYINDEX, typeReference);
+	if( ! lua_istable(L, initialStackTop + 1) ) {
+		LogMsg(ERR, "There is no Mission Type named '%s'.", type.c_str() );
 		lua_settop(L, initialStackTop );
 		return true;
 	}
@@ -285,9 +548,16 @@ bool Mission::RunFunction(string functionName, bool checkCompletion)
 	}
 
 	lua_rawgeti(L, LUA_REGISTRYINDEX, tableReference);
+	ran = true;
+	int arguments = 1;
+	if( event != 0 ) {
+		lua_pushstring(L, GetEventName( event ) );
+		lua_pushinteger(L, value );
+		arguments = 3;
+	}
 	
 	// Call the function
-	if( lua_pcall(L, 1, LUA_MULTRET, 0) != 0)
+	if( lua_pcall(L, arguments, LUA_MULTRET, 0) != 0)
 	{
 		LogMsg(ERR,"Failed to run %s.%s: %s\n", type.c_str(), functionName.c_str(), lua_tostring(L, -1));
 		lua_settop(L,initialStackTop);
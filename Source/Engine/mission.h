@@ -1,7 +1,7 @@
 /**\file			mission.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Tuesday, August 24, 2010
- * \date			Modified: Tuesday, August 24, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			
  * \details
  */
@@ -11,18 +11,33 @@
 
 #include "includes.h"
 #include "common.h"
+#include "Utilities/triggers.h"
 
-class Mission{
+/** The engine events that a MissionType can list in its Events. */
+typedef enum {
+	MISSION_SHIP_DESTROYED	= 1 << 0,	/**< A ship was destroyed.  The value is its ID. */
+	MISSION_ENTERED_REGION	= 1 << 1,	/**< The Player entered the Region.  The value is the Player's ID. */
+	MISSION_EXITED_REGION	= 1 << 2,	/**< The Player left the Region.  The value is the Player's ID. */
+	MISSION_DAY_CHANGED		= 1 << 3,	/**< The Calendar reached a new period.  The value is the period. */
+	MISSION_TICK			= 1 << 4	/**< The UpdatePeriod has passed. */
+} MissionEvent;
+
+class Mission : public TriggerListener {
 	public:
 		Mission( lua_State *L, string _type, int _tableReference);
 		~Mission();
 
+		static void Post( MissionEvent event, int value = 0 );
+		void Entered( int trigger, Sprite* sprite, lua_State *L );
+		void Exited( int trigger, Sprite* sprite, lua_State *L );
+
 		static bool ValidateMission( lua_State *L, string type, int tableReference, int expectedVersion );
 
 		bool Accept();
 		bool Reject();
 		bool Update();
 		bool Land();
+		bool Progressed();
 
 		int GetVersion();
 		string GetName() { return GetStringAttribute("Name"); }
@@ -37,10 +52,24 @@ class Mission{
 		lua_State *L; ///< Lua Pointer
 		string type; ///< The Mission Type
 		int tableReference; ///< A Lua table to hold
+		int typeReference; ///< The Mission Type table, looked up once
+
+		bool everyTick; ///< The Mission Type has no Events, so Update runs every tick
+		int events; ///< The MissionEvents that run Update
+		int period; ///< Ticks between the MISSION_TICK events, or 0 for none
+		int countdown; ///< Ticks until the next MISSION_TICK
+		int regionTrigger; ///< The trigger volume of the Region, or 0
+		list< pair<MissionEvent,int> > pending; ///< Events waiting for the next Update
+		bool ran; ///< Lua has run since the last call to Progressed
+		Uint32 progress; ///< A hash of the Mission Table when Progressed last looked
+
+		static list<Mission*> active; ///< Every Mission that can receive events
 
-		bool RunFunction(string functionName, bool checkCompletion);
+		void Subscribe();
+		bool RunFunction(string functionName, bool checkCompletion, int event = 0, int value = 0);
 		string GetStringAttribute(string attribute);
 		static int GetMissionType( lua_State *L, string type );
+		static const char* GetEventName( int event );
 };
 
 #endif //__H_MISSION__
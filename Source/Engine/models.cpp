@@ -1,7 +1,7 @@
 /**\file			models.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -62,14 +62,14 @@ Model& Model::operator=(const Model& other) {
 	image = other.image;
 	description = other.description;
 	defaultEngine = other.defaultEngine;
-	mass = other.mass;
+	stats.mass = other.stats.mass;
 	thrustOffset = other.thrustOffset;
-	rotPerSecond = other.rotPerSecond;
-	maxSpeed = other.maxSpeed;
-	msrp = other.msrp;
-	cargoSpace = other.cargoSpace;
-	hullStrength = other.hullStrength;
-	shieldStrength = other.shieldStrength;
+	stats.rotPerSecond = other.stats.rotPerSecond;
+	stats.maxSpeed = other.stats.maxSpeed;
+	stats.msrp = other.stats.msrp;
+	stats.cargoSpace = other.stats.cargoSpace;
+	stats.hullStrength = other.stats.hullStrength;
+	stats.shieldStrength = other.stats.shieldStrength;
 	return *this;
 }
 
@@ -118,76 +118,92 @@ Model::Model(
 	//((Component*)this)->SetName(_name);
 }
 
-/**\brief For parsing XML file into fields.
+enum {
+	MODEL_IMAGE,
+	MODEL_DESCRIPTION,
+	MODEL_ENGINE,
+	MODEL_MASS,
+	MODEL_ROTATIONSPERSECOND,
+	MODEL_THRUSTOFFSET,
+	MODEL_MAXSPEED,
+	MODEL_MSRP,
+	MODEL_CARGOSPACE,
+	MODEL_HULLSTRENGTH,
+	MODEL_SHIELDSTRENGTH,
+	MODEL_WEAPONSLOTS
+};
+
+static const ComponentField modelFields[] = {
+	{ "image", MODEL_IMAGE, FIELD_REQUIRED },
+	{ "description", MODEL_DESCRIPTION, 0 },
+	{ "engine", MODEL_ENGINE, FIELD_REQUIRED },
+	{ "mass", MODEL_MASS, FIELD_REQUIRED },
+	{ "rotationsPerSecond", MODEL_ROTATIONSPERSECOND, FIELD_REQUIRED },
+	{ "thrustOffset", MODEL_THRUSTOFFSET, FIELD_REQUIRED },
+	{ "maxSpeed", MODEL_MAXSPEED, FIELD_REQUIRED },
+	{ "msrp", MODEL_MSRP, FIELD_REQUIRED },
+	{ "cargoSpace", MODEL_CARGOSPACE, FIELD_REQUIRED },
+	{ "hullStrength", MODEL_HULLSTRENGTH, FIELD_REQUIRED },
+	{ "shieldStrength", MODEL_SHIELDSTRENGTH, FIELD_REQUIRED },
+	{ "weaponSlots", MODEL_WEAPONSLOTS, FIELD_NESTED },
+	{ NULL, 0, 0 }
+};
+
+/**\brief The XML fields of a Model.
  */
-bool Model::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
+const ComponentField* Model::GetFields( void ) {
+	return modelFields;
+}
 
-	if( (attr = FirstChildNamed(node,"image")) ){
-		image = Image::Get( NodeToString(doc,attr) );
-		Image::Store(name, image);
-		SetPicture(image);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"description")) ){
-		value = NodeToString(doc,attr);
-		SetDescription( value );
-	} else {
-		LogMsg( WARN, "%s does not have a description.", GetName().c_str() );
+/**\brief Parse one XML field of a Model.
+ */
+bool Model::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case MODEL_IMAGE:
+			image = Image::Acquire( value );
+			Image::Store(name, image);
+			SetPicture(image);
+			break;
+		case MODEL_DESCRIPTION:
+			SetDescription( value );
+			break;
+		case MODEL_ENGINE:
+			defaultEngine = Engines::Instance()->GetEngine( value );
+			break;
+		case MODEL_MASS:
+			SetMass( static_cast<float> (atof( value.c_str() )));
+			break;
+		case MODEL_ROTATIONSPERSECOND:
+			SetRotationsPerSecond( static_cast<float>(atof( value.c_str() )));
+			break;
+		case MODEL_THRUSTOFFSET:
+			thrustOffset = static_cast<short>(atoi( value.c_str() ));
+			break;
+		case MODEL_MAXSPEED:
+			SetMaxSpeed( static_cast<float>(atof( value.c_str() )));
+			break;
+		case MODEL_MSRP:
+			SetMSRP( (short int)atoi( value.c_str() ));
+			break;
+		case MODEL_CARGOSPACE:
+			SetCargoSpace( atoi( value.c_str() ));
+			break;
+		case MODEL_HULLSTRENGTH:
+			SetHullStrength( (short)atoi( value.c_str() ));
+			break;
+		case MODEL_SHIELDSTRENGTH:
+			SetShieldStrength( (short)atoi( value.c_str() ));
+			break;
 	}
+	return true;
+}
 
-	if( (attr = FirstChildNamed(node,"engine")) ){
-		defaultEngine = Engines::Instance()->GetEngine( NodeToString(doc,attr) );
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"mass")) ){
-		value = NodeToString(doc,attr);
-		SetMass( static_cast<float> (atof( value.c_str() )));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"rotationsPerSecond")) ){
-		value = NodeToString(doc,attr);
-		SetRotationsPerSecond( static_cast<float>(atof( value.c_str() )));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"thrustOffset")) ){
-		value = NodeToString(doc,attr);
-		thrustOffset = static_cast<short>(atoi( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"maxSpeed")) ){
-		value = NodeToString(doc,attr);
-		SetMaxSpeed( static_cast<float>(atof( value.c_str() )));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"msrp")) ){
-		value = NodeToString(doc,attr);
-		SetMSRP( (short int)atoi( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"cargoSpace")) ){
-		value = NodeToString(doc,attr);
-		SetCargoSpace( atoi( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"hullStrength")) ){
-		value = NodeToString(doc,attr);
-		SetHullStrength( (short)atoi( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"shieldStrength")) ){
-		value = NodeToString(doc,attr);
-		SetShieldStrength( (short)atoi( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"weaponSlots")) ){
-		// pass the weaponSlots XML node into a handler function
-		ConfigureWeaponSlots( doc, attr );
-	} else {
-		//LogMsg( WARN, "Did not find weapon slot configuration - ship cannot have weapons.");
+/**\brief Parse the weapon slots of a Model.
+ */
+bool Model::ParseNestedField( int field, xmlDocPtr doc, xmlNodePtr node ) {
+	if( field == MODEL_WEAPONSLOTS ) {
+		ConfigureWeaponSlots( doc, node );
 	}
-
 	return true;
 }
 
@@ -248,6 +264,62 @@ xmlNodePtr Model::ToXMLNode(string componentName) {
 	return section;
 }
 
+/**\brief Write this Model to a binary cache.
+ */
+bool Model::Serialize( BinaryWriter& out ) {
+	if( (image == NULL) || (defaultEngine == NULL) || !Outfit::Serialize( out ) ) {
+		return false;
+	}
+	out.WriteString( image->GetPath() );
+	out.WriteString( defaultEngine->GetName() );
+	out.WriteShort( thrustOffset );
+	out.WriteUint( static_cast<Uint32>( weaponSlots.size() ) );
+	for( unsigned int w = 0; w < weaponSlots.size(); w++ ) {
+		WeaponSlot *slot = &weaponSlots[w];
+		out.WriteString( slot->name );
+		out.WriteInt( slot->x );
+		out.WriteInt( slot->y );
+		out.WriteDouble( slot->angle );
+		out.WriteDouble( slot->motionAngle );
+		out.WriteString( slot->content ? slot->content->GetName() : "" );
+		out.WriteShort( slot->firingGroup );
+	}
+	return true;
+}
+
+/**\brief Read this Model from a binary cache.
+ */
+bool Model::Deserialize( BinaryReader& in ) {
+	if( !Outfit::Deserialize( in ) ) {
+		return false;
+	}
+	string imageName = in.ReadString();
+	string engineName = in.ReadString();
+	thrustOffset = in.ReadShort();
+	Uint32 numSlots = in.ReadUint();
+	for( Uint32 w = 0; (w < numSlots) && !in.Failed(); w++ ) {
+		WeaponSlot slot;
+		slot.name = in.ReadString();
+		slot.x = in.ReadInt();
+		slot.y = in.ReadInt();
+		slot.angle = in.ReadDouble();
+		slot.motionAngle = in.ReadDouble();
+		string content = in.ReadString();
+		slot.content = content.empty() ? NULL : Weapons::Instance()->GetWeapon( content );
+		slot.firingGroup = in.ReadShort();
+		weaponSlots.push_back( slot );
+	}
+	if( in.Failed() ) {
+		return false;
+	}
+
+	image = Image::Acquire( imageName );
+	Image::Store(name, image);
+	SetPicture(image);
+	defaultEngine = Engines::Instance()->GetEngine( engineName );
+	return true;
+}
+
 /**\brief Configure the ship's weapon slots based on the XML node weaponSlots.
  */
 bool Model::ConfigureWeaponSlots( xmlDocPtr doc, xmlNodePtr node ) {
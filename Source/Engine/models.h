@@ -1,7 +1,7 @@
 /**\file			models.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -46,8 +46,12 @@ class Model : public Outfit {
 				int _cargoSpace,
 				vector<WeaponSlot>& _weaponSlots);
 
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
+		bool ParseNestedField( int field, xmlDocPtr doc, xmlNodePtr node );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 		
 		Image *GetImage( void ) { return image; }
 
@@ -60,7 +64,7 @@ class Model : public Outfit {
 		bool ConfigureWeaponSlots( vector<WeaponSlot>& slots );
 
 	private:
-		Image *image; ///< The Image used when drawing these ships in space.
+		ResourceHandle<Image> image; ///< The Image used when drawing these ships in space.
 		Engine* defaultEngine; ///< The default Engine for this model
 		short int thrustOffset; ///< The number of pixels engine flare animation offset
 		vector<WeaponSlot> weaponSlots; ///< Slots for Weapons
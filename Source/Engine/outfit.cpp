@@ -1,7 +1,7 @@
 /**\file			outfit.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Thursday, April 29, 2010
- * \date			Modified: Thursday, April 29, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -19,20 +19,56 @@
  * \sa Engine, Model, Outfit
  */
 
+/**\class OutfitStats
+ * \brief The numeric stats of an Outfit.
+ * \details Every Model, Engine, Weapon and Outfit keeps its stats in one of
+ *          these, and Ships only ever read them.  A Ship adds up the stats of
+ *          everything it has equipped into its own OutfitStats, so that the
+ *          names, descriptions and pictures are never copied.
+ * \sa Ship::GetStats
+ */
+
+/** Creates empty stats
+ */
+OutfitStats::OutfitStats() {
+	Clear();
+}
+
+/** Reset every stat to zero
+ */
+void OutfitStats::Clear() {
+	msrp = 0;
+	rotPerSecond = 0;
+	maxSpeed = 0;
+	forceOutput = 0;
+	mass = 0;
+	cargoSpace = 0;
+	surfaceArea = 0;
+	hullStrength = 0;
+	shieldStrength = 0;
+}
+
+/**	Add the stats of another Outfit to these
+ */
+OutfitStats& OutfitStats::operator+= (const OutfitStats& other)
+{
+	msrp += other.msrp;
+	rotPerSecond += other.rotPerSecond;
+	maxSpeed += other.maxSpeed;
+	forceOutput += other.forceOutput;
+	mass += other.mass;
+	cargoSpace += other.cargoSpace;
+	surfaceArea += other.surfaceArea;
+	hullStrength += other.hullStrength;
+	shieldStrength += other.shieldStrength;
+	return *this;
+}
+
 /** Default Constructor
  */
 Outfit::Outfit()
-	:msrp(0)
-	,picture(NULL)
+	:picture(NULL)
 	,description("")
-	,rotPerSecond(0)
-	,maxSpeed(0)
-	,forceOutput(0)
-	,mass(0)
-	,cargoSpace(0)
-	,surfaceArea(0)
-	,hullStrength(0)
-	,shieldStrength(0)
 {
 }
 
@@ -51,35 +87,27 @@ Outfit::Outfit(
 	            int _hullStrength,
 	            int _shieldStrength
 	            )
-	:msrp(_msrp)
-	,picture(_picture)
+	:picture(_picture)
 	,description(_description)
-	,rotPerSecond(_rotPerSecond)
-	,maxSpeed(_maxSpeed)
-	,forceOutput(_forceOutput)
-	,mass(_mass)
-	,cargoSpace(_cargoSpace)
-	,surfaceArea(_surfaceArea)
-	,hullStrength(_hullStrength)
-	,shieldStrength(_shieldStrength)
 {
+	stats.msrp = _msrp;
+	stats.rotPerSecond = _rotPerSecond;
+	stats.maxSpeed = _maxSpeed;
+	stats.forceOutput = _forceOutput;
+	stats.mass = _mass;
+	stats.cargoSpace = _cargoSpace;
+	stats.surfaceArea = _surfaceArea;
+	stats.hullStrength = _hullStrength;
+	stats.shieldStrength = _shieldStrength;
 }
 
 /** Default Copy Constructor
  */
 Outfit& Outfit::operator= (const Outfit& other)
 {
-	msrp = other.msrp;
+	stats = other.stats;
 	picture = other.picture;
 	description = other.description;
-	rotPerSecond = other.rotPerSecond;
-	maxSpeed = other.maxSpeed;
-	forceOutput = other.forceOutput;
-	mass = other.mass;
-	cargoSpace = other.cargoSpace;
-	surfaceArea = other.surfaceArea;
-	hullStrength = other.hullStrength;
-	shieldStrength = other.shieldStrength;
 	return *this;
 }
 
@@ -88,16 +116,9 @@ Outfit& Outfit::operator= (const Outfit& other)
 Outfit Outfit::operator+ (const Outfit& other)
 {
 	Outfit total;
-	total.msrp = msrp + other.msrp;
 	total.picture = picture; // Keep the first picture
-	total.rotPerSecond = rotPerSecond + other.rotPerSecond;
-	total.maxSpeed = maxSpeed + other.maxSpeed;
-	total.forceOutput = forceOutput + other.forceOutput;
-	total.mass = mass + other.mass;
-	total.cargoSpace = cargoSpace + other.cargoSpace;
-	total.surfaceArea = surfaceArea + other.surfaceArea;
-	total.hullStrength = hullStrength + other.hullStrength;
-	total.shieldStrength = shieldStrength + other.shieldStrength;
+	total.stats = stats;
+	total.stats += other.stats;
 	return total;
 }
 
@@ -105,84 +126,88 @@ Outfit Outfit::operator+ (const Outfit& other)
  */
 Outfit& Outfit::operator+= (const Outfit& other)
 {
-	msrp += other.msrp;
 	// Don't change the picture
-	rotPerSecond += other.rotPerSecond;
-	maxSpeed += other.maxSpeed;
-	forceOutput += other.forceOutput;
-	mass += other.mass;
-	cargoSpace += other.cargoSpace;
-	surfaceArea += other.surfaceArea;
-	hullStrength += other.hullStrength;
-	shieldStrength += other.shieldStrength;
+	stats += other.stats;
 	return *this;
 }
 
-/**\brief Parses weapon information
+enum {
+	OUTFIT_MSRP,
+	OUTFIT_PICNAME,
+	OUTFIT_DESCRIPTION,
+	OUTFIT_ROTSPERSECOND,
+	OUTFIT_MAXSPEED,
+	OUTFIT_FORCE,
+	OUTFIT_MASS,
+	OUTFIT_SURFACEAREA,
+	OUTFIT_CARGOSPACE,
+	OUTFIT_HULL,
+	OUTFIT_SHIELD
+};
+
+static const ComponentField outfitFields[] = {
+	{ "msrp", OUTFIT_MSRP, FIELD_REQUIRED },
+	{ "picName", OUTFIT_PICNAME, FIELD_REQUIRED },
+	{ "description", OUTFIT_DESCRIPTION, 0 },
+	{ "rotsPerSecond", OUTFIT_ROTSPERSECOND, 0 },
+	{ "maxSpeed", OUTFIT_MAXSPEED, 0 },
+	{ "force", OUTFIT_FORCE, 0 },
+	{ "mass", OUTFIT_MASS, 0 },
+	{ "surfaceArea", OUTFIT_SURFACEAREA, 0 },
+	{ "cargoSpace", OUTFIT_CARGOSPACE, 0 },
+	{ "hull", OUTFIT_HULL, 0 },
+	{ "shield", OUTFIT_SHIELD, 0 },
+	{ NULL, 0, 0 }
+};
+
+/**\brief The XML fields of an Outfit.
  */
-bool Outfit::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
-
-	if( (attr = FirstChildNamed(node,"msrp")) ){
-		value = NodeToString(doc,attr);
-		SetMSRP( atoi( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
-		// This image can be accessed by either the path or the Engine Name
-		Image::Store(name, pic);
-		SetPicture(pic);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"description")) ){
-		value = NodeToString(doc,attr);
-		SetDescription( value );
-	} else {
-		LogMsg( WARN, "%s does not have a description.", GetName().c_str() );
-	}
-
-	if( (attr = FirstChildNamed(node,"rotsPerSecond")) ){
-		value = NodeToString(doc,attr);
-		SetRotationsPerSecond( static_cast<float>(atof( value.c_str() )));
-	}
-
-	if( (attr = FirstChildNamed(node,"maxSpeed")) ){
-		value = NodeToString(doc,attr);
-		SetMaxSpeed( static_cast<float>(atof( value.c_str() )));
-	}
-
-	if( (attr = FirstChildNamed(node,"force")) ){
-		value = NodeToString(doc,attr);
-		SetForceOutput( static_cast<float> (atof( value.c_str() )));
-	}
-
-	if( (attr = FirstChildNamed(node,"mass")) ){
-		value = NodeToString(doc,attr);
-		SetMass( static_cast<float> (atof( value.c_str() )));
-	}
-
-	if( (attr = FirstChildNamed(node,"surfaceArea")) ){
-		value = NodeToString(doc,attr);
-		SetSurfaceArea( atoi( value.c_str() ));
-	}
-
-	if( (attr = FirstChildNamed(node,"cargoSpace")) ){
-		value = NodeToString(doc,attr);
-		SetCargoSpace( atoi( value.c_str() ));
-	}
-
-	if( (attr = FirstChildNamed(node,"hull")) ){
-		value = NodeToString(doc,attr);
-		SetHullStrength( atoi( value.c_str() ));
-	}
+const ComponentField* Outfit::GetFields( void ) {
+	return outfitFields;
+}
 
-	if( (attr = FirstChildNamed(node,"shield")) ){
-		value = NodeToString(doc,attr);
-		SetShieldStrength( (short)atoi( value.c_str() ));
+/**\brief Parse one XML field of an Outfit.
+ */
+bool Outfit::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case OUTFIT_MSRP:
+			SetMSRP( atoi( value.c_str() ));
+			break;
+		case OUTFIT_PICNAME: {
+			ResourceHandle<Image> pic = Image::Acquire( value );
+			// This image can be accessed by either the path or the Outfit Name
+			Image::Store(name, pic);
+			SetPicture(pic);
+			break;
+		}
+		case OUTFIT_DESCRIPTION:
+			SetDescription( value );
+			break;
+		case OUTFIT_ROTSPERSECOND:
+			SetRotationsPerSecond( static_cast<float>(atof( value.c_str() )));
+			break;
+		case OUTFIT_MAXSPEED:
+			SetMaxSpeed( static_cast<float>(atof( value.c_str() )));
+			break;
+		case OUTFIT_FORCE:
+			SetForceOutput( static_cast<float> (atof( value.c_str() )));
+			break;
+		case OUTFIT_MASS:
+			SetMass( static_cast<float> (atof( value.c_str() )));
+			break;
+		case OUTFIT_SURFACEAREA:
+			SetSurfaceArea( atoi( value.c_str() ));
+			break;
+		case OUTFIT_CARGOSPACE:
+			SetCargoSpace( atoi( value.c_str() ));
+			break;
+		case OUTFIT_HULL:
+			SetHullStrength( atoi( value.c_str() ));
+			break;
+		case OUTFIT_SHIELD:
+			SetShieldStrength( (short)atoi( value.c_str() ));
+			break;
 	}
-
 	return true;
 }
 
@@ -228,6 +253,52 @@ xmlNodePtr Outfit::ToXMLNode(string componentName) {
 	return section;
 }
 
+/**\brief Write this Outfit to a binary cache.
+ * \details Subclasses write these common stats before their own.
+ */
+bool Outfit::Serialize( BinaryWriter& out ) {
+	if( picture == NULL ) {
+		return false;
+	}
+	out.WriteInt( stats.msrp );
+	out.WriteString( picture->GetPath() );
+	out.WriteString( description );
+	out.WriteFloat( stats.rotPerSecond );
+	out.WriteFloat( stats.maxSpeed );
+	out.WriteFloat( stats.forceOutput );
+	out.WriteFloat( stats.mass );
+	out.WriteInt( stats.cargoSpace );
+	out.WriteInt( stats.surfaceArea );
+	out.WriteInt( stats.hullStrength );
+	out.WriteInt( stats.shieldStrength );
+	return true;
+}
+
+/**\brief Read this Outfit from a binary cache.
+ */
+bool Outfit::Deserialize( BinaryReader& in ) {
+	stats.msrp = in.ReadInt();
+	string picName = in.ReadString();
+	description = in.ReadString();
+	stats.rotPerSecond = in.ReadFloat();
+	stats.maxSpeed = in.ReadFloat();
+	stats.forceOutput = in.ReadFloat();
+	stats.mass = in.ReadFloat();
+	stats.cargoSpace = in.ReadInt();
+	stats.surfaceArea = in.ReadInt();
+	stats.hullStrength = in.ReadInt();
+	stats.shieldStrength = in.ReadInt();
+	if( in.Failed() ) {
+		return false;
+	}
+
+	ResourceHandle<Image> pic = Image::Acquire( picName );
+	// This image can be accessed by either the path or the Outfit Name
+	Image::Store(name, pic);
+	SetPicture(pic);
+	return true;
+}
+
 /**
  * \fn Outfit::GetMSRP()
  * \brief Get the msrp
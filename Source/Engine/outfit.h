@@ -1,7 +1,7 @@
 /**\file			outfit.h
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Thursday, April 29, 2010
- * \date			Modified: Thursday, April 29, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -13,6 +13,28 @@
 #include "Graphics/image.h"
 #include "Utilities/components.h"
 
+struct OutfitStats {
+	OutfitStats();
+	void Clear();
+	OutfitStats& operator+= (const OutfitStats& other);
+
+	int msrp; ///< The cost in credits.
+
+	// Navigation Stats
+	float rotPerSecond; ///< The degrees of rotatation per second.
+	float maxSpeed; ///< The maximum momentum magnitude.
+	float forceOutput; ///< The force of the engine.
+
+	// Capacity Stats
+	float mass; ///< The mass that this consumes.
+	int cargoSpace; ///< The amount of cargo hold area that this consumes.
+	int surfaceArea; ///< The amount of mountable surface area that this consumes.
+
+	// Defensive Stats
+	int hullStrength; ///< The amount of damage the hull can absorb.
+	int shieldStrength; ///< The amount of damage the shields can absorb.
+};
+
 class Outfit : public Component {
 	public:
 		Outfit();
@@ -35,11 +57,14 @@ class Outfit : public Component {
 		Outfit operator+ (const Outfit& other);
 		Outfit& operator+= (const Outfit& other);
 
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 
-		int GetMSRP() { return msrp; }
-		void SetMSRP( int _msrp ) { msrp = _msrp; }
+		int GetMSRP() { return stats.msrp; }
+		void SetMSRP( int _msrp ) { stats.msrp = _msrp; }
 
 		Image* GetPicture() { return picture; }
 		void SetPicture( Image* _picture ) { picture = _picture; }
@@ -47,50 +72,37 @@ class Outfit : public Component {
 		string GetDescription() { return description; }
 		void SetDescription( string _description ) { description = _description; }
 
-		float GetRotationsPerSecond() { return rotPerSecond; }
-		void SetRotationsPerSecond( float _rotPerSecond ) { rotPerSecond = _rotPerSecond; }
+		float GetRotationsPerSecond() { return stats.rotPerSecond; }
+		void SetRotationsPerSecond( float _rotPerSecond ) { stats.rotPerSecond = _rotPerSecond; }
+
+		float GetMaxSpeed() { return stats.maxSpeed; }
+		void SetMaxSpeed( float _maxSpeed ) { stats.maxSpeed = _maxSpeed; }
 
-		float GetMaxSpeed() { return maxSpeed; }
-		void SetMaxSpeed( float _maxSpeed ) { maxSpeed = _maxSpeed; }
+		float GetForceOutput() { return stats.forceOutput; }
+		void SetForceOutput( float _forceOutput ) { stats.forceOutput = _forceOutput; }
 
-		float GetForceOutput() { return forceOutput; }
-		void SetForceOutput( float _forceOutput ) { forceOutput = _forceOutput; }
+		float GetMass() { return stats.mass; }
+		void SetMass( float _mass ) { stats.mass = _mass; }
 
-		float GetMass() { return mass; }
-		void SetMass( float _mass ) { mass = _mass; }
+		int GetCargoSpace() { return stats.cargoSpace; }
+		void SetCargoSpace( int _cargoSpace ) { stats.cargoSpace = _cargoSpace; }
 
-		int GetCargoSpace() { return cargoSpace; }
-		void SetCargoSpace( int _cargoSpace ) { cargoSpace = _cargoSpace; }
+		int GetSurfaceArea() { return stats.surfaceArea; }
+		void SetSurfaceArea( int _surfaceArea ) { stats.surfaceArea = _surfaceArea; }
 
-		int GetSurfaceArea() { return surfaceArea; }
-		void SetSurfaceArea( int _surfaceArea ) { surfaceArea = _surfaceArea; }
+		int GetHullStrength() { return stats.hullStrength; }
+		void SetHullStrength( int _hullStrength ) { stats.hullStrength = _hullStrength; }
 
-		int GetHullStrength() { return hullStrength; }
-		void SetHullStrength( int _hullStrength ) { hullStrength = _hullStrength; }
+		int GetShieldStrength() { return stats.shieldStrength; }
+		void SetShieldStrength( int _shieldStrength ) { stats.shieldStrength = _shieldStrength; }
 
-		int GetShieldStrength() { return shieldStrength; }
-		void SetShieldStrength( int _shieldStrength ) { shieldStrength = _shieldStrength; }
+		const OutfitStats& GetStats() { return stats; }
 
 	protected:
-		int msrp; ///< The cost in credits.
-		Image* picture; ///< The image used in the store.
+		OutfitStats stats; ///< The numbers that are added to a Ship's stats.
+		ResourceHandle<Image> picture; ///< The image used in the store.
 		string description; ///< The description of the item.
 
-		// Navigation Stats
-		float rotPerSecond; ///< The degrees of rotatation per second.
-		float maxSpeed; ///< The maximum momentum magnitude.
-		float forceOutput; ///< The force of the engine.
-
-		// Capacity Stats
-		float mass; ///< The mass that this consumes.
-		int cargoSpace; ///< The amount of cargo hold area that this consumes.
-		int surfaceArea; ///< The amount of mountable surface area that this consumes.
-
-		// Defensive Stats
-		int hullStrength; ///< The amount of damage the hull can absorb.
-		int shieldStrength; ///< The amount of damage the shields can absorb.
-
-		// Offensive Stats
 	private:
 };
 
@@ -0,0 +1,316 @@
+/**\file			replay.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Deterministic recording and replaying of games
+ * \details
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/replay.h"
+#include "Engine/simulation.h"
+#include "Graphics/video.h"
+#include "Utilities/file.h"
+#include "Utilities/log.h"
+#include "Utilities/random.h"
+#include "Utilities/savemanager.h"
+#include "Utilities/timer.h"
+
+static Option<int> randomUniverse( "options/simulation/random-universe" );
+static Option<int> randomSeed( "options/simulation/random-seed" );
+
+/**\class Replay
+ * \brief Records a game so that it can be played again exactly the same way.
+ * \details Everything that a running Simulation reads from outside of itself
+ *          is recorded: the input events of every frame, the clock of every
+ *          frame, how many logical updates each frame ran and the random
+ *          seed.  A snapshot of the Simulation is taken when the recording
+ *          starts.
+ *
+ *          When the recording is played back, the snapshot is restored, the
+ *          same seed is used and every frame gets the recorded input and
+ *          clock instead of the real ones, so the game plays out the same
+ *          way.  This makes a recording a repeatable workload for comparing
+ *          the speed of two builds.  A replay can run as fast as possible
+ *          and without drawing, and reports its frame times when it ends.
+ *
+ *          The file starts with REPLAY_MAGIC, REPLAY_VERSION, the Epiar
+ *          version, the Simulation, Player and random universe it was
+ *          recorded with, the screen size, the seed and the snapshot.  Each
+ *          frame follows as its input events, its clock and its logical
+ *          updates.
+ *
+ *          Replays start from the Player's saved game, and only the state in
+ *          a snapshot is restored, so missions and favor are not part of it.
+ *
+ * \see Simulation::Run, Simulation::Snapshot
+ */
+
+ReplayMode Replay::mode = REPLAY_OFF;
+bool Replay::fast = false;
+bool Replay::headless = false;
+bool Replay::finished = false;
+string Replay::filename;
+string Replay::simulationName;
+string Replay::playerName;
+int Replay::universeSeed = 0;
+int Replay::width = 0;
+int Replay::height = 0;
+Uint32 Replay::seed = 0;
+BinaryWriter Replay::recording;
+File Replay::file;
+const char* Replay::playback = NULL;
+long Replay::playbackLength = 0;
+BinaryReader* Replay::reader = NULL;
+Uint32 Replay::frames = 0;
+Uint32 Replay::logicTicks = 0;
+Uint32 Replay::lastFrameTick = 0;
+vector<Uint32> Replay::frameTimes;
+
+/**\brief Record the next game that is run into a file.
+ */
+bool Replay::StartRecording( const string& _filename ) {
+	filename = _filename;
+	mode = REPLAY_RECORDING;
+	finished = false;
+	LogMsg(INFO, "The next game will be recorded to '%s'.", filename.c_str() );
+	return true;
+}
+
+/**\brief Play back a recording instead of the menu.
+ * \param fast Don't wait between frames.
+ * \param headless Don't draw anything.
+ */
+bool Replay::StartPlayback( const string& _filename, bool _fast, bool _headless ) {
+	filename = _filename;
+	if( !file.OpenRead( filename ) || ((playback = file.Map()) == NULL) ) {
+		LogMsg(ERR, "Could not read the replay '%s'.", filename.c_str() );
+		return false;
+	}
+	playbackLength = file.GetLength();
+
+	reader = new BinaryReader( playback, playbackLength );
+	if( !ReadHeader( *reader ) ) {
+		StopPlayback();
+		return false;
+	}
+
+	fast = _fast;
+	headless = _headless;
+	finished = false;
+	mode = REPLAY_PLAYING;
+	LogMsg(INFO, "Playing back '%s' with '%s' in '%s'.", filename.c_str(), playerName.c_str(), simulationName.c_str() );
+	return true;
+}
+
+/**\brief Close the replay file that is being played back.
+ * \details This must run before the Filesystem is closed.
+ */
+void Replay::StopPlayback( void ) {
+	delete reader;
+	reader = NULL;
+	playback = NULL;
+	playbackLength = 0;
+	file.Close();
+	if( mode == REPLAY_PLAYING ) {
+		mode = REPLAY_OFF;
+	}
+}
+
+/**\brief Read everything before the snapshot.
+ */
+bool Replay::ReadHeader( BinaryReader& in ) {
+	Uint32 magic = in.ReadUint();
+	Uint32 format = in.ReadUint();
+	Uint32 version = in.ReadUint();
+	simulationName = in.ReadString();
+	playerName = in.ReadString();
+	universeSeed = in.ReadInt();
+	width = in.ReadInt();
+	height = in.ReadInt();
+	seed = in.ReadUint();
+	if( in.Failed() || (magic != REPLAY_MAGIC) || (format != REPLAY_VERSION) ) {
+		LogMsg(ERR, "'%s' is not a replay.", filename.c_str() );
+		return false;
+	}
+	if( version != SIMULATION_CACHE_EPIAR_VERSION ) {
+		LogMsg(WARN, "The replay '%s' was recorded by another version of Epiar.", filename.c_str() );
+	}
+	return true;
+}
+
+/**\brief Start recording or playing back the Simulation that is starting to run.
+ * \details This seeds every random stream, including the one used by
+ *          math.random.
+ * \return false if the replay can not be played in this Simulation.
+ */
+bool Replay::Begin( Simulation* simulation ) {
+	if( mode == REPLAY_RECORDING ) {
+		seed = static_cast<Uint32>( time(NULL) );
+		Random::SeedAll( seed );
+
+		BinaryWriter snapshot;
+		simulation->Snapshot( snapshot );
+
+		recording = BinaryWriter();
+		recording.WriteUint( REPLAY_MAGIC );
+		recording.WriteUint( REPLAY_VERSION );
+		recording.WriteUint( SIMULATION_CACHE_EPIAR_VERSION );
+		recording.WriteString( simulation->GetName() );
+		recording.WriteString( simulation->GetPlayer()->GetName() );
+		recording.WriteInt( randomUniverse ? randomSeed : 0 );
+		recording.WriteInt( Video::GetWidth() );
+		recording.WriteInt( Video::GetHeight() );
+		recording.WriteUint( seed );
+		recording.WriteUint( snapshot.GetSize() );
+		recording.WriteBytes( snapshot.GetData(), snapshot.GetSize() );
+		LogMsg(INFO, "Recording to '%s'.", filename.c_str() );
+	} else if( mode == REPLAY_PLAYING ) {
+		Uint32 size = reader->ReadUint();
+		size_t start = reader->Tell();
+		BinaryReader snapshot( playback + start, (start + size <= static_cast<size_t>(playbackLength)) ? size : 0 );
+		if( reader->Failed() || (simulation->Restore( snapshot ) != true) || (reader->Seek( start + size ) != true) ) {
+			LogMsg(ERR, "The replay '%s' does not match this simulation.", filename.c_str() );
+			finished = true;
+			return false;
+		}
+		if( (width != Video::GetWidth()) || (height != Video::GetHeight()) ) {
+			LogMsg(WARN, "The replay '%s' was recorded at %dx%d, the mouse will not line up.", filename.c_str(), width, height );
+		}
+		Random::SeedAll( seed );
+		frames = 0;
+		logicTicks = 0;
+		frameTimes.clear();
+		lastFrameTick = Timer::GetRealTicks();
+	}
+	return true;
+}
+
+/**\brief Record the input events of a frame, or replace them with the recorded ones.
+ */
+list<InputEvent> Replay::Events( const list<InputEvent>& events ) {
+	list<InputEvent>::const_iterator e;
+
+	if( mode == REPLAY_RECORDING ) {
+		recording.WriteUint( events.size() );
+		for( e = events.begin(); e != events.end(); ++e ) {
+			recording.WriteShort( e->type );
+			if( e->type == KEY ) {
+				recording.WriteInt( e->key );
+				recording.WriteShort( e->kstate );
+			} else {
+				recording.WriteShort( e->mstate );
+				recording.WriteInt( e->mx );
+				recording.WriteInt( e->my );
+			}
+		}
+	} else if( (mode == REPLAY_PLAYING) && !finished ) {
+		// Every frame is timed from one input to the next
+		Uint32 now = Timer::GetRealTicks();
+		if( frames > 0 ) {
+			frameTimes.push_back( now - lastFrameTick );
+		}
+		lastFrameTick = now;
+
+		list<InputEvent> recorded;
+		if( reader->Tell() >= reader->GetSize() ) {
+			finished = true;
+			return recorded;
+		}
+		Uint32 count = reader->ReadUint();
+		for( Uint32 i = 0; (i < count) && !reader->Failed(); i++ ) {
+			if( reader->ReadShort() == KEY ) {
+				int key = reader->ReadInt();
+				keyState kstate = static_cast<keyState>( reader->ReadShort() );
+				recorded.push_back( InputEvent( KEY, kstate, key ) );
+			} else {
+				mouseState mstate = static_cast<mouseState>( reader->ReadShort() );
+				int mx = reader->ReadInt();
+				int my = reader->ReadInt();
+				recorded.push_back( InputEvent( MOUSE, mstate, mx, my ) );
+			}
+		}
+		if( reader->Failed() ) {
+			LogMsg(ERR, "The replay '%s' is truncated.", filename.c_str() );
+			finished = true;
+		}
+		return recorded;
+	}
+	return events;
+}
+
+/**\brief Record the clock of a frame, or replace it with the recorded one.
+ */
+Uint32 Replay::Clock( Uint32 tick ) {
+	if( mode == REPLAY_RECORDING ) {
+		recording.WriteUint( tick );
+	} else if( (mode == REPLAY_PLAYING) && !finished ) {
+		tick = reader->ReadUint();
+	}
+	return tick;
+}
+
+/**\brief Record the logical updates of a frame, or replace them with the recorded ones.
+ * \param[in] loops The number of logical updates that the Timer asked for.
+ * \param[in,out] lowFps Whether the Sprites are updated in waves.
+ * \return The number of logical updates to run.
+ */
+int Replay::LogicLoops( int loops, bool& lowFps ) {
+	if( mode == REPLAY_RECORDING ) {
+		recording.WriteShort( loops );
+		recording.WriteBool( lowFps );
+	} else if( mode == REPLAY_PLAYING ) {
+		if( finished ) {
+			return 0;
+		}
+		int recorded = reader->ReadShort();
+		lowFps = reader->ReadBool();
+		if( reader->Failed() ) {
+			finished = true;
+			return 0;
+		}
+		if( recorded != loops ) {
+			LogMsg(VERBOSE1, "Frame %u ran %d logical updates instead of %d.", frames, recorded, loops );
+		}
+		loops = recorded;
+		frames++;
+		logicTicks += loops;
+	}
+	return loops;
+}
+
+/**\brief Finish the recording or playback of the Simulation that stopped running.
+ */
+void Replay::End( void ) {
+	if( mode == REPLAY_RECORDING ) {
+		if( SaveManager::WriteFile( filename, recording.GetData(), static_cast<long>( recording.GetSize() ) ) ) {
+			LogMsg(INFO, "Wrote the replay '%s' (%d bytes).", filename.c_str(), (int)recording.GetSize() );
+		}
+		recording = BinaryWriter();
+	} else if( mode == REPLAY_PLAYING ) {
+		Report();
+		StopPlayback();
+	}
+	mode = REPLAY_OFF;
+}
+
+/**\brief Print how long the frames of the replay took.
+ */
+void Replay::Report( void ) {
+	Uint32 total = 0;
+	for( unsigned int f = 0; f < frameTimes.size(); f++ ) {
+		total += frameTimes[f];
+	}
+	sort( frameTimes.begin(), frameTimes.end() );
+
+	cout << "Replay '" << filename << "': " << frames << " frames, " << logicTicks << " logical updates, " << total << " ms" << endl;
+	if( !frameTimes.empty() ) {
+		cout << "Frame time: mean " << (float)total / frameTimes.size()
+		     << " ms, median " << frameTimes[frameTimes.size() / 2]
+		     << " ms, 95th " << frameTimes[(frameTimes.size() * 95) / 100]
+		     << " ms, 99th " << frameTimes[(frameTimes.size() * 99) / 100]
+		     << " ms, max " << frameTimes.back() << " ms" << endl;
+	}
+	LogMsg(INFO, "Replayed %u frames and %u logical updates in %u ms.", frames, logicTicks, total );
+}
@@ -0,0 +1,79 @@
+/**\file			replay.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Deterministic recording and replaying of games
+ * \details
+ */
+
+#ifndef __H_REPLAY__
+#define __H_REPLAY__
+
+#include "includes.h"
+#include "Input/input.h"
+#include "Utilities/binary.h"
+#include "Utilities/file.h"
+
+#define REPLAY_MAGIC 0x50525045 // "EPRP"
+#define REPLAY_VERSION 1
+
+class Simulation;
+
+typedef enum {
+	REPLAY_OFF,
+	REPLAY_RECORDING,
+	REPLAY_PLAYING
+} ReplayMode;
+
+class Replay {
+	public:
+		static bool StartRecording( const string& filename );
+		static bool StartPlayback( const string& filename, bool fast, bool headless );
+		static void StopPlayback( void );
+
+		static bool IsRecording( void ) { return mode == REPLAY_RECORDING; }
+		static bool IsPlaying( void ) { return mode == REPLAY_PLAYING; }
+		static bool IsFast( void ) { return IsPlaying() && fast; }
+		static bool IsHeadless( void ) { return IsPlaying() && headless; }
+		static bool IsFinished( void ) { return finished; }
+
+		static string GetSimulationName( void ) { return simulationName; }
+		static string GetPlayerName( void ) { return playerName; }
+		static int GetUniverseSeed( void ) { return universeSeed; }
+
+		static bool Begin( Simulation* simulation );
+		static list<InputEvent> Events( const list<InputEvent>& events );
+		static Uint32 Clock( Uint32 tick );
+		static int LogicLoops( int loops, bool& lowFps );
+		static void End( void );
+
+	private:
+		static bool ReadHeader( BinaryReader& in );
+		static void Report( void );
+
+		static ReplayMode mode;
+		static bool fast;
+		static bool headless;
+		static bool finished;
+
+		static string filename;
+		static string simulationName;
+		static string playerName;
+		static int universeSeed;
+		static int width;
+		static int height;
+		static Uint32 seed;
+
+		static BinaryWriter recording;
+		static File file; ///< The open replay file.
+		static const char* playback; ///< The mapped replay file.
+		static long playbackLength;
+		static BinaryReader* reader;
+
+		static Uint32 frames;
+		static Uint32 logicTicks;
+		static Uint32 lastFrameTick;
+		static vector<Uint32> frameTimes;
+};
+
+#endif // __H_REPLAY__
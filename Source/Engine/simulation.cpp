@@ -1,13 +1,14 @@
 /**\file			simulation.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: July 2006
- * \date			Modified: Tuesday, June 23, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Contains the main game loop
  * \details
  */
 
 #include "includes.h"
 #include "common.h"
+#include "Audio/audio.h"
 #include "Audio/music.h"
 #include "Audio/audio_lua.h"
 #include "Engine/hud.h"
@@ -18,6 +19,7 @@
 #include "Engine/technologies.h"
 #include "Engine/starfield.h"
 #include "Engine/console.h"
+#include "Engine/replay.h"
 #include "Graphics/video.h"
 #include "Sprites/ai.h"
 #include "Sprites/ai_lua.h"
@@ -29,10 +31,26 @@
 #include "Sprites/spritemanager.h"
 #include "UI/ui.h"
 #include "UI/widgets.h"
+#include "Utilities/assetmanager.h"
+#include "Utilities/binary.h"
 #include "Utilities/file.h"
 #include "Utilities/log.h"
 #include "Utilities/timer.h"
 #include "Utilities/lua.h"
+#include "Utilities/random.h"
+#include "Utilities/savemanager.h"
+
+static Option<int> randomUniverse( "options/simulation/random-universe" );
+static Option<int> randomSeed( "options/simulation/random-seed" );
+static Option<int> binaryCache( "options/simulation/binary-cache" );
+static Option<int> starfieldDensity( "options/simulation/starfield-density" );
+static Option<int> trafficBudget( "options/simulation/traffic-budget" );
+static Option<int> trafficSpawns( "options/simulation/traffic-spawns" );
+static Option<float> trafficDistance( "options/simulation/traffic-distance" );
+static Option<int> soundBackground( "options/sound/background" );
+static Option<Uint32> uploadBudget( "options/loading/upload-budget" );
+static Option<int> logUI( "options/log/ui" );
+static Option<int> logSprites( "options/log/sprites" );
 
 /**\class Simulation
  * \brief Handles main game loop. */
@@ -61,6 +79,7 @@ Simulation::Simulation( void ) {
 
 	camera = Camera::Instance();
   calendar = new Calendar();
+	traffic = new Traffic();
 	console = new Console( L );
 
 	folderpath = "";
@@ -197,9 +216,9 @@ bool Simulation::SetupToRun(){
 		return false;
 	}
 
-	if( OPTION(int, "options/simulation/random-universe") ) {
-		if( OPTION(int, "options/simulation/random-seed") ) {
-			Lua::Call("createSystems", "i", OPTION(int, "options/simulation/random-seed") );
+	if( randomUniverse ) {
+		if( randomSeed ) {
+			Lua::Call("createSystems", "i", randomSeed.Get() );
 		} else {
 			Lua::Call("createSystems");
 		}
@@ -218,7 +237,7 @@ bool Simulation::SetupToRun(){
 			for( a = 0; a < 100; a++ ){
 				Effect* asteroid = new Effect( p->GetWorldPosition() + GaussianCoordinate() * p->GetInfluence(), "Resources/Animations/asteroid.ani", 1.0 );
 				asteroid->SetMomentum( GaussianCoordinate() *2 );
-				asteroid->SetAngle( float( rand() %360 ) );
+				asteroid->SetAngle( float( Random::Stream( RANDOM_SIMULATION ).Int( 360 ) ) );
 				sprites->Add( asteroid );
 			}
 #endif
@@ -233,9 +252,10 @@ bool Simulation::SetupToRun(){
 		
 	}
 
-	// Preloading this animation prevents an FPS
-	// drop the first time that a ship explodes.
-	Ani::Get("Resources/Animations/explosion1.ani");
+	// Preloading prevents an FPS drop the first
+	// time that a ship thrusts or explodes.
+	list<string> manifest = CreatePreloadManifest();
+	Preload( manifest );
 
 	// Randomize the Lua Seed
 	Lua::Call("randomizeseed");
@@ -245,6 +265,106 @@ bool Simulation::SetupToRun(){
 	return true;
 }
 
+/**\brief Add the name of a loaded Resource to a manifest.
+ */
+static void AddToManifest( list<string>& manifest, Resource* res ) {
+	if( res && !res->GetName().empty() ) {
+		manifest.push_back( res->GetName() );
+	}
+}
+
+/**\brief List the assets that this Simulation will need once it is running.
+ * \details The list is built from the loaded Models, Weapons, Engines and
+ *          Planets, so it follows whatever their XML files describe.  The
+ *          Animations and Sounds that are only loaded by path when a Sprite
+ *          first uses them are included so that they don't stall the first
+ *          frame that needs them.
+ * \return A list of resource paths.
+ */
+list<string> Simulation::CreatePreloadManifest( void ) {
+	list<string> manifest;
+	list<string>* names;
+	list<string>::iterator n;
+
+	// Ships
+	names = models->GetNames();
+	for( n = names->begin(); n != names->end(); ++n ) {
+		Model* model = models->GetModel( *n );
+		if( model ) {
+			AddToManifest( manifest, model->GetImage() );
+			AddToManifest( manifest, model->GetPicture() );
+		}
+	}
+
+	// Projectiles and their firing sounds
+	names = weapons->GetNames();
+	for( n = names->begin(); n != names->end(); ++n ) {
+		Weapon* weapon = weapons->GetWeapon( *n );
+		if( weapon ) {
+			AddToManifest( manifest, weapon->GetImage() );
+			AddToManifest( manifest, weapon->GetPicture() );
+			AddToManifest( manifest, weapon->GetSound() );
+		}
+	}
+
+	// Engine flares and thrust sounds
+	names = engines->GetNames();
+	for( n = names->begin(); n != names->end(); ++n ) {
+		Engine* engine = engines->GetEngine( *n );
+		if( engine ) {
+			if( !engine->GetFlareAnimation().empty() ) {
+				manifest.push_back( engine->GetFlareAnimation() );
+			}
+			AddToManifest( manifest, engine->GetPicture() );
+			AddToManifest( manifest, engine->GetSound() );
+		}
+	}
+
+	// Planets and the surfaces shown when landing
+	names = planets->GetNames();
+	for( n = names->begin(); n != names->end(); ++n ) {
+		Planet* planet = planets->GetPlanet( *n );
+		if( planet ) {
+			AddToManifest( manifest, planet->GetImage() );
+			AddToManifest( manifest, planet->GetSurfaceImage() );
+		}
+	}
+
+	// Explosions and shield hits are created by Ships and Projectiles
+	// themselves rather than by any component.
+	manifest.push_back( "Resources/Animations/explosion1.ani" );
+	manifest.push_back( "Resources/Animations/shield.ani" );
+	manifest.push_back( "Resources/Audio/Effects/18384__inferno__largex.wav.ogg" );
+
+	manifest.sort();
+	manifest.unique();
+	return manifest;
+}
+
+/**\brief Request every asset in a manifest without waiting for them.
+ * \details The assets are retained until this Simulation is deleted, so the
+ *          Resource cache cannot evict them before they are first used.
+ * \param manifest A list of resource paths.
+ * \sa AssetManager
+ */
+void Simulation::Preload( list<string>& manifest ) {
+	for( list<string>::iterator path = manifest.begin(); path != manifest.end(); ++path ) {
+		string::size_type dot = path->rfind('.');
+		string extension = (dot == string::npos) ? "" : path->substr( dot );
+
+		if( extension == ".ani" ) {
+			preloaded.push_back( Ani::Acquire( *path ).Get() );
+		} else if( extension == ".png" ) {
+			preloaded.push_back( Image::Acquire( *path ).Get() );
+		} else if( (extension == ".ogg") || (extension == ".wav") ) {
+			preloaded.push_back( Sound::Acquire( *path ).Get() );
+		} else {
+			LogMsg(WARN, "Cannot preload '%s'.", path->c_str() );
+		}
+	}
+	LogMsg(INFO, "Preloading %d assets.", AssetManager::GetPending() );
+}
+
 /**\brief Callback for Death dialog UI
  * \return void
  */
@@ -299,11 +419,18 @@ bool Simulation::Run() {
 	// Message appear in reverse order, so this is upside down
 	Hud::Alert("Epiar is currently under development. Please report all bugs to epiar.net");
 
+	// Start recording or playing back before anything random happens
+	if( !Replay::Begin( this ) ) {
+		quit = true;
+	}
+
+	traffic->SetBudget( trafficBudget, trafficSpawns, trafficDistance );
+
 	// Generate a starfield
-	Starfield starfield( OPTION(int, "options/simulation/starfield-density") );
+	Starfield starfield( starfieldDensity );
 
 	// Load sample game music
-	if(bgmusic && OPTION(int, "options/sound/background"))
+	if(bgmusic && soundBackground)
 		bgmusic->Play();
 
 	// main game loop
@@ -312,11 +439,18 @@ bool Simulation::Run() {
 	while( !quit ) {
 		HandleInput();
 
+		// Restore the snapshot that Lua asked for now that no Sprite is updating
+		if( !pendingSnapshot.empty() ) {
+			LoadSnapshot( pendingSnapshot );
+			pendingSnapshot = "";
+		}
+
 		//_ASSERTE(_CrtCheckMemory());
 
 		//logicLoops is the number of times we need to run logical updates to get 50 logical updates per second
 		//if the draw fps is >50 then logicLoops will always be 1 (ie 1 logical update per draw)
-		int logicLoops = Timer::Update();
+		int logicLoops = Timer::Update( Replay::Clock( Timer::GetRealTicks() ) );
+		logicLoops = Replay::LogicLoops( logicLoops, lowFps );
 		bool anyUpdate = (logicLoops>0);
 		if( !paused ) {
 			if(logicLoops > 10) {
@@ -329,6 +463,7 @@ bool Simulation::Run() {
 				Timer::IncrementFrameCount();
 				// Logical update cycle
 				sprites->Update( L, lowFps );
+				traffic->Update( L );
         
         calendar->Update();
 			}
@@ -341,26 +476,40 @@ bool Simulation::Run() {
 			Hud::Update( L );
 		}
 
-		// Erase cycle
-		Video::Erase();
+		// Start the sounds from this frame's updates
+		Audio::Instance().Update();
+
+		if( !Replay::IsHeadless() ) {
+			// Erase cycle
+			Video::Erase();
+
+			// Draw cycle
+			Video::PreDraw();
+			starfield.Draw();
+			sprites->Draw( camera->GetFocusCoordinate() );
+			Hud::Draw( HUD_ALL, currentFPS, camera, sprites );
+			UI::Draw();
+			console->Draw();
+			Video::PostDraw();
+			Video::Update();
+		}
 
-		// Draw cycle
-		Video::PreDraw();
-		starfield.Draw();
-		sprites->Draw( camera->GetFocusCoordinate() );
-		Hud::Draw( HUD_ALL, currentFPS, camera, sprites );
-		UI::Draw();
-		console->Draw();
-		Video::PostDraw();
-		Video::Update();
+		// Upload any assets that finished loading in the background
+		AssetManager::Update( uploadBudget );
 
 		// Don't kill the CPU (play nice)
-		if( paused ) {
+		if( Replay::IsFast() ) {
+			// Run the replay as quickly as possible
+		} else if( paused ) {
 			Timer::Delay(50);
 		} else {
 			Timer::Delay(10);
 		}
 
+		if( Replay::IsFinished() ) {
+			quit = true;
+		}
+
 		// Counting Frames
 		fpsCount++;
 		fpsTotal++;
@@ -404,12 +553,12 @@ bool Simulation::Run() {
 				 * End Low FPS calculation
 				 ************************/
 
-			if( OPTION(int, "options/log/ui") )
+			if( logUI )
 			{
 				UI::Save();
 			}
 
-			if( OPTION(int, "options/log/sprites") )
+			if( logSprites )
 			{
 				sprites->Save();
 			}
@@ -433,6 +582,7 @@ bool Simulation::Run() {
 	}
 	
 	Hud::Close();
+	Replay::End();
 
 	LogMsg(INFO,"Simulation Stopped: Average Framerate: %f Frames/Second", 1000.0 *((float)fpsTotal / Timer::GetTicks() ) );
 
@@ -462,7 +612,7 @@ bool Simulation::SetupToEdit() {
 	// Since the Random Universe Editor is currently broken, disable this feature here.
 	SETOPTION( "options/simulation/random-universe", 0 );
 
-	if( OPTION(int, "options/simulation/random-universe") ) {
+	if( randomUniverse ) {
 		Lua::Call("createSystems");
 	} else {
 		list<string>* planetNames = planets->GetNames();
@@ -485,7 +635,7 @@ bool Simulation::Edit() {
 	quit = false;
 
 	// Generate a starfield
-	Starfield starfield( OPTION(int, "options/simulation/starfield-density") );
+	Starfield starfield( starfieldDensity );
 
 	LogMsg(INFO, "Simulation Edit Starting");
 
@@ -494,11 +644,18 @@ bool Simulation::Edit() {
 	while( !quit ) {
 		HandleInput();
 
+		// Restore the snapshot that Lua asked for now that no Sprite is updating
+		if( !pendingSnapshot.empty() ) {
+			LoadSnapshot( pendingSnapshot );
+			pendingSnapshot = "";
+		}
+
 		Timer::Update();
 		starfield.Update( camera );
 		sprites->Update( L, true );
 		camera->Update( sprites );
 		Hud::Update( L );
+		Audio::Instance().Update();
 
 		// Erase cycle
 		Video::Erase();
@@ -511,6 +668,9 @@ bool Simulation::Edit() {
 		console->Draw();
 		Video::Update();
 
+		// Upload any assets that finished loading in the background
+		AssetManager::Update( uploadBudget );
+
 		// Don't kill the CPU (play nice)
 		Timer::Delay( 50 );
 	}
@@ -533,12 +693,55 @@ void Simulation::LuaRegisters(lua_State *L) {
 }
 
 /**\brief Parses an XML simulation file
+ * \details The Components are read from the binary simulation cache when it
+ *          matches the XML files.  Otherwise they are parsed from XML and the
+ *          cache is written again for the next start.
  * \return true if successful
  */
 bool Simulation::Parse( void ) {
 	LogMsg(INFO, "Simulation version %s.%s.%s.", Get("version-major").c_str(), Get("version-minor").c_str(),  Get("version-macro").c_str());
 
 	// Now load the various subsystems
+	Uint32 start = SDL_GetTicks();
+	if( binaryCache && LoadCache() ) {
+		LogMsg(INFO, "Loaded the simulation from its cache in %d ms.", SDL_GetTicks() - start );
+	} else {
+		if( LoadXML() != true ) {
+			return false;
+		}
+		LogMsg(INFO, "Loaded the simulation from XML in %d ms.", SDL_GetTicks() - start );
+		if( binaryCache ) {
+			SaveCache();
+		}
+	}
+
+	// Check the Music
+	bgmusic = Song::GetAsync( Get("music") );
+	if( bgmusic == NULL ) {
+		LogMsg(WARN, "There was an error loading music from '%s'.", Get("music").c_str() );
+	}
+
+	// Check the Player Defaults
+	if( planets->Get( Get("defaultPlayer/start")) == NULL) {
+		LogMsg(ERR, "Bad Default Player Start Location '%s'.", Get("defaultPlayer/start").c_str() );
+		return false;
+	}
+	if( models->Get( Get("defaultPlayer/model")) == NULL) {
+		LogMsg(ERR, "Bad Default Player Start Model '%s'.", Get("defaultPlayer/model").c_str() );
+		return false;
+	}
+	if( engines->Get( Get("defaultPlayer/engine")) == NULL) {
+		LogMsg(WARN, "Bad Default Player Start Engine '%s'.", Get("defaultPlayer/engine").c_str() );
+		return false;
+	}
+
+	return true;
+}
+
+/**\brief Load every Component collection from its XML file
+ * \return true if successful
+ */
+bool Simulation::LoadXML( void ) {
 	if( commodities->Load( (folderpath + Get("commodities")) ) != true ) {
 		LogMsg(ERR, "There was an error loading the commodities from '%s'.", (folderpath + Get("commodities")).c_str() );
 		return false;
@@ -567,7 +770,7 @@ bool Simulation::Parse( void ) {
 		LogMsg(ERR, "There was an error loading the alliances from '%s'.", (folderpath + Get("alliances")).c_str() );
 		return false;
 	}
-	if( 0 == OPTION(int, "options/simulation/random-universe")) {
+	if( 0 == randomUniverse) {
 		if( planets->Load( (folderpath + Get("planets")) ) != true ) {
 		    LogMsg(WARN, "There was an error loading the planets from '%s'.", (folderpath + Get("planets")).c_str() );
 		    return false;
@@ -578,26 +781,324 @@ bool Simulation::Parse( void ) {
 	    }
 	}
 
-	// Check the Music
-	bgmusic = Song::Get( Get("music") );
-	if( bgmusic == NULL ) {
-		LogMsg(WARN, "There was an error loading music from '%s'.", Get("music").c_str() );
+	return true;
+}
+
+/**\brief The Component collections in the order that they must be loaded
+ * \details Later collections refer to earlier ones by name.
+ */
+list< pair<string,Components*> > Simulation::GetCollections( void ) {
+	list< pair<string,Components*> > collections;
+	collections.push_back( make_pair( string("commodities"), (Components*)commodities ) );
+	collections.push_back( make_pair( string("engines"), (Components*)engines ) );
+	collections.push_back( make_pair( string("weapons"), (Components*)weapons ) );
+	collections.push_back( make_pair( string("models"), (Components*)models ) );
+	collections.push_back( make_pair( string("outfits"), (Components*)outfits ) );
+	collections.push_back( make_pair( string("technologies"), (Components*)technologies ) );
+	collections.push_back( make_pair( string("alliances"), (Components*)alliances ) );
+	if( 0 == randomUniverse) {
+		collections.push_back( make_pair( string("planets"), (Components*)planets ) );
+		collections.push_back( make_pair( string("gates"), (Components*)gates ) );
 	}
+	return collections;
+}
 
-	// Check the Player Defaults
-	if( planets->Get( Get("defaultPlayer/start")) == NULL) {
-		LogMsg(ERR, "Bad Default Player Start Location '%s'.", Get("defaultPlayer/start").c_str() );
+/**\brief Hash the name and contents of every Component XML file
+ * \details Editing, renaming or adding any of these files changes the hash,
+ *          which makes an existing simulation cache stale.
+ * \return false if a file could not be read
+ */
+bool Simulation::HashSources( Uint32& hash ) {
+	list< pair<string,Components*> > collections = GetCollections();
+	hash = BinaryReader::Hash( NULL, 0 );
+
+	for( list< pair<string,Components*> >::iterator c = collections.begin(); c != collections.end(); ++c ) {
+		string path = folderpath + Get( c->first );
+		if( !File::Exists( path ) ) {
+			return false;
+		}
+		File source( path );
+		long length = source.GetLength();
+		const char *buffer = source.Map();
+		if( buffer == NULL ) {
+			return false;
+		}
+		hash = BinaryReader::Hash( c->first.c_str(), c->first.size() + 1, hash );
+		hash = BinaryReader::Hash( path.c_str(), path.size() + 1, hash );
+		hash = BinaryReader::Hash( buffer, length, hash );
+	}
+	return true;
+}
+
+/**\brief Load every Component collection from the binary simulation cache
+ * \details The cache starts with a header:
+ *          - The SIMULATION_CACHE_MAGIC and SIMULATION_CACHE_VERSION.
+ *          - The Epiar version that wrote it.
+ *          - The hash of the XML files it was built from (see HashSources).
+ *          - The hash of everything after the section table.
+ *          - A table of sections, each a collection name, offset and size.
+ *
+ *          Each section holds one collection as written by
+ *          Components::SaveBinary.  The whole file is read into one buffer
+ *          and every section is read in place.
+ * \return false if the cache is missing, stale or damaged.  Nothing is left
+ *         loaded in that case.
+ */
+bool Simulation::LoadCache( void ) {
+	string path = folderpath + SIMULATION_CACHE;
+	list< pair<string,Components*> > collections = GetCollections();
+	Uint32 sourceHash;
+
+	if( !File::Exists( path ) ) {
+		LogMsg(INFO, "There is no simulation cache at '%s'.", path.c_str() );
 		return false;
 	}
-	if( models->Get( Get("defaultPlayer/model")) == NULL) {
-		LogMsg(ERR, "Bad Default Player Start Model '%s'.", Get("defaultPlayer/model").c_str() );
+	if( !HashSources( sourceHash ) ) {
 		return false;
 	}
-	if( engines->Get( Get("defaultPlayer/engine")) == NULL) {
-		LogMsg(WARN, "Bad Default Player Start Engine '%s'.", Get("defaultPlayer/engine").c_str() );
+
+	File cache( path );
+	long length = cache.GetLength();
+	const char *buffer = cache.Map();
+	if( buffer == NULL ) {
+		return false;
+	}
+
+	// Check the header
+	BinaryReader header( buffer, length );
+	Uint32 magic = header.ReadUint();
+	Uint32 format = header.ReadUint();
+	Uint32 version = header.ReadUint();
+	Uint32 cachedHash = header.ReadUint();
+	Uint32 payloadHash = header.ReadUint();
+	Uint32 numSections = header.ReadUint();
+	if( header.Failed() || (magic != SIMULATION_CACHE_MAGIC) || (format != SIMULATION_CACHE_VERSION) ) {
+		LogMsg(WARN, "The simulation cache '%s' is not valid.", path.c_str() );
+		return false;
+	}
+	if( (version != SIMULATION_CACHE_EPIAR_VERSION) || (cachedHash != sourceHash) || (numSections != collections.size()) ) {
+		LogMsg(INFO, "The simulation cache '%s' is stale.", path.c_str() );
+		return false;
+	}
+
+	vector<Uint32> offsets, sizes;
+	for( list< pair<string,Components*> >::iterator c = collections.begin(); c != collections.end(); ++c ) {
+		string section = header.ReadString();
+		offsets.push_back( header.ReadUint() );
+		sizes.push_back( header.ReadUint() );
+		if( header.Failed() || (section != c->first) || (offsets.back() > (Uint32)length) || (sizes.back() > length - offsets.back()) ) {
+			LogMsg(WARN, "The simulation cache '%s' has a bad section table.", path.c_str() );
+			return false;
+		}
+	}
+	if( BinaryReader::Hash( buffer + header.Tell(), length - header.Tell() ) != payloadHash ) {
+		LogMsg(WARN, "The simulation cache '%s' is damaged.", path.c_str() );
+		return false;
+	}
+
+	// Read each collection
+	bool success = true;
+	int i = 0;
+	for( list< pair<string,Components*> >::iterator c = collections.begin(); success && (c != collections.end()); ++c, ++i ) {
+		BinaryReader section( buffer + offsets[i], sizes[i] );
+		// Changing the file name marks the collection dirty, and loading it clears that.
+		c->second->SetFileName( folderpath + Get( c->first ) );
+		success = c->second->LoadBinary( section );
+	}
+
+	if( !success ) {
+		LogMsg(ERR, "Could not read the simulation cache '%s'.", path.c_str() );
+		for( list< pair<string,Components*> >::iterator c = collections.begin(); c != collections.end(); ++c ) {
+			c->second->Clear();
+		}
+		return false;
+	}
+	return true;
+}
+
+/**\brief Write every Component collection to the binary simulation cache
+ * \see LoadCache
+ * \return true if the cache was written
+ */
+bool Simulation::SaveCache( void ) {
+	string path = folderpath + SIMULATION_CACHE;
+	list< pair<string,Components*> > collections = GetCollections();
+	list< pair<string,Components*> >::iterator c;
+	vector<size_t> table;
+	Uint32 sourceHash;
+	BinaryWriter out;
+
+	if( !HashSources( sourceHash ) ) {
+		return false;
+	}
+
+	out.WriteUint( SIMULATION_CACHE_MAGIC );
+	out.WriteUint( SIMULATION_CACHE_VERSION );
+	out.WriteUint( SIMULATION_CACHE_EPIAR_VERSION );
+	out.WriteUint( sourceHash );
+	size_t payloadHash = out.GetSize();
+	out.WriteUint( 0 );
+	out.WriteUint( static_cast<Uint32>( collections.size() ) );
+	for( c = collections.begin(); c != collections.end(); ++c ) {
+		out.WriteString( c->first );
+		table.push_back( out.GetSize() );
+		out.WriteUint( 0 ); // Offset
+		out.WriteUint( 0 ); // Size
+	}
+
+	size_t payload = out.GetSize();
+	int i = 0;
+	for( c = collections.begin(); c != collections.end(); ++c, ++i ) {
+		size_t offset = out.GetSize();
+		if( c->second->SaveBinary( out ) != true ) {
+			LogMsg(INFO, "The simulation cache was not written." );
+			return false;
+		}
+		out.PatchUint( table[i], static_cast<Uint32>( offset ) );
+		out.PatchUint( table[i] + 4, static_cast<Uint32>( out.GetSize() - offset ) );
+	}
+	out.PatchUint( payloadHash, BinaryReader::Hash( out.GetData() + payload, out.GetSize() - payload ) );
+
+	File cache( path, true );
+	if( cache.Write( const_cast<char*>( out.GetData() ), static_cast<long>( out.GetSize() ) ) != true ) {
+		LogMsg(WARN, "Could not write the simulation cache '%s'.", path.c_str() );
+		return false;
+	}
+	LogMsg(INFO, "Wrote the simulation cache '%s' (%d bytes).", path.c_str(), (int)out.GetSize() );
+	return true;
+}
+
+/**\brief The Lua tables that are part of a snapshot.
+ * \details These hold the state of the AI and of the Fleets.
+ */
+static const char* snapshotGlobals[] = { "AIData", "Fleets", NULL };
+
+/**\brief Write the running state of the Simulation into a binary snapshot.
+ * \details A snapshot holds every Sprite, the Calendar, the Traffic and the Lua tables that
+ *          the AI keeps about the Sprites, which is enough to put a running game back exactly the
+ *          way it was.  The Components are not included, so a snapshot can
+ *          only be restored into the Simulation that it was taken from.
+ *
+ *          This should only be called between Updates.
+ * \see Restore, SpriteManager::Snapshot, Lua::SaveGlobal
+ */
+void Simulation::Snapshot( BinaryWriter& out ) {
+	out.WriteUint( SIMULATION_SNAPSHOT_MAGIC );
+	out.WriteUint( SIMULATION_SNAPSHOT_VERSION );
+	out.WriteUint( SIMULATION_CACHE_EPIAR_VERSION );
+	out.WriteString( GetName() );
+	SnapshotState( out );
+}
+
+/**\brief Put the Simulation back to the state in a snapshot.
+ * \details The state is copied before anything is changed.  If any part of
+ *          the snapshot cannot be restored, that copy is restored instead, so
+ *          a bad snapshot never leaves the Simulation half restored.
+ *
+ *          This deletes Sprites, so it must only be called between Updates.
+ *          Lua should use RequestSnapshot instead.
+ * \see Snapshot
+ * \return false if the snapshot does not belong to this Simulation.
+ */
+bool Simulation::Restore( BinaryReader& in ) {
+	Uint32 magic = in.ReadUint();
+	Uint32 format = in.ReadUint();
+	Uint32 version = in.ReadUint();
+	string name = in.ReadString();
+	if( in.Failed() || (magic != SIMULATION_SNAPSHOT_MAGIC) || (format != SIMULATION_SNAPSHOT_VERSION) ) {
+		LogMsg(ERR, "This is not a simulation snapshot." );
+		return false;
+	}
+	if( (version != SIMULATION_CACHE_EPIAR_VERSION) || (name != GetName()) ) {
+		LogMsg(ERR, "The snapshot of '%s' can not be restored into '%s'.", name.c_str(), GetName().c_str() );
+		return false;
+	}
+
+	BinaryWriter backup;
+	SnapshotState( backup );
+
+	if( RestoreState( in ) ) {
+		return true;
+	}
+
+	LogMsg(ERR, "The snapshot could not be restored.  Putting back the state from before it." );
+	BinaryReader undo( backup.GetData(), backup.GetSize() );
+	if( RestoreState( undo ) != true ) {
+		LogMsg(CRITICAL, "Could not put back the state from before the snapshot." );
+	}
+	return false;
+}
+
+/**\brief Restore a snapshot file between two ticks.
+ * \details Lua runs in the middle of an Update, while the SpriteManager still
+ *          holds pointers to the Sprites that a restore would delete.  The
+ *          snapshot is restored by Run before the next tick instead.
+ */
+void Simulation::RequestSnapshot( string filename ) {
+	pendingSnapshot = filename;
+}
+
+/**\brief Write everything in a snapshot after its header.
+ */
+void Simulation::SnapshotState( BinaryWriter& out ) {
+	sprites->Snapshot( out );
+	calendar->Snapshot( out );
+	traffic->Snapshot( out );
+
+	for( int g = 0; snapshotGlobals[g] != NULL; g++ ) {
+		out.WriteString( snapshotGlobals[g] );
+		Lua::SaveGlobal( L, snapshotGlobals[g], out );
+	}
+}
+
+/**\brief Read everything in a snapshot after its header.
+ * \return false if any part failed, which may leave the state half restored.
+ */
+bool Simulation::RestoreState( BinaryReader& in ) {
+	if( (sprites->Restore( in ) != true) || (calendar->Restore( in ) != true) || (traffic->Restore( in ) != true) ) {
+		return false;
+	}
+
+	for( int g = 0; snapshotGlobals[g] != NULL; g++ ) {
+		if( (in.ReadString() != snapshotGlobals[g]) || (Lua::LoadGlobal( L, snapshotGlobals[g], in ) != true) ) {
+			LogMsg(ERR, "The snapshot has no '%s' table.", snapshotGlobals[g] );
+			return false;
+		}
+	}
+	return true;
+}
+
+/**\brief Write a snapshot of the running Simulation to a file.
+ * \see Snapshot
+ */
+bool Simulation::SaveSnapshot( string filename ) {
+	BinaryWriter out;
+	Snapshot( out );
+	if( SaveManager::WriteFile( filename, out.GetData(), static_cast<long>( out.GetSize() ) ) != true ) {
 		return false;
 	}
+	LogMsg(INFO, "Wrote the snapshot '%s' (%d bytes).", filename.c_str(), (int)out.GetSize() );
+	return true;
+}
 
+/**\brief Restore the running Simulation from a snapshot file.
+ * \see Restore
+ */
+bool Simulation::LoadSnapshot( string filename ) {
+	File snapshot( filename );
+	long length = snapshot.GetLength();
+	const char *buffer = snapshot.Map();
+	if( buffer == NULL ) {
+		LogMsg(ERR, "Could not read the snapshot '%s'.", filename.c_str() );
+		return false;
+	}
+
+	BinaryReader in( buffer, length );
+	if( Restore( in ) != true ) {
+		LogMsg(ERR, "Could not restore the snapshot '%s'.", filename.c_str() );
+		return false;
+	}
+	LogMsg(INFO, "Restored the snapshot '%s'.", filename.c_str() );
 	return true;
 }
 
@@ -607,8 +1108,8 @@ void LeaveOption() {exit(0);}
 void Simulation::HandleInput() {
 	list<InputEvent> events;
 
-	// Collect user input events
-	events = inputs.Update();
+	// Collect user input events, or the ones that were recorded
+	events = Replay::Events( inputs.Update() );
 
 	// Pass the Events to the systems that handle them.
 	UI::HandleInput( events );
@@ -674,7 +1175,7 @@ void Simulation::HandleInput() {
 	{
 		list<string>* names = planets->GetNames();
 		int i = 0;
-		int x = rand() % names->size();
+		int x = Random::Stream( RANDOM_SIMULATION ).Int( names->size() );
 		list<string>::iterator pName = names->begin();
 		while( i++ < x ){ pName++; }
 		Planet* p = planets->GetPlanet(*pName);
@@ -1,7 +1,7 @@
 /**\filename		simulation.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: July 2006
- * \date			Modified: Tuesday, June 23, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Contains the main game loop
  * \details
  */
@@ -14,6 +14,7 @@
 #include "Engine/engines.h"
 #include "Engine/models.h"
 #include "Engine/calendar.h"
+#include "Engine/traffic.h"
 #include "Sprites/planets.h"
 #include "Sprites/gate.h"
 #include "Engine/weapons.h"
@@ -24,6 +25,14 @@
 #include "Input/input.h"
 #include "Engine/console.h"
 
+#define SIMULATION_CACHE "simulation.cache"
+#define SIMULATION_CACHE_MAGIC 0x43535045 // "EPSC"
+#define SIMULATION_CACHE_VERSION 1
+#define SIMULATION_CACHE_EPIAR_VERSION ((EPIAR_VERSION_MAJOR << 16) | (EPIAR_VERSION_MINOR << 8) | EPIAR_VERSION_MICRO)
+
+#define SIMULATION_SNAPSHOT_MAGIC 0x53535045 // "EPSS"
+#define SIMULATION_SNAPSHOT_VERSION 3
+
 class Simulation : public XMLFile {
 	public:
 		Simulation();
@@ -45,6 +54,11 @@ class Simulation : public XMLFile {
 		void HandleInput();
 
 		void Save();
+		void Snapshot( BinaryWriter& out );
+		bool Restore( BinaryReader& in );
+		bool SaveSnapshot( string filename );
+		bool LoadSnapshot( string filename );
+		void RequestSnapshot( string filename );
 		void pause();
 		void unpause();
 		bool isPaused() {return paused;}
@@ -62,6 +76,7 @@ class Simulation : public XMLFile {
 		Outfits *GetOutfits() { return outfits; }
 		Players *GetPlayers() { return players; }
 		Camera *GetCamera() { return camera; }
+		Traffic *GetTraffic() { return traffic; }
 		Input *GetInput() { return &inputs; }
 		Player *GetPlayer();
 
@@ -78,7 +93,16 @@ class Simulation : public XMLFile {
 
 	private:
 		bool Parse( void );
+		bool LoadXML( void );
+		list< pair<string,Components*> > GetCollections( void );
+		bool HashSources( Uint32& hash );
+		bool LoadCache( void );
+		bool SaveCache( void );
 		void CreateNavMap( void );
+		void SnapshotState( BinaryWriter& out );
+		bool RestoreState( BinaryReader& in );
+		list<string> CreatePreloadManifest( void );
+		void Preload( list<string>& manifest );
 
 		// Pointers to Singletons
 		///< TODO: These should all be rewritten to not be singletons
@@ -98,15 +122,19 @@ class Simulation : public XMLFile {
 		Player *player;
 		Camera *camera;
     Calendar *calendar;
+		Traffic *traffic;
 
 		// Simulation specific variables
 		Song* bgmusic;
 		Input inputs;
 		Console *console;
+		vector< ResourceHandle<Resource> > preloaded; ///< Keeps preloaded assets from being evicted.
 
 		// Description of this Simulation
 		string folderpath;
 
+		string pendingSnapshot; ///< A snapshot file to restore before the next tick
+
 		// State Variables
 		float currentFPS;
 		bool paused;
@@ -1,7 +1,7 @@
 /**\file			simulation_lua.cpp
  * \author			Matt Zweig
  * \date			Created: Friday, September 3, 2010
- * \date			Modified: Friday, September 3, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Simulation Managment from Lua
  * \details
  */
@@ -34,6 +34,7 @@
 #include "Input/input.h"
 #include "Utilities/file.h"
 #include "Utilities/filesystem.h"
+#include "Utilities/resource.h"
 
 #include "Engine/hud.h"
 
@@ -73,6 +74,8 @@ void Simulation_Lua::RegisterSimulation(lua_State *L) {
 		// Player Functions
 		{"loadPlayer", &Simulation_Lua::LoadPlayer},
 		{"savePlayer", &Simulation_Lua::SavePlayer},
+		{"saveSnapshot", &Simulation_Lua::SaveSnapshot},
+		{"loadSnapshot", &Simulation_Lua::LoadSnapshot},
 		{"newPlayer", &Simulation_Lua::NewPlayer},
 		{"players", &Simulation_Lua::GetPlayerNames},
 		{"player", &Simulation_Lua::GetPlayer},
@@ -126,6 +129,9 @@ void Simulation_Lua::RegisterSimulation(lua_State *L) {
 		{"listImages", &Simulation_Lua::ListImages},
 		{"listAnimations", &Simulation_Lua::ListAnimations},
 		{"listSounds", &Simulation_Lua::ListSounds},
+
+		// Memory Functions
+		{"resources", &Simulation_Lua::ListResources},
 		{NULL, NULL}
 	};
 	luaL_register(L,"Epiar",EngineFunctions);
@@ -224,6 +230,40 @@ int Simulation_Lua::SavePlayer(lua_State *L){
 	return 0;
 }
 
+/** \brief Write a snapshot of every Sprite and the AI tables to a file.
+ *  \param [in] filename The file to write.
+ *  \returns true if the snapshot was written.
+ */
+int Simulation_Lua::SaveSnapshot(lua_State *L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 1)
+		return luaL_error(L, "Got %d arguments expected 1 (filename)", n);
+	string filename = (string)luaL_checkstring(L, 1);
+	lua_pushboolean(L, GetSimulation(L)->SaveSnapshot( filename ) );
+	return 1;
+}
+
+/** \brief Restore every Sprite and the AI tables from a snapshot file.
+ *  \details The snapshot is restored before the next tick, not right away,
+ *  since Lua may be running in the middle of an Update.
+ *  \param [in] filename The file written by saveSnapshot.
+ *  \returns true if the file exists and will be restored.
+ */
+int Simulation_Lua::LoadSnapshot(lua_State *L){
+	int n = lua_gettop(L);  // Number of arguments
+	if (n != 1)
+		return luaL_error(L, "Got %d arguments expected 1 (filename)", n);
+	string filename = (string)luaL_checkstring(L, 1);
+	if( !File::Exists( filename ) ) {
+		LogMsg(ERR, "There is no snapshot '%s'.", filename.c_str() );
+		lua_pushboolean(L, false );
+		return 1;
+	}
+	GetSimulation(L)->RequestSnapshot( filename );
+	lua_pushboolean(L, true );
+	return 1;
+}
+
 /** \brief Get an OPTION value
  *  \param [in] key Path to a specific OPTION.
  *  \returns string representation of the OPTION's value.
@@ -233,7 +273,7 @@ int Simulation_Lua::Getoption(lua_State *L) {
 	if (n != 1)
 		return luaL_error(L, "Got %d arguments expected 1 (option)", n);
 	string path = (string)lua_tostring(L, 1);
-	string value = OPTION(string,path);
+	string value = Options::Get(path);
 	lua_pushstring(L, value.c_str());
 	return 1;
 }
@@ -1317,6 +1357,7 @@ int Simulation_Lua::SetInfo(lua_State *L) {
 		if(oldPlanet!=NULL) {
 			LogMsg(INFO,"Saving changes to '%s'",thisPlanet.GetName().c_str());
 			*oldPlanet = thisPlanet;
+			GetSimulation(L)->GetPlanets()->SetDirty();
 		} else {
 			LogMsg(INFO,"Creating new Planet '%s'",thisPlanet.GetName().c_str());
 			Planet* newPlanet = new Planet(thisPlanet);
@@ -1339,6 +1380,7 @@ int Simulation_Lua::SetInfo(lua_State *L) {
 			if( exit != NULL ) {
 				Gate::SetPair( gate,exit );
 			}
+			gates->SetDirty();
 		}
 
 	} else if(kind == "Technology"){
@@ -1506,6 +1548,31 @@ int Simulation_Lua::ListSounds(lua_State *L) {
 	return 1;
 }
 
+/** \brief Describe the loaded Resources, largest first.
+ *  \details Each Resource is returned as a separate string so that the
+ *  console prints one per line.
+ *  \param[in] count The number of Resources to list (default 20).
+ *  \returns The total memory used, followed by one line per Resource.
+ */
+int Simulation_Lua::ListResources(lua_State *L) {
+	int n = lua_gettop(L);  // Number of arguments
+	int count = (n >= 1) ? luaL_checkint(L, 1) : 20;
+	char header[128];
+
+	list<string> lines = Resource::Describe();
+	snprintf( header, sizeof(header), "%ld KB used by %d Resources",
+		Resource::GetMemoryUsage() / 1024, (int)lines.size() );
+	lua_pushstring(L, header);
+
+	int pushed = 1;
+	for( list<string>::iterator line = lines.begin(); (line != lines.end()) && (pushed <= count); ++line ) {
+		luaL_checkstack(L, 1, "Too many Resources");
+		lua_pushstring(L, line->c_str());
+		pushed++;
+	}
+	return pushed;
+}
+
 int Simulation_Lua::SetDescription(lua_State *L) {
 	string description= (string)lua_tostring(L, 1);
 	Simulation* sim = GetSimulation(L);
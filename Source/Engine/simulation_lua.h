@@ -1,7 +1,7 @@
 /**\file			simulation_lua.h
  * \author			Matt Zweig
  * \date			Created: Friday, September 3, 2010
- * \date			Modified: Friday, September 3, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Simulation Managment from Lua
  * \details
  */
@@ -44,6 +44,8 @@ class Simulation_Lua{
 		static int SetLastPlanet(lua_State *L);
 		static int LoadPlayer(lua_State *L);
 		static int SavePlayer(lua_State *L);
+		static int SaveSnapshot(lua_State *L);
+		static int LoadSnapshot(lua_State *L);
 		static int NewPlayer(lua_State *L);
 
 		static int NewGatePair(lua_State *L);
@@ -93,6 +95,9 @@ class Simulation_Lua{
 		static int ListSounds(lua_State *L);
 		static int SetDescription(lua_State *L);
 
+		// Memory Interfaces
+		static int ListResources(lua_State *L);
+
 		static void PushSprite(lua_State *L,Sprite* sprite);
 		static void PushComponents(lua_State *L, list<Component*> *components);
 	private:
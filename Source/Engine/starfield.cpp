@@ -1,7 +1,7 @@
 /**\file			starfield.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified : Saturday, January 5, 2008
+ * \date			Modified : Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -10,6 +10,7 @@
 #include "Engine/starfield.h"
 #include "Graphics/video.h"
 #include "Engine/camera.h"
+#include "Utilities/random.h"
 
 /**\class Starfield
  * \brief Controls the starfield. */
@@ -20,12 +21,16 @@
 
 /**\brief Initializes the starfield.
  * \param num Number of stars to initialize
+ * \param seed Seed for the star positions, or 0 for a different starfield each time
  */
-Starfield::Starfield( int num ) {
+Starfield::Starfield( int num, unsigned int seed ) {
 	int i;
 	
-	// seed the random number generator
-	srand(static_cast<unsigned int>( time(NULL) ));
+	// A fixed seed always draws the same stars without touching the other streams
+	if( seed == 0 ) {
+		seed = Random::Stream( RANDOM_STARFIELD ).Next();
+	}
+	Random random( seed );
 
 	// allocate space for stars
 	stars = (struct _stars *)malloc( sizeof(struct _stars) * num );
@@ -34,9 +39,9 @@ Starfield::Starfield( int num ) {
 	for( i = 0; i < num; i++ ) {
 		int c;
 
-		stars[i].x = (float)(rand() % (int)(1.3 * Video::GetWidth()));
-		stars[i].y = (float)(rand() % (int)(1.4 * Video::GetHeight()));
-		c = rand() % 225; // generate greys between 0 and 225
+		stars[i].x = (float)(random.Int( (int)(1.3 * Video::GetWidth()) ));
+		stars[i].y = (float)(random.Int( (int)(1.4 * Video::GetHeight()) ));
+		c = random.Int( 225 ); // generate greys between 0 and 225
 		stars[i].clr = static_cast<float>( c / 256. );
 	}
 
@@ -13,7 +13,7 @@
 
 class Starfield {
 	public:
-		Starfield( int num );
+		Starfield( int num, unsigned int seed = 0 );
 		~Starfield( void );
 
 		void Draw( void );
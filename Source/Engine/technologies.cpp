@@ -1,7 +1,7 @@
 /**\file			technologies.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Saturday, February 13, 2010
- * \date			Modified: Saturday, February 13, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -53,48 +53,67 @@ Technology::Technology( string _name,
 	SetName(_name);
 }
 
-/**\brief Parses the XML file for Technology fields
+enum {
+	TECHNOLOGY_MODEL,
+	TECHNOLOGY_ENGINE,
+	TECHNOLOGY_WEAPON,
+	TECHNOLOGY_OUTFIT
+};
+
+static const ComponentField technologyFields[] = {
+	{ "model", TECHNOLOGY_MODEL, 0 },
+	{ "engine", TECHNOLOGY_ENGINE, 0 },
+	{ "weapon", TECHNOLOGY_WEAPON, 0 },
+	{ "outfit", TECHNOLOGY_OUTFIT, 0 },
+	{ NULL, 0, 0 }
+};
+
+/**\brief The XML fields of a Technology.
  */
-bool Technology::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  tech;
-	string value;
+const ComponentField* Technology::GetFields( void ) {
+	return technologyFields;
+}
 
-	for( tech=node->xmlChildrenNode; tech!=NULL; tech = tech->next )
-	{
-		if( NodeNameIs( tech, "model" )) {
-			value = NodeToString(doc,tech);
+/**\brief Parse one XML field of a Technology.
+ * \details Each field may be repeated.
+ */
+bool Technology::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case TECHNOLOGY_MODEL: {
 			Model* model = Models::Instance()->GetModel( value );
 			if(model==NULL) {
 				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
 			} else {
 				models.push_back( model );
 			}
-		} else if( NodeNameIs( tech, "engine" )) {
-			value = NodeToString(doc,tech);
+			break;
+		}
+		case TECHNOLOGY_ENGINE: {
 			Engine* engine = Engines::Instance()->GetEngine( value );
 			if(engine==NULL) {
 				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
 			} else {
 				engines.push_back( engine );
 			}
-		} else if( NodeNameIs( tech, "weapon" )) {
-			value = NodeToString(doc,tech);
+			break;
+		}
+		case TECHNOLOGY_WEAPON: {
 			Weapon* weapon = Weapons::Instance()->GetWeapon( value );
 			if(weapon==NULL) {
 				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
 			} else {
 				weapons.push_back( weapon );
 			}
-		} else if( NodeNameIs( tech, "outfit" )) {
-			value = NodeToString(doc,tech);
+			break;
+		}
+		case TECHNOLOGY_OUTFIT: {
 			Outfit* outfit = Outfits::Instance()->GetOutfit( value );
 			if(outfit==NULL) {
 				LogMsg(ERR, "Could Not find the technology '%s'.", value.c_str() );
 			} else {
 				outfits.push_back( outfit );
 			}
-		} else {
-
+			break;
 		}
 	}
 	return true;
@@ -130,6 +149,66 @@ xmlNodePtr Technology::ToXMLNode(string componentName) {
 	return section;
 }
 
+/**\brief Write this Technology to a binary cache.
+ * \details Each list is written as a count followed by the names.
+ */
+bool Technology::Serialize( BinaryWriter& out ) {
+	out.WriteUint( static_cast<Uint32>( models.size() ) );
+	for( list<Model*>::iterator i = models.begin(); i != models.end(); ++i ) {
+		out.WriteString( (*i)->GetName() );
+	}
+	out.WriteUint( static_cast<Uint32>( engines.size() ) );
+	for( list<Engine*>::iterator i = engines.begin(); i != engines.end(); ++i ) {
+		out.WriteString( (*i)->GetName() );
+	}
+	out.WriteUint( static_cast<Uint32>( weapons.size() ) );
+	for( list<Weapon*>::iterator i = weapons.begin(); i != weapons.end(); ++i ) {
+		out.WriteString( (*i)->GetName() );
+	}
+	out.WriteUint( static_cast<Uint32>( outfits.size() ) );
+	for( list<Outfit*>::iterator i = outfits.begin(); i != outfits.end(); ++i ) {
+		out.WriteString( (*i)->GetName() );
+	}
+	return true;
+}
+
+/**\brief Read this Technology from a binary cache.
+ */
+bool Technology::Deserialize( BinaryReader& in ) {
+	Uint32 count, i;
+	string value;
+
+	count = in.ReadUint();
+	for( i = 0; (i < count) && !in.Failed(); ++i ) {
+		value = in.ReadString();
+		Model* model = Models::Instance()->GetModel( value );
+		if( model == NULL ) return false;
+		models.push_back( model );
+	}
+	count = in.ReadUint();
+	for( i = 0; (i < count) && !in.Failed(); ++i ) {
+		value = in.ReadString();
+		Engine* engine = Engines::Instance()->GetEngine( value );
+		if( engine == NULL ) return false;
+		engines.push_back( engine );
+	}
+	count = in.ReadUint();
+	for( i = 0; (i < count) && !in.Failed(); ++i ) {
+		value = in.ReadString();
+		Weapon* weapon = Weapons::Instance()->GetWeapon( value );
+		if( weapon == NULL ) return false;
+		weapons.push_back( weapon );
+	}
+	count = in.ReadUint();
+	for( i = 0; (i < count) && !in.Failed(); ++i ) {
+		value = in.ReadString();
+		Outfit* outfit = Outfits::Instance()->GetOutfit( value );
+		if( outfit == NULL ) return false;
+		outfits.push_back( outfit );
+	}
+	return !in.Failed();
+}
+
 /**\fn Technology::GetModels()
  *  \brief Returns the list of Model objects
  * \fn Technology::GetEngines()
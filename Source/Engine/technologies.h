@@ -1,7 +1,7 @@
 /**\file			technologies.h
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Saturday, February 13, 2010
- * \date			Modified: Saturday, February 13, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -20,8 +20,11 @@ class Technology : public Component {
 		Technology();
   		Technology& operator= (const Technology&);
 		Technology( string _name, list<Model*> _models, list<Engine*>_engines, list<Weapon*>_weapons, list<Outfit*>_outfits);
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 
 		list<Model*> GetModels() { return models; }
 		list<Engine*> GetEngines() { return engines; }
@@ -39,7 +42,7 @@ class Technology : public Component {
 class Technologies : public Components {
 	public:
 		static Technologies *Instance();
-		Technology *GetTechnology( string& TechnologyName ) { return (Technology*) this->Get(TechnologyName); }
+		Technology *GetTechnology( const string& TechnologyName ) { return (Technology*) this->Get(TechnologyName); }
 		Component* newComponent(){ return new Technology; }
 
 	protected:
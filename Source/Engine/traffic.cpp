@@ -0,0 +1,274 @@
+/**\file			traffic.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Schedules the ships that Planets create
+ * \details
+ */
+
+#include "includes.h"
+#include "Engine/simulation_lua.h"
+#include "Engine/traffic.h"
+#include "Sprites/ai.h"
+#include "Sprites/planets.h"
+#include "Sprites/spritemanager.h"
+#include "Utilities/log.h"
+#include "Utilities/lua.h"
+#include "Utilities/quadtree.h"
+#include "Utilities/random.h"
+#include "Utilities/timer.h"
+
+/**\class Traffic
+ * \brief Decides when the Planets create new ships.
+ * \details Every Planet wants a number of ships near it, its traffic.  Each
+ *          Planet is checked once every TRAFFIC_PERIOD logical frames, but in
+ *          its own slot of that period, so only a few Planets count their
+ *          neighbours on any one frame.  Planets that want a ship wait in a
+ *          queue and only a few ships are created per frame.
+ *
+ *          The ships created this way are the traffic.  There is a budget for
+ *          how many there can be at once.  Once it is used up, a Planet near
+ *          the camera gets one of the traffic ships that is far away instead
+ *          of a new one.  The ship keeps its hull but Lua gives it a new pilot
+ *          and plan for its new Planet, so only a Pirate's escort is
+ *          allocated.  Planets far from the camera wait until their next
+ *          check.
+ *
+ *          Ships that the traffic created but that have since died or been
+ *          removed are forgotten at the start of every Update.  Ships that
+ *          are over the budget are quietly removed.  They were not killed,
+ *          so nobody loses favor and no Mission hears about it.
+ * \see Planet::NeedsTraffic, AI::Recycle
+ */
+
+/**\brief An empty schedule with the default budget.
+ */
+Traffic::Traffic():
+	planetChanges( 0 ),
+	maxPopulation( 100 ),
+	maxSpawns( 1 ),
+	despawnDistance( 4 * QUADRANTSIZE )
+{
+	ResetStats();
+}
+
+/**\brief Set how much traffic there can be.
+ * \param population The most traffic ships at once.
+ * \param spawns The most ships created in one frame.
+ * \param distance Ships this far from the camera may be moved to other Planets.
+ */
+void Traffic::SetBudget( int population, int spawns, float distance ) {
+	maxPopulation = ( population < 0 ) ? 0 : population;
+	maxSpawns = ( spawns < 1 ) ? 1 : spawns;
+	despawnDistance = ( distance < 0.0f ) ? 0.0f : distance;
+}
+
+/**\brief Check the Planets in this frame's slot and create the ships they want.
+ * \details This should be called once per logical frame, after the Sprites
+ *          have been updated.
+ */
+void Traffic::Update( lua_State *L ) {
+	Simulation *simulation = Simulation_Lua::GetSimulation(L);
+	SpriteManager *sprites = simulation->GetSpriteManager();
+	Coordinate focus = simulation->GetCamera()->GetFocusCoordinate();
+
+	FindPlanets( sprites );
+	Prune( sprites );
+
+	// Check the Planets in this frame's slot
+	int checks = 0;
+	Uint32 slot = Timer::GetLogicalFrameCount() % TRAFFIC_PERIOD;
+	for( Uint32 p = slot; p < planets.size(); p += TRAFFIC_PERIOD ) {
+		checks++;
+		if( planets[p]->NeedsTraffic( sprites ) ) {
+			int id = planets[p]->GetID();
+			if( find( waiting.begin(), waiting.end(), id ) == waiting.end() ) {
+				waiting.push_back( id );
+			}
+		}
+	}
+	stats.checks += checks;
+	if( checks > stats.peakChecks ) {
+		stats.peakChecks = checks;
+	}
+
+	// Only a few ships are created in a frame, the rest wait their turn
+	int spawns = 0;
+	while( (spawns < maxSpawns) && !waiting.empty() ) {
+		Sprite *planet = sprites->GetSpriteByID( waiting.front() );
+		waiting.pop_front();
+		if( (planet == NULL) || (planet->GetDrawOrder() != DRAW_ORDER_PLANET) ) {
+			continue;
+		}
+		if( Spawn( L, sprites, (Planet*)planet, focus ) ) {
+			spawns++;
+		}
+	}
+
+	// Lua may create escorts too, and the budget may have been lowered
+	if( GetPopulation() > maxPopulation ) {
+		AI *ship = FindFarShip( sprites, focus );
+		if( ship != NULL ) {
+			Despawn( sprites, ship );
+			stats.trimmed++;
+		}
+	}
+}
+
+/**\brief Write the Planets that are waiting and the ships of the traffic.
+ */
+void Traffic::Snapshot( BinaryWriter& out ) {
+	out.WriteUint( waiting.size() );
+	for( list<int>::iterator w = waiting.begin(); w != waiting.end(); ++w ) {
+		out.WriteInt( *w );
+	}
+	out.WriteUint( spawned.size() );
+	for( unsigned int s = 0; s < spawned.size(); s++ ) {
+		out.WriteInt( spawned[s] );
+	}
+}
+
+/**\brief Read the state written by Snapshot.
+ */
+bool Traffic::Restore( BinaryReader& in ) {
+	list<int> restoredWaiting;
+	vector<int> restoredSpawned;
+
+	Uint32 count = in.ReadUint();
+	for( Uint32 w = 0; (w < count) && !in.Failed(); w++ ) {
+		restoredWaiting.push_back( in.ReadInt() );
+	}
+	count = in.ReadUint();
+	for( Uint32 s = 0; (s < count) && !in.Failed(); s++ ) {
+		restoredSpawned.push_back( in.ReadInt() );
+	}
+	if( in.Failed() ) {
+		LogMsg(ERR, "The traffic snapshot is truncated." );
+		return false;
+	}
+
+	waiting.swap( restoredWaiting );
+	spawned.swap( restoredSpawned );
+	return true;
+}
+
+/**\brief Forget the statistics.
+ */
+void Traffic::ResetStats( void ) {
+	memset( &stats, 0, sizeof(stats) );
+}
+
+/**\brief Find every Planet again when Planets have been added or removed.
+ */
+void Traffic::FindPlanets( SpriteManager *sprites ) {
+	if( !planets.empty() && (planetChanges == sprites->GetPersistentChanges()) ) {
+		return;
+	}
+
+	list<Sprite*> *found = sprites->GetSprites( DRAW_ORDER_PLANET );
+	planets.clear();
+	for( list<Sprite*>::iterator p = found->begin(); p != found->end(); ++p ) {
+		planets.push_back( (Planet*)(*p) );
+	}
+	delete found;
+	planetChanges = sprites->GetPersistentChanges();
+}
+
+/**\brief Forget the traffic ships that no longer exist.
+ */
+void Traffic::Prune( SpriteManager *sprites ) {
+	unsigned int kept = 0;
+	for( unsigned int s = 0; s < spawned.size(); s++ ) {
+		if( sprites->GetSpriteByID( spawned[s] ) != NULL ) {
+			spawned[kept++] = spawned[s];
+		}
+	}
+	spawned.resize( kept );
+}
+
+/**\brief Give a Planet a ship.
+ * \returns false if the ship is not within the budget.
+ */
+bool Traffic::Spawn( lua_State *L, SpriteManager *sprites, Planet *planet, Coordinate focus ) {
+	if( GetPopulation() >= maxPopulation ) {
+		// Nobody would see the ship, so the Planet can wait
+		if( (planet->GetWorldPosition() - focus).GetMagnitudeSquared() < despawnDistance * despawnDistance ) {
+			AI *ship = FindFarShip( sprites, focus );
+			if( ship != NULL ) {
+				Random& random = Random::Stream( RANDOM_SHIPS );
+				int influence = planet->GetInfluence() / 2;
+				Coordinate position = planet->GetWorldPosition()
+					+ Coordinate( static_cast<float>( random.Range( -influence, influence ) ),
+					              static_cast<float>( random.Range( -influence, influence ) ) );
+
+				int oldID = ship->GetID();
+				long first = Sprite::GetNextID();
+				spawned.erase( find( spawned.begin(), spawned.end(), oldID ) );
+				sprites->Detach( ship );
+				ship->Recycle( planet, position );
+				sprites->Add( ship );
+
+				// Lua forgets the old pilot and picks a new one, who may bring an escort
+				Lua::Call( "recycleShipForPlanet", "iii", oldID, ship->GetID(), planet->GetID() );
+				Adopt( sprites, first );
+				stats.recycled++;
+				return true;
+			}
+		}
+		stats.skipped++;
+		return false;
+	}
+
+	long first = Sprite::GetNextID();
+	Lua::Call( "createRandomShipForPlanet", "i", planet->GetID() );
+	Adopt( sprites, first );
+	stats.spawned++;
+	return true;
+}
+
+/**\brief Every ship that was given an ID since first now belongs to the traffic.
+ */
+void Traffic::Adopt( SpriteManager *sprites, long first ) {
+	for( long id = first; id < Sprite::GetNextID(); id++ ) {
+		Sprite *sprite = sprites->GetSpriteByID( id );
+		if( (sprite != NULL) && (sprite->GetDrawOrder() == DRAW_ORDER_SHIP) ) {
+			spawned.push_back( id );
+		}
+	}
+}
+
+/**\brief Remove a traffic ship that nobody can see.
+ * \details Unlike SpriteManager::Delete, this does not call AI::Killed.  The
+ *          ship is removed at once, which is safe because the sprites are not
+ *          being updated.
+ */
+void Traffic::Despawn( SpriteManager *sprites, AI *ship ) {
+	int id = ship->GetID();
+	spawned.erase( find( spawned.begin(), spawned.end(), id ) );
+	sprites->Detach( ship );
+	delete ship;
+
+	// Lua forgets the pilot
+	Lua::Call( "forgetShip", "i", id );
+}
+
+/**\brief The traffic ship that is furthest from the camera, if it is far enough away.
+ * \returns NULL when every traffic ship is close to the camera.
+ */
+AI* Traffic::FindFarShip( SpriteManager *sprites, Coordinate focus ) {
+	AI *farthest = NULL;
+	float farthestDistance = despawnDistance * despawnDistance;
+	for( unsigned int s = 0; s < spawned.size(); s++ ) {
+		Sprite *sprite = sprites->GetSpriteByID( spawned[s] );
+		if( (sprite == NULL) || (sprite->GetDrawOrder() != DRAW_ORDER_SHIP) ) {
+			continue;
+		}
+		AI *ship = (AI*)sprite;
+		float distance = (ship->GetWorldPosition() - focus).GetMagnitudeSquared();
+		if( (distance > farthestDistance) && !ship->IsDisabled() ) {
+			farthest = ship;
+			farthestDistance = distance;
+		}
+	}
+	return farthest;
+}
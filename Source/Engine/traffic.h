@@ -0,0 +1,67 @@
+/**\file			traffic.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Schedules the ships that Planets create
+ * \details
+ */
+
+#ifndef __H_TRAFFIC__
+#define __H_TRAFFIC__
+
+#include "includes.h"
+#include "Utilities/binary.h"
+#include "Utilities/coordinate.h"
+
+class AI;
+class Planet;
+class SpriteManager;
+
+#define TRAFFIC_PERIOD 120 ///< Logical frames between the checks of each Planet.
+
+/** Counts of what the Traffic scheduler has done. */
+typedef struct {
+	Uint32 checks;		///< Planets that counted the ships around them.
+	Uint32 spawned;		///< Ships created by Lua.
+	Uint32 recycled;	///< Far away ships moved to a Planet instead.
+	Uint32 skipped;		///< Ships that were wanted but not within the budget.
+	Uint32 trimmed;		///< Ships removed to get back under the budget.
+	int peakChecks;		///< Most Planets checked in one frame.
+} TrafficStats;
+
+class Traffic {
+	public:
+		Traffic();
+
+		void Update( lua_State *L );
+		void SetBudget( int population, int spawns, float distance );
+		int GetPopulation( void ) { return static_cast<int>( spawned.size() ); }
+		int GetPopulationBudget( void ) { return maxPopulation; }
+
+		void Snapshot( BinaryWriter& out );
+		bool Restore( BinaryReader& in );
+
+		const TrafficStats& GetStats( void ) { return stats; }
+		void ResetStats( void );
+
+	private:
+		void FindPlanets( SpriteManager *sprites );
+		void Prune( SpriteManager *sprites );
+		bool Spawn( lua_State *L, SpriteManager *sprites, Planet *planet, Coordinate focus );
+		void Adopt( SpriteManager *sprites, long first );
+		AI* FindFarShip( SpriteManager *sprites, Coordinate focus );
+		void Despawn( SpriteManager *sprites, AI *ship );
+
+		vector<Planet*> planets;	///< Every Planet, in the order of the SpriteManager.
+		Uint32 planetChanges;		///< SpriteManager::GetPersistentChanges when the Planets were found.
+		list<int> waiting;			///< Planets that want a ship, oldest first.
+		vector<int> spawned;		///< The ships that belong to the traffic.
+
+		int maxPopulation;			///< Most traffic ships at once.
+		int maxSpawns;				///< Most ships created in one frame.
+		float despawnDistance;		///< Ships this far from the camera may be recycled.
+
+		TrafficStats stats;
+};
+
+#endif // __H_TRAFFIC__
@@ -1,7 +1,7 @@
 /**\file			weapons.cpp
  * \author			Shawn Reynolds (eb0s@yahoo.com)
  * \date			Created: Friday, November 21, 2009
- * \date			Modified: Friday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -116,127 +116,110 @@ Weapon::~Weapon(void)
 {
 }
 
-/**\brief Parses weapon information
- */
-bool Weapon::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
-
-	if( (attr = FirstChildNamed(node,"weaponType")) ){
-		weaponType = (short int)NodeToInt(doc,attr);
-	} else {
-		LogMsg(ERR,"Could not find child node weaponType while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"imageName")) ){
-		image = Image::Get( NodeToString(doc,attr) );
-	} else {
-		LogMsg(ERR,"Could not find child node imageName while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"picName")) ){
-		Image* pic = Image::Get( NodeToString(doc,attr) );
-		// This image can be accessed by either the path or the Weapon Name
-		Image::Store(name, pic);
-		SetPicture(pic);
-	} else {
-		LogMsg(ERR,"Could not find child node picName while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"description")) ){
-		value = NodeToString(doc,attr);
-		SetDescription( value );
-	} else {
-		LogMsg( WARN, "%s does not have a description.", GetName().c_str() );
-	}
-
-	if( (attr = FirstChildNamed(node,"payload")) ){
-		payload = NodeToInt(doc,attr);
-	} else {
-		LogMsg(ERR,"Could not find child node payload while searching component");
-		return false;
-	}
+enum {
+	WEAPON_WEAPONTYPE,
+	WEAPON_IMAGENAME,
+	WEAPON_PICNAME,
+	WEAPON_DESCRIPTION,
+	WEAPON_PAYLOAD,
+	WEAPON_VELOCITY,
+	WEAPON_ACCELERATION,
+	WEAPON_AMMOTYPE,
+	WEAPON_AMMOCONSUMPTION,
+	WEAPON_FIREDELAY,
+	WEAPON_LIFETIME,
+	WEAPON_TRACKING,
+	WEAPON_MSRP,
+	WEAPON_SOUND
+};
 
-	if( (attr = FirstChildNamed(node,"velocity")) ){
-		velocity = NodeToInt(doc,attr);
-	} else {
-		LogMsg(ERR,"Could not find child node velocity while searching component");
-		return false;
-	}
+static const ComponentField weaponFields[] = {
+	{ "weaponType", WEAPON_WEAPONTYPE, FIELD_REQUIRED },
+	{ "imageName", WEAPON_IMAGENAME, FIELD_REQUIRED },
+	{ "picName", WEAPON_PICNAME, FIELD_REQUIRED },
+	{ "description", WEAPON_DESCRIPTION, 0 },
+	{ "payload", WEAPON_PAYLOAD, FIELD_REQUIRED },
+	{ "velocity", WEAPON_VELOCITY, FIELD_REQUIRED },
+	{ "acceleration", WEAPON_ACCELERATION, FIELD_REQUIRED },
+	{ "ammoType", WEAPON_AMMOTYPE, FIELD_REQUIRED },
+	{ "ammoConsumption", WEAPON_AMMOCONSUMPTION, FIELD_REQUIRED },
+	{ "fireDelay", WEAPON_FIREDELAY, FIELD_REQUIRED },
+	{ "lifetime", WEAPON_LIFETIME, FIELD_REQUIRED },
+	{ "tracking", WEAPON_TRACKING, FIELD_REQUIRED },
+	{ "msrp", WEAPON_MSRP, FIELD_REQUIRED },
+	{ "sound", WEAPON_SOUND, FIELD_REQUIRED },
+	{ NULL, 0, 0 }
+};
 
-	if( (attr = FirstChildNamed(node,"acceleration")) ){
-		acceleration = NodeToInt(doc,attr);
-	} else {
-		LogMsg(ERR,"Could not find child node acceleration while searching component");
-		return false;
-	}
+/**\brief The XML fields of a Weapon.
+ */
+const ComponentField* Weapon::GetFields( void ) {
+	return weaponFields;
+}
 
-	if( (attr = FirstChildNamed(node,"ammoType")) ){
-		value = NodeToString(doc,attr);
-		ammoType = AmmoNameToType(value);
-		if(ammoType>=max_ammo) {
-			LogMsg(ERR,"ammoType is >= max_ammo in Weapons XML parsing");
-			return false;
+/**\brief Parse one XML field of a Weapon.
+ */
+bool Weapon::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case WEAPON_WEAPONTYPE:
+			weaponType = (short int)atoi( value.c_str() );
+			break;
+		case WEAPON_IMAGENAME:
+			image = Image::Acquire( value );
+			break;
+		case WEAPON_PICNAME: {
+			ResourceHandle<Image> pic = Image::Acquire( value );
+			// This image can be accessed by either the path or the Weapon Name
+			Image::Store(name, pic);
+			SetPicture(pic);
+			break;
 		}
-	} else {
-		LogMsg(ERR,"Could not find child node ammoType while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"ammoConsumption")) ){
-		ammoConsumption = NodeToInt(doc,attr);
-	} else {
-		LogMsg(ERR,"Could not find child node ammoConsumption while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"fireDelay")) ){
-		fireDelay = NodeToInt(doc,attr);
-	} else {
-		LogMsg(ERR,"Could not find child node fireDelay while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"lifetime")) ){
-		lifetime = NodeToInt(doc,attr);
-	} else {
-		LogMsg(ERR,"Could not find child node lifetime while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"tracking")) ){
-		float _tracking = NodeToFloat(doc,attr);
-		if (_tracking > 1.0f ) _tracking = 1.0f;
-		if (_tracking < 0.0001f ) _tracking = 0.0f;
-		tracking = _tracking;
-	} else {
-		LogMsg(ERR,"Could not find child node tracking while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"msrp")) ){
-		value = NodeToString(doc,attr);
-		SetMSRP( (short int)atoi( value.c_str() ));
-	} else {
-		LogMsg(ERR,"Could not find child node msrp while searching component");
-		return false;
-	}
-
-	if( (attr = FirstChildNamed(node,"sound")) ){
-		value = NodeToString(doc,attr);
-		this->sound = Sound::Get( value );
-		if( this->sound==NULL) {
-			// Do not return false here - they may be disabling audio on purpose or audio may not be supported on their system
-			LogMsg(NOTICE,"Could not load sound file while searching component");
+		case WEAPON_DESCRIPTION:
+			SetDescription( value );
+			break;
+		case WEAPON_PAYLOAD:
+			payload = atoi( value.c_str() );
+			break;
+		case WEAPON_VELOCITY:
+			velocity = atoi( value.c_str() );
+			break;
+		case WEAPON_ACCELERATION:
+			acceleration = atoi( value.c_str() );
+			break;
+		case WEAPON_AMMOTYPE:
+			ammoType = AmmoNameToType(value);
+			if(ammoType>=max_ammo) {
+				LogMsg(ERR,"ammoType is >= max_ammo in Weapons XML parsing");
+				return false;
+			}
+			break;
+		case WEAPON_AMMOCONSUMPTION:
+			ammoConsumption = atoi( value.c_str() );
+			break;
+		case WEAPON_FIREDELAY:
+			fireDelay = atoi( value.c_str() );
+			break;
+		case WEAPON_LIFETIME:
+			lifetime = atoi( value.c_str() );
+			break;
+		case WEAPON_TRACKING: {
+			float _tracking = static_cast<float>( atof( value.c_str() ) );
+			if (_tracking > 1.0f ) _tracking = 1.0f;
+			if (_tracking < 0.0001f ) _tracking = 0.0f;
+			tracking = _tracking;
+			break;
 		}
-	} else {
-		LogMsg(ERR,"Could not find child node sound while searching component");
-		return false;
+		case WEAPON_MSRP:
+			SetMSRP( (short int)atoi( value.c_str() ));
+			break;
+		case WEAPON_SOUND:
+			this->sound = Sound::Acquire( value );
+			if( this->sound==NULL) {
+				// Do not return false here - they may be disabling audio on purpose or audio may not be supported on their system
+				LogMsg(NOTICE,"Could not load sound file while searching component");
+			}
+			break;
 	}
-
 	return true;
 }
 
@@ -277,6 +260,51 @@ xmlNodePtr Weapon::ToXMLNode(string componentName) {
 	return section;
 }
 
+/**\brief Write this Weapon to a binary cache.
+ */
+bool Weapon::Serialize( BinaryWriter& out ) {
+	if( (image == NULL) || (sound == NULL) || !Outfit::Serialize( out ) ) {
+		return false;
+	}
+	out.WriteString( image->GetPath() );
+	out.WriteString( sound->GetPath() );
+	out.WriteInt( weaponType );
+	out.WriteInt( payload );
+	out.WriteInt( velocity );
+	out.WriteInt( acceleration );
+	out.WriteInt( ammoType );
+	out.WriteInt( ammoConsumption );
+	out.WriteInt( fireDelay );
+	out.WriteInt( lifetime );
+	out.WriteFloat( tracking );
+	return true;
+}
+
+/**\brief Read this Weapon from a binary cache.
+ */
+bool Weapon::Deserialize( BinaryReader& in ) {
+	if( !Outfit::Deserialize( in ) ) {
+		return false;
+	}
+	string imageName = in.ReadString();
+	string soundName = in.ReadString();
+	weaponType = in.ReadInt();
+	payload = in.ReadInt();
+	velocity = in.ReadInt();
+	acceleration = in.ReadInt();
+	ammoType = static_cast<AmmoType>( in.ReadInt() );
+	ammoConsumption = in.ReadInt();
+	fireDelay = in.ReadInt();
+	lifetime = in.ReadInt();
+	tracking = in.ReadFloat();
+	if( in.Failed() || (ammoType >= max_ammo) ) {
+		return false;
+	}
+	image = Image::Acquire( imageName );
+	sound = Sound::Acquire( soundName );
+	return true;
+}
+
 /**\fn Weapon::GetImage( )
  *  \brief Returns the image of the fired weapon
  * \fn Weapon::GetType( )
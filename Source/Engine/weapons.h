@@ -45,8 +45,11 @@ class Weapon : public Outfit {
 				int _msrp);
 		~Weapon(void);
 
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 
 		static string AmmoTypeToName(AmmoType type);
 		static AmmoType AmmoNameToType(string typeName );
@@ -64,8 +67,8 @@ class Weapon : public Outfit {
 		float GetTracking(void) {return tracking;}
 
 	private:
-		Image *image;
-		Sound *sound; //Sound the weapon makes
+		ResourceHandle<Image> image;
+		ResourceHandle<Sound> sound; //Sound the weapon makes
 		int weaponType; //(energy, explosive, laser, etc)
 		int payload; //intesity of explosion
 		int velocity; //speed of travel
@@ -81,7 +84,7 @@ class Weapons : public Components {
 	public:
 		static Weapons *Instance();
 
-		Weapon *GetWeapon( string& weaponName ) { return (Weapon*) this->Get(weaponName); }
+		Weapon *GetWeapon( const string& weaponName ) { return (Weapon*) this->Get(weaponName); }
 		Component* newComponent() { return new Weapon(); }
 	protected:
 		Weapons(){};
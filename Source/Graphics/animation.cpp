@@ -1,7 +1,7 @@
 /**\file			animation.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -11,9 +11,13 @@
 #include "Utilities/file.h"
 #include "Utilities/log.h"
 #include "Utilities/resource.h"
+#include "Utilities/timer.h"
 
 
 #define ANI_VERSION 1
+#define ANI_ATLAS_VERSION 2
+
+#define ANI_ATLAS_COMPRESSED (1<<0)
 
 /** \class Ani
  *  \brief An animation data object
@@ -34,13 +38,79 @@
  *  - One byte of number of frames
  *
  *  - Multiple Images concatenated together
+ *
+ *  ANI_ATLAS_VERSION 2:
+ *
+ *  - The same first three bytes (version, number of frames, delay time)
+ *
+ *  - One byte of flags (ANI_ATLAS_COMPRESSED)
+ *
+ *  - Two 16 bit atlas dimensions (width, height)
+ *
+ *  - A UV table of four 16 bit values (x, y, w, h) for each frame.  The
+ *    rectangle excludes the gutter of repeated edge pixels that surrounds
+ *    each frame, so linear filtering never blends neighbouring frames.
+ *
+ *  - Two 32 bit lengths (raw pixels, stored pixels)
+ *
+ *  - The atlas as RGBA pixels, top row first, zlib compressed if flagged
+ *
+ *  Version 2 files are loaded with a single read and a single texture upload,
+ *  and every frame is drawn from the same texture.  All multi-byte values
+ *  are little endian.
  *  
  *  The external python script "ani.py" can be used to extract, modify, and create .ani files.
+ *  Use "ani.py --atlas" to create version 2 files.
  *
- *  \warning Since this file format is developed specifically for Epiar it is more fragile than other file formats.  For example, it makes endianess assumptions that require the bytes be swapped before it can be loaded on Big Endian machines.
+ *  \warning Since this file format is developed specifically for Epiar it is more fragile than other file formats.
  *  \see Animation
  */
 
+/**\class AniJob
+ * \brief Loads an Ani in the background.
+ * \details Every frame is decoded on a worker thread, then all of the frames
+ *          are turned into textures together on the main thread.
+ * \see AssetManager, Ani::GetAsync
+ */
+class AniJob : public AssetJob {
+	public:
+		AniJob( Ani* _ani, const string& _filename ):
+			ani(_ani), filename(_filename), delay(0), success(false) {}
+
+		void Decode( void ) {
+			success = Ani::Decode( filename, surfaces, regions, delay );
+		}
+
+		void Upload( void ) {
+			ani->loadJob = NULL;
+			if( !success ) {
+				LogMsg(ERR, "Couldn't load Animation '%s' in the background.", filename.c_str() );
+				return;
+			}
+			ani->Upload( surfaces, regions, delay );
+		}
+
+	private:
+		Ani* ani;
+		string filename;
+		vector<SDL_Surface*> surfaces;
+		vector<SDL_Rect> regions;
+		Uint32 delay;
+		bool success;
+};
+
+/**\brief Read a little endian 16 bit value.
+ */
+static Uint16 ReadLE16( const unsigned char* p ) {
+	return static_cast<Uint16>( p[0] | (p[1]<<8) );
+}
+
+/**\brief Read a little endian 32 bit value.
+ */
+static Uint32 ReadLE32( const unsigned char* p ) {
+	return static_cast<Uint32>( p[0] | (p[1]<<8) | (p[2]<<16) | (p[3]<<24) );
+}
+
 /**\brief Gets the resource object.
  * \param filename string containing the animation
  */
@@ -51,16 +121,56 @@ Ani* Ani::Get( string filename ) {
 		value = new Ani(filename);
 		Resource::Store(filename,(Resource*)value);
 	}
+	value->Pin();
+	return value;
+}
+
+/**\brief Gets the resource object without waiting for it to load.
+ * \details The frames are decoded in the background.  Until they are ready
+ *          the Ani has no frames, so Animations using it will not draw.
+ * \param filename string containing the animation
+ * \sa AssetManager
+ */
+Ani* Ani::GetAsync( string filename ) {
+	Ani* value = Request( filename );
+	value->Pin();
+	return value;
+}
+
+/**\brief Gets a reference counted resource object without waiting for it to load.
+ * \details Like GetAsync, but the Ani may be freed once every handle to it is
+ *          gone.
+ * \param filename string containing the animation
+ * \sa Resource
+ */
+ResourceHandle<Ani> Ani::Acquire( const string& filename ) {
+	return ResourceHandle<Ani>( Request( filename ) );
+}
+
+/**\brief Find an Ani, or start loading it in the background.
+ * \param filename string containing the animation
+ */
+Ani* Ani::Request( const string& filename ) {
+	Ani* value;
+	value = (Ani*)Resource::Get(filename);
+	if( value == NULL ) {
+		value = new Ani();
+		value->loadJob = new AniJob( value, filename );
+		Resource::Store(filename,(Resource*)value);
+		AssetManager::Queue( value->loadJob );
+	}
 	return value;
 }
 
 /**\brief The resource object (no file).
  */
 Ani::Ani() {
+	sheet = NULL;
 	frames = NULL;
 	delay = 0;
 	numFrames = 0;
 	w = h = 0;
+	loadJob = NULL;
 }
 
 /**\brief The resource object based on the file.
@@ -69,84 +179,321 @@ Ani::Ani() {
  */
 Ani::Ani( string& filename ) {
 	LogMsg(INFO,"New Animation from '%s'", filename.c_str() );
+	sheet = NULL;
 	frames = NULL;
 	delay = 0;
 	numFrames = 0;
 	w = h = 0;
+	loadJob = NULL;
 	Load( filename );
 }
 
+/**\brief Frees the frames.
+ */
+Ani::~Ani() {
+	// The background load still refers to this Ani
+	if( loadJob ) {
+		AssetManager::Complete( loadJob );
+	}
+
+	// The frames may be regions of the sheet, so free them first.
+	delete [] frames;
+	delete sheet;
+}
+
+/**\brief The texture memory used by every frame.
+ */
+long Ani::GetMemorySize( void ) {
+	long size = sheet ? sheet->textureBytes : 0;
+	for( int i = 0; i < numFrames; i++ ) {
+		size += frames[i].textureBytes;
+	}
+	return size;
+}
+
 /**\brief Loads the animation file.
  * \param filename File name of the animation
  */
 bool Ani::Load( string& filename ) {
-	char byte;
+	vector<SDL_Surface*> surfaces;
+	vector<SDL_Rect> regions;
+	Uint32 frameDelay;
+
+	if( !Decode( filename, surfaces, regions, frameDelay ) ) {
+		return( false );
+	}
+
+	return Upload( surfaces, regions, frameDelay );
+}
+
+/**\brief Decode every frame of an animation file.
+ * \details This does not touch OpenGL, so it is safe to use from the
+ *          AssetManager's worker threads.
+ * \param[in] filename File name of the animation
+ * \param[out] surfaces The decoded frames, or the single atlas
+ * \param[out] regions The rectangle of each frame within the atlas (empty unless this is an atlas)
+ * \param[out] delay The delay between frames
+ */
+bool Ani::Decode( string& filename, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions, Uint32& delay ) {
 	const char *cName = filename.c_str();
-	File file = File( cName );
+	File file = File();
+	bool success;
 
 	LogMsg(INFO, "Loading animation '%s'", cName );
 
-	file.Read( 1, &byte );
-	if( byte != ANI_VERSION ) {
-		LogMsg(ERR, "Incorrect ani version" );
+	if( !file.OpenRead( filename ) ) {
+		return( false );
+	}
+
+	// Map the whole file at once
+	const unsigned char* buf = reinterpret_cast<const unsigned char*>( file.Map() );
+	int size = file.GetLength();
+	if( buf == NULL ) {
 		return( false );
 	}
 
-	file.Read( 1, &byte );
-	if( byte <= 0 ) {
+	if( size < 3 ) {
+		LogMsg(ERR, "Animation '%s' is too short", cName );
+		return( false );
+	}
+
+	if( buf[1] == 0 ) {
 		LogMsg(ERR, "Cannot have zero or less frames" );
 		return( false );
 	}
-	numFrames = byte;
-	// Allocate space for frames
-	frames = new Image[byte];
 
-	file.Read( 1, &byte );
-	if( byte <= 0 ) {
+	if( buf[2] == 0 ) {
 		LogMsg(ERR, "Cannot have zero or less for a delay" );
-		delete [] frames;
-		frames = NULL;
 		return( false );
 	}
-	delay = byte;
+	delay = buf[2];
+
+	switch( buf[0] ) {
+		case ANI_VERSION:
+			success = DecodeFrames( buf, size, surfaces );
+			break;
+		case ANI_ATLAS_VERSION:
+			success = DecodeAtlas( buf, size, surfaces, regions );
+			break;
+		default:
+			LogMsg(ERR, "Incorrect ani version" );
+			success = false;
+			break;
+	}
 
-	for( int i = 0; i < numFrames; i++ ) {
-		long pos;
-		int fs;
+	if( !success ) {
+		LogMsg(ERR, "Could not decode '%s'", cName );
+		for( vector<SDL_Surface*>::iterator f = surfaces.begin(); f != surfaces.end(); ++f ) {
+			SDL_FreeSurface( *f );
+		}
+		surfaces.clear();
+		regions.clear();
+	}
 
-		file.Read( sizeof(int), (char *) &fs );
+	return( success );
+}
 
-		// Big Endian Machines need to swap the bytes here.
-		if( IsBigEndian() ) {
-			LogMsg(ERR, "Swapping Bytes for Endianness");
-			fs = SDL_SwapLE32(fs);
+/**\brief Decode a version 1 animation, where every frame is its own image.
+ * \param[in] buf The whole file
+ * \param[in] size The length of buf
+ * \param[out] surfaces One surface per frame
+ */
+bool Ani::DecodeFrames( const unsigned char* buf, int size, vector<SDL_Surface*>& surfaces ) {
+	int count = buf[1];
+	int pos = 3;
+
+	for( int i = 0; i < count; i++ ) {
+		if( pos + 4 > size ) {
+			LogMsg(ERR, "Frame %d is missing", i );
+			return( false );
+		}
+		int fs = static_cast<int>( ReadLE32( buf + pos ) );
+		pos += 4;
+
+		if( (fs <= 0) || (pos + fs > size) ) {
+			LogMsg(ERR, "Frame %d is truncated", i );
+			return( false );
+		}
+
+		SDL_Surface *s = Image::Decode( (char*)(buf + pos), fs );
+		if( s == NULL ) {
+			LogMsg(ERR, "Could not decode frame %d", i );
+			return( false );
 		}
+		surfaces.push_back( s );
 
-		pos = file.Tell();
+		pos += fs;
+	}
+
+	return( true );
+}
 
-		// On OS X 10.6 with SDL_image 1.2.8, the load from fp is broken, so we load it into a buffer ourselves and SDL_image
-		// loads from that correctly. It's an extra step on our part, but performance/functionally they're identical. Hopefully
-		// this gets fixed in a future SDL_image
-		char *buf = new char [fs];
-		file.Read( fs, buf );
+/**\brief Decode a version 2 animation, where every frame is packed into one atlas.
+ * \param[in] buf The whole file
+ * \param[in] size The length of buf
+ * \param[out] surfaces The atlas
+ * \param[out] regions The rectangle of each frame within the atlas
+ */
+bool Ani::DecodeAtlas( const unsigned char* buf, int size, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions ) {
+	int count = buf[1];
+	int pos = 3;
 
-		//frames[i].Load( fp, (int)fs );
-		frames[i].Load( buf, fs );
+	// Header
+	if( pos + 5 + (count * 8) + 8 > size ) {
+		LogMsg(ERR, "The atlas header is truncated" );
+		return( false );
+	}
+	unsigned char flags = buf[pos];
+	int atlas_w = ReadLE16( buf + pos + 1 );
+	int atlas_h = ReadLE16( buf + pos + 3 );
+	pos += 5;
 
-		delete [] buf;
-		buf = NULL;
+	if( (atlas_w == 0) || (atlas_h == 0) ) {
+		LogMsg(ERR, "The atlas is empty" );
+		return( false );
+	}
 
-		file.Seek( pos + fs );
+	// UV Table
+	for( int i = 0; i < count; i++ ) {
+		SDL_Rect r;
+		r.x = ReadLE16( buf + pos );
+		r.y = ReadLE16( buf + pos + 2 );
+		r.w = ReadLE16( buf + pos + 4 );
+		r.h = ReadLE16( buf + pos + 6 );
+		pos += 8;
+
+		if( (r.w == 0) || (r.h == 0) || (r.x + r.w > atlas_w) || (r.y + r.h > atlas_h) ) {
+			LogMsg(ERR, "Frame %d is outside of the atlas", i );
+			return( false );
+		}
+		regions.push_back( r );
 	}
 
+	// Pixels
+	uLongf rawLength = ReadLE32( buf + pos );
+	Uint32 storedLength = ReadLE32( buf + pos + 4 );
+	pos += 8;
+
+	if( rawLength != static_cast<uLongf>( atlas_w * atlas_h * 4 ) ) {
+		LogMsg(ERR, "The atlas should have %d bytes of pixels, not %lu", atlas_w * atlas_h * 4, (unsigned long)rawLength );
+		return( false );
+	}
+	if( pos + static_cast<int>(storedLength) > size ) {
+		LogMsg(ERR, "The atlas pixels are truncated" );
+		return( false );
+	}
+
+	SDL_Surface *s = SDL_CreateRGBSurface( SDL_SWSURFACE, atlas_w, atlas_h, 32,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+		);
+	if( s == NULL ) {
+		LogMsg(ERR, "Could not create a %dx%d atlas: %s", atlas_w, atlas_h, SDL_GetError() );
+		return( false );
+	}
+
+	// The pixels can only be copied directly when the rows are not padded
+	bool direct = ( s->pitch == atlas_w * 4 );
+	unsigned char *pixels = direct ? static_cast<unsigned char*>(s->pixels) : new unsigned char[rawLength];
+
+	if( flags & ANI_ATLAS_COMPRESSED ) {
+		uLongf length = rawLength;
+		if( (uncompress( pixels, &length, buf + pos, storedLength ) != Z_OK) || (length != rawLength) ) {
+			LogMsg(ERR, "Could not uncompress the atlas" );
+			if( !direct ) delete [] pixels;
+			SDL_FreeSurface( s );
+			return( false );
+		}
+	} else {
+		if( storedLength != rawLength ) {
+			LogMsg(ERR, "The uncompressed atlas is the wrong length" );
+			if( !direct ) delete [] pixels;
+			SDL_FreeSurface( s );
+			return( false );
+		}
+		memcpy( pixels, buf + pos, rawLength );
+	}
+
+	if( !direct ) {
+		for( int row = 0; row < atlas_h; row++ ) {
+			memcpy( static_cast<unsigned char*>(s->pixels) + row * s->pitch, pixels + row * atlas_w * 4, atlas_w * 4 );
+		}
+		delete [] pixels;
+	}
+
+	surfaces.push_back( s );
+	return( true );
+}
+
+/**\brief Turn decoded frames into textures.
+ * \details This must run on the main thread.  The surfaces are freed.
+ *          When regions are given, the single surface is an atlas and every
+ *          frame uses a region of its texture.
+ */
+bool Ani::Upload( vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions, Uint32 frameDelay ) {
+	assert( !surfaces.empty() );
+
+	delay = frameDelay;
+
+	if( regions.empty() ) {
+		numFrames = static_cast<int>( surfaces.size() );
+
+		// Allocate space for frames
+		frames = new Image[numFrames];
+		for( int i = 0; i < numFrames; i++ ) {
+			frames[i].category = "Animations";
+			frames[i].Upload( surfaces[i] );
+		}
+	} else {
+		assert( surfaces.size() == 1 );
+		numFrames = static_cast<int>( regions.size() );
+
+		sheet = new Image();
+		sheet->category = "Animations";
+		if( !sheet->Upload( surfaces[0] ) ) {
+			delete sheet;
+			sheet = NULL;
+			numFrames = 0;
+			surfaces.clear();
+			return( false );
+		}
+
+		frames = new Image[numFrames];
+		for( int i = 0; i < numFrames; i++ ) {
+			frames[i].UseRegion( sheet, regions[i].x, regions[i].y, regions[i].w, regions[i].h );
+		}
+	}
+	surfaces.clear();
+
 	w = frames[0].GetWidth();
 	h = frames[0].GetHeight();
+	Resized();
 
 	//LogMsg(INFO, "Animation loading done." );
 
 	return( true );
 }
 
+/**\brief Check if the frames have been loaded yet (never blocks).
+ */
+bool Ani::IsReady( void ) {
+	if( loadJob ) {
+		AssetManager::Poll( loadJob );
+	}
+	return ( frames != NULL );
+}
+
+/**\brief Wait for a background load to finish.
+ */
+void Ani::Wait( void ) {
+	if( loadJob ) {
+		AssetManager::Complete( loadJob );
+	}
+}
+
 /** \brief Get the Image at a specific Frame
  * 	\param[in] frameNum
  * 	\returns Image pointer;
@@ -158,6 +505,9 @@ Image* Ani::GetFrame(int frameNum) {
 	return &(frames[frameNum]);
 }
 
+/**\var Ani::sheet
+ *  \brief The atlas texture shared by every frame, or NULL for version 1 files
+ */
 /**\var Ani::frames
  *  \brief Frames of the animation as Image objects
  */
@@ -179,8 +529,9 @@ Image* Ani::GetFrame(int frameNum) {
  *  \details The Animation class is used for each instantiation of an
  *  animation.  Many Animations can share the same Ani object while each having
  *  a different timestamp.
- *  \note The Animation uses "real" clocktime, so they will continue to play
- *  while the game is paused.
+ *  \note The Animation uses the clock of the game loop, which keeps running
+ *  while the game is paused, so they will continue to play.  Since that clock
+ *  is the one a Replay records, Animations play back the same way.
  *  \see Ani, Effect
  */
 
@@ -196,11 +547,11 @@ Animation::Animation() {
  * \param filename File to load.
  * \sa Ani::Get
  */
-Animation::Animation( string filename ) {
+Animation::Animation( const string& filename ) {
 	fnum=0;
 	startTime = 0;
 	loopPercent = 0.0f;
-	ani = Ani::Get( filename );
+	ani = Ani::Acquire( filename );
 }
 
 /**\brief Returns true while animation is still playing.
@@ -213,19 +564,25 @@ bool Animation::Update() {
 	Image *frame = NULL;
 	bool finished = false;
 
+	// Don't start the clock until the frames have been loaded.
+	// An Ani that failed to load will never play, so it is already finished.
+	if( !ani->IsReady() ) {
+		return !ani->IsLoading();
+	}
+
 	if( startTime ) {
-		fnum = (SDL_GetTicks() - startTime) / ani->GetDelay();
+		fnum = (Timer::GetTicks() - startTime) / ani->GetDelay();
 
 		if( fnum > ani->GetNumFrames() - 1 ) {
 			fnum = TO_INT(ani->GetNumFrames() * (1.0f-loopPercent)); // Step back a few frames.
-			startTime = SDL_GetTicks() - ani->GetDelay()*fnum; // Pretend that we started fnum frames ago
+			startTime = Timer::GetTicks() - ani->GetDelay()*fnum; // Pretend that we started fnum frames ago
 			if( loopPercent <= 0.0f ) {
 				finished = true;
 			}
 		}
 
 	} else {
-		startTime = SDL_GetTicks();
+		startTime = Timer::GetTicks();
 		frame = ani->GetFrame(0);
 	}
 	return finished;
@@ -234,6 +591,9 @@ bool Animation::Update() {
 /**\brief Draws the animation at given coordinate.
  */
 void Animation::Draw( int x, int y, float ang ) {
+	if( !ani->IsReady() ) {
+		return;
+	}
 	Image* frame = ani->GetFrame( fnum );
 	frame->DrawCentered( x, y, ang );
 }
@@ -246,6 +606,33 @@ void Animation::Reset( void ) {
 	startTime = 0;
 }
 
+/**\brief How long this animation has been playing, in milliseconds.
+ * \returns 0 if the animation has not started yet.
+ */
+Uint32 Animation::GetAge( void ) {
+	return startTime ? (Timer::GetTicks() - startTime) : 0;
+}
+
+/**\brief Move the animation to the moment that it had played for age milliseconds.
+ * \details An age of 0 restarts the animation on its next Update.
+ */
+void Animation::SetAge( Uint32 age ) {
+	if( age == 0 ) {
+		Reset();
+		return;
+	}
+	startTime = Timer::GetTicks() - age;
+	if( startTime == 0 ) {
+		startTime = 1; // 0 means that the clock has not started
+	}
+	if( ani->IsReady() ) {
+		fnum = (Timer::GetTicks() - startTime) / ani->GetDelay();
+		if( fnum > ani->GetNumFrames() - 1 ) {
+			fnum = ani->GetNumFrames() - 1;
+		}
+	}
+}
+
 /**\fn Animation::SetLoopPercent( float newLoopPercent )
  *  \brief Set the amount that the animation should loop.
  *  \details 0.0 means that this does not loop at all.
@@ -1,7 +1,7 @@
 /**\file			animation.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -17,36 +17,61 @@ class Ani: public Resource {
 	public:
 		Ani();
 		Ani( string& filename );
+		~Ani();
 		bool Load( string& filename );
 		static Ani* Get(string filename);
+		static Ani* GetAsync(string filename);
+		static ResourceHandle<Ani> Acquire(const string& filename);
+
+		bool IsReady( void );
+		bool IsLoading( void ) { return loadJob != NULL; }
+		void Wait( void );
 
 		Image* GetFrame(int frameNum);
 		int GetNumFrames() { return numFrames; }
 		int GetDelay() { return delay; }
 		int GetWidth() { return w; }
 		int GetHeight() { return h; }
+		int GetTextureCount() { return sheet ? 1 : numFrames; }
+
+		string GetTypeName( void ) { return "Animation"; }
+		long GetMemorySize( void );
 
 	private:
+		friend class AniJob;
+
+		static Ani* Request( const string& filename );
+
+		static bool Decode( string& filename, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions, Uint32& delay );
+		static bool DecodeFrames( const unsigned char* buf, int size, vector<SDL_Surface*>& surfaces );
+		static bool DecodeAtlas( const unsigned char* buf, int size, vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions );
+		bool Upload( vector<SDL_Surface*>& surfaces, vector<SDL_Rect>& regions, Uint32 delay );
+
+		Image *sheet;
 		Image *frames;
 		int numFrames;
 		Uint32 delay;
 		int w, h;
+		AssetJob *loadJob; ///< The pending background load, or NULL
 };
 
 class Animation {
 	public:
 		Animation();
-		Animation( string filename );
+		Animation( const string& filename );
 		bool Update( void );
 		void Draw( int x, int y, float ang );
 		void SetLoopPercent( float loopPercent );
 		float GetLoopPercent( void ) { return loopPercent; };
 		void Reset( void );
-		int GetHalfWidth( void ) { return ani->GetWidth() / 2; };
-		int GetHalfHeight( void ) { return ani->GetHeight() / 2; };
+		Uint32 GetAge( void );
+		void SetAge( Uint32 age );
+		int GetHalfWidth( void ) { ani->Wait(); return ani->GetWidth() / 2; };
+		int GetHalfHeight( void ) { ani->Wait(); return ani->GetHeight() / 2; };
+		string GetFilename( void ) { return ani.Get() ? ani->GetName() : ""; }
 
 	private:
-		Ani *ani;
+		ResourceHandle<Ani> ani;
 		Uint32 startTime;
 		float loopPercent;
 		int fnum;
@@ -45,6 +45,7 @@ Font* Font::Get( string filename ) {
 			return NULL;
 		}
 	}
+	value->Pin();
 	return value;
 }
 
@@ -217,6 +218,7 @@ int Font::RenderInternal( int x, int y, const string& text, int h, XPos xpos, YP
 	glPushMatrix(); // to save the current matrix
 	glScalef(1, -1, 1);
 	FTPoint newpoint = this->font->Render( text.c_str(), -1, FTPoint( xn, yn, 1) );
+	Video::CountDrawCall();
 	glPopMatrix(); // restore the previous matrix
 	glDisable(GL_TEXTURE_2D);
 	glDisable(GL_BLEND);
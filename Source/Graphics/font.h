@@ -36,6 +36,8 @@ class Font : public Resource {
 
 			bool Load( string filename );
 
+			string GetTypeName( void ) { return "Font"; }
+
 			void SetSize( int size=12 );
 			unsigned int GetSize( void );
 			void SetColor( Color c, float a=1.0f );
@@ -1,7 +1,7 @@
 /**\file			image.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Saturday, January 31, 2009
- * \date			Modified: Saturday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Image loading and display
  * \details
  * See this note section in image.h for an important clarification about the handling
@@ -14,18 +14,66 @@
 #include "Graphics/video.h"
 #include "Utilities/file.h"
 #include "Utilities/log.h"
+#include "Utilities/options.h"
 #include "Utilities/trig.h"
 
+static Option<long> textureMemory( "options/video/texture-memory" );
+
 /**\class Image
  * \brief Image handling. */
 
+/**\class ImageJob
+ * \brief Loads an Image in the background.
+ * \details The file is decoded into an SDL_Surface on a worker thread, then
+ *          converted into an OpenGL texture on the main thread.
+ * \see AssetManager, Image::GetAsync
+ */
+class ImageJob : public AssetJob {
+	public:
+		ImageJob( Image* _image, const string& _filename ):
+			image(_image), filename(_filename), surface(NULL) {}
+
+		void Decode( void ) {
+			surface = Image::Decode( filename );
+		}
+
+		void Upload( void ) {
+			image->loadJob = NULL;
+			if( surface == NULL ) {
+				LogMsg(ERR, "Couldn't load Image '%s' in the background.", filename.c_str() );
+				return;
+			}
+			image->Upload( surface );
+		}
+
+	private:
+		Image* image;
+		string filename;
+		SDL_Surface* surface;
+};
+
+/**\brief Images that haven't been drawn in this long may be evicted.
+ */
+#define TEXTURE_EVICTION_GRACE 1000
+
+long Image::totalTextureBytes = 0;
+map<string,long> Image::categoryTextureBytes;
+set<Image*> Image::textured;
+Uint32 Image::textureChanges = 0;
+
 /**\brief Constructor, initialize default values
  */
 Image::Image() {
 	// Initialize variables
 	w = h = real_w = real_h = image = 0;
 	scale_w = scale_h = 1.;
+	offset_u = offset_v = 0.;
+	sheet = NULL;
 	filepath="";
+	loadJob = NULL;
+	textureBytes = 0;
+	lastDrawn = 0;
+	evicted = false;
 }
 
 /**\brief Create instance by loading image from file
@@ -34,7 +82,13 @@ Image::Image( const string& filename ) {
 	// Initialize variables
 	w = h = real_w = real_h = image = 0;
 	scale_w = scale_h = 1.;
+	offset_u = offset_v = 0.;
+	sheet = NULL;
 	filepath="";
+	loadJob = NULL;
+	textureBytes = 0;
+	lastDrawn = 0;
+	evicted = false;
 
 	Load(filename);
 }
@@ -45,7 +99,13 @@ Image::Image( GLuint texture, int w, int h ) {
 	this->w = real_w = w;
 	this->h = real_h = h;
 	scale_w = scale_h = 1.;
+	offset_u = offset_v = 0.;
+	sheet = NULL;
 	filepath="";
+	loadJob = NULL;
+	textureBytes = 0;
+	lastDrawn = 0;
+	evicted = false;
 
 	image = texture;
 }
@@ -53,10 +113,16 @@ Image::Image( GLuint texture, int w, int h ) {
 /**\brief Deallocate allocations
  */
 Image::~Image() {
-	if ( image ) {
-		glDeleteTextures( 1, &image );
-		image = 0;
+	// The background load still refers to this Image
+	if( loadJob ) {
+		AssetManager::Complete( loadJob );
+	}
+
+	// Regions of an atlas share their sheet's texture
+	if ( sheet == NULL ) {
+		ReleaseTexture();
 	}
+	image = 0;
 }
 
 /**\brief Lazy fetch an Image
@@ -74,48 +140,129 @@ Image* Image::Get( string filename ) {
 			return NULL;
 		}
 	}
+	value->Pin();
 	return value;
 }
 
+/**\brief Fetch an Image without waiting for it to load
+ * \details The returned Image can be used immediately.  It is decoded in the
+ *          background by the AssetManager.  Until it is ready it will not be
+ *          drawn, and asking for its dimensions will wait for it to finish.
+ * \sa AssetManager
+ */
+Image* Image::GetAsync( string filename ) {
+	Image* value = Request( filename );
+	value->Pin();
+	return value;
+}
+
+/**\brief Fetch a reference counted Image without waiting for it to load
+ * \details Like GetAsync, but the Image may be freed once every handle to it
+ *          is gone.
+ * \sa Resource
+ */
+ResourceHandle<Image> Image::Acquire( string filename ) {
+	return ResourceHandle<Image>( Request( filename ) );
+}
+
+/**\brief Find an Image, or start loading it in the background
+ */
+Image* Image::Request( string filename ) {
+	Image* value;
+	value = static_cast<Image*>(Resource::Get(filename));
+	if( value == NULL ) {
+		value = new Image();
+		value->filepath = filename;
+		value->loadJob = new ImageJob( value, filename );
+		Resource::Store(filename,(Resource*)value);
+		AssetManager::Queue( value->loadJob );
+	}
+	return value;
+}
+
+/**\brief Check if this Image can be drawn yet
+ * \details If the Image has finished decoding in the background, this will
+ *          upload it immediately rather than waiting for the AssetManager.
+ */
+bool Image::IsReady( void ) {
+	if( loadJob ) {
+		AssetManager::Poll( loadJob );
+	}
+	return ( image != 0 );
+}
+
+/**\brief Wait for a background load to finish
+ */
+void Image::Wait( void ) {
+	if( loadJob ) {
+		AssetManager::Complete( loadJob );
+	}
+}
+
 /**\brief Load image from file
  */
 bool Image::Load( const string& filename ) {
+	SDL_Surface *s = Decode( filename );
+	if( s == NULL ) {
+		return false; // Image could not be loaded. (It might not be an Image)
+	}
+
+	filepath = filename;
+	if( Upload( s ) ) {
+		return true;
+	}
+	filepath = "";
+	return false;
+}
+
+/**\brief Load image from buffer
+ */
+bool Image::Load( char *buf, int bufSize ) {
+	SDL_Surface *s = Decode( buf, bufSize );
+	if( s == NULL ) {
+		return false;
+	}
+	return Upload( s );
+}
+
+/**\brief Decode an image file into an SDL_Surface
+ * \details This does not touch OpenGL, so it is safe to use from the
+ *          AssetManager's worker threads.
+ * \returns A new surface or NULL.
+ */
+SDL_Surface *Image::Decode( const string& filename ) {
 	File file = File();
 
 	if( filename == "" ) {
-		return false; // No File to load.
+		return NULL; // No File to load.
 	}
 
 	if( !file.OpenRead(filename ) ) {
-		return false; // File could not be opened or found.
+		return NULL; // File could not be opened or found.
 	}
 
-	char* buffer = file.Read();
+	const char* buffer = file.Map();
 	int bytesread = file.GetLength();
 
 	if ( buffer == NULL ) {
-		return false; // File could not be Read.
+		return NULL; // File could not be Read.
 	}
 
-	int retval = Load( buffer, bytesread );
-	delete [] buffer;
-	if ( retval ){
-        filepath=filename;
-		return true;
-	}
-	return false; // Image could not be loaded. (It might not be an Image)
+	// SDL only reads from the buffer, so it can point into an Archive.
+	return Decode( const_cast<char*>( buffer ), bytesread );
 }
 
-/**\brief Load image from buffer
+/**\brief Decode an image buffer into an SDL_Surface
+ * \returns A new surface or NULL.
  */
-bool Image::Load( char *buf, int bufSize ) {
+SDL_Surface *Image::Decode( char *buf, int bufSize ) {
 	SDL_RWops *rw;
 	SDL_Surface *s = NULL;
 
 	rw = SDL_RWFromMem( buf, bufSize );
 	if( !rw ) {
 		LogMsg(WARN, "Image loading failed. Could not create RWops" );
-		return( false );
+		return( NULL );
 	}
 
 	s = IMG_Load_RW( rw, 0 );
@@ -123,9 +270,16 @@ bool Image::Load( char *buf, int bufSize ) {
 
 	if( !s ) {
 		LogMsg(WARN, "Image loading failed. Could not load image from RWops" );
-		return( false );
+		return( NULL );
 	}
 
+	return( s );
+}
+
+/**\brief Turn a decoded surface into this Image's texture
+ * \details This must run on the main thread.  Will free 's'.
+ */
+bool Image::Upload( SDL_Surface *s ) {
 	w = s->w;
 	h = s->h;
 
@@ -135,10 +289,32 @@ bool Image::Load( char *buf, int bufSize ) {
 		return( false );
 	}
 
-
 	return( true );
 }
 
+/**\brief Use a rectangle of another Image's texture
+ * \details This Image does not own the texture, so the sheet must outlive it.
+ *          This is how each frame of an atlas Animation is drawn without
+ *          giving every frame its own texture.
+ * \param sheet The Image containing every frame.
+ * \param x,y,w,h The rectangle (in pixels) within the sheet.
+ */
+void Image::UseRegion( Image *sheet, int x, int y, int w, int h ) {
+	assert( sheet );
+	assert( sheet->image );
+
+	this->sheet = sheet;
+	this->image = sheet->image;
+	this->w = w;
+	this->h = h;
+	real_w = sheet->real_w;
+	real_h = sheet->real_h;
+	offset_u = static_cast<float>(x) / static_cast<float>(real_w);
+	offset_v = static_cast<float>(y) / static_cast<float>(real_h);
+	scale_w = static_cast<float>(w) / static_cast<float>(real_w);
+	scale_h = static_cast<float>(h) / static_cast<float>(real_h);
+}
+
 /**\brief Draw the image (angle is in degrees)
  */
 void Image::Draw( int x, int y, float angle ) {
@@ -157,6 +333,19 @@ void Image::_Draw( int x, int y, float r, float g, float b, float alpha, float a
 	// the four rotated (if needed) corners of the image
 	float ulx, urx, llx, lrx, uly, ury, lly, lry;
 
+	if( loadJob && !AssetManager::Poll( loadJob ) ) {
+		return; // Still loading in the background.
+	}
+
+	if( evicted ) {
+		// Reload the texture in the background, it will be drawn next time.
+		evicted = false;
+		loadJob = new ImageJob( this, filepath );
+		AssetManager::Queue( loadJob );
+		return;
+	}
+	lastDrawn = SDL_GetTicks();
+
 	assert(image);
 	if( !image ) {
 		LogMsg(WARN, "Trying to draw without loading an image first." );
@@ -175,16 +364,20 @@ void Image::_Draw( int x, int y, float r, float g, float b, float alpha, float a
 	// calculate the coordinates of the quad	
 	// avoid trig when you can
 	if( angle != 0.f ) {
-		Trig *trig = Trig::Instance();
-		float a = (float)trig->DegToRad( angle );
+		float a = Trig::DegToRad( angle );
 		// ax/ay are the coordinate to rotate "about", hence "about points", "about x", "about y"
 		float ax = static_cast<float>(x + (w / 2.));
 		float ay = static_cast<float>(y + (h / 2.));
 
-		trig->RotatePoint( (float)x, (float)y + h, ax, ay, (float *)&ulx, (float *)&uly, a );
-		trig->RotatePoint( (float)x + w, (float)y + h, ax, ay, (float *)&urx, (float *)&ury, a );
-		trig->RotatePoint( (float)x, (float)y, ax, ay, (float *)&llx, (float *)&lly, a );
-		trig->RotatePoint( (float)x + w, (float)y, ax, ay, (float *)&lrx, (float *)&lry, a );
+		// All four corners turn by the same angle
+		float cornerX[4] = { (float)x, (float)x + w, (float)x, (float)x + w };
+		float cornerY[4] = { (float)y + h, (float)y + h, (float)y, (float)y };
+		float nx[4], ny[4];
+		Trig::RotatePoints( cornerX, cornerY, 4, ax, ay, nx, ny, a );
+		ulx = nx[0]; uly = ny[0];
+		urx = nx[1]; ury = ny[1];
+		llx = nx[2]; lly = ny[2];
+		lrx = nx[3]; lry = ny[3];
 	} else {
 		ulx = static_cast<float>(x);
 		urx = static_cast<float>(x + w);
@@ -211,11 +404,12 @@ void Image::_Draw( int x, int y, float r, float g, float b, float alpha, float a
 	float resize_h_delta = (h * resize_ratio_h) - h;
 
 	glBegin( GL_QUADS );
-	glTexCoord2f( 0., 0. ); glVertex2f( llx, lly );
-	glTexCoord2f( scale_w, 0. ); glVertex2f( lrx + resize_w_delta, lry );
-	glTexCoord2f( scale_w, scale_h ); glVertex2f( urx + resize_w_delta, ury + resize_h_delta );
-	glTexCoord2f( 0., scale_h ); glVertex2f( ulx, uly + resize_h_delta );
+	glTexCoord2f( offset_u, offset_v ); glVertex2f( llx, lly );
+	glTexCoord2f( offset_u + scale_w, offset_v ); glVertex2f( lrx + resize_w_delta, lry );
+	glTexCoord2f( offset_u + scale_w, offset_v + scale_h ); glVertex2f( urx + resize_w_delta, ury + resize_h_delta );
+	glTexCoord2f( offset_u, offset_v + scale_h ); glVertex2f( ulx, uly + resize_h_delta );
 	glEnd();
+	Video::CountDrawCall();
 
 	//glPopMatrix();
 
@@ -282,18 +476,23 @@ bool Image::ConvertToTexture( SDL_Surface *s ) {
 
 	// delete an old loaded image if one eixsts
 	if( image ) {
-		glDeleteTextures( 1, &image );
-		image = 0;
+		ReleaseTexture();
 
 		LogMsg(WARN, "Loading an image after another is loaded already. Deleting old ... " );
 	}
 
 	// Check to see if we need to expand the image
-	int expanded_w = PowerOfTwo(s->w);
-	int expanded_h = PowerOfTwo(s->h);
+	int expanded_w = s->w;
+	int expanded_h = s->h;
+	scale_w = scale_h = 1.;
+
+	if( !Video::HasNPOTTextures() ) {
+		expanded_w = PowerOfTwo(s->w);
+		expanded_h = PowerOfTwo(s->h);
 
-	if(expanded_w == 1) expanded_w = 2; // many cards won't accept 1 as a power of two
-	if(expanded_h == 1) expanded_h = 2;
+		if(expanded_w == 1) expanded_w = 2; // many cards won't accept 1 as a power of two
+		if(expanded_h == 1) expanded_h = 2;
+	}
 
 	if((expanded_w != s->w) || (expanded_h != s->h)) {
 		// Expand the canvas (needed)
@@ -309,6 +508,7 @@ bool Image::ConvertToTexture( SDL_Surface *s ) {
 	// check the pixel format, since it could depend on the file format:
 	GLenum internal_format;
  	GLenum img_format, img_type;
+	int texel_bytes;
 	switch (s->format->BitsPerPixel) {
 		case 32:
 			img_format = GL_RGBA;
@@ -316,21 +516,25 @@ bool Image::ConvertToTexture( SDL_Surface *s ) {
 				img_format = GL_BGRA;
 			img_type = GL_UNSIGNED_BYTE;
 			internal_format = GL_RGBA8;
+			texel_bytes = 4;
 			break;
 		case 24:
 			img_format = GL_RGB;
 			img_type = GL_UNSIGNED_BYTE;
 			internal_format = GL_RGB8;
+			texel_bytes = 3;
 			break;
 		case 16:
 			img_format = GL_RGBA;
 			img_type = GL_UNSIGNED_SHORT;
 			internal_format = GL_RGB5_A1;
+			texel_bytes = 2;
 			break;
 		default:
 			img_format = GL_LUMINANCE;
 			img_type = GL_UNSIGNED_BYTE;
 			internal_format=GL_LUMINANCE8;
+			texel_bytes = 1;
 			break;
 	}
 
@@ -349,12 +553,27 @@ bool Image::ConvertToTexture( SDL_Surface *s ) {
 
 	SDL_FreeSurface( s );
 
+	TrackTexture( real_w * real_h * texel_bytes );
+
 	return( true );
 }
 
 /**\brief Draw the image tiled to fill a rectangle of w/h - will crop to meet w/h and won't overflow
  */
 void Image::DrawTiled( int x, int y, int fill_w, int fill_h, float alpha ) {
+	if( loadJob && !AssetManager::Poll( loadJob ) ) {
+		return; // Still loading in the background.
+	}
+
+	if( evicted ) {
+		// Reload the texture in the background, it will be drawn next time.
+		evicted = false;
+		loadJob = new ImageJob( this, filepath );
+		AssetManager::Queue( loadJob );
+		return;
+	}
+	lastDrawn = SDL_GetTicks();
+
 	if( !image ) {
 		LogMsg(WARN, "Trying to draw without loading an image first." );
 		return;
@@ -383,13 +602,14 @@ void Image::DrawTiled( int x, int y, int fill_w, int fill_h, float alpha ) {
 	glBegin( GL_QUADS );
 	for( int j = 0; j < fill_h; j += h) {
 		for( int i = 0; i < fill_w; i += w) {
-			glTexCoord2f( 0., 0. ); glVertex2f( static_cast<GLfloat>(x+i), static_cast<GLfloat>(y+j) ); // Lower Left
-			glTexCoord2f( scale_w, 0. ); glVertex2f( static_cast<GLfloat>(x+w+i) , static_cast<GLfloat>(y+j)); // Lower Right
-			glTexCoord2f( scale_w, scale_h ); glVertex2f( static_cast<GLfloat>(x+w+i) , static_cast<GLfloat>(y+h+j) ); // Upper Right
-			glTexCoord2f( 0., scale_h ); glVertex2f( static_cast<GLfloat>(x+i), static_cast<GLfloat>(y+h+j) ); // Upper Left
+			glTexCoord2f( offset_u, offset_v ); glVertex2f( static_cast<GLfloat>(x+i), static_cast<GLfloat>(y+j) ); // Lower Left
+			glTexCoord2f( offset_u + scale_w, offset_v ); glVertex2f( static_cast<GLfloat>(x+w+i) , static_cast<GLfloat>(y+j)); // Lower Right
+			glTexCoord2f( offset_u + scale_w, offset_v + scale_h ); glVertex2f( static_cast<GLfloat>(x+w+i) , static_cast<GLfloat>(y+h+j) ); // Upper Right
+			glTexCoord2f( offset_u, offset_v + scale_h ); glVertex2f( static_cast<GLfloat>(x+i), static_cast<GLfloat>(y+h+j) ); // Upper Left
 		}
 	}
 	glEnd();
+	Video::CountDrawCall();
 
 	Video::UnsetCropRect();
 
@@ -439,6 +659,108 @@ SDL_Surface *Image::ExpandCanvas( SDL_Surface *s, int w, int h ) {
 	return( expanded );
 }
 
+/**\brief Count a new texture against the texture memory.
+ * \details If this goes over the options/video/texture-memory limit, the
+ *          least recently drawn Images are evicted.
+ */
+void Image::TrackTexture( int bytes ) {
+	if( category.empty() ) {
+		// Use the folder that this Image was loaded from.
+		string path = filepath;
+		if( path.find("Resources/") == 0 ) {
+			path = path.substr( strlen("Resources/") );
+		}
+		string::size_type slash = path.find('/');
+		category = (slash == string::npos) ? "Other" : path.substr( 0, slash );
+	}
+
+	textureBytes = bytes;
+	lastDrawn = SDL_GetTicks(); // Don't evict new textures before they are drawn
+	totalTextureBytes += bytes;
+	categoryTextureBytes[category] += bytes;
+	textured.insert( this );
+	textureChanges++;
+	Resized();
+
+	long limit = textureMemory * 1024 * 1024;
+	if( (limit > 0) && (totalTextureBytes > limit) ) {
+		EvictTextures( limit, this );
+	}
+}
+
+/**\brief Delete this Image's texture and stop counting it.
+ */
+void Image::ReleaseTexture( void ) {
+	if( image ) {
+		glDeleteTextures( 1, &image );
+		image = 0;
+		textureChanges++;
+	}
+	if( textured.erase( this ) ) {
+		totalTextureBytes -= textureBytes;
+		categoryTextureBytes[category] -= textureBytes;
+	}
+	textureBytes = 0;
+	Resized();
+}
+
+/**\brief Check if this Image's texture could be recreated later.
+ * \details Only Images loaded from a file can be reloaded.  Atlas sheets
+ *          have no file of their own, and their frames keep its texture.
+ */
+bool Image::CanEvict( void ) {
+	return ( image != 0 )
+	    && ( loadJob == NULL )
+	    && ( !filepath.empty() )
+	    && ( SDL_GetTicks() - lastDrawn > TEXTURE_EVICTION_GRACE );
+}
+
+/**\brief Sort Images from least to most recently drawn.
+ */
+bool Image::DrawnBefore( Image *a, Image *b ) {
+	return a->lastDrawn < b->lastDrawn;
+}
+
+/**\brief Free the least recently drawn textures until under the limit.
+ * \details Evicted Images keep their dimensions and reload their texture the
+ *          next time that they are drawn.  Images drawn very recently are
+ *          never evicted, so the limit may still be exceeded if they
+ *          are all in use.
+ * \param limit The maximum number of bytes of texture memory.
+ * \param keep An Image that must not be evicted.
+ */
+void Image::EvictTextures( long limit, Image *keep ) {
+	vector<Image*> candidates;
+	for( set<Image*>::iterator i = textured.begin(); i != textured.end(); ++i ) {
+		if( (*i != keep) && (*i)->CanEvict() ) {
+			candidates.push_back( *i );
+		}
+	}
+	sort( candidates.begin(), candidates.end(), Image::DrawnBefore );
+
+	int count = 0;
+	long before = totalTextureBytes;
+	for( vector<Image*>::iterator i = candidates.begin(); (i != candidates.end()) && (totalTextureBytes > limit); ++i ) {
+		(*i)->ReleaseTexture();
+		(*i)->evicted = true;
+		count++;
+	}
+
+	LogMsg(DEBUG1, "Evicted %d textures, freeing %ld bytes.", count, before - totalTextureBytes );
+	if( totalTextureBytes > limit ) {
+		LogMsg(WARN, "Using %ld bytes of texture memory, which is over the %ld byte limit.", totalTextureBytes, limit );
+	}
+}
+
+/**\brief Log the texture memory used by each category of Image.
+ */
+void Image::LogTextureMemory( void ) {
+	LogMsg(INFO, "Texture memory: %ld KB in %d textures.", totalTextureBytes / 1024, (int)textured.size() );
+	for( map<string,long>::iterator c = categoryTextureBytes.begin(); c != categoryTextureBytes.end(); ++c ) {
+		LogMsg(INFO, "\t%-12s %8ld KB", c->first.c_str(), c->second / 1024 );
+	}
+}
+
 /**\fn Image::GetWidth()
  *  \brief Returns width of image.
  * \fn Image::GetHeight()
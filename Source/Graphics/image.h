@@ -1,7 +1,7 @@
 /**\file			image.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Saturday, January 31, 2009
- * \date			Modified: Saturday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Image loading and display
  * \details
  * You don't have to worry about OpenGL's power of 2 image dimension requirements.
@@ -14,12 +14,15 @@
  * but the w/h is still effectively (at least as far as we care on the outside) whatever non-
  * power of two dimensions, and these effective, "fake" dimensions are called it's _virtual_
  * dimensions, or virtual width/height, stored in w, h.
+ * When the video card supports GL_ARB_texture_non_power_of_two, images are uploaded at
+ * their own size and the real and virtual dimensions are the same.
  */
 
 #ifndef __H_IMAGE__
 #define __H_IMAGE__
 
 #include "includes.h"
+#include "Utilities/assetmanager.h"
 #include "Utilities/resource.h"
 
 class Image : public Resource {
@@ -32,17 +35,24 @@ class Image : public Resource {
 		~Image();
 
 		static Image* Get(string filename);
+		static Image* GetAsync(string filename);
+		static ResourceHandle<Image> Acquire(string filename);
 
 		// Load image from file
 		bool Load( const string& filename );
 		// Load image from buffer
 		bool Load( char *buf, int bufSize );
 
+		// Check if the texture has been uploaded yet (never blocks)
+		bool IsReady( void );
+		// Block until a background load has finished
+		void Wait( void );
+
 		// Get information about image dimensions (always the virtual/effective size)
-		int GetWidth( void ) { return w; };
-		int GetHeight( void ) { return h; };
-		int GetHalfWidth( void ) { return w / 2; };
-		int GetHalfHeight( void ) { return h / 2; };
+		int GetWidth( void ) { if( loadJob ) Wait(); return w; };
+		int GetHeight( void ) { if( loadJob ) Wait(); return h; };
+		int GetHalfWidth( void ) { if( loadJob ) Wait(); return w / 2; };
+		int GetHalfHeight( void ) { if( loadJob ) Wait(); return h / 2; };
 
 		// Draw the image (angle in degrees)
 		void Draw( int x, int y, float angle = 0.f );
@@ -59,7 +69,33 @@ class Image : public Resource {
 
 		string GetPath(){return filepath;}
 
+		string GetTypeName( void ) { return "Image"; }
+		long GetMemorySize( void ) { return textureBytes; }
+
+		// Texture memory used by every Image (in bytes)
+		static long GetTextureMemory( void ) { return totalTextureBytes; }
+		static map<string,long> GetTextureMemoryByCategory( void ) { return categoryTextureBytes; }
+		static void LogTextureMemory( void );
+
+		// Counts textures being created or deleted
+		static Uint32 GetTextureChanges( void ) { return textureChanges; }
+
 	private:
+		friend class ImageJob;
+		friend class Ani;
+
+		// Find or start loading an Image in the background
+		static Image* Request( string filename );
+
+		// Decode an image file into a surface (safe to call from any thread)
+		static SDL_Surface *Decode( const string& filename );
+		// Decode an image buffer into a surface (safe to call from any thread)
+		static SDL_Surface *Decode( char *buf, int bufSize );
+		// Turn a decoded surface into this image's texture. Will free 's'.
+		bool Upload( SDL_Surface *s );
+		// Use a rectangle of another image's texture (used by atlas Animations)
+		void UseRegion( Image *sheet, int x, int y, int w, int h );
+
 		// Draw the image (angle in degrees)
 		void _Draw( int x, int y, float r, float g, float b, float alpha = 1.f, float angle = 0.f, float resize_ratio_w = 1.f, float resize_ratio_h = 1.f );
 
@@ -70,6 +106,13 @@ class Image : public Resource {
 		// Returns the next highest power of two if num is not a power of two
 		int PowerOfTwo(int num);
 
+		// Texture memory accounting
+		void TrackTexture( int bytes );
+		void ReleaseTexture( void );
+		bool CanEvict( void );
+		static void EvictTextures( long limit, Image *keep );
+		static bool DrawnBefore( Image *a, Image *b );
+
 		int w, h; // virtual w/h (effective, same as original file)
 		int real_w, real_h; // real w/h, size of expanded canvas (image) should expansion be needed
 		            //   to meet power of two requirements
@@ -77,8 +120,21 @@ class Image : public Resource {
 		                        // the larger canvas actually contains the original image (<= 1.0)
 		                        // defaults = 1.0, this factor is always used, so non-expanded images are
 		                        // simply "scaled" at 1.0. THIS HAS NOTHING TO DO WITH RESIZE()
+		float offset_u, offset_v; // texture coordinate of the upper-left corner, non-zero for atlas regions
 		GLuint image; // OpenGL pointer to texture
+		Image *sheet; // the Image that owns 'image' when this is only a region of it, or NULL
 		string filepath;
+		AssetJob *loadJob; // The pending background load, or NULL
+
+		string category; // which texture memory category this belongs to
+		int textureBytes; // the texture memory used by this image
+		Uint32 lastDrawn; // ticks when this was last drawn, used to evict textures
+		bool evicted; // the texture was freed to save memory and should be reloaded when drawn
+
+		static long totalTextureBytes;
+		static map<string,long> categoryTextureBytes;
+		static set<Image*> textured; // every Image that owns a texture
+		static Uint32 textureChanges; // textures created or deleted so far
 };
 
 #endif // __H_IMAGE__
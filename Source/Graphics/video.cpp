@@ -13,6 +13,12 @@
 #include "Utilities/xml.h"
 #include "Utilities/trig.h"
 
+static Option<int> videoWidth( "options/video/w" );
+static Option<int> videoHeight( "options/video/h" );
+static Option<int> videoBPP( "options/video/bpp" );
+static Option<int> videoFullscreen( "options/video/fullscreen" );
+static Option<int> videoNPOT( "options/video/npot-textures" );
+
 /**\class Color
  * \brief RGB coloring
  * \var Color::r
@@ -136,6 +142,58 @@ Color Color::operator*(float ratio)
  *  \brief height
  */
 
+// GL_EXT_framebuffer_object, loaded at runtime since it is not in GL 1.1
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#define EPIAR_GL_FRAMEBUFFER           0x8D40
+#define EPIAR_GL_RENDERBUFFER          0x8D41
+#define EPIAR_GL_COLOR_ATTACHMENT0     0x8CE0
+#define EPIAR_GL_DEPTH_ATTACHMENT      0x8D00
+#define EPIAR_GL_FRAMEBUFFER_COMPLETE  0x8CD5
+#define EPIAR_GL_DEPTH_COMPONENT24     0x81A6
+
+typedef void (APIENTRY *GenBuffersFunc)( GLsizei n, GLuint *ids );
+typedef void (APIENTRY *DeleteBuffersFunc)( GLsizei n, const GLuint *ids );
+typedef void (APIENTRY *BindBufferFunc)( GLenum target, GLuint id );
+typedef void (APIENTRY *RenderbufferStorageFunc)( GLenum target, GLenum format, GLsizei w, GLsizei h );
+typedef void (APIENTRY *FramebufferRenderbufferFunc)( GLenum target, GLenum attachment, GLenum rbtarget, GLuint rb );
+typedef GLenum (APIENTRY *CheckFramebufferStatusFunc)( GLenum target );
+
+static GenBuffersFunc glGenFramebuffersEXT_ = NULL;
+static DeleteBuffersFunc glDeleteFramebuffersEXT_ = NULL;
+static BindBufferFunc glBindFramebufferEXT_ = NULL;
+static GenBuffersFunc glGenRenderbuffersEXT_ = NULL;
+static DeleteBuffersFunc glDeleteRenderbuffersEXT_ = NULL;
+static BindBufferFunc glBindRenderbufferEXT_ = NULL;
+static RenderbufferStorageFunc glRenderbufferStorageEXT_ = NULL;
+static FramebufferRenderbufferFunc glFramebufferRenderbufferEXT_ = NULL;
+static CheckFramebufferStatusFunc glCheckFramebufferStatusEXT_ = NULL;
+
+/**\brief Find the framebuffer object functions.
+ * \returns false if the driver does not support GL_EXT_framebuffer_object.
+ */
+static bool LoadFramebufferFunctions( void ) {
+	const char *extensions = reinterpret_cast<const char*>( glGetString( GL_EXTENSIONS ) );
+	if( (extensions == NULL) || (strstr( extensions, "GL_EXT_framebuffer_object" ) == NULL) ) {
+		return false;
+	}
+
+	glGenFramebuffersEXT_ = (GenBuffersFunc) SDL_GL_GetProcAddress( "glGenFramebuffersEXT" );
+	glDeleteFramebuffersEXT_ = (DeleteBuffersFunc) SDL_GL_GetProcAddress( "glDeleteFramebuffersEXT" );
+	glBindFramebufferEXT_ = (BindBufferFunc) SDL_GL_GetProcAddress( "glBindFramebufferEXT" );
+	glGenRenderbuffersEXT_ = (GenBuffersFunc) SDL_GL_GetProcAddress( "glGenRenderbuffersEXT" );
+	glDeleteRenderbuffersEXT_ = (DeleteBuffersFunc) SDL_GL_GetProcAddress( "glDeleteRenderbuffersEXT" );
+	glBindRenderbufferEXT_ = (BindBufferFunc) SDL_GL_GetProcAddress( "glBindRenderbufferEXT" );
+	glRenderbufferStorageEXT_ = (RenderbufferStorageFunc) SDL_GL_GetProcAddress( "glRenderbufferStorageEXT" );
+	glFramebufferRenderbufferEXT_ = (FramebufferRenderbufferFunc) SDL_GL_GetProcAddress( "glFramebufferRenderbufferEXT" );
+	glCheckFramebufferStatusEXT_ = (CheckFramebufferStatusFunc) SDL_GL_GetProcAddress( "glCheckFramebufferStatusEXT" );
+
+	return glGenFramebuffersEXT_ && glDeleteFramebuffersEXT_ && glBindFramebufferEXT_
+	    && glGenRenderbuffersEXT_ && glDeleteRenderbuffersEXT_ && glBindRenderbufferEXT_
+	    && glRenderbufferStorageEXT_ && glFramebufferRenderbufferEXT_ && glCheckFramebufferStatusEXT_;
+}
+
 /**\class Video
  * \brief Video handling. */
 
@@ -145,6 +203,14 @@ int Video::w2 = 0;
 int Video::h2 = 0;
 stack<Rect> Video::cropRects;
 SDL_Surface *Video::screen = NULL;
+bool Video::npotTextures = false;
+bool Video::offscreen = false;
+GLuint Video::offscreenFramebuffer = 0;
+GLuint Video::offscreenColor = 0;
+GLuint Video::offscreenDepth = 0;
+int Video::windowW = 0;
+int Video::windowH = 0;
+Uint32 Video::drawCalls = 0;
 
 /**\brief Initializes the Video display.
  */
@@ -166,22 +232,22 @@ bool Video::Initialize( void ) {
 
 	videoInfo = SDL_GetVideoInfo();
 
-	int w = OPTION( int, "options/video/w" );
-	int h = OPTION( int, "options/video/h" );
-	bool fullscreen = OPTION( bool, "options/video/fullscreen" );
+	int w = videoWidth;
+	int h = videoHeight;
+	bool fullscreen = (videoFullscreen != 0);
 
 	// Sanitize Width and Height
 	// TODO: Surely 0 is invalid, but what's the lower limit?
 	if( (w <= 0) || (w > videoInfo->current_w) ) { w = videoInfo->current_w; }
 	if( (h <= 0) || (h > videoInfo->current_w) ) { h = videoInfo->current_h; }
 
-	if( OPTION( int, "options/video/fullscreen" ) ) {
+	if( videoFullscreen ) {
 		// fullscreen set, use native resolution
 		w = videoInfo->current_w;
 		h = videoInfo->current_h;
 	}
 
-	Video::SetWindow( w, h, OPTION( int, "options/video/bpp"), fullscreen );
+	Video::SetWindow( w, h, videoBPP, fullscreen );
 	
 	return( true );
 }
@@ -277,11 +343,27 @@ bool Video::SetWindow( int w, int h, int bpp, bool fullscreen ) {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	// check if images need to be padded to a power of two
+	const char *extensions = reinterpret_cast<const char*>( glGetString( GL_EXTENSIONS ) );
+	npotTextures = ( extensions != NULL )
+	            && ( strstr( extensions, "GL_ARB_texture_non_power_of_two" ) != NULL )
+	            && videoNPOT;
+	LogMsg(INFO, "Non power of two textures are %s.", npotTextures ? "enabled" : "disabled" );
+
 	// for motion blur
 	glClearAccum(0.0, 0.0, 0.0, 1.0);
 	glClear(GL_ACCUM_BUFFER_BIT);
 
-	// set up a pseudo-2D viewpoint
+	SetViewport( w, h );
+
+	LogMsg(INFO, "Video mode initialized at %dx%dx%d\n", screen->w, screen->h, screen->format->BitsPerPixel );
+
+	return( true );
+}
+
+/**\brief Set up a pseudo-2D viewpoint covering w by h pixels.
+ */
+void Video::SetViewport( int w, int h ) {
 	glViewport( 0, 0, w, h );
 	glMatrixMode( GL_PROJECTION );
 	glLoadIdentity();
@@ -295,12 +377,78 @@ bool Video::SetWindow( int w, int h, int bpp, bool fullscreen ) {
 	// compute the half dimensions
 	w2 = w / 2;
 	h2 = h / 2;
+}
 
-	LogMsg(INFO, "Video mode initialized at %dx%dx%d\n", screen->w, screen->h, screen->format->BitsPerPixel );
+/**\brief Draw into an offscreen target instead of the window.
+ * \details Update() will no longer swap the window's buffers, so nothing is
+ *          shown while drawing offscreen.  Use CaptureSurface() to read back
+ *          what was drawn.
+ *
+ *          When the driver supports framebuffer objects the target is exactly
+ *          w by h pixels.  Otherwise the window's back buffer is used, and the
+ *          target is clipped to the size of the window.
+ * \sa UnsetOffscreen
+ */
+bool Video::SetOffscreen( int w, int h ) {
+	if( offscreen ) {
+		UnsetOffscreen();
+	}
+
+	windowW = Video::w;
+	windowH = Video::h;
+
+	if( LoadFramebufferFunctions() ) {
+		glGenFramebuffersEXT_( 1, &offscreenFramebuffer );
+		glBindFramebufferEXT_( EPIAR_GL_FRAMEBUFFER, offscreenFramebuffer );
 
+		glGenRenderbuffersEXT_( 1, &offscreenColor );
+		glBindRenderbufferEXT_( EPIAR_GL_RENDERBUFFER, offscreenColor );
+		glRenderbufferStorageEXT_( EPIAR_GL_RENDERBUFFER, GL_RGBA8, w, h );
+		glFramebufferRenderbufferEXT_( EPIAR_GL_FRAMEBUFFER, EPIAR_GL_COLOR_ATTACHMENT0, EPIAR_GL_RENDERBUFFER, offscreenColor );
+
+		glGenRenderbuffersEXT_( 1, &offscreenDepth );
+		glBindRenderbufferEXT_( EPIAR_GL_RENDERBUFFER, offscreenDepth );
+		glRenderbufferStorageEXT_( EPIAR_GL_RENDERBUFFER, EPIAR_GL_DEPTH_COMPONENT24, w, h );
+		glFramebufferRenderbufferEXT_( EPIAR_GL_FRAMEBUFFER, EPIAR_GL_DEPTH_ATTACHMENT, EPIAR_GL_RENDERBUFFER, offscreenDepth );
+
+		if( glCheckFramebufferStatusEXT_( EPIAR_GL_FRAMEBUFFER ) == EPIAR_GL_FRAMEBUFFER_COMPLETE ) {
+			offscreen = true;
+			SetViewport( w, h );
+			LogMsg(INFO, "Drawing to a %dx%d offscreen framebuffer.", w, h );
+			return( true );
+		}
+
+		LogMsg(WARN, "The offscreen framebuffer is incomplete." );
+		UnsetOffscreen();
+	}
+
+	// Fall back to the back buffer, which is never swapped while offscreen.
+	if( w > windowW ) w = windowW;
+	if( h > windowH ) h = windowH;
+	offscreen = true;
+	glDrawBuffer( GL_BACK );
+	glReadBuffer( GL_BACK );
+	SetViewport( w, h );
+	LogMsg(WARN, "Framebuffer objects are not supported, drawing %dx%d offscreen in the back buffer.", w, h );
 	return( true );
 }
 
+/**\brief Resume drawing to the window.
+ */
+void Video::UnsetOffscreen( void ) {
+	if( offscreenFramebuffer ) {
+		glBindFramebufferEXT_( EPIAR_GL_FRAMEBUFFER, 0 );
+		glDeleteRenderbuffersEXT_( 1, &offscreenColor );
+		glDeleteRenderbuffersEXT_( 1, &offscreenDepth );
+		glDeleteFramebuffersEXT_( 1, &offscreenFramebuffer );
+		offscreenFramebuffer = offscreenColor = offscreenDepth = 0;
+	}
+	if( offscreen || (windowW != 0) ) {
+		SetViewport( windowW, windowH );
+	}
+	offscreen = false;
+}
+
 /**\brief Register Lua functions for Video related operations.
  */
 void Video::RegisterVideo(lua_State *L) {
@@ -333,7 +481,9 @@ int Video::lua_getHeight(lua_State *L) {
  */
 void Video::Update( void ) {
 	glFlush();
-	SDL_GL_SwapBuffers();
+	if( !offscreen ) {
+		SDL_GL_SwapBuffers();
+	}
 	//glAccum(GL_ACCUM, 0.8f);
 	glFinish();
 }
@@ -394,6 +544,7 @@ void Video::DrawPoint( int x, int y, float r, float g, float b ) {
 	glDisable(GL_TEXTURE_2D);
 	glColor3f( r, g, b );
 	glRecti( x, y, x + 1, y + 1 );
+	CountDrawCall();
 }
 
 /**\brief Draw a point using Coordinate and Color.
@@ -422,6 +573,7 @@ void Video::DrawLine( int x1, int y1, int x2, int y2, float r, float g, float b,
 	glVertex2d(x1,y1);
 	glVertex2d(x2,y2);
 	glEnd();
+	CountDrawCall();
 }
 
 
@@ -432,6 +584,7 @@ void Video::DrawRect( int x, int y, int w, int h, float r, float g, float b, flo
 	glEnable(GL_BLEND);
 	glColor4f( r, g, b, a );
 	glRecti( x, y, x + w, y + h );
+	CountDrawCall();
 }
 
 void Video::DrawRect( int x, int y, int w, int h, Color c, float a ) {
@@ -459,7 +612,28 @@ void Video::DrawBox( int x, int y, int w, int h, float r, float g, float b, floa
 	glVertex2d(x,y+h);
 	glVertex2d(x,y);
 	glEnd();
+	CountDrawCall();
+
+}
+
+#define CIRCLE_POINTS 72 ///< One every 5 degrees
 
+/**\brief The points around a circle with a radius of 1.
+ * \details Every circle is drawn from these, so they are only found once.
+ */
+static void GetUnitCircle( const float **circleX, const float **circleY ) {
+	static float pointX[CIRCLE_POINTS], pointY[CIRCLE_POINTS];
+	static bool ready = false;
+	if( !ready ) {
+		float angles[CIRCLE_POINTS];
+		for( int p = 0; p < CIRCLE_POINTS; p++ ) {
+			angles[p] = Trig::DegToRad( static_cast<float>( p * 5 ) );
+		}
+		Trig::SinCos( angles, pointY, pointX, CIRCLE_POINTS );
+		ready = true;
+	}
+	*circleX = pointX;
+	*circleY = pointY;
 }
 
 /**\brief Draws a circle.
@@ -481,14 +655,16 @@ void Video::DrawCircle( int x, int y, int radius, float line_width, float r, flo
 	glColor4f( r, g, b, a );
 	glLineWidth(line_width);
 	glBegin(GL_LINE_STRIP);
-	Trig* t = Trig::Instance();
-	for(int angle = 0; angle < 360; angle += 5)
+	const float *circleX, *circleY;
+	GetUnitCircle( &circleX, &circleY );
+	for(int p = 0; p < CIRCLE_POINTS; p++)
 	{
-		glVertex2d(radius * t->GetCos(angle) + x, radius * t->GetSin(angle) + y);
+		glVertex2f(radius * circleX[p] + x, radius * circleY[p] + y);
 	}
 	// One more point to finish the circle. (ang=0)
 	glVertex2d(radius + x, y);
 	glEnd();
+	CountDrawCall();
 	// Reset Line Width
 	glLineWidth(1);
 }
@@ -507,16 +683,18 @@ void Video::DrawFilledCircle( int x, int y, int radius, float r, float g, float
 	glColor4f(r,g,b,a);
 	glEnable(GL_BLEND);
 	glBegin(GL_TRIANGLE_STRIP);
-	Trig* t = Trig::Instance();
-	for(int angle = 0; angle < 360; angle += 5)
+	const float *circleX, *circleY;
+	GetUnitCircle( &circleX, &circleY );
+	for(int p = 0; p < CIRCLE_POINTS; p++)
 	{
 		glVertex2d(x,y);
-		glVertex2d(radius * t->GetCos(angle) + x, radius * t->GetSin(angle) + y);
+		glVertex2f(radius * circleX[p] + x, radius * circleY[p] + y);
 	}
 	// One more triangle to finish the circle. (ang=0)
 	glVertex2d(x,y);
 	glVertex2d(radius + x, y);
 	glEnd();
+	CountDrawCall();
 }
 
 /**\brief Draws a targeting overlay.
@@ -538,6 +716,7 @@ void Video::DrawTarget( int x, int y, int w, int h, int d, float r, float g, flo
 		glVertex2d(x+w/2,y+h/2); glVertex2d(x+w/2,y+h/2-d);
 		glVertex2d(x+w/2,y+h/2); glVertex2d(x+w/2-d,y+h/2);
 	glEnd();
+	CountDrawCall();
 }
 
 /**\brief Enables the mouse
@@ -619,6 +798,91 @@ void Video::UnsetCropRect( void ) {
 	}
 }
 
+/**\brief The area that drawing is currently cropped to.
+ * \returns The whole screen when nothing is cropped.
+ */
+Rect Video::GetCropRect( void ) {
+	if( cropRects.empty() ) {
+		return Rect( 0, 0, w, h );
+	}
+	return cropRects.top();
+}
+
+/**\class LineBatch
+ * \brief Lines, points and circles that are drawn together.
+ * \details Every shape is added as one pixel wide lines, and Draw() sends
+ *          all of them to OpenGL as a single vertex array instead of one
+ *          glBegin and glEnd for each shape.  The arrays are kept between
+ *          frames, so Clear() does not free them.
+ */
+
+/**\brief Remove every line, but keep the memory for the next frame.
+ */
+void LineBatch::Clear( void ) {
+	vertices.clear();
+	colors.clear();
+}
+
+/**\brief Add one end of a line.
+ */
+void LineBatch::AddVertex( float x, float y, Color c, float a ) {
+	vertices.push_back( x );
+	vertices.push_back( y );
+	colors.push_back( c.r );
+	colors.push_back( c.g );
+	colors.push_back( c.b );
+	colors.push_back( a );
+}
+
+/**\brief Add a line.
+ */
+void LineBatch::AddLine( float x1, float y1, float x2, float y2, Color c, float a ) {
+	AddVertex( x1, y1, c, a );
+	AddVertex( x2, y2, c, a );
+}
+
+/**\brief Add a single pixel, the same one that Video::DrawPoint fills.
+ */
+void LineBatch::AddPoint( int x, int y, Color c, float a ) {
+	AddLine( TO_FLOAT(x), y + 0.5f, x + 1.0f, y + 0.5f, c, a );
+}
+
+/**\brief Add a circle with the same points as Video::DrawCircle.
+ */
+void LineBatch::AddCircle( int x, int y, int radius, Color c, float a ) {
+	const float *circleX, *circleY;
+	GetUnitCircle( &circleX, &circleY );
+	float lastX = radius + TO_FLOAT(x);
+	float lastY = TO_FLOAT(y);
+	for( int p = 1; p <= CIRCLE_POINTS; p++ ) {
+		// The last line goes back to the first point (ang=0)
+		float nextX = radius * circleX[p % CIRCLE_POINTS] + x;
+		float nextY = radius * circleY[p % CIRCLE_POINTS] + y;
+		AddLine( lastX, lastY, nextX, nextY, c, a );
+		lastX = nextX;
+		lastY = nextY;
+	}
+}
+
+/**\brief Draw every line in one call.
+ */
+void LineBatch::Draw( void ) {
+	if( vertices.empty() ) {
+		return;
+	}
+	glDisable(GL_TEXTURE_2D);
+	glEnable(GL_BLEND);
+	glLineWidth(1);
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+	glVertexPointer( 2, GL_FLOAT, 0, &vertices[0] );
+	glColorPointer( 4, GL_FLOAT, 0, &colors[0] );
+	glDrawArrays( GL_LINES, 0, static_cast<GLsizei>( vertices.size() / 2 ) );
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+	Video::CountDrawCall();
+}
+
 /**\brief Takes a screenshot of the game and saves it to an Image.
  */
 Image *Video::CaptureScreen( void ) {
@@ -635,36 +899,51 @@ Image *Video::CaptureScreen( void ) {
 	return( screenshot );
 }
 
+/**\brief Reads back what has been drawn.
+ * \details The surface is 32 bit RGBA with the top row first.  The caller
+ *          must free it with SDL_FreeSurface.
+ */
+SDL_Surface *Video::CaptureSurface( void ) {
+	Uint32 rmask, gmask, bmask, amask;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	rmask = 0xff000000; gmask = 0x00ff0000; bmask = 0x0000ff00; amask = 0x000000ff;
+#else
+	rmask = 0x000000ff; gmask = 0x0000ff00; bmask = 0x00ff0000; amask = 0xff000000;
+#endif
+
+	SDL_Surface *s = SDL_CreateRGBSurface( SDL_SWSURFACE, w, h, 32, rmask, gmask, bmask, amask );
+	if( s == NULL ) {
+		LogMsg(ERR, "Could not create a %dx%d capture surface: %s", w, h, SDL_GetError() );
+		return( NULL );
+	}
+
+	unsigned char *pixels = new unsigned char[ w * h * 4 ];
+	glPixelStorei( GL_PACK_ROW_LENGTH, 0 );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	glReadPixels( 0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels );
+
+	// OpenGL reads from the bottom row up
+	SDL_LockSurface( s );
+	for( int y = 0; y < h; y++ ) {
+		memcpy( (Uint8*)s->pixels + y * s->pitch, pixels + (h - 1 - y) * w * 4, w * 4 );
+	}
+	SDL_UnlockSurface( s );
+
+	delete [] pixels;
+	return( s );
+}
+
 /**\brief Takes a screenshot of the game and saves it to a file.
  */
 void Video::SaveScreenshot( string filename ) {
-	unsigned int size = w * h * 4;
-	int *pixelData, *pixelDataOrig;
-
-	pixelData = (int *)malloc( size );
-	pixelDataOrig = (int *)malloc( size );
-	memset( pixelData, 0, size );
-	memset( pixelDataOrig, 0, size );
-
-	glPixelStorei( GL_PACK_ROW_LENGTH, 0 ) ;
-	glPixelStorei( GL_PACK_ALIGNMENT, 1 ) ;
-	glReadPixels( 0, 0, w, h, GL_BGRA, GL_UNSIGNED_BYTE, pixelDataOrig ) ;
-
-	// image if flipped vertically - fix this
-	for(int x = 1; x < w; x++) {
-		for(int y = 1; y < h; y++) {
-			pixelData[x + (y * w)] = pixelDataOrig[x + ((h-y) * w)];
-		}
+	SDL_Surface *s = CaptureSurface();
+	if( s == NULL ) {
+		return;
 	}
 
-	SDL_Surface *s = SDL_CreateRGBSurfaceFrom( pixelData, w, h, screen->format->BitsPerPixel, screen->pitch, screen->format->Rmask, screen->format->Gmask, screen->format->Bmask, screen->format->Amask);
-
 	if( filename == "" ) filename = string("Screenshot_") + Log::GetTimestamp() + string(".bmp");
 
 	SDL_SaveBMP( s, filename.c_str() );
 
 	SDL_FreeSurface( s );
-	free( pixelData );
-	free( pixelDataOrig );
 }
-
@@ -1,7 +1,7 @@
 /**\file			video.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -77,6 +77,16 @@ class Video {
   		static void EnableMouse( void );
   		static void DisableMouse( void );
 
+		static bool HasNPOTTextures( void ) { return npotTextures; }
+
+		static bool SetOffscreen( int w, int h );
+		static void UnsetOffscreen( void );
+		static bool IsOffscreen( void ) { return offscreen; }
+
+		static void CountDrawCall( void ) { drawCalls++; }
+		static Uint32 GetDrawCalls( void ) { return drawCalls; }
+		static void ResetDrawCalls( void ) { drawCalls = 0; }
+
 		static int GetWidth( void );
 		static int GetHalfWidth( void );
 		static int GetHeight( void );
@@ -103,10 +113,12 @@ class Video {
 
 		static void SetCropRect( int x, int y, int w, int h );
 		static void UnsetCropRect( void );
+		static Rect GetCropRect( void );
 		
 		static void Blur( void );
 
 		static Image *CaptureScreen( void );
+		static SDL_Surface *CaptureSurface( void );
 		static void SaveScreenshot( string filename = "" );
 
 		// Lua functions
@@ -118,6 +130,32 @@ class Video {
 		static int w2, h2; // width/height divided by 2
 		static stack<Rect> cropRects;
 		static SDL_Surface *screen; // pointer to main video surface
+		static bool npotTextures; // can textures have non power of two dimensions
+
+		static void SetViewport( int w, int h );
+
+		static bool offscreen; // drawing to an offscreen target rather than the window
+		static GLuint offscreenFramebuffer; // 0 when drawing to the back buffer
+		static GLuint offscreenColor, offscreenDepth; // offscreen renderbuffers
+		static int windowW, windowH; // size of the window while drawing offscreen
+		static Uint32 drawCalls; // primitives submitted since the last ResetDrawCalls
+};
+
+class LineBatch {
+	public:
+		void Clear( void );
+		void AddLine( float x1, float y1, float x2, float y2, Color c, float a = 1.0f );
+		void AddPoint( int x, int y, Color c, float a = 1.0f );
+		void AddCircle( int x, int y, int radius, Color c, float a = 1.0f );
+		void Draw( void );
+
+		int GetLineCount( void ) { return static_cast<int>( vertices.size() / 4 ); }
+
+	private:
+		void AddVertex( float x, float y, Color c, float a );
+
+		vector<float> vertices; ///< x,y for each end of each line
+		vector<float> colors; ///< r,g,b,a for each end of each line
 };
 
 #endif // __H_VIDEO__
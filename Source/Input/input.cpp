@@ -15,6 +15,8 @@
 #include "Graphics/video.h"
 #include "Utilities/timer.h"
 
+static Option<Uint32> mouseFade( "options/timing/mouse-fade" );
+
 /**\class Input
  * \brief Processor for the Users mouse and keyboard actions
  * \details The Input polls SDL for any new events on every Update.
@@ -124,7 +126,7 @@ list<InputEvent> Input::Update( ) {
 			events.push_back( InputEvent( KEY, KEYPRESSED, k ) );
 	}
 
-	if((Timer::GetTicks() - lastMouseMove > OPTION(Uint32,"options/timing/mouse-fade")) ){
+	if((Timer::GetTicks() - lastMouseMove > mouseFade) ){
 		Video::DisableMouse();
 	}
 	
@@ -1,7 +1,7 @@
 /**\file			ai.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -9,11 +9,15 @@
 #include "includes.h"
 #include "common.h"
 #include "Sprites/ai.h"
+#include "Sprites/planets.h"
 #include "Sprites/player.h"
 #include "Sprites/spritemanager.h"
 #include "Utilities/lua.h"
+#include "Engine/mission.h"
 #include "Engine/simulation_lua.h"
 
+static Option<int> debugAI( "options/development/debug-ai" );
+
 /** \addtogroup Sprites
  * @{
  */
@@ -140,6 +144,8 @@ void AI::Update( lua_State *L ) {
 void AI::Killed( lua_State *L ) {
 	LogMsg( WARN, "AI %s has been killed\n", GetName().c_str() );
 	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
+	Mission::Post( MISSION_SHIP_DESTROYED, GetID() );
+	Lua::Call( "forgetShip", "i", GetID() );
 
 	Sprite* killer = sprites->GetSpriteByID( target );
 	if(killer != NULL) {
@@ -149,6 +155,28 @@ void AI::Killed( lua_State *L ) {
 	}
 }
 
+/**\brief Reuse a ship that is no longer needed as a new ship of a Planet.
+ * \details The ship gets a new ID so that nothing mistakes it for the old
+ *          ship.  It is repaired, stopped, stripped of its equipment and joins
+ *          the Alliance of the Planet.  The Lua function recycleShipForPlanet
+ *          must then give it a new pilot, Model, Engine and State Machine.
+ *
+ *          The ship must not be in the SpriteManager while this is called.
+ * \see Traffic
+ */
+void AI::Recycle( Planet *planet, Coordinate position ) {
+	Renumber();
+	SetWorldPosition( position );
+	SetMomentum( Coordinate( 0, 0 ) );
+	SetHullDamage( 0 );
+	SetShieldDamage( 0 );
+	ClearEquipment();
+	allegiance = planet->GetAlliance();
+	target = 0;
+	enemies.clear();
+	merciful = false;
+	state = "default";
+}
 
 /**\brief Draw the AI Ship, and possibly debugging information.
  *
@@ -159,7 +187,7 @@ void AI::Killed( lua_State *L ) {
  */
 void AI::Draw(){
 	this->Ship::Draw();
-	if( OPTION(int,"options/development/debug-ai") ) {
+	if( debugAI ) {
 		Coordinate position = this->GetWorldPosition();
 		SansSerif->SetColor( WHITE );
 		SansSerif->Render(position.GetScreenX(),position.GetScreenY()+GetImage()->GetHalfHeight(),stateMachine);
@@ -167,6 +195,48 @@ void AI::Draw(){
 	}
 }
 
+/**\brief Write the Ship state along with the pilot and its state machine.
+ */
+void AI::Snapshot( BinaryWriter& out ) {
+	Ship::Snapshot( out );
+
+	out.WriteString( name );
+	out.WriteString( allegiance ? allegiance->GetName() : "" );
+	out.WriteString( stateMachine );
+	out.WriteString( state );
+	out.WriteInt( target );
+	out.WriteBool( merciful );
+	out.WriteUint( enemies.size() );
+	for( list<enemy>::iterator e = enemies.begin(); e != enemies.end(); ++e ) {
+		out.WriteInt( e->damage );
+		out.WriteInt( e->id );
+	}
+}
+
+/**\brief Read the state written by Snapshot.
+ */
+bool AI::Restore( BinaryReader& in ) {
+	if( !Ship::Restore( in ) ) {
+		return false;
+	}
+
+	name = in.ReadString();
+	string alliance = in.ReadString();
+	allegiance = (alliance == "") ? NULL : Alliances::Instance()->GetAlliance( alliance );
+	stateMachine = in.ReadString();
+	state = in.ReadString();
+	target = in.ReadInt();
+	merciful = in.ReadBool();
+	enemies.clear();
+	Uint32 count = in.ReadUint();
+	for( Uint32 i = 0; (i < count) && !in.Failed(); i++ ) {
+		enemy e;
+		e.damage = in.ReadInt();
+		e.id = in.ReadInt();
+		enemies.push_back( e );
+	}
+	return !in.Failed();
+}
 
 /**\brief chooses who the AI should target given the list of the AI's enemies
  *
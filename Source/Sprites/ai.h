@@ -1,7 +1,7 @@
 /**\file			ai.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -13,6 +13,8 @@
 #include "Engine/alliances.h"
 #include "includes.h"
 
+class Planet;
+
 #define COMBAT_RANGE 1000 ///< Radius of ships involved in any specific battle
 #define COMBAT_RANGE_SQUARED (COMBAT_RANGE*COMBAT_RANGE) ///< Used for fast range checking.
 
@@ -23,6 +25,8 @@ class AI : public Ship {
 		// Overloaded Sprite Mechanics:
 		void Update( lua_State *L );
 		void Draw();
+		void Snapshot( BinaryWriter& out );
+		bool Restore( BinaryReader& in );
 
 		// Flavor Mechanics:
 
@@ -52,6 +56,7 @@ class AI : public Ship {
 		int GetMerciful() { return (merciful ? 1 : 0 ); }
 
 		void Killed( lua_State *L );
+		void Recycle( Planet *planet, Coordinate position );
 
 	private:
 		string name; ///< The AI's name.  This should be the name of the ship's pilot.
@@ -1,7 +1,7 @@
 /**\file			ai_lua.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Thursday, October 29, 2009
- * \date			Modified: Monday, November 16 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Lua Bridge for AI objects
  * \details
  */
@@ -20,6 +20,8 @@
 #include "Engine/commodities.h"
 #include "Engine/simulation_lua.h"
 
+static Option<int> soundExplosions( "options/sound/explosions" );
+
 /**\class AI_Lua
  * \brief Lua bridge for AI.*/
 
@@ -341,7 +343,7 @@ int AI_Lua::ShipExplode(lua_State* L){
 		LogMsg(INFO,"A %s Exploded!",(ai)->GetModelName().c_str());
 		// Play explode sound
 		Sound *explodesnd = Sound::Get("Resources/Audio/Effects/18384__inferno__largex.wav.ogg");
-		if(OPTION(int, "options/sound/explosions"))
+		if(soundExplosions)
 			explodesnd->Play(
 				(ai)->GetWorldPosition() - Simulation_Lua::GetSimulation(L)->GetCamera()->GetFocusCoordinate());
 		Simulation_Lua::GetSimulation(L)->GetSpriteManager()->Add(
@@ -988,7 +990,7 @@ int AI_Lua::ShipGetDirectionTowards(lua_State* L){
  * \sa Ship::getWeapons()
  */
 int AI_Lua::ShipGetWeapons(lua_State* L){
-	vector<Weapon*>::iterator iter;
+	vector<Weapon*>::const_iterator iter;
 	int newTable;
 	int n = lua_gettop(L);  // Number of arguments
 	unsigned int w;
@@ -1000,7 +1002,7 @@ int AI_Lua::ShipGetWeapons(lua_State* L){
 		return 0;
 	}
 
-	vector<Weapon*>* weapons = (ai)->GetWeapons();
+	const vector<Weapon*>* weapons = (ai)->GetWeapons();
 	lua_createtable(L, weapons->size(), 0);
 	newTable = lua_gettop(L);
 	for( w = 0; w < weapons->size(); ++w )
@@ -1224,7 +1226,7 @@ int AI_Lua::ShipGetCargo(lua_State* L){
  * \sa Ship::getOutfit()
  */
 int AI_Lua::ShipGetOutfits(lua_State* L){
-	list<Outfit*>::iterator iter;
+	list<Outfit*>::const_iterator iter;
 	int newTable, tableIndex;
 	int n = lua_gettop(L);  // Number of arguments
 
@@ -1236,7 +1238,7 @@ int AI_Lua::ShipGetOutfits(lua_State* L){
 		return 0;
 	}
 
-	list<Outfit*>* outfits = (ai)->GetOutfits();
+	const list<Outfit*>* outfits = (ai)->GetOutfits();
 	lua_createtable(L, outfits->size(), 0);
 	newTable = lua_gettop(L);
 	for(iter=outfits->begin(), tableIndex=1; iter!=outfits->end(); ++iter, ++tableIndex)
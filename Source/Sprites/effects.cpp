@@ -1,7 +1,7 @@
 /**\file			effect.cpp
  * \author			Matt Zweig
  * \date			Created: Tuesday, December 15, 2009
- * \date			Modified: Tuesday, December 15, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Sprite SubClass for Animated backgrounds
  * \details
  */
@@ -12,6 +12,7 @@
 #include "Sprites/spritemanager.h"
 #include "Sprites/sprite.h"
 #include "Sprites/effects.h"
+#include "Utilities/pool.h"
 #include "Engine/simulation_lua.h"
 
 /** \addtogroup Sprites
@@ -20,27 +21,42 @@
 
 /**\class Effect
  * \brief Various Animation effects.
+ * \details Effects come and go every time something is hit or explodes, so
+ *          their memory comes from a Pool.  The frames themselves belong to
+ *          the shared Ani; an Effect only keeps where it is in the Animation.
  */
 
 /**\brief Creates a new Effect at specified coordinate with Animation file
  */
-Effect::Effect(Coordinate pos, string filename, float loopPercent) {
+Effect::Effect(Coordinate pos, const string& filename, float loopPercent)
+	:visual(filename)
+{
 	SetWorldPosition(pos);
-	visual = new Animation(filename);
-	visual->SetLoopPercent( loopPercent );
+	visual.SetLoopPercent( loopPercent );
 }
 
 /**\brief Destroy an Effect
  */
 Effect::~Effect() {
-	delete visual;
+}
+
+/**\brief Take the memory for an Effect from its Pool.
+ */
+void* Effect::operator new( size_t size ) {
+	return Pool<Effect>::Allocate( size );
+}
+
+/**\brief Give the memory for an Effect back to its Pool.
+ */
+void Effect::operator delete( void* memory, size_t size ) {
+	Pool<Effect>::Free( memory, size );
 }
 
 /**\brief Updates the Effect
  */
 void Effect::Update( lua_State *L ) {
 	Sprite::Update( L );
-	if( visual->Update() == true ) {
+	if( visual.Update() == true ) {
 		SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
 		sprites->Delete( (Sprite*)this );
 	}
@@ -50,7 +66,30 @@ void Effect::Update( lua_State *L ) {
  */
 void Effect::Draw( void ) {
 	Coordinate pos = GetWorldPosition();
-	visual->Draw( pos.GetScreenX(), pos.GetScreenY(), this->GetAngle());
+	visual.Draw( pos.GetScreenX(), pos.GetScreenY(), this->GetAngle());
+}
+
+/**\brief Write the Sprite state and how far the Animation has played.
+ * \details The filename is not written, the SpriteManager keeps it with the
+ *          record so that the right Effect can be created before Restore.
+ */
+void Effect::Snapshot( BinaryWriter& out ) {
+	Sprite::Snapshot( out );
+
+	out.WriteFloat( visual.GetLoopPercent() );
+	out.WriteUint( visual.GetAge() );
+}
+
+/**\brief Read the state written by Snapshot.
+ */
+bool Effect::Restore( BinaryReader& in ) {
+	if( !Sprite::Restore( in ) ) {
+		return false;
+	}
+
+	visual.SetLoopPercent( in.ReadFloat() );
+	visual.SetAge( in.ReadUint() );
+	return !in.Failed();
 }
 
 /**\fn Effect::GetDrawOrder( )
@@ -2,7 +2,7 @@
  * Filename      : effect.h
  * Author(s)     : Matt Zweig
  * Date Created  : Tuesday, December 15, 2009
- * Last Modified : Tuesday, December 15, 2009
+ * Last Modified : Sunday, October 18, 2026
  * Purpose       : Sprite SubClass for Animated backgrounds
  * Notes         :
  */
@@ -17,15 +17,22 @@
 
 class Effect : public Sprite {
 	public:
-		Effect(Coordinate pos, string filename, float loopPercent);
+		Effect(Coordinate pos, const string& filename, float loopPercent);
 		~Effect();
+
+		static void* operator new( size_t size );
+		static void operator delete( void* memory, size_t size );
+
 		void Update( lua_State *L );
 		void Draw(void);
+		void Snapshot( BinaryWriter& out );
+		bool Restore( BinaryReader& in );
+		string GetFilename( void ) { return visual.GetFilename(); }
 		virtual int GetDrawOrder( void ) {
 			return( DRAW_ORDER_EFFECT);
 		}
 	private:
-		Animation *visual;
+		Animation visual;
 };
 
 #endif // __H_EFFECT__
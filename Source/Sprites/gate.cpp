@@ -2,7 +2,7 @@
  * Filename      : gate.cpp
  * Author(s)     : Matt Zweig
  * Date Created  : Tuesday, March 16, 2010
- * Last Modified : Tuesday, March 16, 2010
+ * Last Modified : Sunday, October 18, 2026
  * Purpose       : Sprite SubClass for Warp Gates
  * Notes         : A gate is a two-part Sprite that ships can move through
  */
@@ -16,6 +16,7 @@
 #include "Sprites/gate.h"
 #include "Utilities/trig.h"
 #include "Utilities/log.h"
+#include "Utilities/random.h"
 #include "Engine/simulation_lua.h"
 
 /** \addtogroup Sprites
@@ -25,6 +26,8 @@
 /**\class Gate
  * \brief A Gate is a dual-sprite; it has a Top and a Bottom.
  *        This allows ships to fly through the gate.
+ * \details The Top Gate owns a trigger volume, so it is told when a ship
+ *          flies into it rather than looking for ships every tick.
  * */
 
 /**\brief Creates a Top Gate as well as a Bottom Gate automatically
@@ -32,6 +35,7 @@
  */
 Gate::Gate(Coordinate pos, string _name) {
 	top = true;
+	triggerID = 0;
 	SetImage( Image::Get("Resources/Graphics/gate1_top.png") );
 	
 	// Create the PartnerID Gate
@@ -42,7 +46,7 @@ Gate::Gate(Coordinate pos, string _name) {
 
 	// Set both Position and Angle at the same time
 	SetWorldPosition(pos);
-	SetAngle( float( rand() %360 ) );
+	SetAngle( float( Random::Stream( RANDOM_GATES ).Int( 360 ) ) );
 
 	if( _name == "" ) {
 		stringstream val_ss;
@@ -56,37 +60,60 @@ Gate::Gate(Coordinate pos, string _name) {
  */
 Gate::Gate(int topID) {
 	top = false;
+	triggerID = 0;
+	exitID = 0;
 	SetImage( Image::Get("Resources/Graphics/gate1_bottom.png") );
 	partnerID = topID;
 }
 
-/** \brief Load a Gate from XML
+/**\brief Remove the trigger volume of a Top Gate
+ * \todo Remove the SpriteManager Instance access.
  */
-bool Gate::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
-	Coordinate pos;
-
-	if( (attr = FirstChildNamed(node,"x")) ){
-		value = NodeToString(doc,attr);
-		pos.SetX( atof( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"y")) ){
-		value = NodeToString(doc,attr);
-		pos.SetY( atof( value.c_str() ));
-	} else return false;
-
-	SetWorldPosition( pos );
-
-	if( (attr = FirstChildNamed(node,"exit")) ){
-		value = NodeToString(doc,attr);
-		Gate* exit = Gates::Instance()->GetGate( value );
-		if( exit != NULL ) {
-			Gate::SetPair(this,exit);
-		}
+Gate::~Gate() {
+	if( triggerID != 0 ) {
+		SpriteManager::Instance()->GetTriggers()->Remove( triggerID );
 	}
+}
 
+enum {
+	GATE_X,
+	GATE_Y,
+	GATE_EXIT
+};
+
+static const ComponentField gateFields[] = {
+	{ "x", GATE_X, FIELD_REQUIRED },
+	{ "y", GATE_Y, FIELD_REQUIRED },
+	{ "exit", GATE_EXIT, 0 },
+	{ NULL, 0, 0 }
+};
+
+/**\brief The XML fields of a Gate.
+ */
+const ComponentField* Gate::GetFields( void ) {
+	return gateFields;
+}
+
+/**\brief Parse one XML field of a Gate.
+ * \details The exit is parsed after the position so that both Gates can be
+ *          turned to face each other.
+ */
+bool Gate::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case GATE_X:
+			SetWorldPosition( Coordinate( atof( value.c_str() ), GetWorldPosition().GetY() ) );
+			break;
+		case GATE_Y:
+			SetWorldPosition( Coordinate( GetWorldPosition().GetX(), atof( value.c_str() ) ) );
+			break;
+		case GATE_EXIT: {
+			Gate* exit = Gates::Instance()->GetGate( value );
+			if( exit != NULL ) {
+				Gate::SetPair(this,exit);
+			}
+			break;
+		}
+	}
 	return true;
 }
 
@@ -111,6 +138,49 @@ xmlNodePtr Gate::ToXMLNode(string componentName) {
 	return section;
 }
 
+/**\brief Write this Gate to a binary cache.
+ * \details The exit is looked up in the Gates collection rather than the
+ *          SpriteManager since the Gates may not be in the SpriteManager yet.
+ */
+bool Gate::Serialize( BinaryWriter& out ) {
+	string exitName = "";
+	Gates* gates = Gates::Instance();
+	list<string>* names = gates->GetNames();
+	for( list<string>::iterator n = names->begin(); n != names->end(); ++n ) {
+		if( (exitID != 0) && (gates->GetGate(*n)->GetID() == exitID) ) {
+			exitName = *n;
+			break;
+		}
+	}
+
+	out.WriteDouble( GetWorldPosition().GetX() );
+	out.WriteDouble( GetWorldPosition().GetY() );
+	out.WriteString( exitName );
+	return true;
+}
+
+/**\brief Read this Gate from a binary cache.
+ * \details Just like FromXMLNode, the Gate is paired with its exit if the
+ *          exit has already been read.
+ */
+bool Gate::Deserialize( BinaryReader& in ) {
+	double x = in.ReadDouble();
+	double y = in.ReadDouble();
+	string exitName = in.ReadString();
+	if( in.Failed() ) {
+		return false;
+	}
+
+	SetWorldPosition( Coordinate( x, y ) );
+	if( exitName != "" ) {
+		Gate* exit = Gates::Instance()->GetGate( exitName );
+		if( exit != NULL ) {
+			Gate::SetPair(this,exit);
+		}
+	}
+	return true;
+}
+
 /**\brief Set the Angle for Top and Bottom at once
  *        This overrides the normal Sprite SetAngle.
  */
@@ -127,6 +197,7 @@ void Gate::SetAngle(float angle) {
 void Gate::SetWorldPosition(Coordinate c) {
 	this->_SetWorldPosition(c);
 	GetPartner()->_SetWorldPosition(c);
+	GetTop()->PlaceTrigger();
 }
 
 /**\brief Set the exit for this Gate
@@ -179,36 +250,48 @@ Gate* Gate::GetPartner() {
 	return (Gate*)partner;
 }
 
-/**\brief Check if any Ships have entered the Gate, send them somewhere
- * \todo Where to send the ships should not be this random
- * \todo Non-Player ships should just disappear
+/**\brief Add or move the trigger volume of a Top Gate
+ * \todo Remove the SpriteManager Instance access.
  */
+void Gate::PlaceTrigger() {
+	Triggers* triggers = SpriteManager::Instance()->GetTriggers();
+	if( triggerID == 0 ) {
+		triggerID = triggers->Add( GetWorldPosition(), GATE_TRIGGER_RADIUS, TRIGGER_MOVERS, this );
+	} else {
+		triggers->Move( triggerID, GetWorldPosition() );
+	}
+}
 
+/**\brief Update the Gate
+ */
 void Gate::Update( lua_State *L ) {
 	// The Bottom Gate doesn't do anything
 	if(!top) return;
 
-	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
-	Ship* ship = (Ship*)sprites->GetNearestSprite( (Sprite*)this, 50,DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER );
+	Sprite::Update( L );
+}
 
-	if(ship!=NULL) {
-		if(exitID != 0) {
-			SendToExit(ship);
-		} else if(rand()&1) {
-			SendToRandomLocation(ship);
-		} else {
-			SendRandomDistance(ship);
-		}
+/**\brief A Ship has entered the Gate, send it somewhere
+ * \todo Where to send the ships should not be this random
+ * \todo Non-Player ships should just disappear
+ */
+void Gate::Entered( int trigger, Sprite* sprite, lua_State *L ) {
+	Ship* ship = (Ship*)sprite;
+	if(exitID != 0) {
+		SendToExit(ship);
+	} else if( Random::Stream( RANDOM_GATES ).Int( 2 ) ) {
+		SendToRandomLocation(ship);
+	} else {
+		SendRandomDistance(ship);
 	}
-
-	Sprite::Update( L );
 }
 
 /**\brief Teleport any ship that enters the gate to a random location
  */
 
 void Gate::SendToRandomLocation(Sprite* ship) {
-	Coordinate destination = Coordinate( float(rand()%GATE_RADIUS - GATE_RADIUS/2), float(rand()%GATE_RADIUS - GATE_RADIUS/2));
+	Random& random = Random::Stream( RANDOM_GATES );
+	Coordinate destination = Coordinate( float(random.Int( GATE_RADIUS ) - GATE_RADIUS/2), float(random.Int( GATE_RADIUS ) - GATE_RADIUS/2));
 	ship->SetWorldPosition( destination );
 }
 
@@ -235,12 +318,12 @@ void Gate::SendToExit(Ship* ship) {
  */
 
 void Gate::SendRandomDistance(Sprite* ship) {
-	float distance = float(rand()%GATE_RADIUS);
-	Trig *trig = Trig::Instance();
-	float angle = static_cast<float>(trig->DegToRad( GetAngle() ));
+	float distance = float( Random::Stream( RANDOM_GATES ).Int( GATE_RADIUS ) );
+	float s, c;
+	Trig::SinCos( Trig::DegToRad( GetAngle() ), &s, &c );
 	Coordinate destination = GetWorldPosition() +
-		   Coordinate( trig->GetCos( angle ) * distance,
-					  -trig->GetSin( angle ) * distance );
+		   Coordinate( c * distance,
+					  -s * distance );
 	ship->SetWorldPosition( destination );
 }
 
@@ -2,7 +2,7 @@
  * Filename      : gate.h
  * Author(s)     : Matt Zweig
  * Date Created  : Tuesday, March 16, 2010
- * Last Modified : Tuesday, March 16, 2010
+ * Last Modified : Sunday, October 18, 2026
  * Purpose       : Sprite SubClass for Warp Gates
  * Notes         : A gate is a two-part Sprite that ships can move through
  */
@@ -16,15 +16,21 @@
 #include "Graphics/image.h"
 #include "Graphics/animation.h"
 #include "Utilities/components.h"
+#include "Utilities/triggers.h"
 
 #define GATE_RADIUS 20000
+#define GATE_TRIGGER_RADIUS 50 ///< Ships this close to a Gate go through it.
 
-class Gate : public Sprite, public Component {
+class Gate : public Sprite, public Component, public TriggerListener {
 	public:
 		Gate(Coordinate pos = Coordinate(0,0), string name="" );
+		~Gate();
 
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 
 		virtual int GetDrawOrder( void ) {
 			return( top? DRAW_ORDER_GATE_TOP : DRAW_ORDER_GATE_BOTTOM );
@@ -42,10 +48,12 @@ class Gate : public Sprite, public Component {
 		Sprite* GetExit();
 
 		void Update( lua_State *L );
+		void Entered( int trigger, Sprite* sprite, lua_State *L );
 	private:
 		bool top; ///< True if this Sprite is on Top.
 		int partnerID; ///< The partner is the top/bottom of this gate
 		int exitID; ///< Ships entering this gate will be transported to the Exit Gate
+		int triggerID; ///< The trigger volume of a Top Gate
 
 		void SendToRandomLocation(Sprite* ship);
 		void SendToExit(Ship* ship);
@@ -56,12 +64,13 @@ class Gate : public Sprite, public Component {
 		void _SetAngle(float angle) { Sprite::SetAngle(angle); }
 		void _SetWorldPosition(Coordinate c) { Sprite::SetWorldPosition(c); }
 		Gate* GetPartner();
+		void PlaceTrigger();
 };
 
 class Gates : public Components {
 	public:
 		static Gates *Instance();
-		Gate *GetGate( string& GateName ) { return (Gate*) this->Get(GateName); }
+		Gate *GetGate( const string& GateName ) { return (Gate*) this->Get(GateName); }
 		Component* newComponent() { return new Gate(); }
 		
 	protected:
@@ -1,7 +1,7 @@
 /**\file			planets.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Monday, November 16 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -32,6 +32,8 @@
  *\see Planets_Lua
  */
 
+Uint32 Planet::changes = 0;
+
 /**\brief Blank Constructor
  */
 Planet::Planet(){
@@ -44,7 +46,6 @@ Planet::Planet(){
 	traffic = 0;
 	militiaSize = 0;
 	sphereOfInfluence = 0;
-	lastTrafficTime = 0;
 }
 
 /**\brief Copy Constructor
@@ -72,6 +73,9 @@ Planet& Planet::operator=(const Planet& other) {
 	SetImage( other.GetImage() );
 	Image::Store(name,GetImage());
 
+	// The name, alliance or position may have changed
+	changes++;
+
 	return *this;
 }
 
@@ -119,96 +123,115 @@ Planet::Planet(
 Planet::~Planet() {
 }
 
-/**\brief Parse one planet out of an xml node.
+enum {
+	PLANET_ALLIANCE,
+	PLANET_X,
+	PLANET_Y,
+	PLANET_LANDABLE,
+	PLANET_TRAFFIC,
+	PLANET_IMAGE,
+	PLANET_SURFACEIMAGE,
+	PLANET_SUMMARY,
+	PLANET_MILITIA,
+	PLANET_SPHEREOFINFLUENCE,
+	PLANET_TECHNOLOGY
+};
+
+static const ComponentField planetFields[] = {
+	{ "alliance", PLANET_ALLIANCE, FIELD_REQUIRED },
+	{ "x", PLANET_X, FIELD_REQUIRED },
+	{ "y", PLANET_Y, FIELD_REQUIRED },
+	{ "landable", PLANET_LANDABLE, FIELD_REQUIRED },
+	{ "traffic", PLANET_TRAFFIC, FIELD_REQUIRED },
+	{ "image", PLANET_IMAGE, FIELD_REQUIRED },
+	{ "surface-image", PLANET_SURFACEIMAGE, FIELD_REQUIRED },
+	{ "summary", PLANET_SUMMARY, FIELD_REQUIRED },
+	{ "militia", PLANET_MILITIA, FIELD_REQUIRED },
+	{ "sphereOfInfluence", PLANET_SPHEREOFINFLUENCE, FIELD_REQUIRED },
+	{ "technology", PLANET_TECHNOLOGY, 0 },
+	{ NULL, 0, 0 }
+};
+
+/**\brief The XML fields of a Planet.
  */
-bool Planet::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
-	xmlNodePtr  attr;
-	string value;
-	Coordinate pos;
+const ComponentField* Planet::GetFields( void ) {
+	return planetFields;
+}
 
-	if( (attr = FirstChildNamed(node,"alliance")) ){
-		value = NodeToString(doc,attr);
-		alliance = Alliances::Instance()->GetAlliance(value);
-		if(alliance==NULL)
-		{
-			LogMsg(ERR, "Could not create Planet '%s'. Unknown Alliance '%s'.", this->GetName().c_str(), value.c_str());
-			return false;
+/**\brief Parse one XML field of a Planet.
+ */
+bool Planet::ParseField( int field, const string& value ) {
+	switch( field ) {
+		case PLANET_ALLIANCE:
+			alliance = Alliances::Instance()->GetAlliance(value);
+			if(alliance==NULL)
+			{
+				LogMsg(ERR, "Could not create Planet '%s'. Unknown Alliance '%s'.", this->GetName().c_str(), value.c_str());
+				return false;
+			}
+			changes++;
+			break;
+		case PLANET_X:
+			SetWorldPosition( Coordinate( atof( value.c_str() ), GetWorldPosition().GetY() ) );
+			break;
+		case PLANET_Y:
+			SetWorldPosition( Coordinate( GetWorldPosition().GetX(), atof( value.c_str() ) ) );
+			break;
+		case PLANET_LANDABLE:
+			landable = ( atoi( value.c_str() ) != 0);
+			break;
+		case PLANET_TRAFFIC:
+			traffic = (short int) atoi( value.c_str() );
+			break;
+		case PLANET_IMAGE: {
+			Image* image = Image::Get( value );
+			Image::Store(name, image);
+			SetImage(image);
+			break;
+		}
+		case PLANET_SURFACEIMAGE:
+			this->surface = Image::Get( value );
+			break;
+		case PLANET_SUMMARY:
+			summary = value;
+			break;
+		case PLANET_MILITIA:
+			militiaSize = (short int) atoi( value.c_str() );
+			break;
+		case PLANET_SPHEREOFINFLUENCE:
+			sphereOfInfluence = atoi( value.c_str() );
+			break;
+		case PLANET_TECHNOLOGY: {
+			Technology *tech = Technologies::Instance()->GetTechnology( value );
+			if( tech == NULL ) {
+				LogMsg(WARN, "Planet '%s' has an unknown Technology '%s'.", GetName().c_str(), value.c_str() );
+				break;
+			}
+			technologies.push_back( tech );
+			break;
 		}
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"x")) ){
-		value = NodeToString(doc,attr);
-		pos.SetX( atof( value.c_str() ));
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"y")) ){
-		value = NodeToString(doc,attr);
-		pos.SetY( atof( value.c_str() ));
-	} else return false;
-
-	SetWorldPosition( pos );
-
-	if( (attr = FirstChildNamed(node,"landable")) ){
-		value = NodeToString(doc,attr);
-		landable = ( atoi( value.c_str() ) != 0);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"traffic")) ){
-		value = NodeToString(doc,attr);
-		traffic = (short int) atoi( value.c_str() );
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"image")) ){
-		Image* image = Image::Get( NodeToString(doc,attr) );
-		Image::Store(name, image);
-		SetImage(image);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"surface-image")) ){
-		this->surface = Image::Get( NodeToString(doc,attr) );
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"summary")) ){
-		summary = NodeToString(doc,attr);
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"militia")) ){
-		value = NodeToString(doc,attr);
-		militiaSize = (short int) atoi( value.c_str() );
-	} else return false;
-
-	if( (attr = FirstChildNamed(node,"sphereOfInfluence")) ){
-		value = NodeToString(doc,attr);
-		sphereOfInfluence = atoi( value.c_str() );
-	} else return false;
-
-	for( attr = FirstChildNamed(node,"technology"); attr!=NULL; attr = NextSiblingNamed(attr,"technology") ){
-		value = NodeToString(doc,attr);
-		Technology *tech = Technologies::Instance()->GetTechnology( value );
-		technologies.push_back(tech);
 	}
-	technologies.sort();
-	technologies.unique();
-
 	return true;
 }
 
-void Planet::Update( lua_State *L ) {
-	if( lastTrafficTime + 120 < Timer::GetLogicalFrameCount() ) {
-		GenerateTraffic( L );
-	}
-	Sprite::Update( L );
+/**\brief Remove duplicate Technologies once every field has been parsed.
+ */
+bool Planet::FinishFields( void ) {
+	technologies.sort();
+	technologies.unique();
+	return true;
 }
 
-void Planet::GenerateTraffic( lua_State *L ) {
-	SpriteManager *sprites = Simulation_Lua::GetSimulation(L)->GetSpriteManager();
+/**\brief Check if there are fewer ships around this Planet than its traffic.
+ * \details The Traffic scheduler decides when to ask and whether a ship is
+ *          actually created.
+ * \see Traffic
+ */
+bool Planet::NeedsTraffic( SpriteManager *sprites ) {
 	list<Sprite*> *nearbySprites = sprites->GetSpritesNear( GetWorldPosition(), TO_FLOAT(sphereOfInfluence), DRAW_ORDER_SHIP | DRAW_ORDER_PLAYER);
-
-	if( nearbySprites->size() < traffic ) {
-		Lua::Call( "createRandomShipForPlanet", "i", GetID() );
-	}
+	bool needed = ( nearbySprites->size() < traffic );
 	delete nearbySprites;
-	lastTrafficTime = Timer::GetLogicalFrameCount();
+	return needed;
 }
 
 /**\brief List of the Models that are available at this Planet
@@ -309,6 +332,70 @@ xmlNodePtr Planet::ToXMLNode(string componentName) {
 	return section;
 }
 
+/**\brief Write this Planet to a binary cache.
+ */
+bool Planet::Serialize( BinaryWriter& out ) {
+	if( (alliance == NULL) || (GetImage() == NULL) || (surface == NULL) ) {
+		return false;
+	}
+	out.WriteString( alliance->GetName() );
+	out.WriteDouble( GetWorldPosition().GetX() );
+	out.WriteDouble( GetWorldPosition().GetY() );
+	out.WriteBool( landable );
+	out.WriteShort( traffic );
+	out.WriteString( GetImage()->GetPath() );
+	out.WriteString( surface->GetPath() );
+	out.WriteString( summary );
+	out.WriteShort( militiaSize );
+	out.WriteInt( sphereOfInfluence );
+	Uint32 count = 0;
+	list<Technology*>::iterator it;
+	for( it = technologies.begin(); it != technologies.end(); ++it ) {
+		if( *it != NULL ) ++count;
+	}
+	out.WriteUint( count );
+	for( it = technologies.begin(); it != technologies.end(); ++it ) {
+		if( *it != NULL ) {
+			out.WriteString( (*it)->GetName() );
+		}
+	}
+	return true;
+}
+
+/**\brief Read this Planet from a binary cache.
+ */
+bool Planet::Deserialize( BinaryReader& in ) {
+	alliance = Alliances::Instance()->GetAlliance( in.ReadString() );
+	double x = in.ReadDouble();
+	double y = in.ReadDouble();
+	landable = in.ReadBool();
+	traffic = in.ReadShort();
+	string imageName = in.ReadString();
+	string surfaceName = in.ReadString();
+	summary = in.ReadString();
+	militiaSize = in.ReadShort();
+	sphereOfInfluence = in.ReadInt();
+	Uint32 count = in.ReadUint();
+	for( Uint32 i = 0; (i < count) && !in.Failed(); ++i ) {
+		string value = in.ReadString();
+		Technology *tech = Technologies::Instance()->GetTechnology( value );
+		if( tech == NULL ) return false;
+		technologies.push_back( tech );
+	}
+	if( in.Failed() || (alliance == NULL) ) {
+		return false;
+	}
+	technologies.sort();
+	technologies.unique();
+
+	SetWorldPosition( Coordinate( x, y ) );
+	Image* image = Image::Get( imageName );
+	Image::Store(name, image);
+	SetImage(image);
+	this->surface = Image::Get( surfaceName );
+	return true;
+}
+
 /**\class Planets
  * \brief Collection of all Planets
  *
@@ -1,7 +1,7 @@
 /**\file			planets.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Monday, November 16 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -19,6 +19,8 @@
 #include "Engine/technologies.h"
 #include "Engine/alliances.h"
 
+class SpriteManager;
+
 // Abstraction of a single planet
 class Planet : public Sprite, public Component {
 	public:
@@ -38,13 +40,16 @@ class Planet : public Sprite, public Component {
 				list<Technology*> _technologies
 		);
 		
-		void Update( lua_State *L );
-		void GenerateTraffic( lua_State *L );
+		bool NeedsTraffic( SpriteManager *sprites );
 
 		virtual int GetDrawOrder( void ) { return( DRAW_ORDER_PLANET ); }
 		
-		bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		const ComponentField* GetFields( void );
+		bool ParseField( int field, const string& value );
+		bool FinishFields( void );
 		xmlNodePtr ToXMLNode(string componentName);
+		bool Serialize( BinaryWriter& out );
+		bool Deserialize( BinaryReader& in );
 		
 		~Planet();
 
@@ -63,7 +68,9 @@ class Planet : public Sprite, public Component {
 
 		bool GetForbidden() {return forbidden;}
 		void SetForbidden(bool f) {forbidden = f;}
-		void SetInfluence(int influence) {sphereOfInfluence = influence;}
+		void SetInfluence(int influence) {sphereOfInfluence = influence; changes++;}
+
+		static Uint32 GetChanges() { return changes; }
 
 	private:
 		Alliance* alliance;
@@ -76,14 +83,14 @@ class Planet : public Sprite, public Component {
 		string summary;
 		list<Technology*> technologies;
 
-		Uint32 lastTrafficTime;
+		static Uint32 changes; ///< Counts the edits to how Planets are drawn on the Map.
 };
 
 // Class that holds list of all planets; manages them
 class Planets : public Components {
 	public:
 		static Planets *Instance();
-		Planet *GetPlanet( string& PlanetName ) { return (Planet*) this->Get(PlanetName); }
+		Planet *GetPlanet( const string& PlanetName ) { return (Planet*) this->Get(PlanetName); }
 		Component* newComponent() { return new Planet(); }
 		
 	protected:
@@ -495,6 +495,7 @@ int Planets_Lua::SetForbidden(lua_State* L){
 		if(p==NULL) return 0;
 		int f = luaL_checkint (L, 2);
 		(p)->SetForbidden( (f == 1) );
+		Planets::Instance()->SetDirty();
 	} else {
 		luaL_error(L, "Got %d arguments expected 2 (planet, forbidden)", n);
 	}
@@ -511,6 +512,7 @@ int Planets_Lua::SetPosition(lua_State* L){
 		int x = luaL_checkint (L, 2);
 		int y = luaL_checkint (L, 3);
 		p->SetWorldPosition( Coordinate(x, y) );
+		Planets::Instance()->SetDirty();
 	} else {
 		luaL_error(L, "Got %d arguments expected 2 (planet, forbidden)", n);
 	}
@@ -526,6 +528,7 @@ int Planets_Lua::SetInfluence(lua_State* L){
 		if(p==NULL) return 0;
 		int influence = luaL_checkint (L, 2);
 		p->SetInfluence( influence );
+		Planets::Instance()->SetDirty();
 	} else {
 		luaL_error(L, "Got %d arguments expected 2 (planet, influence)", n);
 	}
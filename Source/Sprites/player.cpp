@@ -1,7 +1,7 @@
 /**\file			player.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Wednesday, July 5, 2006
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Main player-specific functions and handle
  * \details
  */
@@ -14,14 +14,25 @@
 #include "Utilities/components.h"
 #include "Utilities/file.h"
 #include "Utilities/filesystem.h"
+#include "Utilities/savemanager.h"
 #include "Engine/simulation_lua.h"
 
+static Option<int> randomSeed( "options/simulation/random-seed" );
+static Option<int> journal( "options/saves/journal" );
+
 /** \addtogroup Sprites
  * @{
  */
 
 /**\class Player
  * \brief Main player-specific functions and handle.
+ * \details A Player is saved in full when it lands.  In between, changes to
+ *          the things that change most often (credits, favor and missions)
+ *          are appended to a journal next to the saved game, one record per
+ *          line.  Every record holds the complete values rather than the
+ *          difference, so only the newest record matters when the Player is
+ *          loaded again.  A crash in the middle of writing a record only
+ *          loses that record.
  */
 
 /**\brief Load a player from a file.
@@ -33,6 +44,9 @@ Player* Player::Load( string filename ) {
 	xmlNodePtr cur;
 	Player* newPlayer = new Player();
 
+	// Make sure that the last save has been written
+	SaveManager::Flush();
+
 	File xmlfile = File (filename);
 	long filelen = xmlfile.GetLength();
 	char *buffer = xmlfile.Read();
@@ -40,6 +54,7 @@ Player* Player::Load( string filename ) {
 	cur = xmlDocGetRootElement( doc );
 
 	newPlayer->FromXMLNode( doc, cur );
+	newPlayer->ReplayJournal();
 
 	// We check the planet location at loadtime in case the planet has moved or the lastPlanet has changed.
 	// This happens with the --random-universe option.
@@ -96,6 +111,7 @@ void Player::AcceptMission( Mission *mission ) {
 	assert( mission != NULL );
 	mission->Accept();
 	missions.push_back( mission );
+	journalPending = true;
 	LogMsg(INFO, "Player has accepted the Mission to %s", mission->GetName().c_str() );
 }
 
@@ -109,6 +125,7 @@ void Player::RejectMission( string missionName ) {
 			(*iter)->Reject();
 			delete (*iter);
 			missions.erase( iter );
+			journalPending = true;
 			LogMsg(INFO, "Player has abandoned the Mission to %s.", missionName.c_str() );
 			return;
 		}
@@ -146,6 +163,7 @@ void Player::UpdateFavor( string allianceName, int deltaFavor ) {
 		favor[alliance] = 0;
 	}
 	favor[alliance] += deltaFavor;
+	journalPending = true;
 }
 
 /**\brief set name of last planet visited
@@ -174,8 +192,13 @@ void Player::Land( lua_State *L, Planet* planet ){
 		if( missionOver ) {
 			LogMsg(INFO, "Completed the Mission '%s'", (*i)->GetName().c_str() );
 			// Remove this completed mission from the list
+			delete (*i);
 			i = missions.erase( i );
+			journalPending = true;
 		} else {
+			if( (*i)->Progressed() ) {
+				journalPending = true;
+			}
 			++i;
 		}
 	}
@@ -190,25 +213,41 @@ void Player::Land( lua_State *L, Planet* planet ){
  */
 Player::Player() {
 	this->SetRadarColor( WHITE );
+	journalSequence = 0;
+	journalCredits = 0;
+	journalPending = false;
 }
 
 /**\brief Destructor
+ * \details Each Mission stops listening for events and triggers as it is deleted.
  */
 Player::~Player() {
 	LogMsg(INFO, "You have been destroyed..." );
+	for( list<Mission*>::iterator iter_mission = missions.begin(); iter_mission != missions.end(); ++iter_mission ) {
+		delete (*iter_mission);
+	}
+	missions.clear();
 }
 
 /**\brief Run the Player Update
+ * \details Each Mission only runs Lua when one of its events has happened.
  */
 void Player::Update( lua_State *L ) {
 	bool missionOver;
-	list<Mission*>::iterator i;
-	for( i = missions.begin(); i != missions.end(); ++i ) {
+	list<Mission*>::iterator i = missions.begin();
+	while( i != missions.end() ) {
 		missionOver = (*i)->Update();
 		if( missionOver ) {
 			LogMsg(INFO, "Completed the Mission %s", (*i)->GetName().c_str() );
 			// Remove this completed mission from the list
+			delete (*i);
 			i = missions.erase( i );
+			journalPending = true;
+		} else {
+			if( (*i)->Progressed() ) {
+				journalPending = true;
+			}
+			++i;
 		}
 	}
 
@@ -217,10 +256,16 @@ void Player::Update( lua_State *L ) {
 	}
 
 	Ship::Update( L );
+
+	if( journal && (journalPending || (GetCredits() != journalCredits)) ) {
+		WriteJournal();
+	}
 }
 
 /**\brief Save an XML file for this player
  * \details The filename is by default the player's name.
+ *          The Player is copied into an XML document right away, but the
+ *          file is written in the background by the SaveManager.
  */
 void Player::Save( string simulation ) {
 	xmlDocPtr xmlPtr;
@@ -231,13 +276,160 @@ void Player::Save( string simulation ) {
 	xmlNodePtr root_node = ToXMLNode("player");
 	xmlDocSetRootElement(xmlPtr, root_node);
 
-	xmlSaveFormatFileEnc( GetFileName().c_str(), xmlPtr, "ISO-8859-1", 1);
+	SaveManager::SaveDocument( GetFileName(), xmlPtr );
+
+	// The saved game now includes everything in the journal.
+	SaveManager::Replace( GetJournalName(), "" );
+	journalCredits = GetCredits();
+	journalPending = false;
 
 	// Update and Save this player's info in the master players list.
 	Players::Instance()->GetPlayerInfo( GetName() )->Update( this, simulation );
+	Players::Instance()->SetDirty();
 	Players::Instance()->Save();
 }
 
+/**\brief Append the current credits, favor and missions to the journal.
+ */
+void Player::WriteJournal( void ) {
+	char buff[32];
+	xmlNodePtr record = xmlNewNode(NULL, BAD_CAST "journal");
+
+	snprintf(buff, sizeof(buff), "%u", ++journalSequence );
+	xmlNewProp(record, BAD_CAST "sequence", BAD_CAST buff );
+	snprintf(buff, sizeof(buff), "%d", GetCredits() );
+	xmlNewChild(record, NULL, BAD_CAST "credits", BAD_CAST buff );
+	xmlNewChild(record, NULL, BAD_CAST "planet", BAD_CAST lastPlanet.c_str() );
+
+	for( map<Alliance*,int>::iterator iter_favor = favor.begin(); iter_favor != favor.end(); ++iter_favor ) {
+		snprintf(buff, sizeof(buff), "%d", (*iter_favor).second );
+		xmlNodePtr favorPtr = xmlNewNode(NULL, BAD_CAST "favor");
+		xmlNewChild(favorPtr, NULL, BAD_CAST "alliance", BAD_CAST ((*iter_favor).first)->GetName().c_str() );
+		xmlNewChild(favorPtr, NULL, BAD_CAST "value", BAD_CAST buff );
+		xmlAddChild(record, favorPtr);
+	}
+
+	for( list<Mission*>::iterator iter_mission = missions.begin(); iter_mission != missions.end(); ++iter_mission ) {
+		xmlAddChild( record, (*iter_mission)->ToXMLNode() );
+	}
+
+	xmlBufferPtr output = xmlBufferCreate();
+	xmlNodeDump( output, NULL, record, 0, 0 );
+	string line = (const char*)xmlBufferContent( output );
+	xmlBufferFree( output );
+	xmlFreeNode( record );
+
+	// Keep each record on a single line.
+	size_t pos = 0;
+	while( (pos = line.find( '\n', pos )) != string::npos ) {
+		line.replace( pos, 1, "&#10;" );
+	}
+	line += '\n';
+
+	SaveManager::Append( GetJournalName(), line );
+	journalCredits = GetCredits();
+	journalPending = false;
+}
+
+/**\brief Apply the newest journal record written after this Player was saved.
+ * \details Lines that are incomplete or cannot be parsed are skipped.
+ * \returns true if a record was applied.
+ */
+bool Player::ReplayJournal( void ) {
+	string filename = GetJournalName();
+	if( !File::Exists( filename ) ) {
+		return false;
+	}
+
+	File journalFile = File( filename );
+	long length = journalFile.GetLength();
+	char *buffer = journalFile.Read();
+	if( buffer == NULL ) {
+		return false;
+	}
+	string contents( buffer, length );
+	delete [] buffer;
+
+	// Every record is complete, so search backwards for the newest good one.
+	size_t end = contents.rfind( '\n' );
+	while( end != string::npos ) {
+		size_t start = (end == 0) ? string::npos : contents.rfind( '\n', end - 1 );
+		start = (start == string::npos) ? 0 : start + 1;
+		string line = contents.substr( start, end - start );
+
+		xmlDocPtr doc = xmlReadMemory( line.c_str(), static_cast<int>(line.size()), filename.c_str(), NULL, XML_PARSE_NOERROR | XML_PARSE_NOWARNING );
+		xmlNodePtr node = doc ? xmlDocGetRootElement( doc ) : NULL;
+		xmlChar *sequence = node ? xmlGetProp( node, BAD_CAST "sequence" ) : NULL;
+		if( sequence != NULL ) {
+			Uint32 recordSequence = static_cast<Uint32>( strtoul( (const char*)sequence, NULL, 10 ) );
+			xmlFree( sequence );
+
+			if( recordSequence <= journalSequence ) {
+				// Everything older is already in the saved game.
+				xmlFreeDoc( doc );
+				return false;
+			}
+
+			bool applied = ApplyJournal( doc, node );
+			xmlFreeDoc( doc );
+			if( applied ) {
+				LogMsg(INFO, "Applied journal record %u to player '%s'.", recordSequence, GetName().c_str() );
+				journalSequence = recordSequence;
+				journalCredits = GetCredits();
+				journalPending = false;
+				return true;
+			}
+		} else if( doc ) {
+			xmlFreeDoc( doc );
+		}
+
+		LogMsg(WARN, "Skipping a damaged record in '%s'.", filename.c_str() );
+		end = (start == 0) ? string::npos : start - 1;
+	}
+
+	return false;
+}
+
+/**\brief Replace the journaled values with those from a journal record.
+ */
+bool Player::ApplyJournal( xmlDocPtr doc, xmlNodePtr node ) {
+	xmlNodePtr attr;
+
+	if( xmlStrcmp( node->name, BAD_CAST "journal" ) ) {
+		return false;
+	}
+
+	if( (attr = FirstChildNamed(node,"credits")) ){
+		SetCredits( NodeToInt(doc,attr) );
+	} else return false;
+
+	if( (attr = FirstChildNamed(node,"planet")) ){
+		lastPlanet = NodeToString(doc,attr);
+	}
+
+	favor.clear();
+	for( attr = FirstChildNamed(node,"favor"); attr!=NULL; attr = NextSiblingNamed(attr,"favor") ){
+		xmlNodePtr alliance = FirstChildNamed(attr,"alliance");
+		xmlNodePtr value = FirstChildNamed(attr,"value");
+		if( alliance && value ) {
+			UpdateFavor( NodeToString(doc,alliance), NodeToInt(doc,value) );
+		}
+	}
+
+	for( list<Mission*>::iterator iter_mission = missions.begin(); iter_mission != missions.end(); ++iter_mission ) {
+		delete (*iter_mission);
+	}
+	missions.clear();
+	for( attr = FirstChildNamed(node,"Mission"); attr!=NULL; attr = NextSiblingNamed(attr,"Mission") ){
+		Mission *mission = Mission::FromXMLNode(doc,attr);
+		if( mission != NULL ) {
+			missions.push_back( mission );
+		}
+	}
+
+	return true;
+}
+
 /**\brief Parse one player out of an xml node
  */
 bool Player::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
@@ -364,6 +556,12 @@ bool Player::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
 		lastLoadTime = (time_t)0;
 	}
 
+	if( (attr = FirstChildNamed(node,"journal")) ){
+		journalSequence = static_cast<Uint32>( NodeToInt(doc,attr) );
+	}
+	journalCredits = GetCredits();
+	journalPending = false;
+
 	RemoveLuaControlFunc();
 
 	return true;
@@ -505,8 +703,8 @@ xmlNodePtr Player::ToXMLNode(string componentName) {
 	}
 
 	// Outfit
-	list<Outfit*> *outfits = this->GetOutfits();
-	for( list<Outfit*>::iterator it_w = outfits->begin(); it_w!=outfits->end(); ++it_w ){
+	const list<Outfit*> *outfits = this->GetOutfits();
+	for( list<Outfit*>::const_iterator it_w = outfits->begin(); it_w!=outfits->end(); ++it_w ){
 		xmlNewChild(section, NULL, BAD_CAST "outfit", BAD_CAST (*it_w)->GetName().c_str() );
 	}
 
@@ -549,6 +747,10 @@ xmlNodePtr Player::ToXMLNode(string componentName) {
 		}
 	}
 
+	// The last journal record that this includes
+	snprintf(buff, sizeof(buff), "%u", journalSequence );
+	xmlNewChild(section, NULL, BAD_CAST "journal", BAD_CAST buff );
+
 	// Last Load Time
 	snprintf(buff, sizeof(buff), "%d", (int)lastLoadTime );
 	xmlNewChild(section, NULL, BAD_CAST "lastLoadTime", BAD_CAST buff );
@@ -667,7 +869,7 @@ void PlayerInfo::Update( Player* player, string simName ) {
 	avatar = (player->GetModel() != NULL) ? player->GetModel()->GetImage() : NULL;
 	file = player->GetFileName();
 	simulation = simName;
-	seed = OPTION(int, "options/simulation/random-seed");
+	seed = randomSeed;
 	lastLoadTime = player->GetLoadTime();
 }
 
@@ -874,6 +1076,9 @@ bool Players::DeletePlayer(string playerName) {
 		return false;
 	}
 	
+	// Don't let a queued save bring the files back
+	SaveManager::Flush();
+
 	// delete the separate player xml
 	string filename = "Resources/Definitions/" + playerName + ".xml";
 	if( Filesystem::DeleteFile( filename ) != true ) {
@@ -881,6 +1086,11 @@ bool Players::DeletePlayer(string playerName) {
 		return false;
 	}
 
+	string journalname = "Resources/Definitions/" + playerName + ".journal";
+	if( File::Exists( journalname ) ) {
+		Filesystem::DeleteFile( journalname );
+	}
+
 	return true;
 }
 
@@ -1,7 +1,7 @@
 /**\file			player.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Wednesday, July 5, 2006
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Main player-specific functions and handle
  * \details
  */
@@ -33,6 +33,7 @@ class Player : public Ship {
 		string GetLastPlanet() { return lastPlanet; }
 		string GetName() { return name; }
 		string GetFileName() { return "Resources/Definitions/"+ GetName() +".xml"; }
+		string GetJournalName() { return "Resources/Definitions/"+ GetName() +".journal"; }
 		time_t GetLoadTime() { return lastLoadTime; }
 		virtual int GetDrawOrder( void ) { return( DRAW_ORDER_PLAYER ); }
 		Color GetRadarColor( void ) { return GOLD; }
@@ -62,6 +63,11 @@ class Player : public Ship {
 		~Player();
 
 		bool ConfigureWeaponSlots(xmlDocPtr, xmlNodePtr);
+
+		// Journal of changes between saves
+		void WriteJournal( void );
+		bool ReplayJournal( void );
+		bool ApplyJournal( xmlDocPtr doc, xmlNodePtr node );
 	private:
 		string name;
 		time_t lastLoadTime; // TODO This may need to be renamed
@@ -69,6 +75,9 @@ class Player : public Ship {
 		list<Mission*> missions;
 		map<Alliance*,int> favor;
 		string luaControlFunc;
+		Uint32 journalSequence; ///< The last record written to the journal.
+		unsigned int journalCredits; ///< The credits when the journal was last written.
+		bool journalPending; ///< Something changed that is not in the journal yet.
 
 		// This list of hired escorts is only needed for XML saving/loading and doesn't control the game itself.
 		// Escorts from missions should not be listed here.
@@ -98,7 +107,7 @@ class PlayerInfo : public Component {
 		xmlNodePtr ConvertOldVersion( xmlDocPtr doc, xmlNodePtr node );
 
 		// name is implicit from Component
-		Image* avatar; ///< Image for this player (Usually the ship's model)
+		ResourceHandle<Image> avatar; ///< Image for this player (Usually the ship's model)
 		string file; ///< The xml file associated with this player.
 		string simulation; ///< The Simulation that this Player is playing.
 		int seed; ///< The Seed for this Simulation.
@@ -1,7 +1,7 @@
 /**\file			projectile.cpp
  * \author			Shawn Reynolds (eb0s@yahoo.com)
  * \date			Created: Friday, November 21, 2009
- * \date			Modified: Friday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Projectile class, child of sprite class, Sprite
  * \details
  */
@@ -14,6 +14,7 @@
 #include "Sprites/ship.h"
 #include "Sprites/effects.h"
 #include "Utilities/timer.h"
+#include "Utilities/pool.h"
 #include "Engine/weapons.h"
 #include "Engine/simulation_lua.h"
 
@@ -28,6 +29,9 @@
  * The Ship decides where and how the Projectile is created.
  * The Weapon defines the effect of the projectile.
  *
+ * Every shot fired makes a new Projectile, so their memory comes from a Pool
+ * instead of the heap.
+ *
  * \see Ship
  * \see Weapon
  */
@@ -52,13 +56,13 @@ Projectile::Projectile(float damageBooster, float angleToFire, Coordinate worldP
 	secondsOfLife = weapon->GetLifetime();
 	SetImage(weapon->GetImage());
 
-	Trig *trig = Trig::Instance();
 	Coordinate momentum = GetMomentum();
-	float angle = static_cast<float>(trig->DegToRad( angleToFire ));
+	float s, c;
+	Trig::SinCos( Trig::DegToRad( angleToFire ), &s, &c );
 
 	momentum = firedMomentum +
-	           Coordinate( trig->GetCos( angle ) * weapon->GetVelocity(),
-	                      -trig->GetSin( angle ) * weapon->GetVelocity() );
+	           Coordinate( c * weapon->GetVelocity(),
+	                      -s * weapon->GetVelocity() );
 	
 	SetMomentum( momentum );
 }
@@ -69,6 +73,18 @@ Projectile::~Projectile(void)
 {
 }
 
+/**\brief Take the memory for a Projectile from its Pool.
+ */
+void* Projectile::operator new( size_t size ) {
+	return Pool<Projectile>::Allocate( size );
+}
+
+/**\brief Give the memory for a Projectile back to its Pool.
+ */
+void Projectile::operator delete( void* memory, size_t size ) {
+	Pool<Projectile>::Free( memory, size );
+}
+
 /**\brief Update the Projectile
  *
  * Projectiles do all the normal Sprite things like moving.
@@ -117,5 +133,34 @@ void Projectile::Update( lua_State *L ) {
 	}
 }
 
+/**\brief Write the Sprite state and the flight of this Projectile.
+ * \details The Weapon is not written, the SpriteManager keeps it with the
+ *          record so that the right Projectile can be created before Restore.
+ */
+void Projectile::Snapshot( BinaryWriter& out ) {
+	Sprite::Snapshot( out );
+
+	out.WriteInt( ownerID );
+	out.WriteInt( targetID );
+	out.WriteFloat( damageBoost );
+	out.WriteUint( secondsOfLife );
+	out.WriteUint( Timer::GetTicks() - start );
+}
+
+/**\brief Read the state written by Snapshot.
+ */
+bool Projectile::Restore( BinaryReader& in ) {
+	if( !Sprite::Restore( in ) ) {
+		return false;
+	}
+
+	ownerID = in.ReadInt();
+	targetID = in.ReadInt();
+	damageBoost = in.ReadFloat();
+	secondsOfLife = in.ReadUint();
+	start = Timer::GetTicks() - in.ReadUint();
+	return !in.Failed();
+}
+
 /** @} */
 
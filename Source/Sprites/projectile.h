@@ -2,7 +2,7 @@
  * Filename      : projectile.h
  * Author(s)     : Shawn Reynolds (eb0s@yahoo.com)
  * Date Created  : Friday, November 21, 2009
- * Last Modified : Friday, November 21, 2009
+ * Last Modified : Sunday, October 18, 2026
  * Purpose       : Header for Projectile class, child of sprite class, Sprite
  * Notes         :
  */
@@ -19,7 +19,14 @@ class Projectile :
 public:
 	Projectile(float damageBooster, float angleToFire, Coordinate worldPosition, Coordinate firedMomentum, Weapon* weapon);
 	~Projectile(void);
+
+	static void* operator new( size_t size );
+	static void operator delete( void* memory, size_t size );
+
 	void Update( lua_State *L );
+	void Snapshot( BinaryWriter& out );
+	bool Restore( BinaryReader& in );
+	Weapon* GetWeapon( void ) { return weapon; }
 	void SetOwnerID(int id) { ownerID = id; }
 	void SetTargetID(int id) { targetID = id; }
 	int GetDrawOrder( void ) {
@@ -1,7 +1,7 @@
 /**\file			ship.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Friday, November 14, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -11,6 +11,7 @@
 #include "Sprites/ship.h"
 #include "Engine/camera.h"
 #include "Engine/simulation_lua.h"
+#include "Utilities/random.h"
 #include "Utilities/timer.h"
 #include "Utilities/trig.h"
 #include "Sprites/spritemanager.h"
@@ -19,6 +20,10 @@
 #include "Audio/sound.h"
 #include "Engine/hud.h"
 
+static Option<float> soundEngines( "options/sound/engines" );
+static Option<float> soundWeapons( "options/sound/weapons" );
+static Option<int> soundExplosions( "options/sound/explosions" );
+
 /** \addtogroup Sprites
  * @{
  */
@@ -122,10 +127,10 @@ Ship::Ship()
 		ammo[a]=0;
 	}
 
-	shipStats = Outfit();
+	statsDirty = true;
 
 	SetRadarColor( RED );
-	SetAngle( float( rand() %360 ) );
+	SetAngle( float( Random::Stream( RANDOM_SHIPS ).Int( 360 ) ) );
 }
 
 /**\brief Ship Destructor
@@ -158,7 +163,7 @@ bool Ship::SetModel( Model *model) {
 
 		SetImage( model->GetImage() );
 
-		ComputeShipStats();
+		statsDirty = true;
 		
 		return( true );
 	}
@@ -183,7 +188,7 @@ bool Ship::SetEngine( Engine *newEngine ) {
 		flareAnimation->Reset();
 		flareAnimation->SetLoopPercent(0.25f);
 
-		ComputeShipStats();
+		statsDirty = true;
 		
 		return( true );
 	}
@@ -241,7 +246,7 @@ void Ship::Rotate( float direction ) {
 	}
 
 	// Compute the maximum amount that the ship can turn
-	rotPerSecond = shipStats.GetRotationsPerSecond();
+	rotPerSecond = GetStats().rotPerSecond;
 	timerDelta = Timer::GetDelta();
 	maxturning = static_cast<float>((rotPerSecond * timerDelta) * 360.);
 
@@ -267,7 +272,7 @@ void Ship::Rotate( float direction ) {
 	/*
 	if( engine->GetSound() != NULL)
 	{
-		float engvol = OPTION(float,"options/sound/engines");
+		float engvol = soundEngines;
 		Coordinate offset = GetWorldPosition() - Camera::Instance()->GetFocusCoordinate();
 		if ( this->GetDrawOrder() == DRAW_ORDER_SHIP )
 			engvol = engvol * NON_PLAYER_SOUND_RATIO ;
@@ -285,15 +290,15 @@ void Ship::Accelerate( void ) {
 		return;
 	}
 
-	Trig *trig = Trig::Instance();
 	Coordinate momentum = GetMomentum();
-	float angle = static_cast<float>(trig->DegToRad( GetAngle() ));
-	float speed = shipStats.GetMaxSpeed() * status.engineBooster;
+	float speed = GetStats().maxSpeed * status.engineBooster;
 
-	float acceleration = (shipStats.GetForceOutput() * status.engineBooster ) / shipStats.GetMass();
+	float acceleration = (GetStats().forceOutput * status.engineBooster ) / GetStats().mass;
 
-	momentum += Coordinate( trig->GetCos( angle ) * acceleration * Timer::GetDelta(),
-	                -1 * trig->GetSin( angle ) * acceleration * Timer::GetDelta() );
+	float s, c;
+	Trig::SinCos( Trig::DegToRad( GetAngle() ), &s, &c );
+	momentum += Coordinate( c * acceleration * Timer::GetDelta(),
+	                -1 * s * acceleration * Timer::GetDelta() );
 
 	momentum.EnforceMagnitude(speed);
 	
@@ -304,12 +309,15 @@ void Ship::Accelerate( void ) {
 	// Play engine sound
 	if( engine->GetSound() != NULL)
 	{
-		float engvol = OPTION(float,"options/sound/engines");
+		float engvol = soundEngines;
+		SoundPriority priority = SOUND_PRIORITY_PLAYER;
 		Coordinate offset = GetWorldPosition() - Camera::Instance()->GetFocusCoordinate();
-		if ( this->GetDrawOrder() == DRAW_ORDER_SHIP )
+		if ( this->GetDrawOrder() == DRAW_ORDER_SHIP ) {
 			engvol = engvol * NON_PLAYER_SOUND_RATIO ;
+			priority = SOUND_PRIORITY_AMBIENT;
+		}
 		this->engine->GetSound()->SetVolume( engvol );
-		this->engine->GetSound()->PlayNoRestart( offset );
+		this->engine->GetSound()->PlayNoRestart( offset, priority );
 	}
 }
 
@@ -317,7 +325,7 @@ void Ship::Accelerate( void ) {
 /**\brief Adds damage to hull or shield
  */
 void Ship::Damage(short int damage) {
-	if(status.shieldDamage >= ((float)shipStats.GetShieldStrength()) * status.shieldBooster)
+	if(status.shieldDamage >= ((float)GetStats().shieldStrength) * status.shieldBooster)
 		status.hullDamage += damage;
 	else
 		status.shieldDamage += damage;
@@ -392,7 +400,7 @@ void Ship::Update( lua_State *L ) {
 	}
 	flareAnimation->Update();
 	Coordinate momentum	= GetMomentum();
-	momentum.EnforceMagnitude( shipStats.GetMaxSpeed() * status.engineBooster );
+	momentum.EnforceMagnitude( GetStats().maxSpeed * status.engineBooster );
 
 	// Show the hits taken as part of the radar color
 	if(IsDisabled()) SetRadarColor( GREY );
@@ -407,7 +415,7 @@ void Ship::Update( lua_State *L ) {
 	}
 	
 	// Ship has taken as much damage as possible...
-	if( status.hullDamage >=  (float)shipStats.GetHullStrength() ) {
+	if( status.hullDamage >=  (float)GetStats().hullStrength ) {
 		// It Explodes!
 		Explode( L );
 	}
@@ -417,7 +425,6 @@ void Ship::Update( lua_State *L ) {
  * \sa Sprite::Draw()
  */
 void Ship::Draw( void ) {
-	Trig *trig = Trig::Instance();
 	Coordinate position = GetWorldPosition();
 
 	/*
@@ -444,12 +451,12 @@ void Ship::Draw( void ) {
 		float direction = GetAngle();
 		float tx, ty;
 		
-		trig->RotatePoint( static_cast<float>((position.GetScreenX() -
+		Trig::RotatePoint( static_cast<float>((position.GetScreenX() -
 						(flareAnimation->GetHalfWidth() + model->GetThrustOffset()) )),
 				static_cast<float>(position.GetScreenY()),
 				static_cast<float>(position.GetScreenX()),
 				static_cast<float>(position.GetScreenY()), &tx, &ty,
-				static_cast<float>( trig->DegToRad( direction ) ));
+				static_cast<float>( Trig::DegToRad( direction ) ));
 		flareAnimation->Draw( (int)tx, (int)ty, direction );
 		
 		status.isAccelerating = false;
@@ -460,12 +467,12 @@ void Ship::Draw( void ) {
 		float direction = GetAngle();
 		float tx, ty;
 		
-		trig->RotatePoint( static_cast<float>((position.GetScreenX() -
+		Trig::RotatePoint( static_cast<float>((position.GetScreenX() -
 						(flareAnimation->GetHalfWidth() + model->GetThrustOffset()) )),
 				static_cast<float>(position.GetScreenY()),
 				static_cast<float>(position.GetScreenX()),
 				static_cast<float>(position.GetScreenY()), &tx, &ty,
-				static_cast<float>( trig->DegToRad( direction ) ));
+				static_cast<float>( Trig::DegToRad( direction ) ));
 		flareAnimation->Draw( (int)tx, (int)ty, direction );
 		
 		status.isRotatingLeft = false;
@@ -535,7 +542,6 @@ FireStatus Ship::Fire( Group group, int target ) {
  */
 FireStatus Ship::FireSlot( int slot, int target )
 {
-	Trig *trig = Trig::Instance();
 	SpriteManager *sprites = SpriteManager::Instance();
 	Weapon* currentWeapon = weaponSlots[slot].content;
 	float projectileAngle = 0.0f;
@@ -577,16 +583,18 @@ FireStatus Ship::FireSlot( int slot, int target )
 
 	// Play weapon sound
 	if( currentWeapon->GetSound() != NULL ) {
-		float weapvol = OPTION(float,"options/sound/weapons");
+		float weapvol = soundWeapons;
+		SoundPriority priority = SOUND_PRIORITY_PLAYER;
 		if ( this->GetDrawOrder() == DRAW_ORDER_SHIP ) {
 			weapvol *= NON_PLAYER_SOUND_RATIO;
+			priority = SOUND_PRIORITY_EFFECT;
 		}
 		currentWeapon->GetSound()->SetVolume( weapvol );
-		currentWeapon->GetSound()->Play( GetWorldPosition() - Camera::Instance()->GetFocusCoordinate() );
+		currentWeapon->GetSound()->Play( GetWorldPosition() - Camera::Instance()->GetFocusCoordinate(), priority );
 	}
 
 	// Find the world position of this slot
-	float angle = static_cast<float>(trig->DegToRad( GetAngle()));
+	float angle = Trig::DegToRad( GetAngle() );
 	Coordinate slotPosition = Coordinate( weaponSlots[slot].x, weaponSlots[slot].y ).RotateTo( angle ) + GetWorldPosition();
 
 	// Fire the weapon
@@ -610,7 +618,7 @@ void Ship::Explode( lua_State *L )
 	Camera* camera = Simulation_Lua::GetSimulation(L)->GetCamera();
 
 	// Play explode sound
-	if(OPTION(int, "options/sound/explosions")) {
+	if(soundExplosions) {
 		Sound *explodesnd = Sound::Get("Resources/Audio/Effects/18384__inferno__largex.wav.ogg");
 		explodesnd->Play( GetWorldPosition() - camera->GetFocusCoordinate());
 	}
@@ -629,7 +637,7 @@ void Ship::Explode( lua_State *L )
 void Ship::AddToShipWeaponList(Weapon *w){
 	if( w ) {
 		shipWeapons.push_back(w);
-		ComputeShipStats();
+		statsDirty = true;
 	}
 }
 
@@ -688,6 +696,7 @@ int Ship::AddShipWeapon(string weaponName){
 void Ship::RemoveFromShipWeaponList(int pos){
 	if( (unsigned int)pos >= shipWeapons.size() ) pos = 0;
 	shipWeapons.erase(shipWeapons.begin()+pos);
+	statsDirty = true;
 }
 
 /**\brief Removes a weapon from the ship
@@ -757,7 +766,7 @@ void Ship::AddAmmo(AmmoType ammoType, int qty){
 void Ship::AddOutfit(Outfit *outfit){
 	assert(outfit!=NULL);
 	outfits.push_back(outfit);
-	ComputeShipStats();
+	statsDirty = true;
 }
 
 void Ship::AddOutfit(string outfitName){
@@ -798,6 +807,22 @@ void Ship::RemoveOutfit(string outfitName){
 	}
 }
 
+/**\brief Remove every Weapon, Outfit, ammo and cargo and all credits.
+ * \details The Model and Engine stay until they are replaced.
+ */
+void Ship::ClearEquipment( void ) {
+	shipWeapons.clear();
+	weaponSlots.clear();
+	outfits.clear();
+	for(int a=0;a<max_ammo;a++){
+		ammo[a]=0;
+	}
+	commodities.clear();
+	status.cargoSpaceUsed = 0;
+	credits = 0;
+	statsDirty = true;
+}
+
 /**\brief Set the number of credits
  */
 void Ship::SetCredits(unsigned int _credits) {
@@ -819,7 +844,7 @@ int Ship::StoreCommodities(string commodity, unsigned int count) {
 	LogMsg(INFO, "Storing %d tons of %s.", count, commodity.c_str());
 
 	// Ensure that we have enough space to store this cargo
-	unsigned int cargoSpaceRemaining = (shipStats.GetCargoSpace() - status.cargoSpaceUsed);
+	unsigned int cargoSpaceRemaining = (GetStats().cargoSpace - status.cargoSpaceUsed);
 	if( count > cargoSpaceRemaining ) {
 		LogMsg(INFO, "Cannot Store all %d tons of %s. Only enough room for %d", count, commodity.c_str(), cargoSpaceRemaining);
 		count = cargoSpaceRemaining;
@@ -897,7 +922,7 @@ float Ship::GetDirectionTowards(float angle){
  * \return Hull remaining
  */
 float Ship::GetHullIntegrityPct() {
-	float remaining =  ( (float)shipStats.GetHullStrength() - (float)status.hullDamage ) / (float)shipStats.GetHullStrength();
+	float remaining =  ( (float)GetStats().hullStrength - (float)status.hullDamage ) / (float)GetStats().hullStrength;
 	return( remaining > 0.0f ? remaining : 0.0f );
 }
 
@@ -905,7 +930,7 @@ float Ship::GetHullIntegrityPct() {
  * \return Shield remaining
  */
 float Ship::GetShieldIntegrityPct() {
-	float remaining =  ( ((float)shipStats.GetShieldStrength() * status.shieldBooster) - (float)status.shieldDamage ) / ((float)shipStats.GetShieldStrength() * status.shieldBooster);
+	float remaining =  ( ((float)GetStats().shieldStrength * status.shieldBooster) - (float)status.shieldDamage ) / ((float)GetStats().shieldStrength * status.shieldBooster);
 	return( remaining > 0.0f ? remaining : 0.0f );
 }
 
@@ -943,28 +968,188 @@ map<Weapon*,int> Ship::GetWeaponsAndAmmo() {
 }
 
 
+/**\brief The Ship Statistics of everything that is equipped.
+ * \details The stats are only added up again after the Model, Engine,
+ *          Weapons or Outfits have changed.
+ */
+const OutfitStats& Ship::GetStats() {
+	if( statsDirty ) {
+		ComputeShipStats();
+	}
+	return shipStats;
+}
+
 /**\brief Computes the Ship Statistics based on equiped Outfit.
  */
 void Ship::ComputeShipStats() {
-	// Start with an empty Outfit
-	shipStats = Outfit();
+	// Start with empty stats
+	shipStats.Clear();
 
 	// Add the single Outfits
 	// Since there it is possible that a ship doesn't have a model or engine,
 	// only add them if they exist.
-	if(model){ shipStats += *model; }
-	if(engine){ shipStats += *engine; }
+	if(model){ shipStats += model->GetStats(); }
+	if(engine){ shipStats += engine->GetStats(); }
 
 	// Add any Outfit Collections
 	for(unsigned int i=0; i<shipWeapons.size(); i++){
-		shipStats += *shipWeapons[i];
+		shipStats += shipWeapons[i]->GetStats();
 	}
 
 	list<Outfit*>::iterator iter;
 	for(iter=outfits.begin(); iter!=outfits.end(); ++iter)
 	{
-		shipStats += *(*iter);
+		shipStats += (*iter)->GetStats();
+	}
+	statsDirty = false;
+}
+
+/**\brief Write the live state of this Ship.
+ * \details The Model, Engine, Weapons, Outfits and Commodities are written by
+ *          name.  Tick counts are written relative to now.
+ */
+void Ship::Snapshot( BinaryWriter& out ) {
+	Uint32 now = Timer::GetTicks();
+
+	Sprite::Snapshot( out );
+
+	out.WriteString( model ? model->GetName() : "" );
+	out.WriteString( engine ? engine->GetName() : "" );
+
+	out.WriteUint( weaponSlots.size() );
+	for( unsigned int i = 0; i < weaponSlots.size(); i++ ) {
+		out.WriteString( GetWeaponSlotContent( i ) );
+		out.WriteShort( weaponSlots[i].firingGroup );
+	}
+	out.WriteUint( shipWeapons.size() );
+	for( unsigned int i = 0; i < shipWeapons.size(); i++ ) {
+		out.WriteString( shipWeapons[i]->GetName() );
 	}
+	out.WriteUint( outfits.size() );
+	for( list<Outfit*>::iterator o = outfits.begin(); o != outfits.end(); ++o ) {
+		out.WriteString( (*o)->GetName() );
+	}
+	for( int a = 0; a < max_ammo; a++ ) {
+		out.WriteInt( ammo[a] );
+	}
+
+	out.WriteShort( status.hullDamage );
+	out.WriteShort( status.shieldDamage );
+	out.WriteUint( now - status.lastWeaponChangeAt );
+	for( int s = 0; s < 32; s++ ) {
+		out.WriteUint( now - status.lastFiredAt[s] );
+	}
+	out.WriteUint( status.cargoSpaceUsed );
+	out.WriteFloat( status.damageBooster );
+	out.WriteFloat( status.engineBooster );
+	out.WriteFloat( status.shieldBooster );
+	out.WriteUint( now - status.jumpStartTime );
+	out.WriteDouble( status.jumpDestination.GetX() );
+	out.WriteDouble( status.jumpDestination.GetY() );
+	out.WriteBool( status.isAccelerating );
+	out.WriteBool( status.isRotatingLeft );
+	out.WriteBool( status.isRotatingRight );
+	out.WriteBool( status.isDisabled );
+	out.WriteBool( status.isJumping );
+
+	out.WriteUint( credits );
+	out.WriteUint( commodities.size() );
+	for( map<Commodity*,unsigned int>::iterator c = commodities.begin(); c != commodities.end(); ++c ) {
+		out.WriteString( c->first->GetName() );
+		out.WriteUint( c->second );
+	}
+}
+
+/**\brief Read the live state written by Snapshot.
+ * \return false if the data ran out or names an unknown component.
+ */
+bool Ship::Restore( BinaryReader& in ) {
+	Uint32 now = Timer::GetTicks();
+	Uint32 count;
+	string name;
+
+	if( !Sprite::Restore( in ) ) {
+		return false;
+	}
+
+	// Setting the Model fills the weapon slots with its defaults
+	shipWeapons.clear();
+	name = in.ReadString();
+	if( name != "" ) {
+		Model* newModel = Models::Instance()->GetModel( name );
+		if( newModel == NULL ) {
+			LogMsg(ERR, "Cannot restore a ship with the unknown model '%s'.", name.c_str() );
+			return false;
+		}
+		SetModel( newModel );
+	}
+	name = in.ReadString();
+	if( name != "" ) {
+		Engine* newEngine = Engines::Instance()->GetEngine( name );
+		if( newEngine == NULL ) {
+			LogMsg(ERR, "Cannot restore a ship with the unknown engine '%s'.", name.c_str() );
+			return false;
+		}
+		SetEngine( newEngine );
+	}
+
+	count = in.ReadUint();
+	if( count != weaponSlots.size() ) {
+		LogMsg(ERR, "The ship has %u weapon slots instead of %u.", count, weaponSlots.size() );
+		return false;
+	}
+	for( unsigned int i = 0; i < count; i++ ) {
+		name = in.ReadString();
+		weaponSlots[i].content = (name == "") ? NULL : Weapons::Instance()->GetWeapon( name );
+		weaponSlots[i].firingGroup = in.ReadShort();
+	}
+	shipWeapons.clear();
+	count = in.ReadUint();
+	for( unsigned int i = 0; (i < count) && !in.Failed(); i++ ) {
+		Weapon* weapon = Weapons::Instance()->GetWeapon( in.ReadString() );
+		if( weapon ) shipWeapons.push_back( weapon );
+	}
+	outfits.clear();
+	count = in.ReadUint();
+	for( unsigned int i = 0; (i < count) && !in.Failed(); i++ ) {
+		Outfit* outfit = Outfits::Instance()->GetOutfit( in.ReadString() );
+		if( outfit ) outfits.push_back( outfit );
+	}
+	for( int a = 0; a < max_ammo; a++ ) {
+		ammo[a] = in.ReadInt();
+	}
+
+	status.hullDamage = in.ReadShort();
+	status.shieldDamage = in.ReadShort();
+	status.lastWeaponChangeAt = now - in.ReadUint();
+	for( int s = 0; s < 32; s++ ) {
+		status.lastFiredAt[s] = now - in.ReadUint();
+	}
+	status.cargoSpaceUsed = in.ReadUint();
+	status.damageBooster = in.ReadFloat();
+	status.engineBooster = in.ReadFloat();
+	status.shieldBooster = in.ReadFloat();
+	status.jumpStartTime = now - in.ReadUint();
+	double x = in.ReadDouble();
+	double y = in.ReadDouble();
+	status.jumpDestination = Coordinate( x, y );
+	status.isAccelerating = in.ReadBool();
+	status.isRotatingLeft = in.ReadBool();
+	status.isRotatingRight = in.ReadBool();
+	status.isDisabled = in.ReadBool();
+	status.isJumping = in.ReadBool();
+
+	credits = in.ReadUint();
+	commodities.clear();
+	count = in.ReadUint();
+	for( unsigned int i = 0; (i < count) && !in.Failed(); i++ ) {
+		Commodity* commodity = Commodities::Instance()->GetCommodity( in.ReadString() );
+		unsigned int tons = in.ReadUint();
+		if( commodity ) commodities[commodity] = tons;
+	}
+
+	statsDirty = true;
+	return !in.Failed();
 }
 
 /**\brief The total number of weapon slots on this ship
@@ -1,7 +1,7 @@
 /**\file			ship.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Friday, November 14, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -25,6 +25,8 @@ class Ship : public Sprite {
 		// Fundamental Sprite Mechanics
 		void Update( lua_State *L );
 		void Draw( void );
+		void Snapshot( BinaryWriter& out );
+		bool Restore( BinaryReader& in );
 
 		// Movement Mechanics
 		void Rotate( float direction );
@@ -65,6 +67,7 @@ class Ship : public Sprite {
 		void AddOutfit(string outfitName);
 		void RemoveOutfit(Outfit *outfit);
 		void RemoveOutfit(string outfitName);
+		void ClearEquipment( void );
 
 		// Weapon Slot Mechanics
 		int GetWeaponSlotCount();
@@ -95,15 +98,16 @@ class Ship : public Sprite {
 		//int GetCurrentAmmo();
 		int GetAmmo(AmmoType type);
 		map<Weapon*,int> GetWeaponsAndAmmo();
-		vector<Weapon*>* GetWeapons() { return &shipWeapons; }
-		list<Outfit*>* GetOutfits() { return &outfits; }
-		void SetOutfits(list<Outfit*>* o) { outfits = *o; }
+		const vector<Weapon*>* GetWeapons() const { return &shipWeapons; }
+		const list<Outfit*>* GetOutfits() const { return &outfits; }
+		void SetOutfits(list<Outfit*>* o) { outfits = *o; statsDirty = true; }
 
 		Engine* GetEngine( void ) const { return engine; }
 		unsigned int GetCredits() { return credits; }
 		unsigned int GetCargoSpaceUsed() { return status.cargoSpaceUsed; }
 		bool IsDisabled() { return status.isDisabled; }
-		int GetTotalCost() {  return shipStats.GetMSRP();  }
+		int GetTotalCost() {  return GetStats().msrp;  }
+		const OutfitStats& GetStats();
 		
 		virtual string GetName( void ) { return ""; }
 		virtual int GetDrawOrder( void ) {
@@ -124,7 +128,8 @@ class Ship : public Sprite {
 		Model *model;
 		Engine *engine;
 		Animation *flareAnimation;
-		Outfit shipStats;
+		OutfitStats shipStats; ///< The sum of every equipped Outfit.
+		bool statsDirty; ///< Set when the equipment changes and shipStats must be added up again.
 		//power distribution variables
 
 		enum Group{ PRIMARY, SECONDARY, MAX_GROUPS };
@@ -1,7 +1,7 @@
 /**\file			sprite.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -95,6 +95,54 @@ void Sprite::Update( lua_State *L ) {
 	lastMomentum = momentum;
 }
 
+/**\brief Write the live state of this Sprite.
+ * \details Subclasses that have their own state extend this and call it
+ *          first.  The Image is not written since it is set again by whatever
+ *          the Sprite is made from.  Times are written relative to now so that
+ *          a snapshot can be restored at any time.
+ * \sa SpriteManager::Snapshot
+ */
+void Sprite::Snapshot( BinaryWriter& out ) {
+	out.WriteInt( id );
+	out.WriteDouble( worldPosition.GetX() );
+	out.WriteDouble( worldPosition.GetY() );
+	out.WriteDouble( momentum.GetX() );
+	out.WriteDouble( momentum.GetY() );
+	out.WriteDouble( acceleration.GetX() );
+	out.WriteDouble( acceleration.GetY() );
+	out.WriteDouble( lastMomentum.GetX() );
+	out.WriteDouble( lastMomentum.GetY() );
+	out.WriteFloat( angle );
+	out.WriteFloat( radarColor.r );
+	out.WriteFloat( radarColor.g );
+	out.WriteFloat( radarColor.b );
+	out.WriteUint( Timer::GetLogicalFrameCount() - lastUpdateFrame );
+}
+
+/**\brief Read the live state written by Snapshot.
+ * \details This also takes the ID of the Sprite that was written, so the
+ *          Sprite must not be in the SpriteManager while it is restored.
+ * \return false if the data ran out.
+ */
+bool Sprite::Restore( BinaryReader& in ) {
+	double x, y;
+	id = in.ReadInt();
+	x = in.ReadDouble(); y = in.ReadDouble();
+	worldPosition = Coordinate( x, y );
+	x = in.ReadDouble(); y = in.ReadDouble();
+	momentum = Coordinate( x, y );
+	x = in.ReadDouble(); y = in.ReadDouble();
+	acceleration = Coordinate( x, y );
+	x = in.ReadDouble(); y = in.ReadDouble();
+	lastMomentum = Coordinate( x, y );
+	angle = in.ReadFloat();
+	radarColor.r = in.ReadFloat();
+	radarColor.g = in.ReadFloat();
+	radarColor.b = in.ReadFloat();
+	lastUpdateFrame = Timer::GetLogicalFrameCount() - in.ReadUint();
+	return !in.Failed();
+}
+
 /**\brief Draw
  * \details The Sprite is drawn centered on wx,wy.
  *          This will attempt to Draw the sprite even if wx,wy are completely off the Screen.
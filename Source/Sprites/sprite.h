@@ -1,7 +1,7 @@
 /**\file			sprite.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -12,6 +12,7 @@
 #include "Graphics/image.h"
 #include "Graphics/video.h"
 #include "Utilities/lua.h"
+#include "Utilities/binary.h"
 #include "Utilities/coordinate.h"
 
 // With the draw order, higher numbers are drawn later (on top)
@@ -35,8 +36,14 @@ class Sprite {
 		
 		virtual void Update( lua_State *L );
 		virtual void Draw( void );
+
+		virtual void Snapshot( BinaryWriter& out );
+		virtual bool Restore( BinaryReader& in );
 		
 		int GetID( void ) { return id; }
+		static long int GetNextID( void ) { return sprite_ids; }
+		static void SetNextID( long int next ) { sprite_ids = next; }
+		void Renumber( void ) { id = sprite_ids++; } ///< Become a new Sprite, for Sprites that are reused.
 
 		float GetAngle( void ) const {
 			return( angle );
@@ -76,7 +83,7 @@ class Sprite {
 		Coordinate momentum; ///< The current Speed and Direction that this Sprite is moving (not pointing).
 		Coordinate acceleration; ///< The ammount that the Sprite accelerated during the previous Update.
 		Coordinate lastMomentum; ///< The momentum that this Sprite had after the previous Update.
-		Image *image; ///< The current Image that this Sprite is using.
+		ResourceHandle<Image> image; ///< The current Image that this Sprite is using.
 		float angle; ///< The current direction that this Sprite is pointing (not moving).
 		int radarSize; ///< A Rough appoximation of this Sprite's size.
 		Color radarColor; ///< The color of this Sprite.
@@ -1,6 +1,7 @@
 /**\file			spritemanager.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -9,11 +10,16 @@
 #include "common.h"
 #include "Sprites/ai.h"
 #include "Sprites/effects.h"
+#include "Sprites/gate.h"
+#include "Sprites/planets.h"
+#include "Sprites/player.h"
+#include "Sprites/projectile.h"
 #include "Sprites/spritemanager.h"
 #include "Utilities/log.h"
 #include "Utilities/quadtree.h"
 #include "Engine/camera.h"
 #include "Engine/simulation_lua.h"
+#include "Engine/weapons.h"
 
 /** \defgroup Sprites Sprite Objects and their Management
  * @{
@@ -48,6 +54,10 @@
  *   - Sprites can be queried by passing an ID.
  *   \see GetSpriteByID
  *
+ * The SpriteManager also keeps the trigger volumes, which tell their
+ * listeners when ships enter or leave them.
+ *   \see Triggers
+ *
  * Sprites are never deleted immediately.  This is to prevent a Sprite from
  * being deleted during the middle of the Update Loop.  Instead, 'deleted'
  * Sprites are recorded in a list and deleted in a batch once per Update.
@@ -63,6 +73,7 @@ SpriteManager::SpriteManager() :
 	 , fullUpdatePeriod (120)		//update the full quadrant map every 120 ticks
 	 , numRegularBands (2)			//the regular (per-tick) updates are on this number of bands
 	 , numSemiRegularBands (5)		//the semi-regular updates are on this number of bands - this SHOULD be easily divisible into semiRegularPeriod
+	 , persistentChanges (0)
 {
 	player = NULL;
 
@@ -86,6 +97,8 @@ SpriteManager& SpriteManager::operator=( SpriteManager& object ){
 	trees = object.trees;
 	spritelist = object.spritelist;
 	spritelookup = object.spritelookup;
+	movers = object.movers;
+	triggers = object.triggers;
 	
 	spritesToDelete = object.spritesToDelete;
 	
@@ -102,6 +115,8 @@ SpriteManager& SpriteManager::operator=( SpriteManager& object ){
 	eastEdge = object.eastEdge;
 	westEdge = object.westEdge;
 
+	persistentChanges = object.persistentChanges + 1;
+
 	return * this;
 }
 
@@ -124,6 +139,12 @@ void SpriteManager::Add( Sprite *sprite ) {
 	spritelist->push_back(sprite);
 	spritelookup->insert(make_pair(sprite->GetID(),sprite));
 	GetQuadrant( sprite->GetWorldPosition() )->Insert( sprite );
+	if( sprite->GetDrawOrder() & TRIGGER_MOVERS ) {
+		movers.push_back( sprite );
+	}
+	if( IsPersistent( sprite->GetDrawOrder() ) ) {
+		persistentChanges++;
+	}
 }
 
 /**\brief Adds player sprite to the manager.
@@ -142,17 +163,33 @@ void SpriteManager::AddPlayer( Sprite *sprite ) {
 bool SpriteManager::DeleteSprite( Sprite *sprite ) {
 	if(sprite == player) LogMsg(ALERT, "Deleting player sprite. Should we be doing this?");
 
-	spritelist->remove(sprite);
-	spritelookup->erase( sprite->GetID() );
-	GetQuadrant( sprite->GetWorldPosition() )->Delete( sprite );
+	Detach( sprite );
 	// Delete the sprite itself unless it is a Planet or Player.
 	// Planets and Players are special sprites since they are Components and get saved.
-	if( !(sprite->GetDrawOrder() & (DRAW_ORDER_PLAYER | DRAW_ORDER_PLANET | DRAW_ORDER_GATE_TOP | DRAW_ORDER_GATE_BOTTOM)) ) {
+	if( !IsPersistent( sprite->GetDrawOrder() ) ) {
 		delete sprite;
+	} else {
+		persistentChanges++;
 	}
 	return true;
 }
 
+/**\brief Removes a sprite from the manager without deleting it.
+ * \param sprite Pointer to the sprite
+ * \details
+ * The caller owns the sprite afterwards and may Add it again.  This must not
+ * be called while the sprites are being updated.
+ */
+void SpriteManager::Detach( Sprite *sprite ) {
+	spritelist->remove(sprite);
+	spritelookup->erase( sprite->GetID() );
+	GetQuadrant( sprite->GetWorldPosition() )->Delete( sprite );
+	if( sprite->GetDrawOrder() & TRIGGER_MOVERS ) {
+		movers.remove( sprite );
+		triggers.Forget( sprite );
+	}
+}
+
 /**\brief Deletes a sprite.
  * \param sprite Pointer to the sprite object
  * \details
@@ -244,6 +281,8 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 		spritesToDelete.clear();
 	}
 
+	UpdateTriggers( L );
+
 	for ( iter = quadList.begin(); iter != quadList.end(); ++iter ) {
 		(*iter)->ReBallance();
 	}
@@ -254,6 +293,14 @@ void SpriteManager::Update( lua_State *L, bool lowFps) {
 	UpdateTickCount ();
 }
 
+/**\brief Send the enter and exit events of the trigger volumes.
+ * \details Every ship is checked on every tick, even in the wave update mode,
+ *          so that nothing can slip through a Gate.
+ */
+void SpriteManager::UpdateTriggers( lua_State *L ) {
+	triggers.Update( L, movers );
+}
+
 /**\brief Deletes empty QuadTrees (Internal use)
  */
 void SpriteManager::DeleteEmptyQuadrants() {
@@ -425,43 +472,45 @@ list<QuadTree*> SpriteManager::GetQuadrantsInBand ( Coordinate c, int bandIndex)
 	
 
 /**\brief Retrieves nearby QuadTrees
+ * \details The nearby vector is emptied first.  Since the callers reuse one
+ *          vector, this only allocates when more QuadTrees are found than
+ *          ever before.
  * \param c Coordinate
  * \param r Radius
- * \return std::list of QuadTree pointers.
+ * \param[out] nearby The QuadTrees that may hold Sprites within the radius.
  */
-list<QuadTree*> SpriteManager::GetQuadrantsNear( Coordinate c, float r) {
-	// The possibleQuadrants are those trees adjacent and within a radius r
+void SpriteManager::GetQuadrantsNear( Coordinate c, float r, vector<QuadTree*> *nearby ) {
+	// The possible quadrants are those trees adjacent and within a radius r
 	// Gather more trees when r is greater than the size of a quadrant
-	map<Coordinate,QuadTree*>::iterator iter;
-	list<QuadTree*> nearbyQuadrants;
-	set<Coordinate> possibleQuadrants;
-
-	Coordinate center = GetQuadrantCenter(c);
+	nearby->clear();
 
-	possibleQuadrants.insert( center );
+	AddQuadrantNear( GetQuadrantCenter(c), c, r, nearby );
 	float R = r;
 	do{
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,-0)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-0,+R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+0,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,+0)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(-R,+R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,-R)));
-		possibleQuadrants.insert( GetQuadrantCenter(c + Coordinate(+R,+R)));
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(-R,-0)), c, r, nearby );
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(-0,+R)), c, r, nearby );
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(+0,-R)), c, r, nearby );
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(+R,+0)), c, r, nearby );
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(-R,-R)), c, r, nearby );
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(-R,+R)), c, r, nearby );
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(+R,-R)), c, r, nearby );
+		AddQuadrantNear( GetQuadrantCenter(c + Coordinate(+R,+R)), c, r, nearby );
 		R/=2;
 	} while(R>QUADRANTSIZE);
-	set<Coordinate>::iterator it;
-	for(it = possibleQuadrants.begin(); it != possibleQuadrants.end(); ++it) {
-		//here we're checking to see if this possible quadrant is one of the existing quadrants
-		// and if it is then we add its QuadTree to the vector we're returning
-		//how about we try creating the quadrant if it does not already exist
-		iter = trees.find(*it);
-		if(iter != trees.end() && iter->second->PossiblyNear(c,r)){
-			nearbyQuadrants.push_back(iter->second);
-		}
+}
+
+/**\brief Add the QuadTree at a quadrant center if it exists and is near
+ * \details Neighbouring points often share a quadrant, so a QuadTree that
+ *          is already in the vector is not added again.
+ */
+void SpriteManager::AddQuadrantNear( Coordinate quadrant, Coordinate c, float r, vector<QuadTree*> *nearby ) {
+	map<Coordinate,QuadTree*>::iterator iter = trees.find( quadrant );
+	if( iter == trees.end() || !iter->second->PossiblyNear(c,r) ) {
+		return;
+	}
+	if( find( nearby->begin(), nearby->end(), iter->second ) == nearby->end() ) {
+		nearby->push_back( iter->second );
 	}
-	return nearbyQuadrants;
 }
 
 
@@ -499,13 +548,10 @@ list<Sprite*> *SpriteManager::GetSpritesNear(Coordinate c, float r, int type) {
 	list<Sprite*> *sprites = new list<Sprite*>();
 	
 	// Search the possible quadrants
-	list<QuadTree*> nearbyQuadrants = GetQuadrantsNear(c,r);
-	list<QuadTree*>::iterator it;
-	for(it = nearbyQuadrants.begin(); it != nearbyQuadrants.end(); ++it) {
-			list<Sprite *>* nearby = new list<Sprite*>;
-			(*it)->GetSpritesNear(c,r,nearby,type);
-			sprites->splice(sprites->end(), *nearby);
-			delete nearby;
+	GetQuadrantsNear(c,r,&quadrantsNear);
+	vector<QuadTree*>::iterator it;
+	for(it = quadrantsNear.begin(); it != quadrantsNear.end(); ++it) {
+		(*it)->GetSpritesNear(c,r,sprites,type);
 	}
 
 	// Sort sprites by their distance from the coordinate c
@@ -513,6 +559,25 @@ list<Sprite*> *SpriteManager::GetSpritesNear(Coordinate c, float r, int type) {
 	return( sprites );
 }
 
+/**\brief Find the Sprites near a coordinate without sorting them.
+ * \details The found vector is emptied first.  Callers that run every frame
+ *          should keep the vector between calls, since it then only needs
+ *          to allocate when more Sprites are found than ever before.
+ * \param c The center of the search.
+ * \param r The radius of the search.
+ * \param[out] found The Sprites that are within the radius, in no order.
+ * \param type A DRAW_ORDER mask used to filter for desired Sprite types.
+ */
+void SpriteManager::FindSpritesNear(Coordinate c, float r, vector<Sprite*> *found, int type) {
+	found->clear();
+
+	GetQuadrantsNear(c,r,&quadrantsNear);
+	vector<QuadTree*>::iterator it;
+	for(it = quadrantsNear.begin(); it != quadrantsNear.end(); ++it) {
+		(*it)->GetSpritesNear(c,r,found,type);
+	}
+}
+
 /**\brief Get a Sprite nearest to another Sprite.
  * \details Rather than just accept a Coordinate, this requires another Sprite
  *          because the common usage is to look for a nearby enemy or
@@ -539,9 +604,9 @@ Sprite* SpriteManager::GetNearestSprite(Sprite* obj, float r, int type) {
 	Sprite* possible=NULL;
 	if(obj==NULL)
 		return (Sprite*)NULL;
-	list<QuadTree*> nearbyQuadrants = GetQuadrantsNear(obj->GetWorldPosition(),r);
-	list<QuadTree*>::iterator it;
-	for(it = nearbyQuadrants.begin(); it != nearbyQuadrants.end(); ++it) {
+	GetQuadrantsNear(obj->GetWorldPosition(),r,&quadrantsNear);
+	vector<QuadTree*>::iterator it;
+	for(it = quadrantsNear.begin(); it != quadrantsNear.end(); ++it) {
 		possible = (*it)->GetNearestSprite(obj,r, type);
 		if(possible!=NULL) {
 			tmpdist = (obj->GetWorldPosition()-possible->GetWorldPosition()).GetMagnitude();
@@ -665,6 +730,199 @@ void SpriteManager::Save() {
 	xmlFreeDoc( doc );
 }
 
+/**\brief One Sprite in a snapshot, found while checking it.
+ * \see SpriteManager::Restore
+ */
+typedef struct {
+	int drawOrder;
+	string key;
+	size_t offset; ///< Where the Sprite's own state starts.
+	Uint32 size;
+	Sprite* sprite; ///< The existing Sprite, for persistent Sprites.
+	Weapon* weapon; ///< The Weapon, for Projectiles.
+} SnapshotRecord;
+
+/**\brief Write every Sprite into a compact binary snapshot.
+ * \details The snapshot starts with the next Sprite ID, the tick count and
+ *          the number of Sprites.  Each Sprite is then written as its draw
+ *          order, a key that says what to create it from, the size of its
+ *          state and then the state itself from Sprite::Snapshot.
+ *
+ *          Sprites are written in the order of the sprite list so that they
+ *          are added back in the same order.
+ *
+ *          This should only be called between Updates.
+ * \see Restore, Simulation::SaveSnapshot
+ */
+void SpriteManager::Snapshot( BinaryWriter& out ) {
+	out.WriteUint( static_cast<Uint32>( Sprite::GetNextID() ) );
+	out.WriteInt( tickCount );
+	out.WriteUint( spritelist->size() );
+
+	list<Sprite*>::iterator i;
+	for( i = spritelist->begin(); i != spritelist->end(); ++i ) {
+		BinaryWriter state;
+		(*i)->Snapshot( state );
+
+		out.WriteUint( (*i)->GetDrawOrder() );
+		out.WriteString( GetSnapshotKey( *i ) );
+		out.WriteUint( state.GetSize() );
+		out.WriteBytes( state.GetData(), state.GetSize() );
+	}
+}
+
+/**\brief Replace every Sprite with the Sprites from a snapshot.
+ * \details Planets, Gates and the Player are Components, so they are not
+ *          created again.  They must already exist with the same IDs, which
+ *          means that a snapshot can only be restored into the Simulation
+ *          that it was taken from.  Their state is restored in place.
+ *
+ *          Every other Sprite is deleted and recreated from the snapshot.
+ *
+ *          The whole snapshot is checked before anything is changed, so a
+ *          snapshot that does not match leaves the Sprites as they were.
+ * \return false if the snapshot could not be restored.
+ */
+bool SpriteManager::Restore( BinaryReader& in ) {
+	Uint32 nextID = in.ReadUint();
+	int ticks = in.ReadInt();
+	Uint32 count = in.ReadUint();
+
+	// Check every record first
+	vector<SnapshotRecord> records;
+	for( Uint32 r = 0; (r < count) && !in.Failed(); r++ ) {
+		SnapshotRecord record;
+		record.drawOrder = static_cast<int>( in.ReadUint() );
+		record.key = in.ReadString();
+		record.size = in.ReadUint();
+		record.offset = in.Tell();
+		record.sprite = NULL;
+		record.weapon = NULL;
+		int id = in.ReadInt();
+		if( in.Failed() || (in.Seek( record.offset + record.size ) != true) ) {
+			LogMsg(ERR, "The sprite snapshot is truncated." );
+			return false;
+		}
+
+		if( IsPersistent( record.drawOrder ) ) {
+			record.sprite = GetSpriteByID( id );
+			if( (record.sprite == NULL) || (record.sprite->GetDrawOrder() != record.drawOrder) ) {
+				LogMsg(ERR, "The sprite snapshot does not match this simulation: sprite %d '%s' is missing.", id, record.key.c_str() );
+				return false;
+			}
+		} else if( record.drawOrder == DRAW_ORDER_PROJECTILE ) {
+			record.weapon = Weapons::Instance()->GetWeapon( record.key );
+			if( record.weapon == NULL ) {
+				LogMsg(ERR, "The sprite snapshot uses the unknown weapon '%s'.", record.key.c_str() );
+				return false;
+			}
+		} else if( (record.drawOrder != DRAW_ORDER_SHIP) && (record.drawOrder != DRAW_ORDER_EFFECT) ) {
+			LogMsg(ERR, "The sprite snapshot has a sprite with the unknown draw order %d.", record.drawOrder );
+			return false;
+		}
+		records.push_back( record );
+	}
+	if( in.Failed() ) {
+		LogMsg(ERR, "The sprite snapshot is truncated." );
+		return false;
+	}
+
+	// Forget every Sprite, but keep the persistent ones
+	list<Sprite*> persistent;
+	list<Sprite*>::iterator i;
+	for( i = spritelist->begin(); i != spritelist->end(); ++i ) {
+		if( IsPersistent( (*i)->GetDrawOrder() ) ) {
+			persistent.push_back( *i );
+		} else {
+			delete (*i);
+		}
+	}
+	spritelist->clear();
+	spritelookup->clear();
+	spritesToDelete.clear();
+	movers.clear();
+	triggers.Reset();
+	map<Coordinate,QuadTree*>::iterator iter;
+	for ( iter = trees.begin(); iter != trees.end(); ++iter ) {
+		delete iter->second;
+	}
+	trees.clear();
+
+	// Recreate the Sprites in their original order
+	bool restored = true;
+	vector<SnapshotRecord>::iterator record;
+	for( record = records.begin(); record != records.end(); ++record ) {
+		Sprite* sprite = record->sprite;
+		switch( record->drawOrder ) {
+			case DRAW_ORDER_PROJECTILE:
+				sprite = new Projectile( 1.0f, 0.0f, Coordinate(), Coordinate(), record->weapon );
+				break;
+			case DRAW_ORDER_SHIP:
+				sprite = new AI( "", "" );
+				break;
+			case DRAW_ORDER_EFFECT:
+				sprite = new Effect( Coordinate(), record->key, 0.0f );
+				break;
+			default:
+				persistent.remove( sprite );
+				break;
+		}
+
+		in.Seek( record->offset );
+		if( (sprite->Restore( in ) != true) || (in.Tell() != record->offset + record->size) ) {
+			LogMsg(ERR, "Could not restore the sprite '%s' from the snapshot.", record->key.c_str() );
+			restored = false;
+			if( !IsPersistent( record->drawOrder ) ) {
+				delete sprite;
+				continue;
+			}
+		}
+		Add( sprite );
+	}
+
+	// Persistent Sprites that were added after the snapshot stay where they are
+	for( i = persistent.begin(); i != persistent.end(); ++i ) {
+		Add( *i );
+	}
+
+	// The ships inside a Gate were already inside when the snapshot was taken
+	triggers.Settle( movers );
+
+	Sprite::SetNextID( nextID );
+	tickCount = ticks;
+	return restored;
+}
+
+/**\brief Sprites that are Components and so are never deleted.
+ */
+bool SpriteManager::IsPersistent( int drawOrder ) {
+	return (drawOrder & (DRAW_ORDER_PLAYER | DRAW_ORDER_PLANET | DRAW_ORDER_GATE_TOP | DRAW_ORDER_GATE_BOTTOM)) != 0;
+}
+
+/**\brief The name of what a Sprite is made from.
+ * \details For a Projectile this is its Weapon and for an Effect this is its
+ *          animation, which are needed to create them again.  For the others
+ *          this is only used in messages.
+ */
+string SpriteManager::GetSnapshotKey( Sprite* sprite ) {
+	switch( sprite->GetDrawOrder() ) {
+		case DRAW_ORDER_PLANET:
+			return ((Planet*)sprite)->GetName();
+		case DRAW_ORDER_GATE_TOP:
+			return ((Gate*)sprite)->GetName();
+		case DRAW_ORDER_PLAYER:
+			return ((Player*)sprite)->GetName();
+		case DRAW_ORDER_SHIP:
+			return ((AI*)sprite)->GetName();
+		case DRAW_ORDER_PROJECTILE:
+			return ((Projectile*)sprite)->GetWeapon()->GetName();
+		case DRAW_ORDER_EFFECT:
+			return ((Effect*)sprite)->GetFilename();
+		default:
+			return "";
+	}
+}
+
 /**\brief Count up to fullUpdatePeriod
  */
 void SpriteManager::UpdateTickCount ()
@@ -1,6 +1,7 @@
 /**\file			spritemanager.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -9,7 +10,9 @@
 #define __H_SPRITEMANAGER__
 
 #include "Sprites/sprite.h"
+#include "Utilities/binary.h"
 #include "Utilities/quadtree.h"
+#include "Utilities/triggers.h"
 
 class SpriteManager {
 	public:
@@ -19,6 +22,7 @@ class SpriteManager {
 		void Add( Sprite *sprite );
 		void AddPlayer( Sprite *sprite );
 		bool Delete( Sprite *sprite );
+		void Detach( Sprite *sprite );
 		
 		void Update( lua_State *L, bool lowFps);
 		void Draw( Coordinate focus );
@@ -27,15 +31,23 @@ class SpriteManager {
 		Sprite *GetSpriteByID(int id);
 		list<Sprite*> *GetSprites(int type = DRAW_ORDER_ALL);
 		list<Sprite*> *GetSpritesNear(Coordinate c, float r, int type = DRAW_ORDER_ALL);
+		void FindSpritesNear(Coordinate c, float r, vector<Sprite*> *found, int type = DRAW_ORDER_ALL);
 		Sprite* GetNearestSprite(Sprite *obj, float r, int type = DRAW_ORDER_ALL);
 		Sprite* GetNearestSprite(Coordinate c, float r, int type = DRAW_ORDER_ALL);
 
+		Triggers* GetTriggers() { return &triggers; }
+		void UpdateTriggers( lua_State *L );
+
 		Coordinate GetQuadrantCenter( Coordinate point );
 		int GetNumQuadrants() { return trees.size(); }
 		int GetNumSprites();
+		Uint32 GetPersistentChanges() { return persistentChanges; }
 		void GetBoundaries(float *northEdge, float *southEdge, float *eastEdge, float *westEdge);
 
 		void Save();
+
+		void Snapshot( BinaryWriter& out );
+		bool Restore( BinaryReader& in );
 		
 	protected:
 		SpriteManager();
@@ -45,6 +57,8 @@ class SpriteManager {
 		map<Coordinate,QuadTree*> trees;    ///< Collection of all Sprites.  Use the tree when referring to the sprites at a location.
 		list<Sprite*> *spritelist;          ///< Collection of all Sprites.  Use the list when referring to all sprites.
 		map<int,Sprite*> *spritelookup;     ///< Collection of all Sprites.  Use the map when referring to sprites by their unique ID.
+		list<Sprite*> movers;               ///< The Sprites that can set off trigger volumes.
+		Triggers triggers;                  ///< Regions that report when movers enter and leave them.
 
 		Sprite *player;                     ///< The Player Sprite.
 		
@@ -61,15 +75,22 @@ class SpriteManager {
 
 		float northEdge, southEdge, eastEdge, westEdge; ///< The Edges of the universe
 
+		Uint32 persistentChanges;           ///< Counts the Planets, Gates and Players that have been added or removed.
+		vector<QuadTree*> quadrantsNear;    ///< Reused by each search for the QuadTrees near a point.
+
 		bool DeleteSprite( Sprite *sprite );
 		void DeleteEmptyQuadrants( void );
 		QuadTree* GetQuadrant( Coordinate point );
-		list<QuadTree*> GetQuadrantsNear( Coordinate c, float r);
+		void GetQuadrantsNear( Coordinate c, float r, vector<QuadTree*> *nearby );
+		void AddQuadrantNear( Coordinate quadrant, Coordinate c, float r, vector<QuadTree*> *nearby );
 		list<QuadTree*> GetQuadrantsInBand ( Coordinate c, int bandIndex);
 		void AdjustBoundaries();
 		void UpdateTickCount();
 
 		void GetAllQuadrants( list<QuadTree*> *newTree);
+
+		static bool IsPersistent( int drawOrder );
+		static string GetSnapshotKey( Sprite* sprite );
 };
 
 #endif // __H_SPRITEMANAGER__
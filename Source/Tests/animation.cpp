@@ -0,0 +1,54 @@
+/**\file			animation.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Animation loading and drawing comparison
+ * \details
+ * Loads every Animation in Resources/Animations/ and reports how long it took
+ * to load, how long it took to draw every frame, and how many textures were
+ * bound while drawing.  Convert an Animation with "ani.py --atlas" and run
+ * this again to compare the atlas format against the original format.
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Graphics/animation.h"
+#include "Graphics/video.h"
+#include "Utilities/filesystem.h"
+
+int test_animation(int argc, char **argv) {
+	int failures = 0;
+	list<string> files = Filesystem::Enumerate( "Resources/Animations/", ".ani" );
+
+	cout << "Animation                 Frames Textures   Load ms   Draw ms" << endl;
+	for( list<string>::iterator f = files.begin(); f != files.end(); ++f ) {
+		string path = "Resources/Animations/" + *f;
+
+		Uint32 start = SDL_GetTicks();
+		Ani* ani = new Ani( path );
+		Uint32 loaded = SDL_GetTicks();
+
+		if( ani->GetNumFrames() == 0 ) {
+			cout << *f << " failed to load." << endl;
+			failures++;
+			continue;
+		}
+
+		// Draw every frame, as an Animation would over its lifetime
+		Video::Erase();
+		for( int i = 0; i < ani->GetNumFrames(); i++ ) {
+			ani->GetFrame(i)->DrawCentered( Video::GetWidth()/2, Video::GetHeight()/2, 0.f );
+		}
+		glFinish();
+		Uint32 drawn = SDL_GetTicks();
+		Video::Update();
+
+		cout << setw(25) << left << *f << right
+		     << setw(7) << ani->GetNumFrames()
+		     << setw(9) << ani->GetTextureCount()
+		     << setw(10) << (loaded - start)
+		     << setw(10) << (drawn - loaded) << endl;
+	}
+
+	return failures;
+}
@@ -0,0 +1,13 @@
+/**\file			animation.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Animation loading and drawing comparison
+ * \details
+ */
+
+
+#ifndef __H_TEST_ANIMATION__
+#define __H_TEST_ANIMATION__
+int test_animation(int argc, char **argv);
+#endif // __H_TEST_ANIMATION__
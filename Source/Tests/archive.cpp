@@ -0,0 +1,93 @@
+/**\file			archive.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Packed resource archive timing
+ * \details
+ * Opens and maps every file in Resources.epk, first as loose files and then
+ * from the archive, checks that both give the same bytes and reports how long
+ * each took.  Build the archive first with:
+ *
+ *   python pack.py
+ *
+ * The time for a cold start is best measured after dropping the disk cache,
+ * and the number of system calls with and without the archive can be counted
+ * with:
+ *
+ *   strace -c -f ./epiar --run-test=archive
+ *
+ *   --passes=N     Times to read every file (default 5)
+ */
+
+#include "includes.h"
+#include "Tests/setup.h"
+#include "Utilities/archive.h"
+#include "Utilities/argparser.h"
+#include "Utilities/binary.h"
+#include "Utilities/file.h"
+#include "Utilities/filesystem.h"
+
+/**\brief Open and map every file once.
+ * \returns The milliseconds taken, or -1 if a file could not be read.
+ */
+static int ReadAll( list<string>& names, map<string,Uint32>& hashes ) {
+	Uint32 start = SDL_GetTicks();
+	for( list<string>::iterator n = names.begin(); n != names.end(); ++n ) {
+		File file;
+		if( !file.OpenRead( *n ) ) {
+			cout << "Could not open '" << *n << "'." << endl;
+			return -1;
+		}
+		const char *contents = file.Map();
+		if( contents == NULL ) {
+			cout << "Could not read '" << *n << "'." << endl;
+			return -1;
+		}
+		hashes[*n] = BinaryReader::Hash( contents, file.GetLength() );
+	}
+	return static_cast<int>( SDL_GetTicks() - start );
+}
+
+int test_archive(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "passes", "Times to read every file" );
+
+	int passes = GetIntArgument( args, "passes", 5 );
+	if( passes < 1 ) passes = 1;
+
+	if( !Archive::IsMounted() && !Filesystem::MountArchive( "Resources.epk" ) ) {
+		cout << "There is no Resources.epk. Build one with pack.py." << endl;
+		return -1;
+	}
+	list<string> names = Archive::GetNames();
+	map<string,Uint32> packed, loose;
+	int packedTime = 0, looseTime = 0;
+
+	for( int p = 0; p < passes; p++ ) {
+		int elapsed = ReadAll( names, packed );
+		if( elapsed < 0 ) return -1;
+		packedTime += elapsed;
+	}
+
+	Archive::UnmountAll();
+	for( int p = 0; p < passes; p++ ) {
+		int elapsed = ReadAll( names, loose );
+		if( elapsed < 0 ) return -1;
+		looseTime += elapsed;
+	}
+	Filesystem::MountArchive( "Resources.epk" );
+
+	int different = 0;
+	for( map<string,Uint32>::iterator h = packed.begin(); h != packed.end(); ++h ) {
+		if( loose[h->first] != h->second ) {
+			cout << "'" << h->first << "' is out of date in the archive." << endl;
+			different++;
+		}
+	}
+
+	cout << names.size() << " files, " << passes << " passes" << endl;
+	cout << "Loose files: " << looseTime / passes << " ms per pass" << endl;
+	cout << "Archive:     " << packedTime / passes << " ms per pass" << endl;
+
+	return different;
+}
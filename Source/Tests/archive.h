@@ -0,0 +1,13 @@
+/**\file			archive.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Packed resource archive timing
+ * \details
+ */
+
+
+#ifndef __H_TEST_ARCHIVE__
+#define __H_TEST_ARCHIVE__
+int test_archive(int argc, char **argv);
+#endif // __H_TEST_ARCHIVE__
@@ -0,0 +1,389 @@
+/**\file			benchmark.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Offscreen rendering benchmark
+ * \details
+ * Draws a series of scripted scenes into an offscreen target for a fixed
+ * number of frames, then reports frame time percentiles and the number of
+ * draw calls in each frame.  Nothing is shown on screen and no input is
+ * needed, so this can run on a software renderer, for example:
+ *
+ *   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./epiar --run-test=benchmark
+ *
+ * The last frame of each scene can be compared against a golden image so
+ * that a rendering optimization can be checked for visible changes:
+ *
+ *   --golden=DIR         Compare against DIR/<scene>.bmp
+ *   --update-golden      Write DIR/<scene>.bmp instead of comparing
+ *   --frames=N           Frames to draw per scene (default 120)
+ *   --tolerance=N        Allowed difference per color channel (default 8)
+ *   --width=W --height=H Size of the offscreen target (default 1024x768)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/camera.h"
+#include "Engine/hud.h"
+#include "Engine/starfield.h"
+#include "Graphics/image.h"
+#include "Graphics/video.h"
+#include "Engine/alliances.h"
+#include "Sprites/planets.h"
+#include "Sprites/sprite.h"
+#include "Sprites/spritemanager.h"
+#include "UI/ui.h"
+#include "UI/widgets.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/log.h"
+#include "Utilities/random.h"
+
+static Option<int> starfieldDensity( "options/simulation/starfield-density" );
+
+#define BENCHMARK_SHIPS 500
+#define BENCHMARK_PLANETS 3000
+#define BENCHMARK_RADAR_SHIPS 5000
+#define BENCHMARK_SEED 1234
+
+/**\brief A Sprite that only draws its Image.
+ */
+class BenchmarkShip : public Sprite {
+	public:
+		BenchmarkShip( Image* image, Coordinate position, float angle ) {
+			SetImage( image );
+			SetWorldPosition( position );
+			SetAngle( angle );
+			SetRadarColor( RED );
+		}
+		int GetDrawOrder( void ) { return DRAW_ORDER_SHIP; }
+};
+
+typedef void (*sceneFunc)( int frame );
+
+struct BenchmarkScene {
+	const char *name;
+	sceneFunc setup; ///< Called once before the first frame, may be NULL.
+	sceneFunc draw; ///< Draws a single frame.
+};
+
+static Starfield *starfield = NULL;
+static Camera *camera = NULL;
+static SpriteManager *sprites = NULL;
+static list<BenchmarkShip*> ships;
+static Map *worldMap = NULL;
+static Map *galaxyMap = NULL;
+
+/**\brief Rotate every ship so that each frame is different.
+ */
+static void TurnShips( int frame ) {
+	int i = 0;
+	for( list<BenchmarkShip*>::iterator s = ships.begin(); s != ships.end(); ++s, ++i ) {
+		(*s)->SetAngle( static_cast<float>( (i * 37 + frame * 3) % 360 ) );
+	}
+}
+
+static void DrawStarfield( int frame ) {
+	starfield->Draw();
+}
+
+static void DrawShips( int frame ) {
+	TurnShips( frame );
+	starfield->Draw();
+	sprites->Draw( camera->GetFocusCoordinate() );
+}
+
+static void DrawHud( int frame ) {
+	DrawShips( frame );
+	Hud::Draw( HUD_Shield | HUD_Radar | HUD_Target, 60.0f, camera, sprites );
+}
+
+static void DrawMap( int frame ) {
+	TurnShips( frame );
+	worldMap->Draw();
+}
+
+/**\brief Fill a much larger universe with Planets.
+ */
+static void SetupGalaxy( int frame ) {
+	Alliance *alliance = new Alliance( "Benchmark", 1, 0.5f, "Credits", BLUE );
+	Image *image = Image::Get( "Resources/Graphics/planet2.png" );
+	list<Technology*> technologies;
+	Random random( BENCHMARK_SEED );
+	for( int i = 0; i < BENCHMARK_PLANETS; i++ ) {
+		char name[32];
+		snprintf( name, sizeof(name), "Planet %d", i );
+		Planet *planet = new Planet( name, random.Range( -60000, 60000 ), random.Range( -60000, 60000 ),
+			image, alliance, true, 0, 0, 500 + random.Int( 1500 ), image, "", technologies );
+		sprites->Add( planet );
+	}
+
+	galaxyMap = new Map( 0, 0, Video::GetWidth(), Video::GetHeight(), Coordinate( 0, 0 ), sprites );
+	galaxyMap->SetFilter( DRAW_ORDER_PLANET | DRAW_ORDER_SHIP );
+}
+
+/**\brief Pan across the galaxy, which only shifts the Map's static layer.
+ */
+static void DrawGalaxy( int frame ) {
+	TurnShips( frame );
+	galaxyMap->SetCenter( Coordinate( frame * 50, frame * 20 ) );
+	galaxyMap->Draw();
+}
+
+/**\brief Leave the Planets out of the Map so that they can be drawn every frame.
+ */
+static void SetupGalaxyImmediate( int frame ) {
+	galaxyMap->SetFilter( DRAW_ORDER_SHIP );
+}
+
+/**\brief Pan across the galaxy while drawing every Planet each frame.
+ * \details This is how the Map drew its Planets before they were kept in a
+ *          static layer, to compare against the "galaxy" scene.
+ */
+static void DrawGalaxyImmediate( int frame ) {
+	TurnShips( frame );
+	galaxyMap->SetCenter( Coordinate( frame * 50, frame * 20 ) );
+	galaxyMap->Draw();
+
+	list<Sprite*> *planets = sprites->GetSprites( DRAW_ORDER_PLANET );
+	float scale = galaxyMap->GetScale();
+	for( list<Sprite*>::iterator iter = planets->begin(); iter != planets->end(); ++iter ) {
+		Planet *planet = (Planet*)(*iter);
+		Coordinate pos = galaxyMap->WorldToScreen( planet->GetWorldPosition() );
+		Color field = planet->GetAlliance()->GetColor();
+		for( float i = 1; i < 10; i += 0.25f ) {
+			Video::DrawFilledCircle( pos, (planet->GetInfluence() * scale) / i, field, 0.05f );
+		}
+		Video::DrawCircle( pos, 3, 1, planet->GetRadarColor(), 1.0f );
+		SansSerif->Render( TO_INT( pos.GetX() ) + 5, TO_INT( pos.GetY() ), planet->GetName() );
+	}
+	delete planets;
+}
+
+/**\brief Crowd the radar with ships.
+ */
+static void SetupRadar( int frame ) {
+	Image *image = Image::Get( "Resources/Graphics/Fighter.png" );
+	Random random( BENCHMARK_SEED );
+	while( static_cast<int>( ships.size() ) < BENCHMARK_RADAR_SHIPS ) {
+		Coordinate position( random.Range( -2500, 2500 ), random.Range( -2500, 2500 ) );
+		BenchmarkShip *ship = new BenchmarkShip( image, position, 0.0f );
+		ships.push_back( ship );
+		sprites->Add( ship );
+	}
+}
+
+static void DrawRadar( int frame ) {
+	Hud::Draw( HUD_Radar, 60.0f, camera, sprites );
+}
+
+static void SetupWindow( int frame ) {
+	Window *window = new Window( 50, 50, Video::GetWidth() - 100, Video::GetHeight() - 100, "Benchmark" );
+	for( int i = 0; i < 8; i++ ) {
+		int y = 40 + i * 40;
+		char label[32];
+		snprintf( label, sizeof(label), "Row %d", i );
+		window->AddChild( new Label( 20, y, label ) );
+		window->AddChild( new Button( 120, y, 100, 30, label ) );
+		window->AddChild( new Checkbox( 240, y, (i % 2) == 0, label ) );
+		window->AddChild( new Slider( 380, y, 150, 20, label, i / 8.0f ) );
+		window->AddChild( new Textbox( 560, y, 150, 1, label ) );
+	}
+	window->AddChild( new Picture( 20, 370, 100, 100, "Resources/Graphics/planet2.png" ) );
+	window->AddChild( new Paragraph( 140, 370, 400, 150,
+		"Epiar is a space trading and combat game.  This paragraph is here to "
+		"measure how long it takes to wrap and draw a block of text." ) );
+	UI::Add( window );
+}
+
+static void DrawWindow( int frame ) {
+	starfield->Draw();
+	UI::Draw();
+}
+
+static BenchmarkScene scenes[] = {
+	{ "starfield",  NULL,                 DrawStarfield },
+	{ "ships",      NULL,                 DrawShips },
+	{ "hud",        NULL,                 DrawHud },
+	{ "map",        NULL,                 DrawMap },
+	{ "galaxy",     SetupGalaxy,          DrawGalaxy },
+	{ "galaxy-old", SetupGalaxyImmediate, DrawGalaxyImmediate },
+	{ "radar",      SetupRadar,           DrawRadar },
+	{ "ui",         SetupWindow,          DrawWindow },
+};
+
+/**\brief Create the Sprites and Widgets shared by every scene.
+ */
+static void SetupScenes( void ) {
+	const char *images[] = {
+		"Resources/Graphics/Fighter.png",
+		"Resources/Graphics/terran-frigate.png",
+		"Resources/Graphics/corvet.png",
+		"Resources/Graphics/patrol.png",
+		"Resources/Graphics/pirate.png",
+	};
+	int numImages = sizeof(images) / sizeof(images[0]);
+
+	starfield = new Starfield( starfieldDensity, BENCHMARK_SEED );
+	camera = Camera::Instance();
+	camera->Focus( 0, 0 );
+	sprites = SpriteManager::Instance();
+
+	// Spread the ships over a few screens so that some are on the radar but off screen
+	Random random( BENCHMARK_SEED );
+	for( int i = 0; i < BENCHMARK_SHIPS; i++ ) {
+		Coordinate position( random.Int( 4000 ) - 2000, random.Int( 4000 ) - 2000 );
+		BenchmarkShip *ship = new BenchmarkShip( Image::Get( images[i % numImages] ), position, 0.0f );
+		ships.push_back( ship );
+		sprites->Add( ship );
+	}
+
+	Hud::Init();
+	UI::Initialize( "Benchmark" );
+	worldMap = new Map( 0, 0, Video::GetWidth(), Video::GetHeight(), Coordinate( 0, 0 ), sprites );
+	worldMap->SetFilter( DRAW_ORDER_SHIP );
+}
+
+/**\brief Compare the offscreen target against a golden image.
+ * \returns The fraction of pixels that differ by more than the tolerance, or
+ *          a negative number if the images could not be compared.
+ */
+static float CompareGolden( SDL_Surface *capture, const string& path, int tolerance ) {
+	SDL_Surface *loaded = SDL_LoadBMP( path.c_str() );
+	if( loaded == NULL ) {
+		cout << "  Could not load golden image " << path << ": " << SDL_GetError() << endl;
+		return -1.0f;
+	}
+	SDL_Surface *golden = SDL_ConvertSurface( loaded, capture->format, SDL_SWSURFACE );
+	SDL_FreeSurface( loaded );
+
+	if( (golden == NULL) || (golden->w != capture->w) || (golden->h != capture->h) ) {
+		cout << "  Golden image " << path << " is not " << capture->w << "x" << capture->h << "." << endl;
+		if( golden ) SDL_FreeSurface( golden );
+		return -1.0f;
+	}
+
+	long different = 0;
+	SDL_LockSurface( capture );
+	SDL_LockSurface( golden );
+	for( int y = 0; y < capture->h; y++ ) {
+		Uint8 *a = (Uint8*)capture->pixels + y * capture->pitch;
+		Uint8 *b = (Uint8*)golden->pixels + y * golden->pitch;
+		for( int x = 0; x < capture->w; x++, a += 4, b += 4 ) {
+			// Only compare the color channels, the alpha of the target is not shown.
+			Uint8 ar, ag, ab, br, bg, bb;
+			SDL_GetRGB( *(Uint32*)a, capture->format, &ar, &ag, &ab );
+			SDL_GetRGB( *(Uint32*)b, golden->format, &br, &bg, &bb );
+			if( (abs( ar - br ) > tolerance) || (abs( ag - bg ) > tolerance) || (abs( ab - bb ) > tolerance) ) {
+				different++;
+			}
+		}
+	}
+	SDL_UnlockSurface( golden );
+	SDL_UnlockSurface( capture );
+	SDL_FreeSurface( golden );
+
+	return static_cast<float>( different ) / ( capture->w * capture->h );
+}
+
+/**\brief The frame time below which a fraction of frames fall.
+ */
+static Uint32 Percentile( vector<Uint32>& sorted, float fraction ) {
+	if( sorted.empty() ) return 0;
+	size_t index = static_cast<size_t>( fraction * (sorted.size() - 1) + 0.5f );
+	return sorted[index];
+}
+
+int test_benchmark(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "frames", "Frames to draw per scene" );
+	args.SetOpt( VALUEOPT, "golden", "Directory of golden images" );
+	args.SetOpt( LONGOPT, "update-golden", "Write the golden images" );
+	args.SetOpt( VALUEOPT, "tolerance", "Allowed difference per color channel" );
+	args.SetOpt( VALUEOPT, "width", "Width of the offscreen target" );
+	args.SetOpt( VALUEOPT, "height", "Height of the offscreen target" );
+
+	int frames = GetIntArgument( args, "frames", 120 );
+	int tolerance = GetIntArgument( args, "tolerance", 8 );
+	int width = GetIntArgument( args, "width", 1024 );
+	int height = GetIntArgument( args, "height", 768 );
+	string golden = args.HaveValue("golden");
+	bool update = args.HaveLong("update-golden");
+	int failures = 0;
+
+	if( frames < 1 ) frames = 1;
+	if( !Video::SetOffscreen( width, height ) ) {
+		cout << "Could not draw offscreen." << endl;
+		return -1;
+	}
+	cout << "Renderer: " << glGetString( GL_RENDERER ) << " (" << glGetString( GL_VERSION ) << ")" << endl;
+	cout << "Target: " << Video::GetWidth() << "x" << Video::GetHeight() << ", " << frames << " frames per scene" << endl;
+
+	SetupScenes();
+
+	cout << "Scene        Draws/frame   p50 ms   p90 ms   p99 ms   max ms   Golden" << endl;
+	for( size_t s = 0; s < sizeof(scenes) / sizeof(scenes[0]); s++ ) {
+		BenchmarkScene& scene = scenes[s];
+		vector<Uint32> times;
+		Uint32 draws = 0;
+
+		if( scene.setup ) {
+			scene.setup( 0 );
+		}
+
+		for( int f = 0; f < frames; f++ ) {
+			Uint32 start = SDL_GetTicks();
+			Video::ResetDrawCalls();
+			Video::Erase();
+			Video::PreDraw();
+			scene.draw( f );
+			Video::PostDraw();
+			Video::Update(); // Waits for the frame to finish
+			draws = Video::GetDrawCalls();
+			times.push_back( SDL_GetTicks() - start );
+		}
+		sort( times.begin(), times.end() );
+
+		// Compare the final frame
+		string result = "-";
+		if( !golden.empty() ) {
+			string path = golden + "/" + scene.name + ".bmp";
+			SDL_Surface *capture = Video::CaptureSurface();
+			if( capture == NULL ) {
+				result = "no capture";
+				failures++;
+			} else if( update ) {
+				result = ( SDL_SaveBMP( capture, path.c_str() ) == 0 ) ? "written" : "not written";
+			} else {
+				float difference = CompareGolden( capture, path, tolerance );
+				char buf[32];
+				if( difference < 0.0f ) {
+					result = "missing";
+					failures++;
+				} else {
+					// Allow a few pixels of rasterization differences between drivers
+					snprintf( buf, sizeof(buf), "%.3f%% %s", difference * 100.0f, (difference > 0.001f) ? "FAIL" : "ok" );
+					result = buf;
+					if( difference > 0.001f ) failures++;
+				}
+			}
+			if( capture ) SDL_FreeSurface( capture );
+		}
+
+		cout << setw(12) << left << scene.name << right
+		     << setw(12) << draws
+		     << setw(9) << Percentile( times, 0.50f )
+		     << setw(9) << Percentile( times, 0.90f )
+		     << setw(9) << Percentile( times, 0.99f )
+		     << setw(9) << times.back()
+		     << "   " << result << endl;
+	}
+
+	UI::CloseAll();
+	delete worldMap;
+	delete galaxyMap;
+	delete starfield;
+	Video::UnsetOffscreen();
+
+	return failures;
+}
@@ -0,0 +1,13 @@
+/**\file			benchmark.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Offscreen rendering benchmark
+ * \details
+ */
+
+
+#ifndef __H_TEST_BENCHMARK__
+#define __H_TEST_BENCHMARK__
+int test_benchmark(int argc, char **argv);
+#endif // __H_TEST_BENCHMARK__
@@ -0,0 +1,169 @@
+/**\file			missions.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Event driven Mission updates
+ * \details
+ * Gives the Player hundreds of Missions and times the same ticks twice: once
+ * with Missions that are updated every tick, as every Mission used to be,
+ * and once with Missions that only listen for destroyed ships and check in
+ * now and then.  Checks that:
+ * - The polled Missions run Lua every tick.
+ * - The event driven Missions only run Lua on their UpdatePeriod.
+ * - Destroying a ship runs every event driven Mission with "ShipDestroyed".
+ * - The bundled DestroyPirate Mission pays out once its pirate is destroyed.
+ *
+ *   --missions=N   Missions to accept (default 300)
+ *   --ticks=N      Ticks to run (default 200)
+ *   --period=N     The UpdatePeriod of the event driven Missions (default 100)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/mission.h"
+#include "Engine/simulation.h"
+#include "Sprites/player.h"
+#include "Sprites/spritemanager.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/lua.h"
+
+/**\brief Drop every Mission that the Player has accepted.
+ */
+static void DropMissions( Simulation& simulation ) {
+	list<Mission*>* accepted = simulation.GetPlayer()->GetMissions();
+	for( list<Mission*>::iterator m = accepted->begin(); m != accepted->end(); ++m ) {
+		delete (*m);
+	}
+	accepted->clear();
+}
+
+/**\brief Accept many Missions of one type, after dropping every other Mission.
+ */
+static void AcceptMissions( Simulation& simulation, const char* type, int missions ) {
+	DropMissions( simulation );
+
+	char accept[256];
+	snprintf( accept, sizeof(accept), "for m=1,%d do PLAYER:AcceptMission( '%s', %s.Create() ) end MissionCalls = 0", missions, type, type );
+	Lua::Run( accept );
+}
+
+/**\brief Read a number from a Lua global.
+ */
+static int GetGlobal( const char* name ) {
+	lua_State *L = Lua::CurrentState();
+	lua_getglobal( L, name );
+	int value = static_cast<int>( lua_tonumber( L, -1 ) );
+	lua_pop( L, 1 );
+	return value;
+}
+
+/**\brief The number of times that a Mission's Update ran.
+ */
+static int GetCalls( void ) {
+	return GetGlobal( "MissionCalls" );
+}
+
+int test_missions(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "missions", "Missions to accept" );
+	args.SetOpt( VALUEOPT, "ticks", "Ticks to run" );
+	args.SetOpt( VALUEOPT, "period", "The UpdatePeriod of the event driven Missions" );
+
+	int missions = GetIntArgument( args, "missions", 300 );
+	int ticks = GetIntArgument( args, "ticks", 200 );
+	int period = GetIntArgument( args, "period", 100 );
+	if( period < 1 ) period = 1;
+
+	Simulation simulation;
+	if( !SetupDefaultSimulation( simulation, "Mission Test" ) ) {
+		return -1;
+	}
+
+	// Two Mission Types that do the same work
+	char define[1024];
+	snprintf( define, sizeof(define),
+		"MissionCalls = 0 "
+		"PolledMission = { UID = 100, Version = 1, Author = 'Test', Difficulty = 'EASY',"
+		" Create = function() local t = defaultMissionTable( 'Polled', 'Polled' ) t.target = PLAYER:GetID() return t end,"
+		" Accept = function( t ) end, Reject = function( t ) end, Land = function( t ) end,"
+		" Update = function( t, event, value ) MissionCalls = MissionCalls + 1"
+		"  if Epiar.getSprite( t.target ) == nil then return true end end,"
+		" Success = function( t ) end, Failure = function( t ) end }"
+		"EventMission = {} for k,v in pairs( PolledMission ) do EventMission[k] = v end "
+		"EventMission.Events = { 'ShipDestroyed' } EventMission.UpdatePeriod = %d",
+		period );
+	Lua::Run( define );
+
+	// Every Mission runs on every tick
+	AcceptMissions( simulation, "PolledMission", missions );
+	Uint32 polled = RunTicks( simulation, ticks );
+	int polledCalls = GetCalls();
+	cout << missions << " polled missions: " << polledCalls << " updates, "
+	     << 1000.0f * polled / ticks << " us per tick" << endl;
+
+	// Missions only run when something happens
+	AcceptMissions( simulation, "EventMission", missions );
+	Uint32 evented = RunTicks( simulation, ticks );
+	int eventCalls = GetCalls();
+	cout << missions << " event driven missions: " << eventCalls << " updates, "
+	     << 1000.0f * evented / ticks << " us per tick" << endl;
+
+	int retval = 0;
+	if( polledCalls != missions * ticks ) {
+		cout << "The polled missions ran " << polledCalls << " times instead of " << missions * ticks << "." << endl;
+		retval = 1;
+	}
+	if( eventCalls > missions * (ticks / period + 1) ) {
+		cout << "The event driven missions ran " << eventCalls << " times in " << ticks << " ticks." << endl;
+		retval = 1;
+	}
+
+	// Destroy a ship
+	Lua::Run( "createRandomShip( 5000, 5000, 100, Epiar.models(), Epiar.engines(), Epiar.weapons() ) MissionCalls = 0" );
+	SpriteManager *sprites = simulation.GetSpriteManager();
+	list<Sprite*> *ships = sprites->GetSprites( DRAW_ORDER_SHIP );
+	if( ships->empty() ) {
+		cout << "Could not create a ship to destroy." << endl;
+		delete ships;
+		return -1;
+	}
+	sprites->Delete( ships->back() );
+	delete ships;
+	RunTicks( simulation, 2 );
+	int destroyedCalls = GetCalls();
+	if( destroyedCalls < missions ) {
+		cout << "Only " << destroyedCalls << " missions heard that a ship was destroyed." << endl;
+		retval = 1;
+	}
+	cout << "Destroying a ship ran " << destroyedCalls << " updates." << endl;
+
+	// Destroy the pirate of a bundled Mission
+	DropMissions( simulation );
+	Lua::Run( "UI.newAlert = function( message ) end "
+		"Pirate = DestroyPirate.Create() "
+		"PLAYER:AcceptMission( 'DestroyPirate', Pirate ) "
+		"PirateShip = Pirate.ship PirateReward = Pirate.reward" );
+	Player *player = simulation.GetPlayer();
+	Sprite *pirate = sprites->GetSpriteByID( GetGlobal( "PirateShip" ) );
+	if( player->GetMissions()->size() != 1 || pirate == NULL ) {
+		cout << "Could not accept the DestroyPirate mission." << endl;
+		return -1;
+	}
+	unsigned int credits = player->GetCredits();
+	RunTicks( simulation, 2 );
+	if( player->GetMissions()->empty() ) {
+		cout << "The DestroyPirate mission ended before its pirate was destroyed." << endl;
+		retval = 1;
+	}
+	sprites->Delete( pirate );
+	RunTicks( simulation, 2 );
+	if( !player->GetMissions()->empty() ) {
+		cout << "The DestroyPirate mission did not end when its pirate was destroyed." << endl;
+		retval = 1;
+	} else if( player->GetCredits() != credits + static_cast<unsigned int>( GetGlobal( "PirateReward" ) ) ) {
+		cout << "The DestroyPirate mission ended without paying its reward." << endl;
+		retval = 1;
+	}
+	return retval;
+}
@@ -0,0 +1,13 @@
+/**\file			missions.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Event driven Mission updates
+ * \details
+ */
+
+
+#ifndef __H_TEST_MISSIONS__
+#define __H_TEST_MISSIONS__
+int test_missions(int argc, char **argv);
+#endif // __H_TEST_MISSIONS__
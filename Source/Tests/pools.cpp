@@ -0,0 +1,93 @@
+/**\file			pools.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Projectile and Effect pools during a battle
+ * \details
+ * Starts a battle in the default Simulation and runs it twice as long as it
+ * takes to warm up.  For the second half it reports how many Projectiles and
+ * Effects were made, how many times their Pools went to the heap and how long
+ * a tick took, then checks that:
+ * - Every live object in a Pool is a Sprite in the SpriteManager.
+ * - Once warm, the Pools reuse memory instead of growing for every object.
+ *
+ *   --ships=N      Ships in the battle (default 40)
+ *   --ticks=N      Ticks to run for each half (default 500)
+ *   --seed=N       Random seed (default 1234)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/simulation.h"
+#include "Sprites/effects.h"
+#include "Sprites/projectile.h"
+#include "Sprites/spritemanager.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/lua.h"
+#include "Utilities/pool.h"
+#include "Utilities/random.h"
+
+/**\brief Print the use of a Pool and check it against the Sprites.
+ * \returns false if the Pool does not match the SpriteManager.
+ */
+static bool Report( const char* name, const PoolStats& stats, int sprites ) {
+	cout << name << ": " << stats.allocations << " made, "
+	     << stats.chunks << " heap allocations, "
+	     << stats.live << " live, "
+	     << stats.peak << " at most" << endl;
+
+	if( stats.live != sprites ) {
+		cout << stats.live << " " << name << "s are live but the SpriteManager has " << sprites << "." << endl;
+		return false;
+	}
+	if( (stats.allocations > POOL_CHUNK) && (stats.chunks * POOL_CHUNK >= stats.allocations) ) {
+		cout << "The " << name << " Pool did not reuse any memory." << endl;
+		return false;
+	}
+	return true;
+}
+
+/**\brief Count the Sprites of one draw order.
+ */
+static int Count( Simulation& simulation, int type ) {
+	list<Sprite*> *sprites = simulation.GetSpriteManager()->GetSprites( type );
+	int count = sprites->size();
+	delete sprites;
+	return count;
+}
+
+int test_pools(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "ships", "Ships in the battle" );
+	args.SetOpt( VALUEOPT, "ticks", "Ticks to run for each half" );
+	args.SetOpt( VALUEOPT, "seed", "Random seed" );
+
+	int ships = GetIntArgument( args, "ships", 40 );
+	int ticks = GetIntArgument( args, "ticks", 500 );
+	int seed = GetIntArgument( args, "seed", 1234 );
+
+	Simulation simulation;
+	if( !SetupDefaultSimulation( simulation, "Pool Test" ) ) {
+		return -1;
+	}
+
+	Random::SeedAll( seed );
+	char spawn[256];
+	snprintf( spawn, sizeof(spawn), "for i=1,%d do createRandomShip( 0, 0, 1000, Epiar.models(), Epiar.engines(), Epiar.weapons() ) end", ships );
+	Lua::Run( spawn );
+
+	// Let the Pools grow to the size of the battle
+	Uint32 warmup = RunTicks( simulation, ticks );
+	cout << "Warmed up for " << ticks << " ticks in " << warmup << " ms" << endl;
+
+	Pool<Projectile>::ResetStats();
+	Pool<Effect>::ResetStats();
+	Uint32 elapsed = RunTicks( simulation, ticks );
+	cout << "Ran " << ticks << " ticks in " << elapsed << " ms, "
+	     << (ticks ? static_cast<float>( elapsed ) / ticks : 0.0f) << " ms per tick" << endl;
+
+	bool matched = Report( "Projectile", Pool<Projectile>::GetStats(), Count( simulation, DRAW_ORDER_PROJECTILE ) );
+	matched = Report( "Effect", Pool<Effect>::GetStats(), Count( simulation, DRAW_ORDER_EFFECT ) ) && matched;
+	return matched ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+/**\file			pools.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Projectile and Effect pools during a battle
+ * \details
+ */
+
+
+#ifndef __H_TEST_POOLS__
+#define __H_TEST_POOLS__
+int test_pools(int argc, char **argv);
+#endif // __H_TEST_POOLS__
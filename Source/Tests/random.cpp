@@ -0,0 +1,109 @@
+/**\file			random.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Random number streams
+ * \details
+ * Checks that:
+ * - The same seed always gives the same numbers, and the streams differ.
+ * - Int() stays in range and is evenly spread.
+ * - Gaussian() and Gaussians() have a mean of 0 and a deviation of 1.
+ *
+ * Then reports how long rand(), Random::Next(), Random::Gaussian() and
+ * Random::Gaussians() take.
+ *
+ *   --count=N      Numbers drawn for each check (default 1000000)
+ */
+
+#include "includes.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/random.h"
+
+/**\brief Check the mean and deviation of some numbers from the normal distribution.
+ */
+static bool CheckNormal( const char* name, const vector<float>& values ) {
+	double sum = 0.0, squares = 0.0;
+	for( unsigned int i = 0; i < values.size(); i++ ) {
+		sum += values[i];
+		squares += values[i] * values[i];
+	}
+	double mean = sum / values.size();
+	double deviation = sqrt( squares / values.size() - mean * mean );
+	cout << name << ": mean " << mean << ", deviation " << deviation << endl;
+	if( (fabs( mean ) > 0.01) || (fabs( deviation - 1.0 ) > 0.01) ) {
+		cout << name << " is not normally distributed." << endl;
+		return false;
+	}
+	return true;
+}
+
+int test_random(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "count", "Numbers drawn for each check" );
+
+	int count = GetIntArgument( args, "count", 1000000 );
+	if( count < 1000 ) count = 1000;
+
+	// Repeatable
+	Random::SeedAll( 1234 );
+	vector<Uint32> first;
+	for( int i = 0; i < 100; i++ ) first.push_back( Random::Stream( RANDOM_SHIPS ).Next() );
+	Random::SeedAll( 1234 );
+	for( int i = 0; i < 100; i++ ) {
+		if( Random::Stream( RANDOM_SHIPS ).Next() != first[i] ) {
+			cout << "The same seed gave different numbers." << endl;
+			return 1;
+		}
+	}
+	Random::SeedAll( 1234 );
+	if( Random::Stream( RANDOM_GATES ).Next() == first[0] ) {
+		cout << "Two streams gave the same numbers." << endl;
+		return 1;
+	}
+
+	// In range and even
+	Random random( 1234 );
+	int buckets[10] = {0};
+	for( int i = 0; i < count; i++ ) {
+		int n = random.Int( 10 );
+		if( (n < 0) || (n >= 10) ) {
+			cout << "Int(10) gave " << n << "." << endl;
+			return 1;
+		}
+		buckets[n]++;
+	}
+	for( int b = 0; b < 10; b++ ) {
+		if( abs( buckets[b] - count / 10 ) > count / 200 ) {
+			cout << "Int(10) gave " << b << " " << buckets[b] << " times out of " << count << "." << endl;
+			return 1;
+		}
+	}
+
+	// Normal
+	vector<float> single( count ), batch( count );
+	for( int i = 0; i < count; i++ ) single[i] = random.Gaussian();
+	random.Gaussians( &batch[0], count );
+	if( !CheckNormal( "Gaussian", single ) || !CheckNormal( "Gaussians", batch ) ) {
+		return 1;
+	}
+
+	// Speed
+	Uint32 sink = 0;
+	Uint32 start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) sink += rand();
+	Uint32 libc = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) sink += random.Next();
+	Uint32 next = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) single[i] = random.Gaussian();
+	Uint32 gaussian = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	random.Gaussians( &batch[0], count );
+	Uint32 gaussians = SDL_GetTicks() - start;
+
+	cout << count << " numbers: rand() " << libc << " ms, Next() " << next << " ms, Gaussian() "
+	     << gaussian << " ms, Gaussians() " << gaussians << " ms" << (sink ? "" : " ") << endl;
+	return 0;
+}
@@ -0,0 +1,13 @@
+/**\file			random.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Random number streams
+ * \details
+ */
+
+
+#ifndef __H_TEST_RANDOM__
+#define __H_TEST_RANDOM__
+int test_random(int argc, char **argv);
+#endif // __H_TEST_RANDOM__
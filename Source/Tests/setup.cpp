@@ -0,0 +1,54 @@
+/**\file			setup.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Setup shared by the tests
+ * \details
+ * The tests that run the game read their sizes from the command line and
+ * start from the default Simulation with a new Player.  They run the game
+ * logic tick by tick, as fast as it will go.
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/simulation.h"
+#include "Sprites/spritemanager.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/lua.h"
+#include "Utilities/timer.h"
+
+/**\brief Read a number from a --name=N argument.
+ * \returns defaultValue when the argument was not given.
+ */
+int GetIntArgument( ArgParser& args, const string& name, int defaultValue ) {
+	string value = args.HaveValue( name );
+	return value.empty() ? defaultValue : atoi( value.c_str() );
+}
+
+/**\brief Load the default Simulation and give it a new Player.
+ * \details The Player is also set as PLAYER in Lua, which the ship scripts use.
+ * \returns false if the Simulation could not be loaded.
+ */
+bool SetupDefaultSimulation( Simulation& simulation, const string& playerName ) {
+	if( !simulation.Load( "default" ) || !simulation.SetupToRun() ) {
+		cout << "Could not load the default simulation." << endl;
+		return false;
+	}
+	simulation.CreateDefaultPlayer( playerName );
+	Lua::Run( "PLAYER = Epiar.player()" );
+	return true;
+}
+
+/**\brief Run logical updates without drawing or waiting.
+ * \details The Timer is not updated, so the game time stands still.
+ * \returns The time it took in milliseconds.
+ */
+Uint32 RunTicks( Simulation& simulation, int ticks ) {
+	Uint32 start = SDL_GetTicks();
+	for( int t = 0; t < ticks; t++ ) {
+		Timer::IncrementFrameCount();
+		simulation.GetSpriteManager()->Update( Lua::CurrentState(), false );
+	}
+	return SDL_GetTicks() - start;
+}
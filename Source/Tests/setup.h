@@ -0,0 +1,18 @@
+/**\file			setup.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Setup shared by the tests
+ * \details
+ */
+
+
+#ifndef __H_TEST_SETUP__
+#define __H_TEST_SETUP__
+class ArgParser;
+class Simulation;
+
+int GetIntArgument( ArgParser& args, const string& name, int defaultValue );
+bool SetupDefaultSimulation( Simulation& simulation, const string& playerName );
+Uint32 RunTicks( Simulation& simulation, int ticks );
+#endif // __H_TEST_SETUP__
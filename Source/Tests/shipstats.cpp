@@ -0,0 +1,202 @@
+/**\file			shipstats.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Cached Ship stats
+ * \details
+ * Equips and unequips random Models, Engines, Weapons and Outfits on a Ship
+ * and checks after every change that its cached stats match the stats added
+ * up field by field from a separate list of what was equipped.
+ *
+ *   --steps=N      Random changes to make (default 2000)
+ *   --seed=N       Random seed (default 1234)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/simulation.h"
+#include "Sprites/ship.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/random.h"
+
+/**\brief What the test has equipped on the Ship, kept apart from the Ship.
+ */
+struct Equipment {
+	Equipment(): model( NULL ), engine( NULL ) {}
+
+	Model* model;
+	Engine* engine;
+	vector<Weapon*> weapons;
+	list<Outfit*> outfits;
+};
+
+/**\brief The stats of an Equipment, added up one field at a time.
+ */
+struct Expected {
+	Expected(): msrp( 0 ), rotPerSecond( 0.0f ), maxSpeed( 0.0f ), forceOutput( 0.0f ),
+		mass( 0.0f ), cargoSpace( 0 ), surfaceArea( 0 ), hullStrength( 0 ), shieldStrength( 0 ) {}
+
+	void Add( Outfit* outfit ) {
+		msrp += outfit->GetMSRP();
+		rotPerSecond += outfit->GetRotationsPerSecond();
+		maxSpeed += outfit->GetMaxSpeed();
+		forceOutput += outfit->GetForceOutput();
+		mass += outfit->GetMass();
+		cargoSpace += outfit->GetCargoSpace();
+		surfaceArea += outfit->GetSurfaceArea();
+		hullStrength += outfit->GetHullStrength();
+		shieldStrength += outfit->GetShieldStrength();
+	}
+
+	int msrp;
+	float rotPerSecond;
+	float maxSpeed;
+	float forceOutput;
+	float mass;
+	int cargoSpace;
+	int surfaceArea;
+	int hullStrength;
+	int shieldStrength;
+};
+
+/**\brief Add up the stats of everything that was equipped.
+ */
+static Expected AddUp( Equipment& equipment ) {
+	Expected total;
+	if( equipment.model ) { total.Add( equipment.model ); }
+	if( equipment.engine ) { total.Add( equipment.engine ); }
+	for( unsigned int i = 0; i < equipment.weapons.size(); i++ ) {
+		total.Add( equipment.weapons[i] );
+	}
+	for( list<Outfit*>::iterator iter = equipment.outfits.begin(); iter != equipment.outfits.end(); ++iter ) {
+		total.Add( *iter );
+	}
+	return total;
+}
+
+/**\brief Compare two sums that may have been added up in different orders.
+ */
+static bool Close( float a, float b ) {
+	return fabs( a - b ) <= 0.001f * (1.0f + fabs( a ) + fabs( b ));
+}
+
+/**\brief Compare the cached stats of a Ship with what was equipped on it.
+ */
+static bool Matches( Ship& ship, Equipment& equipment ) {
+	Expected expected = AddUp( equipment );
+	const OutfitStats& stats = ship.GetStats();
+	return (stats.msrp == expected.msrp)
+		&& Close( stats.rotPerSecond, expected.rotPerSecond )
+		&& Close( stats.maxSpeed, expected.maxSpeed )
+		&& Close( stats.forceOutput, expected.forceOutput )
+		&& Close( stats.mass, expected.mass )
+		&& (stats.cargoSpace == expected.cargoSpace)
+		&& (stats.surfaceArea == expected.surfaceArea)
+		&& (stats.hullStrength == expected.hullStrength)
+		&& (stats.shieldStrength == expected.shieldStrength);
+}
+
+/**\brief Pick a random name from a Components list.
+ */
+static string Pick( Random& random, list<string>* names ) {
+	list<string>::iterator iter = names->begin();
+	advance( iter, random.Int( names->size() ) );
+	return *iter;
+}
+
+int test_shipstats(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "steps", "Random changes to make" );
+	args.SetOpt( VALUEOPT, "seed", "Random seed" );
+
+	int steps = GetIntArgument( args, "steps", 2000 );
+	int seed = GetIntArgument( args, "seed", 1234 );
+
+	Simulation simulation;
+	if( !simulation.Load( "default" ) ) {
+		cout << "Could not load the default simulation." << endl;
+		return -1;
+	}
+	Models* models = simulation.GetModels();
+	Engines* engines = simulation.GetEngines();
+	Weapons* weapons = simulation.GetWeapons();
+	Outfits* outfits = simulation.GetOutfits();
+	if( models->GetNames()->empty() || engines->GetNames()->empty()
+	 || weapons->GetNames()->empty() || outfits->GetNames()->empty() ) {
+		cout << "The default simulation is missing components." << endl;
+		return -1;
+	}
+
+	Random random( seed );
+	Ship ship;
+	Equipment equipment;
+	if( !Matches( ship, equipment ) ) {
+		cout << "An empty ship does not have empty stats." << endl;
+		return 1;
+	}
+
+	for( int step = 0; step < steps; step++ ) {
+		switch( random.Int( 7 ) ) {
+			case 0: {
+				Model* model = models->GetModel( Pick( random, models->GetNames() ) );
+				ship.SetModel( model );
+				// A new Model also installs its default Weapons
+				equipment.model = model;
+				vector<WeaponSlot> slots = model->GetWeaponSlots();
+				for( unsigned int i = 0; i < slots.size(); i++ ) {
+					if( slots[i].content ) {
+						equipment.weapons.push_back( slots[i].content );
+					}
+				}
+				break;
+			}
+			case 1: {
+				Engine* engine = engines->GetEngine( Pick( random, engines->GetNames() ) );
+				ship.SetEngine( engine );
+				equipment.engine = engine;
+				break;
+			}
+			case 2: {
+				string name = Pick( random, weapons->GetNames() );
+				ship.AddToShipWeaponList( name );
+				equipment.weapons.push_back( weapons->GetWeapon( name ) );
+				break;
+			}
+			case 3:
+				if( !equipment.weapons.empty() ) {
+					int pos = random.Int( equipment.weapons.size() );
+					ship.RemoveFromShipWeaponList( pos );
+					equipment.weapons.erase( equipment.weapons.begin() + pos );
+				}
+				break;
+			case 4: {
+				string name = Pick( random, outfits->GetNames() );
+				ship.AddOutfit( name );
+				equipment.outfits.push_back( outfits->GetOutfit( name ) );
+				break;
+			}
+			case 5: {
+				string name = Pick( random, outfits->GetNames() );
+				ship.RemoveOutfit( name );
+				list<Outfit*>::iterator iter = find( equipment.outfits.begin(), equipment.outfits.end(), outfits->GetOutfit( name ) );
+				if( iter != equipment.outfits.end() ) {
+					equipment.outfits.erase( iter );
+				}
+				break;
+			}
+			case 6:
+				// Read the stats twice without a change in between
+				ship.GetStats();
+				break;
+		}
+
+		if( !Matches( ship, equipment ) ) {
+			cout << "The stats did not match after " << (step + 1) << " changes." << endl;
+			return 1;
+		}
+	}
+
+	cout << "The stats matched after all " << steps << " changes." << endl;
+	return 0;
+}
@@ -0,0 +1,13 @@
+/**\file			shipstats.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Cached Ship stats
+ * \details
+ */
+
+
+#ifndef __H_TEST_SHIPSTATS__
+#define __H_TEST_SHIPSTATS__
+int test_shipstats(int argc, char **argv);
+#endif // __H_TEST_SHIPSTATS__
@@ -0,0 +1,144 @@
+/**\file			snapshot.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Simulation snapshot round trip
+ * \details
+ * Builds a combat scene in the default Simulation, takes a snapshot of it and
+ * then checks that:
+ * - Restoring the snapshot and taking another one gives the same state.
+ * - A truncated snapshot is refused and leaves the state as it was, even
+ *   though it only fails after the Sprites have been restored.
+ * - Running the same number of ticks twice from the snapshot gives the same
+ *   state both times.
+ * - A Lua table nested deeper than the Lua stack is written and read back
+ *   without overflowing the stack.
+ *
+ * The time to take and restore a snapshot is also reported.  Effects are
+ * left out of the comparison since their Animations follow the loop clock,
+ * which these ticks do not advance.
+ *
+ *   --ships=N      Ships in the scene (default 40)
+ *   --ticks=N      Ticks to run from the snapshot (default 200)
+ *   --seed=N       Random seed (default 1234)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/simulation.h"
+#include "Sprites/spritemanager.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/binary.h"
+#include "Utilities/lua.h"
+#include "Utilities/random.h"
+
+/**\brief Everything in the snapshot except for the Effects.
+ */
+static string GetState( Simulation& simulation ) {
+	BinaryWriter out;
+	list<Sprite*> *sprites = simulation.GetSpriteManager()->GetSprites( DRAW_ORDER_ALL & ~DRAW_ORDER_EFFECT );
+	out.WriteUint( static_cast<Uint32>( Sprite::GetNextID() ) );
+	out.WriteUint( sprites->size() );
+	for( list<Sprite*>::iterator s = sprites->begin(); s != sprites->end(); ++s ) {
+		out.WriteUint( (*s)->GetDrawOrder() );
+		(*s)->Snapshot( out );
+	}
+	delete sprites;
+
+	Lua::SaveGlobal( Lua::CurrentState(), "AIData", out );
+	Lua::SaveGlobal( Lua::CurrentState(), "Fleets", out );
+	return string( out.GetData(), out.GetSize() );
+}
+
+/**\brief Restore a snapshot and report how long it took.
+ */
+static bool Restore( Simulation& simulation, BinaryWriter& snapshot ) {
+	BinaryReader in( snapshot.GetData(), snapshot.GetSize() );
+	Uint32 start = SDL_GetTicks();
+	if( !simulation.Restore( in ) ) {
+		cout << "Could not restore the snapshot." << endl;
+		return false;
+	}
+	cout << "Restored " << simulation.GetSpriteManager()->GetNumSprites() << " sprites in " << (SDL_GetTicks() - start) << " ms" << endl;
+	return true;
+}
+
+int test_snapshot(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "ships", "Ships in the scene" );
+	args.SetOpt( VALUEOPT, "ticks", "Ticks to run from the snapshot" );
+	args.SetOpt( VALUEOPT, "seed", "Random seed" );
+
+	int ships = GetIntArgument( args, "ships", 40 );
+	int ticks = GetIntArgument( args, "ticks", 200 );
+	int seed = GetIntArgument( args, "seed", 1234 );
+
+	Simulation simulation;
+	if( !SetupDefaultSimulation( simulation, "Snapshot Test" ) ) {
+		return -1;
+	}
+
+	// Build a crowded scene around the player and let the fighting start
+	Random::SeedAll( seed );
+	Lua::Run( "PLAYER:SetCredits( 20000 )" );
+	char spawn[256];
+	snprintf( spawn, sizeof(spawn), "for i=1,%d do createRandomShip( 0, 0, 1000, Epiar.models(), Epiar.engines(), Epiar.weapons() ) end", ships );
+	Lua::Run( spawn );
+	RunTicks( simulation, 50 );
+
+	BinaryWriter snapshot;
+	Uint32 start = SDL_GetTicks();
+	simulation.Snapshot( snapshot );
+	cout << "Wrote " << simulation.GetSpriteManager()->GetNumSprites() << " sprites into " << snapshot.GetSize() << " bytes in " << (SDL_GetTicks() - start) << " ms" << endl;
+
+	// A restored snapshot is the state that was saved
+	string saved = GetState( simulation );
+	if( !Restore( simulation, snapshot ) ) {
+		return -1;
+	}
+	if( GetState( simulation ) != saved ) {
+		cout << "The restored state is not the state that was saved." << endl;
+		return 1;
+	}
+
+	// A damaged snapshot is rolled back
+	BinaryReader truncated( snapshot.GetData(), snapshot.GetSize() - 4 );
+	if( simulation.Restore( truncated ) ) {
+		cout << "A truncated snapshot was restored." << endl;
+		return 1;
+	}
+	if( GetState( simulation ) != saved ) {
+		cout << "A truncated snapshot left the state half restored." << endl;
+		return 1;
+	}
+
+	// A table nested too deeply is cut off instead of overflowing the stack
+	Lua::Run( "Deep = {} local t = Deep for i=1,100000 do t.next = {} t = t.next end" );
+	BinaryWriter deep;
+	Lua::SaveGlobal( Lua::CurrentState(), "Deep", deep );
+	BinaryReader deepIn( deep.GetData(), deep.GetSize() );
+	if( Lua::LoadGlobal( Lua::CurrentState(), "Deep", deepIn ) != true ) {
+		cout << "A deeply nested Lua table could not be read back." << endl;
+		return 1;
+	}
+	Lua::Run( "Deep = nil" );
+
+	// The same snapshot leads to the same state
+	string after[2];
+	for( int run = 0; run < 2; run++ ) {
+		if( !Restore( simulation, snapshot ) ) {
+			return -1;
+		}
+		Random::SeedAll( seed );
+		RunTicks( simulation, ticks );
+		after[run] = GetState( simulation );
+	}
+	if( after[0] != after[1] ) {
+		cout << "Two runs of " << ticks << " ticks from the same snapshot did not match." << endl;
+		return 1;
+	}
+
+	cout << "Both runs of " << ticks << " ticks matched." << endl;
+	return 0;
+}
@@ -0,0 +1,13 @@
+/**\file			snapshot.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Simulation snapshot round trip
+ * \details
+ */
+
+
+#ifndef __H_TEST_SNAPSHOT__
+#define __H_TEST_SNAPSHOT__
+int test_snapshot(int argc, char **argv);
+#endif // __H_TEST_SNAPSHOT__
@@ -1,7 +1,7 @@
 /**\file		tests.cpp
  * \author		Maoserr
  * \date		Created: Saturday, March 20, 2010
- * \date		Modified: Saturday, March 20, 2010
+ * \date		Modified: Sunday, October 18, 2026
  * \brief		Tests framework.
  * \details
  * This file implements functionality to test individual components of Epiar
@@ -15,6 +15,19 @@
 #include "Tests/argparser.h"
 #include "Tests/ui.h"
 #include "Tests/font.h"
+#include "Tests/animation.h"
+#include "Tests/benchmark.h"
+#include "Tests/archive.h"
+#include "Tests/snapshot.h"
+#include "Tests/random.h"
+#include "Tests/trig.h"
+#include "Tests/shipstats.h"
+#include "Tests/uicache.h"
+#include "Tests/voices.h"
+#include "Tests/traffic.h"
+#include "Tests/pools.h"
+#include "Tests/triggers.h"
+#include "Tests/missions.h"
 // Header files for various subsystems
 #include "Audio/audio.h"
 #include "Graphics/font.h"
@@ -46,6 +59,28 @@ Test::Test( const string& testname ):testname( testname ){
 		REQUIRE_VIDEO|REQUIRE_AUDIO|REQUIRE_OPTIONS|REQUIRE_FONTS);
 	tests["font"]=make_pair(test_font,
 		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["animation"]=make_pair(test_animation,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS);
+	tests["benchmark"]=make_pair(test_benchmark,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["archive"]=make_pair(test_archive,0);
+	tests["snapshot"]=make_pair(test_snapshot,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["random"]=make_pair(test_random,0);
+	tests["trig"]=make_pair(test_trig,0);
+	tests["shipstats"]=make_pair(test_shipstats,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["uicache"]=make_pair(test_uicache,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["voices"]=make_pair(test_voices,0);
+	tests["traffic"]=make_pair(test_traffic,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["pools"]=make_pair(test_pools,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["triggers"]=make_pair(test_triggers,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
+	tests["missions"]=make_pair(test_missions,
+		REQUIRE_VIDEO|REQUIRE_OPTIONS|REQUIRE_FONTS);
 
 }
 
@@ -90,7 +125,7 @@ void Test::LoadRequirements( void ){
 	if( testreqs & REQUIRE_VIDEO ){
 		cout<<"  Initializing video subsystem..."<<endl;
 		Video::Initialize();
-		Video::SetWindow( 640, 480, 32 );
+		Video::SetWindow( 640, 480, 32, false );
 	}
 	if( testreqs & REQUIRE_AUDIO ){
 		cout<<"  Initializing audio subsystem..."<<endl;
@@ -135,7 +170,9 @@ void Test::GameLoop( void ){
 	Input inputs;
 	Timer::Update();
 	while( !quit ) {
-		quit = inputs.Update();
+		list<InputEvent> events = inputs.Update();
+		quit = Input::HandleSpecificEvent( events, InputEvent( KEY, KEYTYPED, SDLK_ESCAPE ) );
+		UI::HandleInput( events );
 		
 		int logicLoops = Timer::Update();
 		while(logicLoops--) {
@@ -145,6 +182,6 @@ void Test::GameLoop( void ){
 		Video::Erase();
 		Video::Update();
 		UI::Draw();
-		Timer::Delay();
+		Timer::Delay( 10 );
 	}
 }
@@ -0,0 +1,177 @@
+/**\file			traffic.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Planet traffic scheduling
+ * \details
+ * Adds many Planets to the default Simulation and runs the same ticks twice
+ * from the same snapshot: once with every Planet checked on the same tick, as
+ * the Planets used to do it, and once with the Traffic scheduler.  Checks
+ * that the scheduler:
+ * - Checks every Planet once per period, and only a few on any one tick.
+ * - Never has more traffic than the budget.
+ * - Removes a ship over the budget at once instead of killing it.
+ *
+ * Then reports the mean, deviation and worst time of a tick for both runs.
+ *
+ *   --planets=N    Planets to add (default 300)
+ *   --ticks=N      Ticks to run (default 600)
+ *   --budget=N     Most traffic ships at once (default 100)
+ *   --seed=N       Random seed (default 1234)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/simulation.h"
+#include "Engine/traffic.h"
+#include "Sprites/planets.h"
+#include "Sprites/spritemanager.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/binary.h"
+#include "Utilities/lua.h"
+#include "Utilities/random.h"
+#include "Utilities/timer.h"
+
+/**\brief Report how long the ticks took.
+ * \returns The worst tick.
+ */
+static Uint32 Report( const char* name, const vector<Uint32>& times ) {
+	double sum = 0.0, squares = 0.0;
+	Uint32 worst = 0;
+	for( unsigned int t = 0; t < times.size(); t++ ) {
+		sum += times[t];
+		squares += times[t] * times[t];
+		worst = max( worst, times[t] );
+	}
+	double mean = sum / times.size();
+	double deviation = sqrt( squares / times.size() - mean * mean );
+	cout << name << ": mean " << mean << " ms, deviation " << deviation << " ms, worst " << worst << " ms" << endl;
+	return worst;
+}
+
+/**\brief Put the Simulation back to the snapshot.
+ */
+static bool Restore( Simulation& simulation, BinaryWriter& snapshot, int seed ) {
+	BinaryReader in( snapshot.GetData(), snapshot.GetSize() );
+	if( !simulation.Restore( in ) ) {
+		cout << "Could not restore the snapshot." << endl;
+		return false;
+	}
+	Random::SeedAll( seed );
+	return true;
+}
+
+int test_traffic(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "planets", "Planets to add" );
+	args.SetOpt( VALUEOPT, "ticks", "Ticks to run" );
+	args.SetOpt( VALUEOPT, "budget", "Most traffic ships at once" );
+	args.SetOpt( VALUEOPT, "seed", "Random seed" );
+
+	int planets = GetIntArgument( args, "planets", 300 );
+	int ticks = GetIntArgument( args, "ticks", 600 );
+	int budget = GetIntArgument( args, "budget", 100 );
+	int seed = GetIntArgument( args, "seed", 1234 );
+	if( ticks < 2 * TRAFFIC_PERIOD ) ticks = 2 * TRAFFIC_PERIOD;
+
+	Simulation simulation;
+	if( !SetupDefaultSimulation( simulation, "Traffic Test" ) ) {
+		return -1;
+	}
+	SpriteManager *sprites = simulation.GetSpriteManager();
+	Traffic *traffic = simulation.GetTraffic();
+	lua_State *L = Lua::CurrentState();
+
+	// A large universe
+	Random::SeedAll( seed );
+	char create[512];
+	snprintf( create, sizeof(create),
+		"math.randomseed(%d) "
+		"for p=1,%d do Planet.NewPlanet( 'Traffic '..p, about(400000), about(400000), 'Resources/Graphics/planet1.png', "
+		"choose(Epiar.alliances()), 1, math.random(3), 0, math.random(10)*1000, "
+		"'Resources/Graphics/planet1s.png', 'Traffic Test', choose(Epiar.technologies()) ) end",
+		seed, planets );
+	Lua::Run( create );
+
+	list<Sprite*> *planetList = sprites->GetSprites( DRAW_ORDER_PLANET );
+	int totalPlanets = planetList->size();
+	cout << "Running " << ticks << " ticks with " << totalPlanets << " planets." << endl;
+
+	BinaryWriter snapshot;
+	simulation.Snapshot( snapshot );
+
+	// Every Planet checks on the same tick
+	vector<Uint32> before;
+	if( !Restore( simulation, snapshot, seed ) ) {
+		delete planetList;
+		return -1;
+	}
+	for( int t = 0; t < ticks; t++ ) {
+		Uint32 start = SDL_GetTicks();
+		RunTicks( simulation, 1 );
+		if( Timer::GetLogicalFrameCount() % TRAFFIC_PERIOD == 0 ) {
+			for( list<Sprite*>::iterator p = planetList->begin(); p != planetList->end(); ++p ) {
+				if( ((Planet*)(*p))->NeedsTraffic( sprites ) ) {
+					Lua::Call( "createRandomShipForPlanet", "i", (*p)->GetID() );
+				}
+			}
+		}
+		before.push_back( SDL_GetTicks() - start );
+	}
+	delete planetList;
+	cout << "Without the scheduler there are " << sprites->GetNumSprites() << " sprites." << endl;
+
+	// The Traffic scheduler
+	vector<Uint32> after;
+	if( !Restore( simulation, snapshot, seed ) ) {
+		return -1;
+	}
+	traffic->SetBudget( budget, 1, 4 * QUADRANTSIZE );
+	traffic->ResetStats();
+	int retval = 0;
+	for( int t = 0; t < ticks; t++ ) {
+		Uint32 start = SDL_GetTicks();
+		RunTicks( simulation, 1 );
+		traffic->Update( L );
+		after.push_back( SDL_GetTicks() - start );
+
+		// Lua may add an escort with the last ship
+		if( traffic->GetPopulation() > budget + 1 ) {
+			cout << "There are " << traffic->GetPopulation() << " traffic ships on tick " << t << "." << endl;
+			retval = 1;
+		}
+	}
+	cout << "With the scheduler there are " << sprites->GetNumSprites() << " sprites." << endl;
+
+	const TrafficStats& stats = traffic->GetStats();
+	int periods = ticks / TRAFFIC_PERIOD;
+	if( stats.checks < static_cast<Uint32>( totalPlanets * periods ) ) {
+		cout << "Only " << stats.checks << " planet checks in " << periods << " periods." << endl;
+		retval = 1;
+	}
+	if( stats.peakChecks > (totalPlanets + TRAFFIC_PERIOD - 1) / TRAFFIC_PERIOD ) {
+		cout << stats.peakChecks << " planets were checked on one tick." << endl;
+		retval = 1;
+	}
+	cout << "Checked " << stats.checks
+	     << ", spawned " << stats.spawned
+	     << ", recycled " << stats.recycled
+	     << ", skipped " << stats.skipped
+	     << ", trimmed " << stats.trimmed
+	     << ", population " << traffic->GetPopulation() << endl;
+
+	// Ships over the budget are removed at once, not queued to be killed
+	int population = traffic->GetPopulation();
+	int numSprites = sprites->GetNumSprites();
+	traffic->SetBudget( 0, 1, 0.0f );
+	traffic->Update( L );
+	if( (population > 0) && (sprites->GetNumSprites() != numSprites - 1) ) {
+		cout << "Trimming the traffic left " << sprites->GetNumSprites() << " of " << numSprites << " sprites." << endl;
+		retval = 1;
+	}
+
+	Report( "Every planet at once", before );
+	Report( "Scheduled", after );
+	return retval;
+}
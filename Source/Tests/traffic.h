@@ -0,0 +1,13 @@
+/**\file			traffic.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Planet traffic scheduling
+ * \details
+ */
+
+
+#ifndef __H_TEST_TRAFFIC__
+#define __H_TEST_TRAFFIC__
+int test_traffic(int argc, char **argv);
+#endif // __H_TEST_TRAFFIC__
@@ -0,0 +1,150 @@
+/**\file			trig.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Fast math accuracy and speed
+ * \details
+ * Compares Trig against the double precision C library math that it
+ * replaced.  The largest error of each function is checked:
+ * - SinCos within 1e-6, both for small angles and for angles just below
+ *   TRIG_LARGE_ANGLE.
+ * - Atan2 within 2e-5 radians.
+ * - RotatePoint within 0.01 pixels for points 2000 pixels away.
+ *
+ * Then reports how long each of them takes, both one at a time and in a
+ * batch, next to the old code.
+ *
+ *   --count=N      Values to check and time (default 1000000)
+ */
+
+#include "includes.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/random.h"
+#include "Utilities/trig.h"
+
+/**\brief How RotatePoint used to work.
+ */
+static void OldRotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang ) {
+	float theta = atan2( y - ay, x - ax );
+	float dist = sqrt( ((x - ax)*(x-ax)) + ((y - ay)*(y-ay)) );
+	float ntheta = theta + ang;
+
+	*nx = ax + (dist * cos( ntheta ) );
+	*ny = ay - (dist * sin( ntheta ) );
+}
+
+/**\brief Print and check the largest error of one function.
+ */
+static bool Report( const char* name, double error, double limit ) {
+	cout << name << ": largest error " << error << endl;
+	if( error > limit ) {
+		cout << name << " is less accurate than " << limit << "." << endl;
+		return false;
+	}
+	return true;
+}
+
+int test_trig(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "count", "Values to check and time" );
+
+	int count = GetIntArgument( args, "count", 1000000 );
+	if( count < 1000 ) count = 1000;
+
+	Random random( 1234 );
+	vector<float> angles( count ), x( count ), y( count );
+	for( int i = 0; i < count; i++ ) {
+		angles[i] = (random.Float() * 4.0f - 2.0f) * TRIG_PI; // Two turns either way
+		x[i] = random.Float() * 4000.0f - 2000.0f;
+		y[i] = random.Float() * 4000.0f - 2000.0f;
+	}
+	vector<float> s( count ), c( count ), out( count ), nx( count ), ny( count );
+
+	// Accuracy
+	double sinError = 0.0, atanError = 0.0, rotateError = 0.0;
+	for( int i = 0; i < count; i++ ) {
+		float fs, fc;
+		Trig::SinCos( angles[i], &fs, &fc );
+		sinError = max( sinError, fabs( fs - sin( (double)angles[i] ) ) );
+		sinError = max( sinError, fabs( fc - cos( (double)angles[i] ) ) );
+
+		atanError = max( atanError, fabs( Trig::Atan2( y[i], x[i] ) - atan2( (double)y[i], (double)x[i] ) ) );
+
+		float ox, oy, rx, ry;
+		OldRotatePoint( x[i], y[i], 0.0f, 0.0f, &ox, &oy, angles[i] );
+		Trig::RotatePoint( x[i], y[i], 0.0f, 0.0f, &rx, &ry, angles[i] );
+		rotateError = max( rotateError, (double)max( fabs( ox - rx ), fabs( oy - ry ) ) );
+	}
+	Trig::SinCos( &angles[0], &s[0], &c[0], count );
+	for( int i = 0; i < count; i++ ) {
+		sinError = max( sinError, fabs( s[i] - sin( (double)angles[i] ) ) );
+	}
+
+	// The reduction has to stay accurate all the way to the C library
+	double largeError = 0.0;
+	for( int i = 0; i < count; i++ ) {
+		float angle = (random.Float() * 0.2f + 0.8f) * TRIG_LARGE_ANGLE * ((i & 1) ? -1.0f : 1.0f);
+		float fs, fc;
+		Trig::SinCos( angle, &fs, &fc );
+		largeError = max( largeError, fabs( fs - sin( (double)angle ) ) );
+		largeError = max( largeError, fabs( fc - cos( (double)angle ) ) );
+	}
+	if( !Report( "SinCos", sinError, 1e-6 )
+	 || !Report( "SinCos of large angles", largeError, 1e-6 )
+	 || !Report( "Atan2", atanError, 2e-5 )
+	 || !Report( "RotatePoint", rotateError, 0.01 ) ) {
+		return 1;
+	}
+
+	// Speed
+	float sink = 0.0f;
+	Uint32 start, libm, fast, batch;
+
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) { s[i] = sin( (double)angles[i] ); c[i] = cos( (double)angles[i] ); }
+	libm = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) Trig::SinCos( angles[i], &s[i], &c[i] );
+	fast = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	Trig::SinCos( &angles[0], &s[0], &c[0], count );
+	batch = SDL_GetTicks() - start;
+	sink += s[count / 2];
+	cout << "SinCos: libm " << libm << " ms, Trig " << fast << " ms, batch " << batch << " ms" << endl;
+
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) out[i] = atan2( (double)y[i], (double)x[i] );
+	libm = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) out[i] = Trig::Atan2( y[i], x[i] );
+	fast = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	Trig::Atan2( &y[0], &x[0], &out[0], count );
+	batch = SDL_GetTicks() - start;
+	sink += out[count / 2];
+	cout << "Atan2: libm " << libm << " ms, Trig " << fast << " ms, batch " << batch << " ms" << endl;
+
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) out[i] = sqrt( (double)x[i] * x[i] + (double)y[i] * y[i] );
+	libm = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	Trig::Magnitude( &x[0], &y[0], &out[0], count );
+	batch = SDL_GetTicks() - start;
+	sink += out[count / 2];
+	cout << "Magnitude: libm " << libm << " ms, batch " << batch << " ms" << endl;
+
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) OldRotatePoint( x[i], y[i], 1.0f, 1.0f, &nx[i], &ny[i], 0.5f );
+	libm = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	for( int i = 0; i < count; i++ ) Trig::RotatePoint( x[i], y[i], 1.0f, 1.0f, &nx[i], &ny[i], 0.5f );
+	fast = SDL_GetTicks() - start;
+	start = SDL_GetTicks();
+	Trig::RotatePoints( &x[0], &y[0], count, 1.0f, 1.0f, &nx[0], &ny[0], 0.5f );
+	batch = SDL_GetTicks() - start;
+	sink += nx[count / 2];
+	cout << "RotatePoint: old " << libm << " ms, Trig " << fast << " ms, batch " << batch << " ms" << (sink != 0.0f ? "" : " ") << endl;
+
+	return 0;
+}
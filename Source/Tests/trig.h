@@ -0,0 +1,13 @@
+/**\file			trig.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Fast math accuracy and speed
+ * \details
+ */
+
+
+#ifndef __H_TEST_TRIG__
+#define __H_TEST_TRIG__
+int test_trig(int argc, char **argv);
+#endif // __H_TEST_TRIG__
@@ -0,0 +1,161 @@
+/**\file			triggers.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Gate trigger volumes
+ * \details
+ * Adds more and more Gates to the default Simulation, with the Player as the
+ * only ship, and times the same ticks in two ways: with every Gate looking
+ * for the nearest ship, as the Gates used to do it, and with the trigger
+ * volumes.  Checks that:
+ * - The work done by the trigger volumes does not grow with the Gates.
+ * - A ship that flies into a Gate sets it off.
+ *
+ *   --gates=N      Gate pairs to add in the largest round (default 2000)
+ *   --ticks=N      Ticks to time in each round (default 200)
+ *   --seed=N       Random seed (default 1234)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Engine/simulation.h"
+#include "Sprites/gate.h"
+#include "Sprites/spritemanager.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/binary.h"
+#include "Utilities/lua.h"
+#include "Utilities/random.h"
+#include "Utilities/triggers.h"
+
+/**\brief Counts the Sprites that enter a volume.
+ */
+class EnterCounter : public TriggerListener {
+	public:
+		EnterCounter(): entered( 0 ) {}
+		void Entered( int trigger, Sprite* sprite, lua_State *L ) { entered++; }
+		int entered;
+};
+
+/**\brief Time every Gate looking for the nearest ship.
+ * \returns The time it took in milliseconds.
+ */
+static Uint32 TimeQueries( SpriteManager *sprites, int ticks ) {
+	list<Sprite*> *gates = sprites->GetSprites( DRAW_ORDER_GATE_TOP );
+	Uint32 start = SDL_GetTicks();
+	for( int t = 0; t < ticks; t++ ) {
+		for( list<Sprite*>::iterator g = gates->begin(); g != gates->end(); ++g ) {
+			sprites->GetNearestSprite( *g, GATE_TRIGGER_RADIUS, DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER );
+		}
+	}
+	Uint32 elapsed = SDL_GetTicks() - start;
+	delete gates;
+	return elapsed;
+}
+
+/**\brief Time the trigger volumes.
+ * \returns The time it took in milliseconds.
+ */
+static Uint32 TimeTriggers( SpriteManager *sprites, int ticks ) {
+	lua_State *L = Lua::CurrentState();
+	Uint32 start = SDL_GetTicks();
+	for( int t = 0; t < ticks; t++ ) {
+		sprites->UpdateTriggers( L );
+	}
+	return SDL_GetTicks() - start;
+}
+
+int test_triggers(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "gates", "Gate pairs to add in the largest round" );
+	args.SetOpt( VALUEOPT, "ticks", "Ticks to time in each round" );
+	args.SetOpt( VALUEOPT, "seed", "Random seed" );
+
+	int maxGates = GetIntArgument( args, "gates", 2000 );
+	int ticks = GetIntArgument( args, "ticks", 200 );
+	int seed = GetIntArgument( args, "seed", 1234 );
+	if( ticks < 1 ) ticks = 1;
+
+	Simulation simulation;
+	if( !SetupDefaultSimulation( simulation, "Trigger Test" ) ) {
+		return -1;
+	}
+	SpriteManager *sprites = simulation.GetSpriteManager();
+	Triggers *triggers = sprites->GetTriggers();
+
+	Random::SeedAll( seed );
+	char create[256];
+	snprintf( create, sizeof(create), "math.randomseed(%d)", seed );
+	Lua::Run( create );
+
+	int retval = 0;
+	int added = 0;
+	float firstChecks = -1.0f;
+	for( int round = max( maxGates / 8, 1 ); ; round *= 2 ) {
+		int gates = min( round, maxGates );
+		snprintf( create, sizeof(create),
+			"for g=1,%d do Epiar.NewGatePair( math.random(-400000,400000), math.random(-400000,400000),"
+			" math.random(-400000,400000), math.random(-400000,400000) ) end",
+			gates - added );
+		Lua::Run( create );
+		added = gates;
+
+		Uint32 queries = TimeQueries( sprites, ticks );
+		triggers->ResetStats();
+		Uint32 volumes = TimeTriggers( sprites, ticks );
+		float checks = static_cast<float>( triggers->GetStats().checks ) / ticks;
+
+		cout << triggers->GetCount() << " gates: "
+		     << 1000.0f * queries / ticks << " us per tick with queries, "
+		     << 1000.0f * volumes / ticks << " us per tick with triggers, "
+		     << checks << " checks per tick" << endl;
+
+		// The Player only meets the Gates near it, however many there are
+		if( firstChecks < 0.0f ) {
+			firstChecks = checks;
+		} else if( checks > firstChecks + 1.0f ) {
+			cout << "The trigger checks grew from " << firstChecks << " to " << checks << " per tick." << endl;
+			retval = 1;
+		}
+		if( gates >= maxGates ) {
+			break;
+		}
+	}
+
+	// Fly the Player into a Gate
+	list<Sprite*> *gates = sprites->GetSprites( DRAW_ORDER_GATE_TOP );
+	list<Sprite*> *players = sprites->GetSprites( DRAW_ORDER_PLAYER );
+	if( gates->empty() || players->empty() ) {
+		cout << "There is no Gate or no Player." << endl;
+		retval = 1;
+	} else {
+		triggers->ResetStats();
+		players->front()->SetWorldPosition( gates->front()->GetWorldPosition() );
+		sprites->UpdateTriggers( Lua::CurrentState() );
+		if( triggers->GetStats().entered == 0 ) {
+			cout << "The Player flew into a Gate without setting it off." << endl;
+			retval = 1;
+		}
+
+		// Restoring a snapshot must not set off a volume that the Player was already in
+		EnterCounter counter;
+		int volume = triggers->Add( players->front()->GetWorldPosition(), 100.0f, TRIGGER_MOVERS, &counter );
+		sprites->UpdateTriggers( Lua::CurrentState() );
+		BinaryWriter snapshot;
+		simulation.Snapshot( snapshot );
+		BinaryReader in( snapshot.GetData(), snapshot.GetSize() );
+		if( !simulation.Restore( in ) ) {
+			cout << "Could not restore the snapshot." << endl;
+			retval = 1;
+		}
+		sprites->UpdateTriggers( Lua::CurrentState() );
+		if( counter.entered != 1 ) {
+			cout << "The Player entered a volume " << counter.entered << " times across a snapshot." << endl;
+			retval = 1;
+		}
+		triggers->Remove( volume );
+	}
+	delete gates;
+	delete players;
+	return retval;
+}
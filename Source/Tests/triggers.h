@@ -0,0 +1,13 @@
+/**\file			triggers.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Gate trigger volumes
+ * \details
+ */
+
+
+#ifndef __H_TEST_TRIGGERS__
+#define __H_TEST_TRIGGERS__
+int test_triggers(int argc, char **argv);
+#endif // __H_TEST_TRIGGERS__
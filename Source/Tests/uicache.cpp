@@ -0,0 +1,246 @@
+/**\file			uicache.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Retained UI drawing and cached searches
+ * \details
+ * Builds two large Windows, shaped like the store and the options dialog,
+ * and draws them offscreen.  The first frames are drawn from scratch, after
+ * which the Containers should replay their display lists.  The test checks
+ * that the replayed frames look exactly like the first one, that they need
+ * far fewer draw calls, and that changing one Label only redraws the
+ * Containers above it.
+ *
+ * It then times the same Searches with and without remembered results and
+ * checks that removing or renaming a Widget is noticed.
+ *
+ *   --frames=N       Frames to draw after each change (default 30)
+ *   --searches=N     Searches to time (default 20000)
+ */
+
+#include "includes.h"
+#include "common.h"
+#include "Graphics/video.h"
+#include "UI/ui.h"
+#include "UI/widgets.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+
+#define UICACHE_ITEMS 60
+
+/**\brief A Window like the store, with a page of ships for each Tab.
+ */
+static Window* BuildStore( void ) {
+	const char *tabs[] = { "Ships", "Engines", "Weapons", "Outfits" };
+	const char *images[] = {
+		"Resources/Graphics/Fighter.png",
+		"Resources/Graphics/terran-frigate.png",
+		"Resources/Graphics/corvet.png",
+		"Resources/Graphics/patrol.png",
+		"Resources/Graphics/pirate.png",
+	};
+	int numImages = sizeof(images) / sizeof(images[0]);
+
+	Window *window = new Window( 20, 20, 600, 700, "Store" );
+	Tabs *pages = new Tabs( 10, 30, 580, 600, "Store Tabs" );
+	for( size_t t = 0; t < sizeof(tabs) / sizeof(tabs[0]); t++ ) {
+		Tab *tab = new Tab( tabs[t] );
+		for( int i = 0; i < UICACHE_ITEMS; i++ ) {
+			char label[32];
+			snprintf( label, sizeof(label), "%s %d", tabs[t], i );
+			int x = 10 + (i % 4) * 140;
+			int y = 10 + (i / 4) * 110;
+			tab->AddChild( new Picture( x, y, 100, 80, images[i % numImages] ) );
+			tab->AddChild( new Label( x, y + 85, label ) );
+		}
+		pages->AddChild( tab );
+	}
+	window->AddChild( pages );
+	window->AddChild( new Button( 10, 650, 100, 30, "Buy" ) );
+	window->AddChild( new Button( 120, 650, 100, 30, "Sell" ) );
+	return window;
+}
+
+/**\brief A Window like the options dialog, with rows of settings.
+ */
+static Window* BuildOptions( void ) {
+	const char *tabs[] = { "Game", "Video", "Sound", "Keys" };
+
+	Window *window = new Window( 640, 20, 360, 700, "Options" );
+	Tabs *pages = new Tabs( 10, 30, 340, 620, "Options Tabs" );
+	for( size_t t = 0; t < sizeof(tabs) / sizeof(tabs[0]); t++ ) {
+		Tab *tab = new Tab( tabs[t] );
+		for( int i = 0; i < UICACHE_ITEMS / 2; i++ ) {
+			char label[32];
+			snprintf( label, sizeof(label), "%s %d", tabs[t], i );
+			int y = 10 + i * 30;
+			switch( i % 3 ) {
+				case 0: tab->AddChild( new Checkbox( 10, y, (i % 2) == 0, label ) ); break;
+				case 1: tab->AddChild( new Slider( 10, y, 150, 20, label, i / 30.0f ) ); break;
+				case 2: tab->AddChild( new Textbox( 10, y, 150, 1, label, label ) ); break;
+			}
+		}
+		pages->AddChild( tab );
+	}
+	window->AddChild( pages );
+	window->AddChild( new Button( 10, 660, 100, 30, "Save" ) );
+	return window;
+}
+
+/**\brief Draw one frame of the UI.
+ * \returns The number of draw calls.
+ */
+static Uint32 DrawFrame( void ) {
+	Video::ResetDrawCalls();
+	Video::Erase();
+	Video::PreDraw();
+	UI::Draw();
+	Video::PostDraw();
+	Video::Update(); // Waits for the frame to finish
+	return Video::GetDrawCalls();
+}
+
+/**\brief Draw several frames and return the draw calls of the last one.
+ */
+static Uint32 DrawFrames( int frames ) {
+	Uint32 draws = 0;
+	for( int f = 0; f < frames; f++ ) {
+		draws = DrawFrame();
+	}
+	return draws;
+}
+
+/**\brief Count the pixels that are different between two captures.
+ */
+static long ComparePixels( SDL_Surface *a, SDL_Surface *b ) {
+	long different = 0;
+	SDL_LockSurface( a );
+	SDL_LockSurface( b );
+	for( int y = 0; y < a->h; y++ ) {
+		Uint32 *pa = (Uint32*)((Uint8*)a->pixels + y * a->pitch);
+		Uint32 *pb = (Uint32*)((Uint8*)b->pixels + y * b->pitch);
+		for( int x = 0; x < a->w; x++ ) {
+			if( pa[x] != pb[x] ) {
+				different++;
+			}
+		}
+	}
+	SDL_UnlockSurface( b );
+	SDL_UnlockSurface( a );
+	return different;
+}
+
+/**\brief Time a list of Searches.
+ * \param forget Forget the remembered results before every Search.
+ * \returns Microseconds per Search.
+ */
+static float TimeSearches( const vector<string>& queries, int searches, bool forget ) {
+	Uint32 start = SDL_GetTicks();
+	for( int s = 0; s < searches; s++ ) {
+		if( forget ) {
+			Widget::TreeChanged();
+		}
+		UI::Search( queries[s % queries.size()] );
+	}
+	return (SDL_GetTicks() - start) * 1000.0f / searches;
+}
+
+int test_uicache(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "frames", "Frames to draw after each change" );
+	args.SetOpt( VALUEOPT, "searches", "Searches to time" );
+
+	int frames = GetIntArgument( args, "frames", 30 );
+	int searches = GetIntArgument( args, "searches", 20000 );
+	int failures = 0;
+
+	if( frames < 3 ) frames = 3;
+	if( searches < 1 ) searches = 1;
+	if( !Video::SetOffscreen( 1024, 768 ) ) {
+		cout << "Could not draw offscreen." << endl;
+		return -1;
+	}
+
+	UI::Initialize( "UICache" );
+	Window *store = BuildStore();
+	Window *options = BuildOptions();
+	UI::Add( store );
+	UI::Add( options );
+
+	// Drawing
+	Uint32 first = DrawFrame();
+	SDL_Surface *drawn = Video::CaptureSurface();
+	Uint32 steady = DrawFrames( frames );
+	SDL_Surface *replayed = Video::CaptureSurface();
+
+	Label *label = static_cast<Label*>( UI::Search( "/Window'Store'/Tabs/Tab'Ships'/Label'Ships 5'/" ) );
+	if( label == NULL ) {
+		cout << "  Could not find the Label to change." << endl;
+		failures++;
+	} else {
+		label->SetText( "Ships Five" );
+	}
+	Uint32 changed = DrawFrame();
+	Uint32 settled = DrawFrames( frames );
+
+	cout << "  Draw calls: " << first << " first frame, " << steady << " unchanged, "
+	     << changed << " after changing a Label, " << settled << " settled" << endl;
+	if( (drawn == NULL) || (replayed == NULL) ) {
+		cout << "  Could not capture the frames." << endl;
+		failures++;
+	} else {
+		long different = ComparePixels( drawn, replayed );
+		cout << "  Replayed frame differs by " << different << " pixels" << endl;
+		if( different != 0 ) failures++;
+	}
+	if( drawn ) SDL_FreeSurface( drawn );
+	if( replayed ) SDL_FreeSurface( replayed );
+
+	if( steady * 10 > first ) {
+		cout << "  Unchanged frames were not replayed." << endl;
+		failures++;
+	}
+	if( changed >= first ) {
+		cout << "  Changing one Label redrew everything." << endl;
+		failures++;
+	}
+	if( settled != steady ) {
+		cout << "  The UI did not settle after the change." << endl;
+		failures++;
+	}
+
+	// Searching
+	vector<string> queries;
+	queries.push_back( "/Window'Store'/Tabs/Tab'Weapons'/Picture[40]/" );
+	queries.push_back( "/Window'Store'/Tabs/Tab'Outfits'/Label'Outfits 59'/" );
+	queries.push_back( "/Window'Options'/Tabs/Tab'Keys'/Textbox[9]/" );
+	queries.push_back( "/Window'Options'/Button'Save'/" );
+	for( size_t q = 0; q < queries.size(); q++ ) {
+		if( UI::Search( queries[q] ) == NULL ) {
+			cout << "  Could not find " << queries[q] << endl;
+			failures++;
+		}
+	}
+	float searched = TimeSearches( queries, searches, true );
+	float remembered = TimeSearches( queries, searches, false );
+	cout << "  Search: " << searched << " us without remembered results, " << remembered << " us with them" << endl;
+
+	// The Widget is freed, so only its unique name can be checked afterwards
+	UI::Close( UI::Search( queries[1] ) );
+	if( UI::Search( queries[1] ) != NULL ) {
+		cout << "  A removed Widget was still found." << endl;
+		failures++;
+	}
+	if( label != NULL ) {
+		label->SetText( "Renamed" );
+		if( UI::Search( "/Window'Store'/Tabs/Tab'Ships'/Label'Renamed'/" ) != label ) {
+			cout << "  A renamed Widget was not found." << endl;
+			failures++;
+		}
+	}
+
+	UI::CloseAll();
+	Video::UnsetOffscreen();
+
+	return failures;
+}
@@ -0,0 +1,13 @@
+/**\file			uicache.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Retained UI drawing and cached searches
+ * \details
+ */
+
+
+#ifndef __H_TEST_UICACHE__
+#define __H_TEST_UICACHE__
+int test_uicache(int argc, char **argv);
+#endif // __H_TEST_UICACHE__
@@ -0,0 +1,111 @@
+/**\file			voices.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Sound voice budgeting
+ * \details
+ * Uses SDL's dummy audio driver, so no sound card is needed.  A crowd of
+ * ships fire their weapons every frame, and the test checks that:
+ * - No more voices play than the budget allows.
+ * - Copies of a sound in the same frame are merged, and far away sounds are
+ *   culled.
+ * - A sound from the player still plays when every voice is busy.
+ *
+ * Then reports what happened to every requested sound.
+ *
+ *   --ships=N      Ships firing each frame (default 200)
+ *   --frames=N     Frames to simulate (default 60)
+ */
+
+#include "includes.h"
+#include "Audio/audio.h"
+#include "Audio/sound.h"
+#include "Tests/setup.h"
+#include "Utilities/argparser.h"
+#include "Utilities/random.h"
+
+int test_voices(int argc, char **argv) {
+	ArgParser args( argc, argv );
+	args.SetOpt( VALUEOPT, "ships", "Ships firing each frame" );
+	args.SetOpt( VALUEOPT, "frames", "Frames to simulate" );
+
+	int ships = GetIntArgument( args, "ships", 200 );
+	int frames = GetIntArgument( args, "frames", 60 );
+	if( ships < 10 ) ships = 10;
+	if( frames < 5 ) frames = 5;
+
+	putenv( const_cast<char*>( "SDL_AUDIODRIVER=dummy" ) );
+	Audio& audio = Audio::Instance();
+	if( !audio.Initialize() ) {
+		cout << "Could not open the dummy audio driver." << endl;
+		return 1;
+	}
+	audio.SetSoundVol( 1.0f );
+	audio.SetVoiceBudget( 8, 0.05f );
+	audio.ResetStats();
+
+	Sound* sounds[3];
+	sounds[0] = Sound::Get( "Resources/Audio/Effects/18384__inferno__largex.wav.ogg" );
+	sounds[1] = Sound::Get( "Resources/Audio/Interface/28820__junggle__btn010.ogg" );
+	sounds[2] = Sound::Get( "Resources/Audio/Interface/28853__junggle__btn043.ogg" );
+
+	// A crowd of ships all around the camera
+	Random random( 1234 );
+	int retval = 0;
+	for( int frame = 0; frame < frames; frame++ ) {
+		for( int ship = 0; ship < ships; ship++ ) {
+			Coordinate offset( static_cast<float>( random.Int( 20000 ) - 10000 ),
+			                   static_cast<float>( random.Int( 20000 ) - 10000 ) );
+			sounds[ ship % 3 ]->Play( offset, SOUND_PRIORITY_EFFECT );
+		}
+		audio.Update();
+		if( audio.GetPlayingVoices() > audio.GetVoiceBudget() ) {
+			cout << audio.GetPlayingVoices() << " voices are playing in frame " << frame << "." << endl;
+			retval = 1;
+		}
+	}
+
+	const AudioStats& stats = audio.GetStats();
+	if( stats.played == 0 ) {
+		cout << "No sounds were played." << endl;
+		retval = 1;
+	}
+	if( stats.merged == 0 ) {
+		cout << "No sounds were merged." << endl;
+		retval = 1;
+	}
+	if( stats.culled == 0 ) {
+		cout << "No sounds were culled." << endl;
+		retval = 1;
+	}
+
+	// Every voice is taken by other ships, but the player must be heard
+	while( audio.GetPlayingVoices() < audio.GetVoiceBudget() ) {
+		sounds[ random.Int( 3 ) ]->Play( Coordinate( 0.0f, 0.0f ), SOUND_PRIORITY_EFFECT );
+		audio.Update();
+	}
+	Uint32 stolen = stats.stolen;
+	Uint32 played = stats.played;
+	sounds[0]->Play( Coordinate( 0.0f, 0.0f ), SOUND_PRIORITY_PLAYER );
+	audio.Update();
+	if( (stats.stolen != stolen + 1) || (stats.played != played + 1) ) {
+		cout << "The player's sound did not take a voice." << endl;
+		retval = 1;
+	}
+	if( audio.GetPlayingVoices() > audio.GetVoiceBudget() ) {
+		cout << "The player's sound went over the budget." << endl;
+		retval = 1;
+	}
+
+	cout << "Requested " << stats.requested
+	     << ", merged " << stats.merged
+	     << ", culled " << stats.culled
+	     << ", dropped " << stats.dropped
+	     << ", stolen " << stats.stolen
+	     << ", played " << stats.played
+	     << ", peak voices " << stats.peakVoices << "." << endl;
+
+	audio.HaltAll();
+	audio.Shutdown();
+	return retval;
+}
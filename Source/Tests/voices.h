@@ -0,0 +1,13 @@
+/**\file			voices.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Sound voice budgeting
+ * \details
+ */
+
+
+#ifndef __H_TEST_VOICES__
+#define __H_TEST_VOICES__
+int test_voices(int argc, char **argv);
+#endif // __H_TEST_VOICES__
@@ -15,6 +15,10 @@
 #include "Input/input.h"
 #include "Utilities/timer.h"
 
+static Option<int> screenSwap( "options/timing/screen-swap" );
+static Option<int> videoWidth( "options/video/w" );
+static Option<int> videoHeight( "options/video/h" );
+
 /** \defgroup UI User Interface and Widget Management
  * @{
  */
@@ -250,10 +254,10 @@ void UI::SwapScreens(string newname, Image* oldBackground, Image* newBackground
 	// There is a 10ms delay between frames.
 	// Since "options/timing/screen-swap" is in ms use screen-swap / 10.
 	// Only do this animation if it will finish in a finite time, so skip if time=0 or dx=0
-	if ( (0 < OPTION(int, "options/timing/screen-swap") / 10)
-	  && (0 < Video::GetWidth() / (OPTION(int, "options/timing/screen-swap")/10)) )
+	if ( (0 < screenSwap / 10)
+	  && (0 < Video::GetWidth() / (screenSwap/10)) )
 	{
-		int dx = Video::GetWidth() / (OPTION(int, "options/timing/screen-swap")/10);
+		int dx = Video::GetWidth() / (screenSwap/10);
 		int oldX = 0;
 		int newX = Video::GetWidth();
 		Timer::Update();
@@ -278,7 +282,7 @@ void UI::SwapScreens(string newname, Image* oldBackground, Image* newBackground
 			oldScreen->Draw( );
 			DrawDeferred();
 
-			newBackground->DrawStretch( newX, 0, OPTION( int, "options/video/w" ), OPTION( int, "options/video/h"));
+			newBackground->DrawStretch( newX, 0, videoWidth, videoHeight);
 			Image::Get("Resources/Art/logo.png")->Draw(newX + Video::GetWidth() - 240, Video::GetHeight() - 120 );
 			newScreen->SetX( newX );
 			newScreen->Draw( );
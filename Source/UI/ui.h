@@ -1,7 +1,7 @@
 /**\file			ui.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -55,6 +55,7 @@ class UI {
 		static void Defer( Widget*, int x, int y );
 		static void DrawDeferred( void );
 		static int GetZLayer() { return zlayer; }
+		static int GetDeferredCount() { return static_cast<int>( deferred.size() ); }
 
 		static void ModalDialog( Window *widget );
 		static void ReleaseModality();
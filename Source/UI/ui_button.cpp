@@ -16,6 +16,8 @@
 #include "Utilities/log.h"
 #include "Utilities/lua.h"
 
+static Option<int> soundButtons( "options/sound/buttons" );
+
 /** \addtogroup UI
  * @{
  */
@@ -96,7 +98,7 @@ void Button::Draw( int relx, int rely ) {
 /**\brief When Left mouse is down on the button.*/
 bool Button::MouseLDown( int xi, int yi ) {
 	Widget::MouseLDown( xi, yi );
-	if(OPTION(int, "options/sound/buttons")) UI::beep->Play();
+	if(soundButtons) UI::beep->Play();
 	bitmap_current = bitmap_pressed;
 	return true;
 }
@@ -1,7 +1,7 @@
 /**\file			ui_button.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Friday, April 25, 2008
- * \date			Modified: Friday, April 25, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -22,7 +22,7 @@ class Button : public Widget {
 		
 		void Draw( int relx = 0, int rely = 0 );
 
-		void SetText(string text) { this->name = text; }
+		void SetText(string text) { this->name = text; TreeChanged(); MarkDirty(); }
 		string GetText() { return this->name; }
 
 		virtual string GetType( void ) {return string("Button");}
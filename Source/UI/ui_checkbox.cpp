@@ -14,6 +14,8 @@
 #include "Utilities/log.h"
 #include "Utilities/lua.h"
 
+static Option<int> soundButtons( "options/sound/buttons" );
+
 /** \addtogroup UI
  * @{
  */
@@ -59,7 +61,7 @@ void Checkbox::Draw( int relx, int rely ) {
 bool Checkbox::MouseLUp( int xi, int yi ) {
 	checked = !checked;
 	Widget::MouseLUp( xi, yi );
-	if(OPTION(int, "options/sound/buttons")) UI::beep->Play();
+	if(soundButtons) UI::beep->Play();
 	return true;
 }
 
@@ -1,7 +1,7 @@
 /**\file			ui_container.cpp
  * \author			Maoserr
  * \date			Created: Saturday, March 27, 2010
- * \date			Modified: Saturday, March 27, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Container object can contain other widgets.
  */
 
@@ -11,6 +11,9 @@
 #include "Utilities/log.h"
 #include "UI/ui.h"
 #include "UI/ui_container.h"
+#include "Graphics/image.h"
+
+static Option<int> disableCache( "options/development/disable-ui-cache" );
 
 /** \addtogroup UI
  * @{
@@ -18,14 +21,67 @@
 
 /**\class Container
  * \brief Container is a container class for other widgets.
+ * \details Drawing is retained.  When a Container draws its children without
+ *          any of them having changed since the last frame, it records them
+ *          into a display list, and then replays that list every frame until
+ *          a child is marked dirty.  A change deep inside a Window only
+ *          redraws the Containers between it and the screen; every other
+ *          Container replays its list with a single call.
+ *
+ *          The list is recorded on the second unchanged frame rather than
+ *          the first so that every texture and glyph it uses has already
+ *          been uploaded.  Containers holding a live Widget, or a Widget that
+ *          was deferred, are drawn normally every frame.
+ *
+ *          Set options/development/disable-ui-cache to draw everything every
+ *          frame.
  */
 
+bool Container::compiling = false;
+
+/**\brief One Widget descriptor of a Search query.
+ */
+typedef struct {
+	union {
+		int flags;
+		struct {
+			int FOUND_COORD :1;
+			int FOUND_TYPE  :1;
+			int FOUND_NAME  :1;
+			int FOUND_INDEX :1;
+		};
+	};
+	int x,y;
+	string type;
+	string name;
+	int index;
+} Query;
+
+/**\brief A Search query that has been parsed.
+ */
+typedef struct {
+	bool valid; ///< False if the query was malformed.
+	bool positional; ///< Does any descriptor use coordinates?
+	bool trailing; ///< Were there tokens after the last slash?
+	vector<Query> steps; ///< One descriptor for each slash.
+} CompiledQuery;
+
+/**\brief Stop remembering queries after this many different ones.
+ */
+#define MAX_COMPILED_QUERIES 1024
+
+static map<string,CompiledQuery> compiledQueries;
+
 /**\brief Constructor, initializes default values.*/
 Container::Container( string _name, bool _mouseHandled ):
 	mouseHandled( _mouseHandled ), keyboardFocus( NULL ), mouseHover( NULL ),
 	lmouseDown( NULL ), mmouseDown( NULL ), rmouseDown( NULL ),
 	vscrollbar( NULL ),
-	formbutton( NULL )
+	formbutton( NULL ),
+	drawing( 0 ), compiled( false ), live( false ),
+	drawnX( 0 ), drawnY( 0 ), drawnScroll( 0 ),
+	drawnTextures( 0 ),
+	foundChanges( 0 )
 {
 	name = _name;
 	InnerRect.left = InnerRect.top = InnerRect.right = InnerRect.bottom = 0;
@@ -52,6 +108,10 @@ Container::~Container( void ) {
 	
 	vscrollbar = NULL;
 	formbutton = NULL;
+
+	if( drawing ) {
+		glDeleteLists( drawing, 1 );
+	}
 }
 
 /**\brief Adds a child to the current container.
@@ -65,6 +125,8 @@ Container *Container::AddChild( Widget *widget ) {
 		}
 		children.push_back( widget );
 		widget->parent = this;
+		TreeChanged();
+		MarkDirty();
 		//LogMsg(INFO, "Adding %s %s %p to %s", widget->GetType().c_str(), widget->GetName().c_str(), widget, GetName().c_str() );
 		// Check to see if widget is past the bounds.
 		ResetScrollBars();
@@ -77,6 +139,7 @@ void Container::SetInnerRect( int left, int top, int right, int bottom ) {
 	InnerRect.top = top;
 	InnerRect.right = right;
 	InnerRect.bottom = bottom;
+	MarkDirty();
 }
 
 /**\brief Deletes a child from the current container.
@@ -99,6 +162,7 @@ bool Container::DelChild( Widget *widget ){
 			delete (*i);
 			i = children.erase( i );
 			ResetInput();
+			MarkDirty();
 
 			// Don't reset the Scrollbars when it is a scrollbar being deleted
 			// This will cause a stack overflow.
@@ -129,6 +193,8 @@ bool Container::Detach( Widget *widget ) {
 	for( i = children.begin(); i != children.end(); ++i ) {
 		if( (*i) == widget ) {
 			i = children.erase( i );
+			TreeChanged();
+			MarkDirty();
 			return true;
 		}
 	}
@@ -146,6 +212,7 @@ void Container::Empty( void ){
 	children.clear();
 
 	ResetInput();
+	MarkDirty();
 }
 
 /**\brief Reset focus and events.
@@ -248,95 +315,38 @@ bool Container::IsAttached( Widget* possible ) {
 	return false;
 }
 
-/**\brief Search this Container for a Widget
- *
- * \details
- *
- * The Container Search is used for traversing the Widget tree
- * starting at this Container.  The query is a list of Widget
- * descriptions surrounded by slashes.  Each widget description is a
- * collection of tokens that will narrow down which specific widget is
- * being referred to.
- *
- * The form of the Query:
- *  - The query always starts and ends with a slash.
- *  - Between slashes is a widget descriptor.
- *  - Each internal slash tells the search to step down to the described child.
- *  - The widget descriptor is a combinations of one or more widget characteristics.
- *
- * The Tokens:
- *  - TYPE : A Type Name restricts this search to this specific Type.
- *  - [N] : A number inside square brackets designates that this search must be
- *        (N-1)th match for this particular search. Indexes start at zero.
- *  - "NAME" or 'NAME' : This will find a specifically named Widget.  Either
- *        kind of Quote can be used.
- *  - (X,Y) :  This will find the Widget at the relative coordinates (X,Y).
- *  - / : The Slash is used as a boundary between Widget queries.
- *
- * Examples Search Queries:
- *  - /2/ This will find the 3rd child of this Container.
- *  - /Tab/ This will find the first Tab in this Container.
- *  - /"Foobar"/ This will find the first Widget named Foobar.
- *  - /(50,50)/ This will find the first Widget at (50,50).
- *  - /Frame[2]/ This will find the 3rd Frame of this Container.
- *  - /Window[2]/Checkbox/ This will find the first Checkbox in the 3rd
- *                         Window of this Container.
- *
- * \warn Repeating the same same Token type within the same Widget descriptor
- *       will overwrite the previous token.  For example, /Button[0]Textbox/
- *       will find the first Textbox not the first Button.
- * \warn The name cannot contain any of the special-character tokens, or else it will not
- *       be properly captured.
- *
- * \todo The query validation needs to be improved.
- * \todo /(Foobar,4)/ will attempt to convert the string "Foobar" to a string.
- * \todo /[]/ This should fail but doesn't. The empty string is converted to an Int.
- * \todo /(,)/ This should fail but doesn't. The empty string is converted to an Int.
- *
- * \param[in] full_query A specially formatted string
- * \returns A pointer to the first matching Widget or NULL.
+/**\brief Turn a Search query into the Widget descriptors between its slashes.
+ * \details This only looks at the query, so the result is shared by every
+ *          Container.  Malformed queries are logged once and marked invalid.
+ * \see Container::Search
  */
-Widget *Container::Search( string full_query ) {
-	int section = 0;
+static CompiledQuery CompileQuery( const string& full_query ) {
 	char token;
 	string subquery;
 	string tokens = "/[]\"'(,)";
 	vector<string> tokenized;
 	vector<string>::iterator iter;
-	list<Widget *>::iterator i;
 
-	Container *current = this;
+	CompiledQuery compiled;
+	compiled.valid = false;
+	compiled.positional = false;
+	compiled.trailing = false;
 
 	// Temporary query values
-	typedef struct {
-		union {
-			int flags;
-			struct {
-				int FOUND_COORD :1;
-				int FOUND_TYPE  :1;
-				int FOUND_NAME  :1;
-				int FOUND_INDEX :1;
-			};
-		};
-		int x,y;
-		string type;
-		string name;
-		int index;
-	} Query;
 	Query query = {{0},0,0,"","",0};
 
 	#define ABSORB() do{\
 		++iter;\
 		if( iter == tokenized.end() ) {\
 			LogMsg(ERR, "Malformed Query %s Unexpected End", full_query.c_str());\
-			return NULL;\
+			return compiled;\
 		}\
 	}while(0)
 
 	#define ABSORB_STR(X) do{\
 		if( *(iter) != X ) {\
 			LogMsg(ERR, "Malformed Query %s Expected \"" X "\"", full_query.c_str());\
-			return NULL;\
+			return compiled;\
 		}\
 		ABSORB();\
 	}while(0)
@@ -364,58 +374,25 @@ Widget *Container::Search( string full_query ) {
         assert( subquery.size() >= 1 );
 		token = subquery[0];
 
-		// If we're checking a Token, we need to be in a Container
-		if( !( (current->GetMask()) & WIDGET_CONTAINER ) ) {
-			LogMsg(INFO, "The query '%s' reached a non-container Widget and aborted at section %d.", full_query.c_str(), section );
-			return NULL;
-		}
+		// Every token after the last slash still needs a Container
+		compiled.trailing = true;
 
 		// If this is not a token then it is Widget Type
 		if( subquery.find_first_of(tokens) != string::npos) {
 			if( subquery.size() != 1 ) {
 				LogMsg(ERR, "Malformed Query %s Multi-character token", full_query.c_str());
-				return NULL;
+				return compiled;
 			}
 
 			switch( token ) {
 				// Boundary: Search the Children
 				case '/':
 				{
-					bool found = false;
-					int ind = 0;
-					if( 0 == (current->GetMask() & WIDGET_CONTAINER) ) {
-						LogMsg(ERR, "Malformed Query %s '/' token on non-container 0x%08X", full_query.c_str(), current->GetMask());
-						return NULL;
-					}
-					for( i = current->children.begin(); i != current->children.end(); ++i ) {
-						// LogMsg(DEBUG1, "Checking %s %s (%d,%d) 0x%08X\n", (*i)->GetName().c_str(), (*i)->GetType().c_str(), (*i)->GetX(), (*i)->GetY(), (*i)->GetMask() );
-						if( query.FOUND_NAME && (query.name != (*i)->GetName()) ) {
-							continue;
-						}
-						if( query.FOUND_TYPE && (query.type != (*i)->GetType()) ) {
-							continue;
-						}
-						if( query.FOUND_COORD && ((*i)->Contains(query.x, query.y) == false) ) {
-							continue;
-						}
-						if( query.FOUND_INDEX && (query.index != ind) ) {
-							ind++;
-							continue;
-						}
-						// Found a match!
-						found = true;
-						current = (Container*)(*i);
-						// Forget about the old query
-						query.flags = 0;
-						break;
-					}
-					
-					if( found == false ) {
-						LogMsg(INFO, "The query '%s' failed to find a widget at section %d", full_query.c_str(), section );
-						return NULL;
-					}
-
-					++section;
+					compiled.positional = compiled.positional || query.FOUND_COORD;
+					compiled.steps.push_back( query );
+					compiled.trailing = false;
+					// Forget about the old query
+					query.flags = 0;
 					break;
 				}
 
@@ -470,7 +447,7 @@ Widget *Container::Search( string full_query ) {
 
 				default:
 					LogMsg(ERR, "Unexpected token '%c' in query '%s'", token, full_query.c_str() );
-					return NULL;
+					return compiled;
 			}
 		}
 
@@ -491,6 +468,140 @@ Widget *Container::Search( string full_query ) {
 	#undef ABSORB
 	#undef ABSORB_STR
 
+	compiled.valid = true;
+	return compiled;
+}
+
+/**\brief Search this Container for a Widget
+ *
+ * \details
+ *
+ * The Container Search is used for traversing the Widget tree
+ * starting at this Container.  The query is a list of Widget
+ * descriptions surrounded by slashes.  Each widget description is a
+ * collection of tokens that will narrow down which specific widget is
+ * being referred to.
+ *
+ * The form of the Query:
+ *  - The query always starts and ends with a slash.
+ *  - Between slashes is a widget descriptor.
+ *  - Each internal slash tells the search to step down to the described child.
+ *  - The widget descriptor is a combinations of one or more widget characteristics.
+ *
+ * The Tokens:
+ *  - TYPE : A Type Name restricts this search to this specific Type.
+ *  - [N] : A number inside square brackets designates that this search must be
+ *        (N-1)th match for this particular search. Indexes start at zero.
+ *  - "NAME" or 'NAME' : This will find a specifically named Widget.  Either
+ *        kind of Quote can be used.
+ *  - (X,Y) :  This will find the Widget at the relative coordinates (X,Y).
+ *  - / : The Slash is used as a boundary between Widget queries.
+ *
+ * Examples Search Queries:
+ *  - /2/ This will find the 3rd child of this Container.
+ *  - /Tab/ This will find the first Tab in this Container.
+ *  - /"Foobar"/ This will find the first Widget named Foobar.
+ *  - /(50,50)/ This will find the first Widget at (50,50).
+ *  - /Frame[2]/ This will find the 3rd Frame of this Container.
+ *  - /Window[2]/Checkbox/ This will find the first Checkbox in the 3rd
+ *                         Window of this Container.
+ *
+ * Each query is only parsed once, and the Widget that it found is remembered
+ * until a Widget is added, removed or renamed.  Queries that use coordinates
+ * are always searched again since Widgets can move.
+ *
+ * \warn Repeating the same same Token type within the same Widget descriptor
+ *       will overwrite the previous token.  For example, /Button[0]Textbox/
+ *       will find the first Textbox not the first Button.
+ * \warn The name cannot contain any of the special-character tokens, or else it will not
+ *       be properly captured.
+ *
+ * \todo The query validation needs to be improved.
+ * \todo /(Foobar,4)/ will attempt to convert the string "Foobar" to a string.
+ * \todo /[]/ This should fail but doesn't. The empty string is converted to an Int.
+ * \todo /(,)/ This should fail but doesn't. The empty string is converted to an Int.
+ *
+ * \param[in] full_query A specially formatted string
+ * \returns A pointer to the first matching Widget or NULL.
+ */
+Widget *Container::Search( string full_query ) {
+	// Forget the old results when any Widget has been added, removed or renamed.
+	if( foundChanges != GetTreeChanges() ) {
+		found.clear();
+		foundChanges = GetTreeChanges();
+	}
+	map<string,Widget*>::iterator cached = found.find( full_query );
+	if( cached != found.end() ) {
+		return cached->second;
+	}
+
+	// Compile each query once
+	map<string,CompiledQuery>::iterator compiled = compiledQueries.find( full_query );
+	if( compiled == compiledQueries.end() ) {
+		if( compiledQueries.size() >= MAX_COMPILED_QUERIES ) {
+			compiledQueries.clear();
+		}
+		compiled = compiledQueries.insert( make_pair( full_query, CompileQuery( full_query ) ) ).first;
+	}
+	CompiledQuery& selector = compiled->second;
+	if( !selector.valid ) {
+		return NULL;
+	}
+
+	Container *current = this;
+	vector<Query>::iterator step;
+	list<Widget *>::iterator i;
+	int section = 0;
+
+	for( step = selector.steps.begin(); step != selector.steps.end(); ++step ) {
+		// If we're checking a Token, we need to be in a Container
+		if( !( (current->GetMask()) & WIDGET_CONTAINER ) ) {
+			LogMsg(INFO, "The query '%s' reached a non-container Widget and aborted at section %d.", full_query.c_str(), section );
+			return NULL;
+		}
+
+		bool found_child = false;
+		int ind = 0;
+		for( i = current->children.begin(); i != current->children.end(); ++i ) {
+			// LogMsg(DEBUG1, "Checking %s %s (%d,%d) 0x%08X\n", (*i)->GetName().c_str(), (*i)->GetType().c_str(), (*i)->GetX(), (*i)->GetY(), (*i)->GetMask() );
+			if( step->FOUND_NAME && (step->name != (*i)->GetName()) ) {
+				continue;
+			}
+			if( step->FOUND_TYPE && (step->type != (*i)->GetType()) ) {
+				continue;
+			}
+			if( step->FOUND_COORD && ((*i)->Contains(step->x, step->y) == false) ) {
+				continue;
+			}
+			if( step->FOUND_INDEX && (step->index != ind) ) {
+				ind++;
+				continue;
+			}
+			// Found a match!
+			found_child = true;
+			current = (Container*)(*i);
+			break;
+		}
+
+		if( found_child == false ) {
+			LogMsg(INFO, "The query '%s' failed to find a widget at section %d", full_query.c_str(), section );
+			current = NULL;
+			break;
+		}
+
+		++section;
+	}
+
+	if( (current != NULL) && selector.trailing && !( (current->GetMask()) & WIDGET_CONTAINER ) ) {
+		LogMsg(INFO, "The query '%s' reached a non-container Widget and aborted at section %d.", full_query.c_str(), section );
+		current = NULL;
+	}
+
+	// Widgets move, so searches by position can't be remembered.
+	if( !selector.positional ) {
+		found[ full_query ] = current;
+	}
+
 	//LogMsg(DEBUG1, "Found %s %s (%d,%d) 0x%08X\n", (*i)->GetName().c_str(), (*i)->GetType().c_str(), (*i)->GetX(), (*i)->GetY(), (*i)->GetMask() );
 	return (Widget*)current;
 }
@@ -622,8 +733,57 @@ void Container::Draw( int relx, int rely ) {
 
 	// Crop to prevent child widgets from spilling
 	Video::SetCropRect(x, y, this->w - InnerRect.right - InnerRect.left, this->h - InnerRect.bottom - InnerRect.top);
+
+	int yscroll = 0;
+	if ( this->vscrollbar )
+		yscroll = vscrollbar->GetPos();
+
+	if( disableCache || compiling ) {
+		// This is already being recorded by a Container further up.
+		DrawChildren( x, y, yscroll );
+	} else if( !CanReplay( x, y, yscroll ) ) {
+		int deferred = UI::GetDeferredCount();
+		DrawChildren( x, y, yscroll );
+
+		// Remember how the children were drawn so that they can be recorded next frame.
+		live = ( UI::GetDeferredCount() != deferred );
+		list<Widget *>::iterator i;
+		for( i = children.begin(); i != children.end(); ++i ) {
+			live = live || (*i)->IsLive();
+			(*i)->dirty = false;
+		}
+		dirty = false;
+		compiled = false;
+		drawnX = x;
+		drawnY = y;
+		drawnScroll = yscroll;
+		drawnCrop = Video::GetCropRect();
+		drawnTextures = Image::GetTextureChanges();
+	} else if( compiled ) {
+		glCallList( drawing );
+		Video::CountDrawCall();
+	} else {
+		if( drawing == 0 ) {
+			drawing = glGenLists( 1 );
+		}
+		glNewList( drawing, GL_COMPILE_AND_EXECUTE );
+		compiling = true;
+		DrawChildren( x, y, yscroll );
+		compiling = false;
+		glEndList();
+
+		// A texture that was uploaded while recording could not be replayed.
+		compiled = ( Image::GetTextureChanges() == drawnTextures );
+	}
+
+	Video::UnsetCropRect();
 	
-	// Draw any children
+	Widget::Draw(relx, rely);
+}
+
+/**\brief Draw every child.
+ */
+void Container::DrawChildren( int x, int y, int yscroll ) {
 	list<Widget *>::iterator i;
 	
 	for( i = children.begin(); i != children.end(); ++i ) {
@@ -633,16 +793,21 @@ void Container::Draw( int relx, int rely ) {
 			continue;
 		}
 
-		int yscroll = 0;
-		if ( this->vscrollbar )
-			yscroll = vscrollbar->GetPos();
-
 		(*i)->Draw( x, y - yscroll );
 	}
-	
-	Video::UnsetCropRect();
-	
-	Widget::Draw(relx, rely);
+}
+
+/**\brief Check if the children would look exactly like they did last frame.
+ */
+bool Container::CanReplay( int x, int y, int yscroll ) {
+	if( dirty || live ) {
+		return false;
+	}
+	Rect crop = Video::GetCropRect();
+	return (drawnX == x) && (drawnY == y) && (drawnScroll == yscroll)
+		&& (drawnCrop.x == crop.x) && (drawnCrop.y == crop.y)
+		&& (drawnCrop.w == crop.w) && (drawnCrop.h == crop.h)
+		&& (drawnTextures == Image::GetTextureChanges());
 }
 
 /**\brief Mouse is currently moving over the widget, without button down.
@@ -659,6 +824,7 @@ bool Container::MouseMotion( int xi, int yi ){
 
 	if ( this->lmouseDown ){
 		// Mouse button is held down, send drag event
+		MarkDirty();
 		this->lmouseDown->MouseDrag(xr,yr);
 	}
 
@@ -666,6 +832,7 @@ bool Container::MouseMotion( int xi, int yi ){
 		// Not on a widget
 		if( this->mouseHover ){
 			// We were on a widget, send leave event
+			MarkDirty();
 			this->mouseHover->MouseLeave();
 			this->mouseHover=NULL;
 		}
@@ -674,6 +841,7 @@ bool Container::MouseMotion( int xi, int yi ){
 	if( !this->mouseHover ){
 		// We're on a widget, but nothing was hovered on before
 		// send enter event only
+		MarkDirty();
 		event_on->MouseEnter( xr,yr + yoffset );
 		this->mouseHover=event_on;
 		return true;
@@ -681,6 +849,7 @@ bool Container::MouseMotion( int xi, int yi ){
 	if( this->mouseHover != event_on ){
 		// We're on a widget, and leaving another widget
 		// send both enter and leave event
+		MarkDirty();
 		this->mouseHover->MouseLeave();
 		event_on->MouseEnter( xr,yr + yoffset );
 		this->mouseHover=event_on;
@@ -965,6 +1134,7 @@ bool Container::KeyboardLeave( void ){
  */
 bool Container::KeyPress( SDLKey key ) {
 	Widget *next;
+	MarkDirty();
 	if( keyboardFocus ) {
 		
 		// If this key is a TAB and the keyboard is currently focused on a Textbox,
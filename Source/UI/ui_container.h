@@ -1,7 +1,7 @@
 /**\file			ui_container.h
  * \author			Maoserr
  * \date			Created: Saturday, March 27, 2010
- * \date			Modified: Saturday, March 27, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Container object can contain other widgets.
  */
 
@@ -9,6 +9,7 @@
 #define __H_UI_CONTAINER__
 
 #include "UI/ui.h"
+#include "Graphics/video.h"
 #include "ui_widget.h"
 #include "ui_scrollbar.h"
 #include "ui_button.h"
@@ -45,6 +46,7 @@ class Container : public Widget {
 		virtual Widget *PrevChild( Widget* widget, int mask = WIDGET_ALL );
 
 		virtual void Draw( int relx = 0, int rely = 0 );
+		virtual bool IsLive( void ) { return live; }
 
 		xmlNodePtr ToNode();
 
@@ -76,6 +78,9 @@ class Container : public Widget {
 		bool mouseHandled;
 
 	private:
+		void DrawChildren( int x, int y, int yscroll );
+		bool CanReplay( int x, int y, int yscroll );
+
 		Widget *keyboardFocus; ///< Remembers which child last had focus
 		Widget *mouseHover; ///< Remember which widget mouse is hovering over
 		Widget *lmouseDown; ///< Remember which widget was last L-clicked on.
@@ -88,6 +93,19 @@ class Container : public Widget {
 		struct _InnerRect {
 			int left, top, right, bottom;
 		} InnerRect;
+
+		// Retained drawing
+		GLuint drawing; ///< Display list of the children, 0 until it is first compiled.
+		bool compiled; ///< Does the display list match the children?
+		bool live; ///< Did a child that changes every frame get drawn?
+		int drawnX, drawnY, drawnScroll; ///< Where the children were last drawn.
+		Rect drawnCrop; ///< The crop rectangle that the children were last drawn in.
+		Uint32 drawnTextures; ///< Image::GetTextureChanges() when the children were last drawn.
+		static bool compiling; ///< Is some Container compiling its display list?
+
+		// Search results
+		map<string,Widget*> found; ///< Results of previous searches
+		Uint32 foundChanges; ///< Widget::GetTreeChanges() when the results were found.
 };
 
 #endif//__H_UI_CONTAINER__
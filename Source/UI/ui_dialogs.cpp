@@ -95,7 +95,7 @@ void CheckOption( void* checkbox, void*option )
 
 Checkbox* OptionBox( const char* option, string name, int x, int y )
 {
-	Checkbox *box = new Checkbox( x, y, OPTION(int, option), name);
+	Checkbox *box = new Checkbox( x, y, convertTo<int>( Options::Get(option) ), name);
 	box->RegisterAction( Action_MouseLUp, new MessageAction( CheckOption, box, (void*)option ) );
 	return box;
 }
@@ -108,7 +108,7 @@ void SlideOption( void* slider, void*option )
 
 Slider* OptionSlider( const char* option, string name, int x, int y )
 {
-	Slider *slider = new Slider( x, y, 80, 16, name, OPTION(float, option) );
+	Slider *slider = new Slider( x, y, 80, 16, name, convertTo<float>( Options::Get(option) ) );
 	slider->RegisterAction( Action_MouseDrag, new MessageAction( SlideOption, slider, (void*)option ) );
 	return slider;
 }
@@ -1,7 +1,7 @@
 /**\file			ui_dropdown.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Thursday, November 18, 2010
- * \date			Modified: Friday, December 31, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -61,6 +61,7 @@ Dropdown* Dropdown::AddOption( string option ) {
 		if( options.size() == 1 ) {
 			selected = 0;
 		}
+		MarkDirty();
 	}
 	return this;
 }
@@ -192,6 +193,7 @@ bool Dropdown::SetText(string text){
 	for(i = 0; i < options.size(); i++){
 		if(options[i] == text){
 			selected = i;
+			MarkDirty();
 			return true;
 		}
 	}
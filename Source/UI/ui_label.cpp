@@ -1,7 +1,7 @@
 /**\file			ui_label.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Friday, April 25, 2008
- * \date			Modified: Friday, April 25, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -27,8 +27,10 @@ Label::Label( int _x, int _y, string input, bool _centered) {
 	x = _x;
 	y = _y;
 
-	// w/h is dependent upon the text given
-	
+	// w/h is dependent upon the text given, and SetText skips empty text
+	w = 0;
+	h = UI::font->TightHeight( );
+
 	centered = _centered;
 	SetText( input );
 }
@@ -53,8 +55,13 @@ void Label::Draw(  int relx, int rely ) {
 /**\brief Set the text string of this Widget
  */
 void Label::SetText(string newText) {
+	if( newText == text ) {
+		return;
+	}
 	text = newText;
 	name = text;
+	TreeChanged();
+	MarkDirty();
 	if( text.find("\n") != string::npos )
 	{
 		LogMsg(WARN, "Multiline Label: %s at %ld", text.c_str(), text.find("\n") );
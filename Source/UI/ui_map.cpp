@@ -1,7 +1,7 @@
 /**\file			ui_map.cpp
  * \author			Matt Zweig
  * \date			Created:  Saturday, May 28, 2011
- * \date			Modified: Saturday, May 28, 2011
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Map Widget
  * \details
  */
@@ -13,17 +13,32 @@
 #include "Sprites/effects.h"
 #include "Utilities/timer.h"
 
+static Option<int> shipsWorldmap( "options/development/ships-worldmap" );
+static const XMLPathID skinGatePath = XMLFile::Intern( "Skin/HUD/Map/GatePath" );
+static const XMLPathID skinMapFont = XMLFile::Intern( "Skin/HUD/Map/Font" );
+static const XMLPathID skinMapColor = XMLFile::Intern( "Skin/HUD/Map/Color" );
+static const XMLPathID skinMapSize = XMLFile::Intern( "Skin/HUD/Map/Size" );
+
 /** \addtogroup UI
  * @{
  */
 
 /**\class Map
  * \brief Widget for displaying Sprites
+ * \details The Map is drawn in two layers.  Planets, their influence and
+ *          names, and Gates hardly ever change, so they are drawn once into
+ *          OpenGL display lists, the static layer.  The lists are only built
+ *          again when the zoom, the transparency, the filter or the Planets
+ *          and Gates in the SpriteManager change.  Panning the Map or moving
+ *          the widget only shifts the lists.
  *
+ *          The Player and the Ships are the dynamic layer and are drawn every
+ *          frame between the symbols and the names of the static layer.
  */
 
 
 #define MAP_ZOOM_RATIO 1.1f ///< The rate at which the Map Zooms in and out.
+#define MAP_STATIC_LAYER ( DRAW_ORDER_PLANET | DRAW_ORDER_GATE_TOP | DRAW_ORDER_GATE_BOTTOM ) ///< The Sprites in the static layer.
 
 Font *Map::MapFont = NULL;
 
@@ -45,7 +60,7 @@ Map::Map( int x, int y, int w, int h, Coordinate center, SpriteManager* sprites
 	                DRAW_ORDER_GATE_TOP );
 
 	// Show sprites only if this option is set.
-	if( OPTION(int,"options/development/ships-worldmap") ) {
+	if( shipsWorldmap ) {
 		spriteTypes |= DRAW_ORDER_SHIP;
 	}
 
@@ -64,13 +79,21 @@ Map::Map( int x, int y, int w, int h, Coordinate center, SpriteManager* sprites
 
 	if( MapFont == NULL )
 	{
-		MapFont = new Font( SKIN("Skin/HUD/Map/Font") );
-		MapFont->SetColor( Color( SKIN("Skin/HUD/Map/Color") ) );
-		MapFont->SetSize( convertTo<int>( SKIN("Skin/HUD/Map/Size") ) );
+		MapFont = new Font( SKIN(skinMapFont) );
+		MapFont->SetColor( Color( SKIN(skinMapColor) ) );
+		MapFont->SetSize( skinfile->GetInt(skinMapSize) );
 	}
 
 	zoomable = true;
 	pannable = true;
+
+	staticLists = 0;
+	staticBuilt = false;
+	builtScale = 0;
+	builtAlpha = 0;
+	builtTypes = 0;
+	builtChanges = 0;
+	builtPlanetChanges = 0;
 }
 
 /** \brief Map Destructor
@@ -78,6 +101,9 @@ Map::Map( int x, int y, int w, int h, Coordinate center, SpriteManager* sprites
  */
 Map::~Map()
 {
+	if( staticLists ) {
+		glDeleteLists( staticLists, 2 );
+	}
 	sprites = NULL;
 }
 
@@ -90,11 +116,8 @@ void Map::Draw( int relx, int rely )
 	list<Sprite*>::iterator iter;
 
 	// These variables are used for almost every sprite symbol
-	Coordinate pos, pos2;
-	Color col, field, gatePath;
-
-	// Configurable Settings
-	gatePath = Color( SKIN("Skin/HUD/Map/GatePath") );
+	Coordinate pos;
+	Color col;
 
 	// The Backdrop
 	Video::DrawRect( relx + GetX(), rely + GetY(), w, h, BLACK, alpha);
@@ -129,8 +152,19 @@ void Map::Draw( int relx, int rely )
 						 point.GetX(), rely + GetY() + h , 0.07, 0.07, 0.07, alpha );
 	}
 
-	// Draw the Sprites
-	spriteList = sprites->GetSprites( spriteTypes );
+	// The static layer is shifted by however far the Map has been panned
+	if( StaticLayerChanged() ) {
+		BuildStaticLayer();
+	}
+	Coordinate shift = WorldToScreen( Coordinate(0,0) ) - builtOrigin;
+	glPushMatrix();
+	glTranslatef( static_cast<float>( TO_INT( shift.GetX() ) ), static_cast<float>( TO_INT( shift.GetY() ) ), 0 );
+	glCallList( staticLists );
+	Video::CountDrawCall();
+	glPopMatrix();
+
+	// Draw the Sprites that move
+	spriteList = sprites->GetSprites( spriteTypes & ~MAP_STATIC_LAYER );
 	for( iter = spriteList->begin(); iter != spriteList->end(); ++iter )
 	{
 		col = (*iter)->GetRadarColor();
@@ -148,6 +182,74 @@ void Map::Draw( int relx, int rely )
 				Video::DrawFilledCircle( pos, 2, col, alpha );
 				break;
 
+			default:
+				LogMsg(WARN,"Unknown Sprite type (0x%04X) being drawn in the Map.", (*iter)->GetDrawOrder() );
+		}
+	}
+
+	// Draw the planet Names on top
+	glPushMatrix();
+	glTranslatef( static_cast<float>( TO_INT( shift.GetX() ) ), static_cast<float>( TO_INT( shift.GetY() ) ), 0 );
+	glCallList( staticLists + 1 );
+	Video::CountDrawCall();
+	glPopMatrix();
+
+	// TODO: Draw Radar Visibility
+
+	Video::UnsetCropRect();
+
+	delete spriteList;
+	spriteList = NULL;
+}
+
+/** \brief Check if the static layer needs to be built again
+ */
+bool Map::StaticLayerChanged( void )
+{
+	return ( !staticBuilt )
+	    || ( builtScale != scale )
+	    || ( builtAlpha != alpha )
+	    || ( builtTypes != (spriteTypes & MAP_STATIC_LAYER) )
+	    || ( builtChanges != sprites->GetPersistentChanges() )
+	    || ( builtPlanetChanges != Planet::GetChanges() );
+}
+
+/** \brief Draw the Planets and Gates into the display lists
+ * \details The first list holds the symbols and the second the names, so
+ *          that the names are drawn over the Ships.
+ */
+void Map::BuildStaticLayer( void )
+{
+	list<Sprite*> *spriteList;
+	list<Sprite*>::iterator iter;
+	Coordinate pos, pos2;
+	Color col, field, gatePath;
+
+	// Configurable Settings
+	gatePath = Color( SKIN(skinGatePath) );
+
+	if( staticLists == 0 ) {
+		staticLists = glGenLists( 2 );
+	}
+
+	spriteList = sprites->GetSprites( spriteTypes & MAP_STATIC_LAYER );
+
+	// FTGL uploads the glyphs as it first meets them, which must not happen
+	// while a list is being compiled.
+	for( iter = spriteList->begin(); iter != spriteList->end(); ++iter )
+	{
+		if( (*iter)->GetDrawOrder() == DRAW_ORDER_PLANET ) {
+			MapFont->TextWidth( ((Planet*)(*iter))->GetName() );
+		}
+	}
+
+	glNewList( staticLists, GL_COMPILE );
+	for( iter = spriteList->begin(); iter != spriteList->end(); ++iter )
+	{
+		col = (*iter)->GetRadarColor();
+		pos = WorldToScreen( (*iter)->GetWorldPosition() );
+
+		switch( (*iter)->GetDrawOrder() ) {
 			case DRAW_ORDER_PLANET:
 				field = ((Planet*)(*iter))->GetAlliance()->GetColor();
 				// Draw a gradient for influence
@@ -168,13 +270,11 @@ void Map::Draw( int relx, int rely )
 			case DRAW_ORDER_GATE_BOTTOM:
 				// Don't draw these ever, they are invisible.
 				break;
-
-			default:
-				LogMsg(WARN,"Unknown Sprite type (0x%04X) being drawn in the Map.", (*iter)->GetDrawOrder() );
 		}
 	}
+	glEndList();
 
-	// Do a second pass to draw planet Names on top
+	glNewList( staticLists + 1, GL_COMPILE );
 	for( iter = spriteList->begin(); iter != spriteList->end(); ++iter )
 	{
 		if( (*iter)->GetDrawOrder() == DRAW_ORDER_PLANET )
@@ -183,13 +283,17 @@ void Map::Draw( int relx, int rely )
 			MapFont->Render( pos.GetX()+5, pos.GetY(), ((Planet*)(*iter))->GetName().c_str() );
 		}
 	}
-
-	// TODO: Draw Radar Visibility
-
-	Video::UnsetCropRect();
+	glEndList();
 
 	delete spriteList;
-	spriteList = NULL;
+
+	staticBuilt = true;
+	builtScale = scale;
+	builtAlpha = alpha;
+	builtTypes = spriteTypes & MAP_STATIC_LAYER;
+	builtChanges = sprites->GetPersistentChanges();
+	builtPlanetChanges = Planet::GetChanges();
+	builtOrigin = WorldToScreen( Coordinate(0,0) );
 }
 
 /** \brief Convert click coordinates to World Coordinates
@@ -1,7 +1,7 @@
 /**\file			ui_map.h
  * \author			Matt Zweig
  * \date			Created:  Saturday, May 28, 2011
- * \date			Modified: Saturday, May 28, 2011
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			
  * \details
  */
@@ -37,6 +37,8 @@ class Map: public Widget {
 		Coordinate WorldToClick( Coordinate world );
 		Coordinate WorldToScreen( Coordinate world );
 
+		bool IsLive( void ) { return true; } // The player's position pulses
+
 		string GetType( void ) { return string("Map"); }
 		virtual int GetMask( void ) { return WIDGET_MAP; }
 	protected:
@@ -47,6 +49,9 @@ class Map: public Widget {
 		virtual bool MouseDrag( int xi, int yi );
 
 	private:
+		bool StaticLayerChanged( void );
+		void BuildStaticLayer( void );
+
 		int spriteTypes;
 		float alpha;
 		float scale;
@@ -57,6 +62,16 @@ class Map: public Widget {
 
 		SpriteManager* sprites;
 
+		// The static layer: Planets and Gates drawn into display lists
+		GLuint staticLists; ///< The symbols, followed by the Planet names.
+		bool staticBuilt;
+		float builtScale;
+		float builtAlpha;
+		int builtTypes;
+		Uint32 builtChanges; ///< SpriteManager::GetPersistentChanges when the lists were built.
+		Uint32 builtPlanetChanges; ///< Planet::GetChanges when the lists were built.
+		Coordinate builtOrigin; ///< Where the world origin was on screen when the lists were built.
+
 		static Font *MapFont;
 };
 
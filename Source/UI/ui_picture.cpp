@@ -1,7 +1,7 @@
 /**\file			ui_picture.cpp
  * \author			Matt Zweig
  * \date			Created: Tuesday, November 2, 2009
- * \date			Modified: Friday, November 14, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Widget for displaying Images
  * \details
  */
@@ -116,6 +116,7 @@ Picture::Picture( int x, int y, string filename ) {
  */
 void Picture::Rotate(double angle) {
 	rotation = angle;
+	MarkDirty();
 }
 
 /**\brief Center the Image on (x, y).
@@ -123,6 +124,7 @@ void Picture::Rotate(double angle) {
 void Picture::Center(int x, int y) {
 	this->x = x - (w / 2);
 	this->y = y - (h / 2);
+	MarkDirty();
 }
 
 /**\brief Draw this Picture
@@ -162,6 +164,8 @@ void Picture::Set( Image *img ){
 
 	w = bitmap->GetWidth();
 	h = bitmap->GetHeight();
+	TreeChanged();
+	MarkDirty();
 }
 
 /**\brief Change the Image in this Picture.
@@ -176,6 +180,8 @@ void Picture::Set( string filename ){
 
 	w = bitmap->GetWidth();
 	h = bitmap->GetHeight();
+	TreeChanged();
+	MarkDirty();
 }
 
 /**\brief Set the Background color and alpha
@@ -184,6 +190,7 @@ void Picture::Set( string filename ){
 void Picture::SetColor( float r, float g, float b, float a) {
 	color = Color(r,g,b);
 	alpha = a;
+	MarkDirty();
 }
 
 /** @} */
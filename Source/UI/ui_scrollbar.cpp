@@ -1,7 +1,7 @@
 /**\file			ui_scrollbar.cpp
  * \author			Maoserr
  * \date			Created: Tuesday, March 16, 2010
- * \date			Modified: Tuesday, March 16, 2010
+ * \date			Modified: Sunday, October 18, 2026
  */
 
 #include "includes.h"
@@ -69,6 +69,7 @@ Scrollbar::~Scrollbar() {
 void Scrollbar::SetSize(int length) {
 	this->w = bitmaps[0]->GetWidth();
 	this->h = length;
+	MarkDirty();
 }
 
 /**\brief Draws the scrollbar.
@@ -135,12 +136,14 @@ bool Scrollbar::MouseDrag( int xi, int yi ){
 void Scrollbar::ScrollUp( int pix ){
 	int newpos = pos-pix;
 	this->pos = this->CheckPos( newpos );
+	MarkDirty();
 }
 
 /**\brief Scroll the scrollbar down.*/
 void Scrollbar::ScrollDown( int pix ){
 	int newpos = pos+pix;
 	this->pos = this->CheckPos( newpos );
+	MarkDirty();
 }
 
 /**\brief Calculates marker size based on current dimensions.
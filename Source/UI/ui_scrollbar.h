@@ -1,7 +1,7 @@
 /**\file			ui_scrollbar.h
  * \author			Maoserr
  * \date			Created: Tuesday, March 16, 2010
- * \date			Modified: Tuesday, March 16, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \details
  */
 
@@ -22,7 +22,7 @@ class Scrollbar : public Widget {
 		void Draw( int relx = 0, int rely = 0 );
 
 		// Use these when the encompassing window size changes
-		void SetPosition(int x, int y) { this->x = x; this->y = y; }
+		void SetPosition(int x, int y) { this->x = x; this->y = y; MarkDirty(); }
 		void SetSize(int length);
 
 
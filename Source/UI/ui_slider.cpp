@@ -1,7 +1,7 @@
 /**\file			ui_slider.cpp
  * \author			Maoserr
  * \date			Created: Saturday, March 13, 2010
- * \date			Modified: Saturday, March 13, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Creates a slider widget
  */
 
@@ -12,6 +12,8 @@
 #include "UI/ui_slider.h"
 #include "Utilities/log.h"
 
+static Option<int> soundButtons( "options/sound/buttons" );
+
 /** \addtogroup UI
  * @{
  */
@@ -105,7 +107,7 @@ bool Slider::MouseLDown( int xi, int yi ){
 bool Slider::MouseLUp( int xi, int yi ){
 	this->SetVal(this->PixelToVal(xi - GetX()));
 	Widget::MouseLDown( xi, yi );;
-	if(OPTION(int, "options/sound/buttons")) UI::beep->Play();
+	if(soundButtons) UI::beep->Play();
 	return true;
 }
 
@@ -130,6 +132,7 @@ void Slider::SetVal( float value ){
 			checkedval = minval;
 	}
 	this->val = checkedval;
+	MarkDirty();
 }
 
 // Private functions
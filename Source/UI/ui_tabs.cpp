@@ -1,7 +1,7 @@
 /**\file			ui_tabs.cpp
  * \author			Maoserr
  * \date			Created: Sunday, March 14, 2010
- * \date			Modified: Sunday, March 14, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Implements Tab pages
  */
 
@@ -145,6 +145,7 @@ void Tabs::TabNext( void ){
 			break;
 		}
 	}
+	MarkDirty();
 }
 
 /**\brief Tabs drawing function.
@@ -1,7 +1,7 @@
 /**\file			ui_tabs.h
  * \author			Maoserr
  * \date			Created: Sunday, March 14, 2010
- * \date			Modified: Sunday, March 14, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Implement Tab pages
  */
 
@@ -43,6 +43,7 @@ class Tabs : public Container {
 		Widget *DetermineMouseFocus( int relx, int rely );
 
 		void Draw( int relx = 0, int rely = 0 );
+		bool IsLive( void ) { return (activetab != NULL) && activetab->IsLive(); }
 		string GetType( void ) { return string("Tabs"); }
 		virtual int GetMask( void ) { return WIDGET_TABS | WIDGET_CONTAINER; }
 
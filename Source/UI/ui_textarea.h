@@ -1,7 +1,7 @@
 /**\file			ui_textbox.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Monday, November 9, 2009
- * \date			Modified: Monday, November 9, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -23,7 +23,7 @@ class Textarea : public Widget {
 		virtual int GetMask( void ) { return WIDGET_TEXTAREA; }
 
 		string GetText() { return lines.GetText(); }
-		void SetText(string s) { lines.SetText(s); }
+		void SetText(string s) { lines.SetText(s); MarkDirty(); }
 
 	protected:
 		bool KeyPress( SDLKey key );
@@ -1,7 +1,7 @@
 /**\file			ui_textbox.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Monday, November 9, 2009
- * \date			Modified: Monday, November 9, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -24,7 +24,9 @@ class Textbox : public Widget {
 		virtual int GetMask( void ) { return WIDGET_TEXTBOX; }
 
 		string GetText() { return text; }
-		void SetText(string s) { text = s; }
+		void SetText(string s) { text = s; MarkDirty(); }
+
+		bool IsLive( void ) { return IsActive() && !disabled; } // The cursor blinks
 
 	protected:
 		bool KeyPress( SDLKey key );
@@ -1,7 +1,7 @@
 /**\file			ui_widget.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, December 27, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -12,12 +12,22 @@
 #include "Utilities/log.h"
 #include "Graphics/video.h"
 
+static Option<int> debugUI( "options/development/debug-ui" );
+
+Uint32 Widget::treeChanges = 0;
+
 /** \addtogroup UI
  * @{
  */
 
 /**\class Widget
  * \brief A user interface widget, widgets do not have children.
+ * \details Whenever something changes the way that a Widget looks it calls
+ *          MarkDirty(), which also marks every Container above it.  Containers
+ *          only redraw their children from scratch when they are dirty and
+ *          otherwise replay what they drew last time.  Widgets that look
+ *          different every frame, like a blinking cursor, return true from
+ *          IsLive() so that they are never replayed.
  * \todo actions could be an array of lists of Actions.
  *       This would allow multiple Actions to be registered to the same Event.
  * \fn Widget::Draw()
@@ -34,6 +44,7 @@ Widget::Widget( void ):
 	hidden( false ),
 	disabled( false ),
 	keyactivated( false ),
+	dirty( true ),
 	x( 0 ), y( 0 ),
 	w( 0 ), h( 0 ),
 	dragX( 0 ), dragY( 0 ),
@@ -49,6 +60,7 @@ Widget::Widget( void ):
 Widget::~Widget( void )
 {
 	Activate(Action_Close, 0, 0);
+	TreeChanged();
 
 	// Delete all alocated Actions
 	for( int i = 0; i < (int)Action_Last; i++ ){
@@ -63,7 +75,7 @@ Widget::~Widget( void )
  * information when the "debug-ui" option is enabled.
  */
 void Widget::Draw( int relx, int rely ) {
-	if( hovering && OPTION(int,"options/development/debug-ui") ) {
+	if( hovering && debugUI ) {
 		int absx, absy;
 		char xbuff[6];
 		char ybuff[6];
@@ -84,6 +96,18 @@ void Widget::Draw( int relx, int rely ) {
 	}
 }
 
+/**\brief Remember that this Widget must be drawn again.
+ * \details Every Container above this Widget is marked as well, since they
+ *          are the ones that keep copies of what was drawn.
+ */
+void Widget::MarkDirty( void ) {
+	Widget* widget = this;
+	while( widget != NULL ) {
+		widget->dirty = true;
+		widget = widget->parent;
+	}
+}
+
 /**\brief Tests if point is within a rectangle.
  */
 int Widget::GetAbsX( void ) {
@@ -147,6 +171,7 @@ bool Widget::Activate( action_type type, int xi, int yi ) {
 /**\brief Widget is currently being dragged.
  */
 bool Widget::MouseDrag( int xi,int yi ){
+	MarkDirty();
 	Activate(Action_MouseDrag, xi, yi);
 	return true;
 }
@@ -161,6 +186,7 @@ bool Widget::MouseMotion( int xi, int yi ){
 /**\brief Event is triggered on mouse enter.
  */
 bool Widget::MouseEnter( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse enter detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	hovering = true;
 	Activate(Action_MouseEnter, xi, yi);
@@ -170,6 +196,7 @@ bool Widget::MouseEnter( int xi, int yi ){
 /**\brief Event is triggered on mouse leave.
  */
 bool Widget::MouseLeave( void ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse leave detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	hovering = false;
 	Activate(Action_MouseLeave, 0, 0);
@@ -179,6 +206,7 @@ bool Widget::MouseLeave( void ){
 /**\brief Generic mouse up function.
  */
 bool Widget::MouseLUp( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Left up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseLUp, xi, yi);
 	return true;
@@ -187,6 +215,7 @@ bool Widget::MouseLUp( int xi, int yi ){
 /**\brief Generic mouse down function.
  */
 bool Widget::MouseLDown( int xi, int yi ) {
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Left up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	// update drag coordinates in case this is draggable
 	dragX = xi-x;
@@ -198,6 +227,7 @@ bool Widget::MouseLDown( int xi, int yi ) {
 /**\brief Generic mouse release function.
  */
 bool Widget::MouseLRelease( void ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Left Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseLRelease, 0, 0);
 	return true;
@@ -206,6 +236,7 @@ bool Widget::MouseLRelease( void ){
 /**\brief Generic middle mouse up function.
  */
 bool Widget::MouseMUp( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Middle up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseMUp, xi, yi);
 	return true;
@@ -214,6 +245,7 @@ bool Widget::MouseMUp( int xi, int yi ){
 /**\brief Generic middle mouse down function.
  */
 bool Widget::MouseMDown( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Middle down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseMDown, xi, yi);
 	return true;
@@ -222,6 +254,7 @@ bool Widget::MouseMDown( int xi, int yi ){
 /**\brief Generic middle mouse release function.
  */
 bool Widget::MouseMRelease( void ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Middle Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseMRelease, 0, 0);
 	return true;
@@ -230,6 +263,7 @@ bool Widget::MouseMRelease( void ){
 /**\brief Generic right mouse up function.
  */
 bool Widget::MouseRUp( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Right up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseRUp, xi, yi);
 	return true;
@@ -238,6 +272,7 @@ bool Widget::MouseRUp( int xi, int yi ){
 /**\brief Generic right mouse down function.
  */
 bool Widget::MouseRDown( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Right down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseRDown, xi, yi);
 	return true;
@@ -246,6 +281,7 @@ bool Widget::MouseRDown( int xi, int yi ){
 /**\brief Generic right mouse release function.
  */
 bool Widget::MouseRRelease( void ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Right Mouse released in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseRRelease, 0, 0);
 	return true;
@@ -254,6 +290,7 @@ bool Widget::MouseRRelease( void ){
 /**\brief Generic mouse wheel up function.
  */
 bool Widget::MouseWUp( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Wheel up detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseWUp, xi, yi);
 	return false;
@@ -262,6 +299,7 @@ bool Widget::MouseWUp( int xi, int yi ){
 /**\brief Generic mouse wheel down function.
  */
 bool Widget::MouseWDown( int xi, int yi ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Mouse Wheel down detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_MouseWDown, xi, yi);
 	return false;
@@ -270,6 +308,7 @@ bool Widget::MouseWDown( int xi, int yi ){
 /**\brief Generic keyboard focus function.
  */
 bool Widget::KeyboardEnter( void ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Keyboard enter detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_KeyboardEnter, 0, 0);
 	keyactivated = true;
@@ -279,6 +318,7 @@ bool Widget::KeyboardEnter( void ){
 /**\brief Generic keyboard unfocus function.
  */
 bool Widget::KeyboardLeave( void ){
+	MarkDirty();
 	LogMsg(UIINPUT,"Keyboard leave detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	Activate(Action_KeyboardLeave, 0, 0);
 	keyactivated = false;
@@ -288,6 +328,7 @@ bool Widget::KeyboardLeave( void ){
 /**\brief Generic keyboard key press function.
  */
 bool Widget::KeyPress( SDLKey key ) {
+	MarkDirty();
 	LogMsg(UIINPUT,"Key press detect in %s named %s.", GetType().c_str(), GetName().c_str() );
 	return false;
 }
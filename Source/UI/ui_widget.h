@@ -1,7 +1,7 @@
 /**\file			ui_widget.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, December 27, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -75,10 +75,10 @@ class Widget {
 		virtual int GetW( void ){ return this->w; }
 		virtual int GetH( void ){ return this->h; }
 
-		virtual void SetX( int _x ){ x = _x; }
-		virtual void SetY( int _y ){ y = _y; }
-		virtual void SetW( int _w ){ w = _w; }
-		virtual void SetH( int _h ){ h = _h; }
+		virtual void SetX( int _x ){ x = _x; MarkDirty(); }
+		virtual void SetY( int _y ){ y = _y; MarkDirty(); }
+		virtual void SetW( int _w ){ w = _w; MarkDirty(); }
+		virtual void SetH( int _h ){ h = _h; MarkDirty(); }
 
 		virtual int GetAbsX( void );
 		virtual int GetAbsY( void );
@@ -92,8 +92,15 @@ class Widget {
 		virtual void Draw( int relx = 0, int rely = 0 );
 		bool Contains( int relx, int rely );
 
-		void Show( void ) { hidden = false; }
-		void Hide( void ) { hidden = true; }
+		void Show( void ) { hidden = false; MarkDirty(); }
+		void Hide( void ) { hidden = true; MarkDirty(); }
+
+		void MarkDirty( void );
+		bool IsDirty( void ) { return dirty; }
+		virtual bool IsLive( void ) { return false; }
+
+		static Uint32 GetTreeChanges( void ) { return treeChanges; }
+		static void TreeChanged( void ) { ++treeChanges; }
 
 		virtual xmlNodePtr ToNode();
 
@@ -131,11 +138,15 @@ class Widget {
 		bool hidden;            ///< Is this widget is hidden?
 		bool disabled;          ///< Is this widget is disabled?
 		bool keyactivated;		///< Is this widget has keyboard activation.
+		bool dirty;             ///< Has this widget changed since its Container last drew it?
 		int x, y;               ///< The Location of this widget.
 		int w, h;               ///< The Width and Height of this widget.
 		int dragX, dragY;		///< If dragging, this is the offset from (x,y) to the point of click for the drag
 		Widget* parent;         ///< This widget's parent.
 		Action *(actions[Action_Last]); ///< Array of potential Actions
+
+	private:
+		static Uint32 treeChanges; ///< Counts Widgets being added, removed or renamed
 };
 
 #endif // __H_UI_WIDGET__
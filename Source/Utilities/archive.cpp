@@ -0,0 +1,261 @@
+/**\file			archive.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Memory mapped resource archives
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/archive.h"
+#include "Utilities/binary.h"
+#include "Utilities/log.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**\class Archive
+ * \brief A packed archive of resources that is memory mapped.
+ * \details An archive holds many resource files in one file so that they can
+ *          be loaded without opening, reading and closing each of them.  The
+ *          whole archive is mapped into memory when it is mounted and File
+ *          hands out pointers straight into the mapping, so nothing is copied.
+ *
+ *          Archives are built from the Resources folder by pack.py.  The
+ *          format is little endian:
+ *          - A header: ARCHIVE_MAGIC, ARCHIVE_VERSION, the number of files
+ *            and the offset of the index.
+ *          - The contents of every file, each aligned to 16 bytes.
+ *          - The index: one entry per file, sorted by name.  Each entry is the
+ *            offset and length of the file's name, followed by the offset
+ *            and size of its contents.
+ *          - The names, one after the other.
+ *
+ *          Files are found by a binary search of the index, which is read in
+ *          place.
+ *
+ * \see File, Filesystem::MountArchive
+ */
+
+list<Archive*> Archive::mounted;
+
+Archive::Archive()
+	:base(NULL)
+	,length(0)
+	,count(0)
+	,indexOffset(0)
+#ifdef _WIN32
+	,file(INVALID_HANDLE_VALUE)
+	,mapping(NULL)
+#endif
+{
+}
+
+Archive::~Archive() {
+#ifdef _WIN32
+	if( base ) UnmapViewOfFile( base );
+	if( mapping ) CloseHandle( mapping );
+	if( file != INVALID_HANDLE_VALUE ) CloseHandle( file );
+#else
+	if( base ) munmap( const_cast<char*>( base ), length );
+#endif
+}
+
+/**\brief Map an archive and add it to the front of the search order.
+ * \param path The real path to the archive, not a PhysFS path.
+ */
+bool Archive::Mount( const string& path ) {
+	Archive* archive = new Archive();
+	if( !archive->Open( path ) ) {
+		delete archive;
+		return false;
+	}
+	mounted.push_front( archive );
+	LogMsg(INFO, "Mounted the archive '%s' with %u files.", path.c_str(), archive->count );
+	return true;
+}
+
+/**\brief Unmap every archive.
+ * \details Any view returned by Find becomes invalid.
+ */
+void Archive::UnmountAll( void ) {
+	for( list<Archive*>::iterator a = mounted.begin(); a != mounted.end(); ++a ) {
+		delete *a;
+	}
+	mounted.clear();
+}
+
+/**\brief Find a file in the mounted archives.
+ * \param[in] filename The PhysFS style name, for example "Resources/Skin/skin.xml".
+ * \param[out] data Set to the start of the file.
+ * \param[out] size Set to the size of the file.
+ * \returns true if the file was found.
+ */
+bool Archive::Find( const string& filename, const char** data, long* size ) {
+	for( list<Archive*>::iterator a = mounted.begin(); a != mounted.end(); ++a ) {
+		Archive* archive = *a;
+		Uint32 low = 0, high = archive->count;
+		while( low < high ) {
+			Uint32 mid = low + (high - low) / 2;
+			int order = archive->Compare( mid, filename );
+			if( order == 0 ) {
+				string name;
+				Uint32 offset, bytes;
+				archive->ReadEntry( mid, name, offset, bytes );
+				*data = archive->base + offset;
+				*size = static_cast<long>( bytes );
+				return true;
+			} else if( order < 0 ) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
+	}
+	return false;
+}
+
+/**\brief List the files directly inside a folder of the mounted archives.
+ * \details This matches Filesystem::Enumerate, so only the file names are
+ *          returned and not the folder.
+ */
+list<string> Archive::Enumerate( const string& path, const string& suffix ) {
+	list<string> files;
+	string folder = path;
+	if( !folder.empty() && (folder[folder.size() - 1] != '/') ) {
+		folder += '/';
+	}
+
+	for( list<Archive*>::iterator a = mounted.begin(); a != mounted.end(); ++a ) {
+		for( Uint32 i = 0; i < (*a)->count; ++i ) {
+			string name;
+			Uint32 offset, bytes;
+			(*a)->ReadEntry( i, name, offset, bytes );
+			if( (name.compare( 0, folder.size(), folder ) != 0) || (name.find( '/', folder.size() ) != string::npos) ) {
+				continue;
+			}
+			string file = name.substr( folder.size() );
+			if( (file.size() >= suffix.size()) && (file.compare( file.size() - suffix.size(), suffix.size(), suffix ) == 0) ) {
+				files.push_back( file );
+			}
+		}
+	}
+	return files;
+}
+
+/**\brief Every file in the mounted archives.
+ */
+list<string> Archive::GetNames( void ) {
+	list<string> names;
+	for( list<Archive*>::iterator a = mounted.begin(); a != mounted.end(); ++a ) {
+		for( Uint32 i = 0; i < (*a)->count; ++i ) {
+			string name;
+			Uint32 offset, bytes;
+			(*a)->ReadEntry( i, name, offset, bytes );
+			names.push_back( name );
+		}
+	}
+	return names;
+}
+
+/**\brief Map the archive and check its header and index.
+ */
+bool Archive::Open( const string& _path ) {
+	path = _path;
+
+#ifdef _WIN32
+	file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( file == INVALID_HANDLE_VALUE ) {
+		LogMsg(ERR, "Could not open the archive '%s'.", path.c_str() );
+		return false;
+	}
+	length = static_cast<size_t>( GetFileSize( file, NULL ) );
+	mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	if( mapping != NULL ) {
+		base = static_cast<const char*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+	}
+#else
+	int fd = open( path.c_str(), O_RDONLY );
+	if( fd < 0 ) {
+		LogMsg(ERR, "Could not open the archive '%s': %s", path.c_str(), strerror(errno) );
+		return false;
+	}
+	struct stat status;
+	if( fstat( fd, &status ) == 0 ) {
+		length = static_cast<size_t>( status.st_size );
+		void* view = mmap( NULL, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+		base = (view == MAP_FAILED) ? NULL : static_cast<const char*>( view );
+	}
+	close( fd );
+#endif
+
+	if( base == NULL ) {
+		LogMsg(ERR, "Could not map the archive '%s'.", path.c_str() );
+		return false;
+	}
+
+	BinaryReader header( base, length );
+	Uint32 magic = header.ReadUint();
+	Uint32 version = header.ReadUint();
+	count = header.ReadUint();
+	indexOffset = header.ReadUint();
+	if( header.Failed() || (magic != ARCHIVE_MAGIC) || (version != ARCHIVE_VERSION) ) {
+		LogMsg(ERR, "'%s' is not a version %d archive.", path.c_str(), ARCHIVE_VERSION );
+		return false;
+	}
+	if( (indexOffset > length) || (count > (length - indexOffset) / ARCHIVE_ENTRY_SIZE) ) {
+		LogMsg(ERR, "The archive '%s' has a bad index.", path.c_str() );
+		return false;
+	}
+
+	// Check every entry once so that lookups do not need to.
+	for( Uint32 i = 0; i < count; ++i ) {
+		string name;
+		Uint32 offset, bytes;
+		if( !ReadEntry( i, name, offset, bytes ) ) {
+			LogMsg(ERR, "The archive '%s' is damaged.", path.c_str() );
+			count = 0;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**\brief Read one entry of the index.
+ * \returns false if the entry points outside of the archive.
+ */
+bool Archive::ReadEntry( Uint32 i, string& name, Uint32& offset, Uint32& size ) {
+	BinaryReader entry( base + indexOffset + i * ARCHIVE_ENTRY_SIZE, ARCHIVE_ENTRY_SIZE );
+	Uint32 nameOffset = entry.ReadUint();
+	Uint32 nameLength = entry.ReadUint();
+	offset = entry.ReadUint();
+	size = entry.ReadUint();
+	if( (nameOffset > length) || (nameLength > length - nameOffset)
+	 || (offset > length) || (size > length - offset) ) {
+		return false;
+	}
+	name.assign( base + nameOffset, nameLength );
+	return true;
+}
+
+/**\brief Compare the name of an entry against a filename without copying it.
+ * \returns A negative number, zero or a positive number like strcmp.
+ */
+int Archive::Compare( Uint32 i, const string& filename ) {
+	BinaryReader entry( base + indexOffset + i * ARCHIVE_ENTRY_SIZE, ARCHIVE_ENTRY_SIZE );
+	Uint32 nameOffset = entry.ReadUint();
+	Uint32 nameLength = entry.ReadUint();
+	size_t common = min( static_cast<size_t>( nameLength ), filename.size() );
+	int order = memcmp( base + nameOffset, filename.data(), common );
+	if( order != 0 ) {
+		return order;
+	}
+	if( nameLength == filename.size() ) {
+		return 0;
+	}
+	return (nameLength < filename.size()) ? -1 : 1;
+}
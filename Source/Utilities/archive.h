@@ -0,0 +1,52 @@
+/**\file			archive.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Memory mapped resource archives
+ * \details
+ */
+
+#ifndef __H_ARCHIVE__
+#define __H_ARCHIVE__
+
+#include "includes.h"
+
+#define ARCHIVE_MAGIC 0x314B5045 // "EPK1"
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_HEADER_SIZE 16
+#define ARCHIVE_ENTRY_SIZE 16
+
+class Archive {
+	public:
+		static bool Mount( const string& path );
+		static void UnmountAll( void );
+		static bool IsMounted( void ) { return !mounted.empty(); }
+
+		static bool Find( const string& filename, const char** data, long* size );
+		static list<string> Enumerate( const string& path, const string& suffix = "" );
+		static list<string> GetNames( void );
+
+	private:
+		Archive();
+		~Archive();
+		Archive( const Archive& );
+		Archive& operator= ( const Archive& );
+
+		bool Open( const string& path );
+		bool ReadEntry( Uint32 i, string& name, Uint32& offset, Uint32& size );
+		int Compare( Uint32 i, const string& filename );
+
+		static list<Archive*> mounted;
+
+		string path;
+		const char* base; ///< The start of the mapped file.
+		size_t length;
+		Uint32 count;
+		Uint32 indexOffset;
+#ifdef _WIN32
+		HANDLE file;
+		HANDLE mapping;
+#endif
+};
+
+#endif // __H_ARCHIVE__
@@ -0,0 +1,266 @@
+/**\file			assetmanager.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Background decoding of Images, Animations and Audio
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/assetmanager.h"
+#include "Utilities/log.h"
+
+/**\class AssetJob
+ * \brief A single asset that should be loaded in the background.
+ * \details Loading is split into two halves.  Decode() does the slow work of
+ *          reading the file and decompressing it.  It runs on a worker
+ *          thread, so it must not touch OpenGL, Lua or any shared game state.
+ *          Upload() runs on the main thread and hands the decoded data to the
+ *          Resource that requested it (for example by creating a texture).
+ *
+ *          The AssetManager owns every queued AssetJob and deletes it after
+ *          it has been uploaded.
+ *
+ * \see AssetManager
+ */
+
+/**\class AssetManager
+ * \brief Decodes assets on a pool of worker threads.
+ * \details Resources like Image, Ani, Sound and Song can be requested with
+ *          their GetAsync functions.  These return a usable handle
+ *          immediately and queue an AssetJob here.  Worker threads decode the
+ *          queued jobs in parallel.  The main thread calls Update() once per
+ *          frame to upload decoded jobs, but stops once its time budget is
+ *          used so that a burst of loading does not drop frames.
+ *
+ *          A Resource that needs its data right now can call Poll() to upload
+ *          it early if it has already been decoded, or Complete() to block
+ *          until it is ready.
+ *
+ *          When no worker threads are running, jobs are decoded as soon as
+ *          they are queued.
+ *
+ * \see AssetJob, Image::GetAsync, Ani::GetAsync, Sound::GetAsync, Song::GetAsync
+ */
+
+list<AssetJob*> AssetManager::queued;
+list<AssetJob*> AssetManager::decoded;
+vector<SDL_Thread*> AssetManager::threads;
+SDL_mutex* AssetManager::lock = NULL;
+SDL_cond* AssetManager::wake = NULL;
+SDL_cond* AssetManager::done = NULL;
+int AssetManager::inflight = 0;
+bool AssetManager::running = false;
+
+/**\brief Start the worker threads.
+ * \param numThreads The number of decoding threads.  Zero decodes synchronously.
+ */
+bool AssetManager::Initialize( int numThreads ) {
+	if( lock == NULL ) {
+		lock = SDL_CreateMutex();
+		wake = SDL_CreateCond();
+		done = SDL_CreateCond();
+	}
+
+	running = true;
+	for( int i = 0; i < numThreads; ++i ) {
+		SDL_Thread* thread = SDL_CreateThread( AssetManager::Worker, NULL );
+		if( thread == NULL ) {
+			LogMsg(ERR, "Could not start asset thread %d: %s", i, SDL_GetError() );
+			break;
+		}
+		threads.push_back( thread );
+	}
+
+	if( threads.empty() ) {
+		running = false;
+	}
+
+	LogMsg(INFO, "Asset Manager started with %d decoding threads.", (int)threads.size() );
+	return true;
+}
+
+/**\brief Stop the worker threads and finish any outstanding jobs.
+ */
+void AssetManager::Shutdown( void ) {
+	if( lock == NULL ) {
+		return;
+	}
+
+	SDL_LockMutex( lock );
+	running = false;
+	SDL_CondBroadcast( wake );
+	SDL_UnlockMutex( lock );
+
+	for( vector<SDL_Thread*>::iterator t = threads.begin(); t != threads.end(); ++t ) {
+		SDL_WaitThread( *t, NULL );
+	}
+	threads.clear();
+
+	Flush();
+}
+
+/**\brief Hand a job to the worker threads.
+ * \details The AssetManager takes ownership of the job.
+ */
+void AssetManager::Queue( AssetJob* job ) {
+	assert( job );
+	job->state = JOB_QUEUED;
+
+	if( !running ) {
+		// Without workers, decode immediately but still upload later.
+		job->state = JOB_DECODING;
+		job->Decode();
+		job->state = JOB_DECODED;
+		if( lock ) SDL_LockMutex( lock );
+		decoded.push_back( job );
+		if( lock ) SDL_UnlockMutex( lock );
+		return;
+	}
+
+	SDL_LockMutex( lock );
+	queued.push_back( job );
+	SDL_CondSignal( wake );
+	SDL_UnlockMutex( lock );
+}
+
+/**\brief Upload decoded jobs until the budget has been spent.
+ * \details At least one job is always uploaded so that loading makes progress
+ *          even when the budget is very small.
+ * \param budgetMS The number of milliseconds that may be spent this frame.
+ */
+void AssetManager::Update( Uint32 budgetMS ) {
+	Uint32 start = SDL_GetTicks();
+	AssetJob* job;
+
+	do {
+		if( lock ) SDL_LockMutex( lock );
+		if( decoded.empty() ) {
+			if( lock ) SDL_UnlockMutex( lock );
+			return;
+		}
+		job = decoded.front();
+		decoded.pop_front();
+		if( lock ) SDL_UnlockMutex( lock );
+
+		Finish( job );
+	} while( (SDL_GetTicks() - start) < budgetMS );
+}
+
+/**\brief Upload a job now if it has already been decoded.
+ * \details This never blocks.
+ * \returns true if the job was uploaded (and deleted).
+ */
+bool AssetManager::Poll( AssetJob* job ) {
+	assert( job );
+
+	if( lock ) SDL_LockMutex( lock );
+	if( job->state != JOB_DECODED ) {
+		if( lock ) SDL_UnlockMutex( lock );
+		return false;
+	}
+	decoded.remove( job );
+	if( lock ) SDL_UnlockMutex( lock );
+
+	Finish( job );
+	return true;
+}
+
+/**\brief Block until a job has been decoded, then upload it.
+ * \details If no worker has picked up the job yet, it is decoded on the
+ *          calling thread rather than waiting in line.
+ */
+void AssetManager::Complete( AssetJob* job ) {
+	assert( job );
+
+	if( lock ) SDL_LockMutex( lock );
+	if( job->state == JOB_QUEUED ) {
+		queued.remove( job );
+		job->state = JOB_DECODING;
+		if( lock ) SDL_UnlockMutex( lock );
+
+		job->Decode();
+
+		if( lock ) SDL_LockMutex( lock );
+		job->state = JOB_DECODED;
+	} else {
+		while( job->state == JOB_DECODING ) {
+			SDL_CondWait( done, lock );
+		}
+		decoded.remove( job );
+	}
+	if( lock ) SDL_UnlockMutex( lock );
+
+	Finish( job );
+}
+
+/**\brief Decode and upload every outstanding job.
+ */
+void AssetManager::Flush( void ) {
+	AssetJob* job;
+
+	while( true ) {
+		if( lock ) SDL_LockMutex( lock );
+		if( !queued.empty() ) {
+			job = queued.front();
+		} else if( !decoded.empty() ) {
+			job = decoded.front();
+		} else if( running && (GetPending() > 0) ) {
+			// Something is still being decoded by a worker.
+			SDL_CondWait( done, lock );
+			SDL_UnlockMutex( lock );
+			continue;
+		} else {
+			if( lock ) SDL_UnlockMutex( lock );
+			return;
+		}
+		if( lock ) SDL_UnlockMutex( lock );
+
+		Complete( job );
+	}
+}
+
+/**\brief The number of jobs that have not been uploaded yet.
+ */
+int AssetManager::GetPending( void ) {
+	return static_cast<int>( queued.size() + decoded.size() ) + inflight;
+}
+
+/**\brief Upload a decoded job and release it.
+ */
+void AssetManager::Finish( AssetJob* job ) {
+	assert( job->state == JOB_DECODED );
+	job->Upload();
+	delete job;
+}
+
+/**\brief The decoding loop run by each worker thread.
+ */
+int AssetManager::Worker( void *unused ) {
+	AssetJob* job;
+
+	SDL_LockMutex( lock );
+	while( running ) {
+		if( queued.empty() ) {
+			SDL_CondWait( wake, lock );
+			continue;
+		}
+
+		job = queued.front();
+		queued.pop_front();
+		job->state = JOB_DECODING;
+		++inflight;
+		SDL_UnlockMutex( lock );
+
+		job->Decode();
+
+		SDL_LockMutex( lock );
+		--inflight;
+		job->state = JOB_DECODED;
+		decoded.push_back( job );
+		SDL_CondBroadcast( done );
+	}
+	SDL_UnlockMutex( lock );
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+/**\file			assetmanager.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Background decoding of Images, Animations and Audio
+ * \details
+ */
+
+#ifndef __H_ASSETMANAGER__
+#define __H_ASSETMANAGER__
+
+#include "includes.h"
+
+typedef enum {
+	JOB_QUEUED,		/**< Waiting for a worker thread. */
+	JOB_DECODING,	/**< A worker thread is decoding this job. */
+	JOB_DECODED		/**< Decoded, waiting for the main thread to upload it. */
+} AssetJobState;
+
+class AssetJob {
+	public:
+		AssetJob(): state(JOB_QUEUED) {}
+		virtual ~AssetJob() {}
+
+		virtual void Decode( void ) = 0; ///< Runs on a worker thread.
+		virtual void Upload( void ) = 0; ///< Runs on the main thread.
+
+		AssetJobState state;
+};
+
+class AssetManager {
+	public:
+		static bool Initialize( int numThreads );
+		static void Shutdown( void );
+
+		static void Queue( AssetJob* job );
+		static void Update( Uint32 budgetMS );
+		static bool Poll( AssetJob* job );
+		static void Complete( AssetJob* job );
+		static void Flush( void );
+
+		static int GetPending( void );
+
+	private:
+		static int Worker( void *unused );
+		static void Finish( AssetJob* job );
+
+		static list<AssetJob*> queued;
+		static list<AssetJob*> decoded;
+		static vector<SDL_Thread*> threads;
+		static SDL_mutex* lock;
+		static SDL_cond* wake;
+		static SDL_cond* done;
+		static int inflight;
+		static bool running;
+};
+
+#endif // __H_ASSETMANAGER__
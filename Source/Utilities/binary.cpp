@@ -0,0 +1,188 @@
+/**\file			binary.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Little endian binary buffers
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/binary.h"
+#include "Utilities/file.h"
+
+/**\class BinaryWriter
+ * \brief Builds a buffer of little endian values.
+ * \details Every value is written at its natural size with no padding, and
+ *          strings are written as a 32 bit length followed by their bytes.
+ *          The same buffer can be read back on any platform by a
+ *          BinaryReader.
+ * \see BinaryReader
+ */
+
+/**\class BinaryReader
+ * \brief Reads values from a buffer written by a BinaryWriter.
+ * \details The reader never copies or owns the buffer.  Reading past the end
+ *          of the buffer returns zeroes and marks the reader as Failed(), so
+ *          a caller can read a whole record and check for errors once.
+ * \see BinaryWriter
+ */
+
+/**\brief Append a value, swapping it to little endian if needed.
+ */
+void BinaryWriter::WriteRaw( const void* value, size_t size ) {
+	const char* bytes = static_cast<const char*>( value );
+	if( IsBigEndian() ) {
+		for( size_t i = size; i > 0; --i ) {
+			buffer.push_back( bytes[i - 1] );
+		}
+	} else {
+		buffer.insert( buffer.end(), bytes, bytes + size );
+	}
+}
+
+void BinaryWriter::WriteInt( Sint32 value ) {
+	WriteRaw( &value, sizeof(value) );
+}
+
+void BinaryWriter::WriteUint( Uint32 value ) {
+	WriteRaw( &value, sizeof(value) );
+}
+
+void BinaryWriter::WriteShort( Sint16 value ) {
+	WriteRaw( &value, sizeof(value) );
+}
+
+void BinaryWriter::WriteBool( bool value ) {
+	buffer.push_back( value ? 1 : 0 );
+}
+
+void BinaryWriter::WriteFloat( float value ) {
+	WriteRaw( &value, sizeof(value) );
+}
+
+void BinaryWriter::WriteDouble( double value ) {
+	WriteRaw( &value, sizeof(value) );
+}
+
+/**\brief Write a string as its length followed by its characters.
+ */
+void BinaryWriter::WriteString( const string& value ) {
+	WriteUint( static_cast<Uint32>( value.size() ) );
+	buffer.insert( buffer.end(), value.begin(), value.end() );
+}
+
+/**\brief Append bytes exactly as they are.
+ */
+void BinaryWriter::WriteBytes( const char* data, size_t size ) {
+	buffer.insert( buffer.end(), data, data + size );
+}
+
+/**\brief Overwrite a value that was written earlier.
+ * \details This is used to fill in offsets and sizes once they are known.
+ */
+void BinaryWriter::PatchUint( size_t offset, Uint32 value ) {
+	assert( offset + sizeof(value) <= buffer.size() );
+	BinaryWriter patch;
+	patch.WriteUint( value );
+	memcpy( &buffer[offset], patch.GetData(), sizeof(value) );
+}
+
+BinaryReader::BinaryReader( const char* _data, size_t _size )
+	:data(_data)
+	,size(_size)
+	,pos(0)
+	,failed(false)
+{
+}
+
+/**\brief Copy the next value out of the buffer, swapping it if needed.
+ */
+bool BinaryReader::ReadRaw( void* value, size_t bytes ) {
+	if( failed || (bytes > size - pos) ) {
+		memset( value, 0, bytes );
+		failed = true;
+		return false;
+	}
+	char* out = static_cast<char*>( value );
+	if( IsBigEndian() ) {
+		for( size_t i = 0; i < bytes; ++i ) {
+			out[i] = data[pos + bytes - 1 - i];
+		}
+	} else {
+		memcpy( out, data + pos, bytes );
+	}
+	pos += bytes;
+	return true;
+}
+
+Sint32 BinaryReader::ReadInt( void ) {
+	Sint32 value;
+	ReadRaw( &value, sizeof(value) );
+	return value;
+}
+
+Uint32 BinaryReader::ReadUint( void ) {
+	Uint32 value;
+	ReadRaw( &value, sizeof(value) );
+	return value;
+}
+
+Sint16 BinaryReader::ReadShort( void ) {
+	Sint16 value;
+	ReadRaw( &value, sizeof(value) );
+	return value;
+}
+
+bool BinaryReader::ReadBool( void ) {
+	char value;
+	ReadRaw( &value, sizeof(value) );
+	return value != 0;
+}
+
+float BinaryReader::ReadFloat( void ) {
+	float value;
+	ReadRaw( &value, sizeof(value) );
+	return value;
+}
+
+double BinaryReader::ReadDouble( void ) {
+	double value;
+	ReadRaw( &value, sizeof(value) );
+	return value;
+}
+
+/**\brief Read a string written by BinaryWriter::WriteString.
+ */
+string BinaryReader::ReadString( void ) {
+	Uint32 length = ReadUint();
+	if( failed || (length > size - pos) ) {
+		failed = true;
+		return "";
+	}
+	string value( data + pos, length );
+	pos += length;
+	return value;
+}
+
+/**\brief Move to an absolute position in the buffer.
+ */
+bool BinaryReader::Seek( size_t _pos ) {
+	if( _pos > size ) {
+		failed = true;
+		return false;
+	}
+	pos = _pos;
+	return true;
+}
+
+/**\brief A 32 bit FNV-1a hash.
+ * \details Pass the result back in as the starting hash to hash several
+ *          buffers as if they were one.
+ */
+Uint32 BinaryReader::Hash( const char* data, size_t size, Uint32 hash ) {
+	for( size_t i = 0; i < size; ++i ) {
+		hash ^= static_cast<unsigned char>( data[i] );
+		hash *= 16777619u;
+	}
+	return hash;
+}
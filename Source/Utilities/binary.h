@@ -0,0 +1,67 @@
+/**\file			binary.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Little endian binary buffers
+ * \details
+ */
+
+#ifndef __H_BINARY__
+#define __H_BINARY__
+
+#include "includes.h"
+
+class BinaryWriter {
+	public:
+		BinaryWriter() {}
+
+		void WriteInt( Sint32 value );
+		void WriteUint( Uint32 value );
+		void WriteShort( Sint16 value );
+		void WriteBool( bool value );
+		void WriteFloat( float value );
+		void WriteDouble( double value );
+		void WriteString( const string& value );
+		void WriteBytes( const char* data, size_t size );
+
+		void PatchUint( size_t offset, Uint32 value );
+
+		const char* GetData( void ) const { return buffer.empty() ? NULL : &buffer[0]; }
+		size_t GetSize( void ) const { return buffer.size(); }
+
+	private:
+		void WriteRaw( const void* value, size_t size );
+
+		vector<char> buffer;
+};
+
+class BinaryReader {
+	public:
+		BinaryReader( const char* _data, size_t _size );
+
+		Sint32 ReadInt( void );
+		Uint32 ReadUint( void );
+		Sint16 ReadShort( void );
+		bool ReadBool( void );
+		float ReadFloat( void );
+		double ReadDouble( void );
+		string ReadString( void );
+
+		bool Seek( size_t _pos );
+		size_t Tell( void ) const { return pos; }
+		size_t GetSize( void ) const { return size; }
+
+		bool Failed( void ) const { return failed; }
+
+		static Uint32 Hash( const char* data, size_t size, Uint32 hash = 2166136261u );
+
+	private:
+		bool ReadRaw( void* value, size_t bytes );
+
+		const char* data;
+		size_t size;
+		size_t pos;
+		bool failed;
+};
+
+#endif // __H_BINARY__
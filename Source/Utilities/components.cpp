@@ -1,7 +1,7 @@
 /**\file			components.cpp
  * \author			Matt Zweig
  * \date			Created: Friday, February 26, 2010
- * \date			Modified: Friday, February 26, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -9,6 +9,7 @@
 #include "includes.h"
 #include "Utilities/log.h"
 #include "Utilities/file.h"
+#include "Utilities/savemanager.h"
 #include "Utilities/components.h"
 
 /**\class Component
@@ -33,9 +34,45 @@
  *
  **\fn FromXMLNode
  * \brief Parse an XML Node into a Component.
+ * \details Components with a field table are parsed through it, exactly
+ *          like Components::ParseStream does.  Components without one must
+ *          override this.
  *
  **\fn ToXMLNode
  * \brief Create an XML Node from this Component.
+ *
+ **\fn Serialize
+ * \brief Write this Component to a binary cache.
+ * \details Components that cannot be cached return false, which stops the
+ *          cache from being written.
+ *
+ **\fn Deserialize
+ * \brief Read this Component back from a binary cache.
+ * \details This must read exactly what Serialize wrote and resolve other
+ *          Components the same way that FromXMLNode does.
+ *
+ **\fn GetFields
+ * \brief The table of child elements that this Component understands.
+ * \details The table ends with a NULL tag.  Components that return a table
+ *          are parsed by Components::Load in a single streaming pass without
+ *          building a DOM.  Components without a table are parsed with
+ *          FromXMLNode instead.
+ *
+ **\fn ParseField
+ * \brief Parse the text of one field from the GetFields table.
+ * \details Fields are parsed in the order of the table, not the order of
+ *          the file, so a field may depend on the fields listed before it.
+ *          Repeated elements are passed in one at a time.  The name has
+ *          always been set before the first field is parsed.
+ *
+ **\fn ParseNestedField
+ * \brief Parse a FIELD_NESTED field from its element.
+ * \details Only this element is expanded into a DOM.  Nested fields are
+ *          parsed while the file is read, before any text fields, so they
+ *          must not depend on the other fields.
+ *
+ **\fn FinishFields
+ * \brief Called after every field has been parsed.
  */
 
 /**\class Components
@@ -65,6 +102,49 @@ Component::Component() {
 	name = "";
 }
 
+/**\brief Parse an XML Node through the field table.
+ * \details Nested fields are parsed first and then every text field in the
+ *          order of the table, which is the same order that ParseStream uses.
+ */
+bool Component::FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) {
+	const ComponentField* fields = GetFields();
+	xmlNodePtr attr;
+	int i;
+
+	if( fields == NULL ) {
+		LogMsg(ERR, "The Component '%s' cannot be parsed from XML.", name.c_str() );
+		return false;
+	}
+
+	for( i = 0; fields[i].tag != NULL; ++i ) {
+		if( fields[i].flags & FIELD_NESTED ) {
+			for( attr = FirstChildNamed(node,fields[i].tag); attr != NULL; attr = NextSiblingNamed(attr,fields[i].tag) ) {
+				if( !ParseNestedField( fields[i].id, doc, attr ) ) {
+					return false;
+				}
+			}
+		}
+	}
+
+	for( i = 0; fields[i].tag != NULL; ++i ) {
+		attr = FirstChildNamed(node,fields[i].tag);
+		if( (attr == NULL) && (fields[i].flags & FIELD_REQUIRED) ) {
+			LogMsg(ERR,"'%s' does not have a %s.", name.c_str(), fields[i].tag );
+			return false;
+		}
+		if( fields[i].flags & FIELD_NESTED ) {
+			continue;
+		}
+		for( ; attr != NULL; attr = NextSiblingNamed(attr,fields[i].tag) ) {
+			if( !ParseField( fields[i].id, NodeToString(doc,attr) ) ) {
+				return false;
+			}
+		}
+	}
+
+	return FinishFields();
+}
+
 /**\brief Get the Names of all Components in this collection
  */
 list<string>* Components::GetNames() {
@@ -78,6 +158,7 @@ void Components::Add(Component* component) {
 	string name = component->GetName();
 	names.push_back( name );
 	components[name] = component;
+	dirty = true;
 }
 
 /**\brief Remove a Component from this collection
@@ -102,6 +183,7 @@ bool Components::Remove(Component* component) {
 	string name = component->GetName();
 	c = components.find(name);
 	components.erase(c);
+	dirty = true;
 
 	return true;
 }
@@ -111,6 +193,7 @@ bool Components::Remove(Component* component) {
 void Components::AddOrReplace(string oldname, Component* component) {
 	list<string>::iterator n;
 	string name = component->GetName();
+	dirty = true;
 	map<string,Component*>::iterator val = components.find( oldname );
 	if( val == components.end() ) { // new
 		LogMsg(INFO,"Creating new Component '%s'",component->GetName().c_str());
@@ -158,15 +241,21 @@ Component* Components::Get(string name) {
  */
 
 bool Components::ParseXMLNode( xmlDocPtr doc, xmlNodePtr node )
+{
+	return ParseXMLNode( doc, node, newComponent() );
+}
+
+/**\brief Parse an XML Node into a Component that was already created.
+ */
+bool Components::ParseXMLNode( xmlDocPtr doc, xmlNodePtr node, Component* component )
 {
 	xmlNodePtr  attr;
-	Component* component = newComponent();
 
 	// All Compoents must have names!
 	if( (attr = FirstChildNamed(node,"name")) ){
 		component->SetName(NodeToString(doc,attr));
 	} else {
-		LogMsg(ERR,"Failed to find a name attribute for the %s node at line %ld.\n", NodeToString(doc,attr).c_str(), xmlGetLineNo(node) );
+		LogMsg(ERR,"Failed to find a name attribute for the %s node at line %ld.\n", componentName.c_str(), xmlGetLineNo(node) );
 		return false;
 	}
 
@@ -177,59 +266,195 @@ bool Components::ParseXMLNode( xmlDocPtr doc, xmlNodePtr node )
 	return false;
 }
 
+/**\brief The text inside the current element of an XML reader.
+ */
+static string ReaderToString( xmlTextReaderPtr reader ) {
+	string value;
+	xmlChar *xmlString = xmlTextReaderReadString( reader );
+	if( xmlString ) {
+		value = (const char *)xmlString;
+	}
+	xmlFree( xmlString );
+	return value;
+}
+
+/**\brief Parse the Component element that an XML reader is on.
+ * \details The children of the element are read once.  Each child is found
+ *          in the Component's field table by comparing its interned name,
+ *          and its text is kept until the whole element has been read.  The
+ *          fields are then handed to the Component in the order of its table.
+ *
+ *          Components without a field table have just this element expanded
+ *          into a DOM and are parsed with FromXMLNode.
+ *
+ *          When this returns, the reader is on the last node of the element.
+ * \param index Maps interned tag names to positions in the field table.  It
+ *              is filled in by the first Component that is parsed.
+ */
+bool Components::ParseStream( xmlTextReaderPtr reader, map<const xmlChar*,int>& index )
+{
+	Component* component = newComponent();
+	const ComponentField* fields = component->GetFields();
+	int line = xmlTextReaderGetParserLineNumber( reader );
+
+	if( fields == NULL ) {
+		xmlNodePtr node = xmlTextReaderExpand( reader );
+		if( (node == NULL) || !ParseXMLNode( xmlTextReaderCurrentDoc( reader ), node, component ) ) {
+			delete component;
+			return false;
+		}
+		return true;
+	}
+
+	// Intern the field names so that tags can be compared by pointer
+	if( index.empty() ) {
+		for( int i = 0; fields[i].tag != NULL; ++i ) {
+			index[ xmlTextReaderConstString( reader, BAD_CAST fields[i].tag ) ] = i;
+		}
+	}
+	const xmlChar *nameTag = xmlTextReaderConstString( reader, BAD_CAST "name" );
+	vector< list<string> > values( index.size() );
+	vector<int> found( index.size(), 0 );
+	bool hasName = false;
+	bool success = true;
+
+	// Read every child element
+	int depth = xmlTextReaderDepth( reader );
+	int ret = xmlTextReaderIsEmptyElement( reader ) ? 0 : xmlTextReaderRead( reader );
+	while( (ret == 1) && (xmlTextReaderDepth( reader ) > depth) ) {
+		if( (xmlTextReaderNodeType( reader ) != XML_READER_TYPE_ELEMENT) || (xmlTextReaderDepth( reader ) != depth + 1) ) {
+			ret = xmlTextReaderRead( reader );
+			continue;
+		}
+
+		const xmlChar *tag = xmlTextReaderConstLocalName( reader );
+		map<const xmlChar*,int>::iterator field = index.find( tag );
+		if( tag == nameTag ) {
+			component->SetName( ReaderToString( reader ) );
+			hasName = true;
+		} else if( field != index.end() ) {
+			int i = field->second;
+			found[i]++;
+			if( fields[i].flags & FIELD_NESTED ) {
+				xmlNodePtr node = xmlTextReaderExpand( reader );
+				success = success && (node != NULL) && component->ParseNestedField( fields[i].id, xmlTextReaderCurrentDoc( reader ), node );
+			} else {
+				values[i].push_back( ReaderToString( reader ) );
+			}
+		}
+		ret = xmlTextReaderNext( reader );
+	}
+
+	// All Compoents must have names!
+	if( !hasName ) {
+		LogMsg(ERR,"Failed to find a name attribute for the %s node at line %d.", componentName.c_str(), line );
+		delete component;
+		return false;
+	}
+
+	// Parse the fields in the order of the table
+	for( int i = 0; success && (fields[i].tag != NULL); ++i ) {
+		if( (fields[i].flags & FIELD_REQUIRED) && (found[i] == 0) ) {
+			LogMsg(ERR,"The %s '%s' does not have a %s.", componentName.c_str(), component->GetName().c_str(), fields[i].tag );
+			success = false;
+		}
+		for( list<string>::iterator v = values[i].begin(); success && (v != values[i].end()); ++v ) {
+			success = component->ParseField( fields[i].id, *v );
+		}
+	}
+
+	if( success && component->FinishFields() ) {
+		Add( component );
+		return true;
+	}
+	delete component;
+	return false;
+}
+
 /**\brief Load an XML file
+ * \details The file is streamed with an XML reader rather than parsed into a
+ *          DOM, so only one Component is held in memory at a time.
  * \arg filename The XML file that should be parsed.
  * \arg optional  If this is true, an error is not returned if the file doesn't exist.
+ * \see ParseStream
  */
 bool Components::Load(string filename, bool fileoptional, bool skipcorrupt) {
-	xmlDocPtr doc;
-	xmlNodePtr cur, ver;
+	xmlTextReaderPtr reader;
+	map<const xmlChar*,int> index;
 	int versionMajor = 0, versionMinor = 0, versionMacro = 0;
 	int numObjs = 0;
+	int ret;
 	bool success = true;
 	
 	File xmlfile = File (filename);
 	long filelen = xmlfile.GetLength();
-	char *buffer = xmlfile.Read();
-	doc = xmlParseMemory( buffer, static_cast<int>(filelen) );
-	delete [] buffer;
+	const char *buffer = xmlfile.Map();
+	reader = (buffer == NULL) ? NULL : xmlReaderForMemory( buffer, static_cast<int>(filelen), filename.c_str(), NULL, XML_PARSE_NOENT | XML_PARSE_NOBLANKS );
 
 	// This path will be used when saving the file later.
 	this->filename = filename;
 
-	if( doc == NULL ) {
+	if( (buffer == NULL) || (reader == NULL) ) {
 		LogMsg(ERR, "Could not load '%s' for parsing.", filename.c_str() );
+		if( reader ) xmlFreeTextReader( reader );
 		return fileoptional;
 	}
 
 	LogMsg(INFO, "Loading '%s' for parsing.", filename.c_str() );
+
+	// Find the root element
+	while( ((ret = xmlTextReaderRead( reader )) == 1) && (xmlTextReaderNodeType( reader ) != XML_READER_TYPE_ELEMENT) );
 	
-	cur = xmlDocGetRootElement( doc );
-	
-	if( cur == NULL ) {
+	if( ret != 1 ) {
 		LogMsg(ERR, "'%s' file appears to be empty.", filename.c_str() );
-		xmlFreeDoc( doc );
-		return false;
+		xmlFreeTextReader( reader );
+		return (ret == 0) ? false : fileoptional;
 	}
 	
-	if( xmlStrcmp( cur->name, (const xmlChar *)rootName.c_str() ) ) {
-		LogMsg(ERR, "'%s' appears to be invalid. Root element was %s.", filename.c_str(), (char *)cur->name );
-		xmlFreeDoc( doc );
+	if( xmlStrcmp( xmlTextReaderConstName( reader ), (const xmlChar *)rootName.c_str() ) ) {
+		LogMsg(ERR, "'%s' appears to be invalid. Root element was %s.", filename.c_str(), (char *)xmlTextReaderConstName( reader ) );
+		xmlFreeTextReader( reader );
 		return false;
 	} else {
 		LogMsg(INFO, "'%s' file found and valid, parsing...", filename.c_str() );
 	}
-	
-	// Get the version number
-	if( (ver = FirstChildNamed(cur, "version-major")) != NULL ) {
-		versionMajor = NodeToInt(doc,ver);
-	}
-	if( (ver = FirstChildNamed(cur, "version-minor")) != NULL ) {
-		versionMinor = NodeToInt(doc,ver);
+
+	const xmlChar *componentTag = xmlTextReaderConstString( reader, BAD_CAST componentName.c_str() );
+	const xmlChar *majorTag = xmlTextReaderConstString( reader, BAD_CAST "version-major" );
+	const xmlChar *minorTag = xmlTextReaderConstString( reader, BAD_CAST "version-minor" );
+	const xmlChar *macroTag = xmlTextReaderConstString( reader, BAD_CAST "version-macro" );
+
+	// Get the version number and the components
+	ret = xmlTextReaderRead( reader );
+	while( (success || skipcorrupt) && (ret == 1) ) {
+		if( (xmlTextReaderNodeType( reader ) != XML_READER_TYPE_ELEMENT) || (xmlTextReaderDepth( reader ) != 1) ) {
+			ret = xmlTextReaderRead( reader );
+			continue;
+		}
+
+		const xmlChar *tag = xmlTextReaderConstLocalName( reader );
+		if( tag == componentTag ) {
+			// Parse a Component
+			success = ParseStream( reader, index );
+			assert(success || skipcorrupt);
+			if(success) numObjs++;
+		} else if( tag == majorTag ) {
+			versionMajor = atoi( ReaderToString( reader ).c_str() );
+		} else if( tag == minorTag ) {
+			versionMinor = atoi( ReaderToString( reader ).c_str() );
+		} else if( tag == macroTag ) {
+			versionMacro = atoi( ReaderToString( reader ).c_str() );
+		}
+		ret = xmlTextReaderNext( reader );
 	}
-	if( (ver = FirstChildNamed(cur, "version-macro")) != NULL ) {
-		versionMacro = NodeToInt(doc,ver);
+
+	xmlFreeTextReader( reader );
+
+	if( ret < 0 ) {
+		LogMsg(ERR, "'%s' could not be parsed after %d objects.", filename.c_str(), numObjs );
+		return false;
 	}
+
 	if( ( versionMajor != EPIAR_VERSION_MAJOR ) ||
 	    ( versionMinor != EPIAR_VERSION_MINOR ) ||
 	    ( versionMacro != EPIAR_VERSION_MICRO ) ) {
@@ -239,33 +464,27 @@ bool Components::Load(string filename, bool fileoptional, bool skipcorrupt) {
 			EPIAR_VERSION_MAJOR, EPIAR_VERSION_MINOR, EPIAR_VERSION_MICRO );
 	}
 	
-	// Get the components
-	cur = cur->xmlChildrenNode;
-	while( (success || skipcorrupt) && cur != NULL ) {
-		// Parse for the version information and any children nodes
-		if( ( !xmlStrcmp( cur->name, BAD_CAST componentName.c_str() ) ) ) {
-			// Parse a Component
-			success = ParseXMLNode( doc, cur );
-			assert(success || skipcorrupt);
-			if(success) numObjs++;
-		}
-		
-		cur = cur->next;
-	}
-	
-	xmlFreeDoc( doc );
-	
 	LogMsg(INFO, "Parsing of file '%s' done, found %d objects. File is version %d.%d.%d.", filename.c_str(), numObjs, versionMajor, versionMinor, versionMacro );
+	dirty = false;
 	return success;
 }
 
 /**\brief Save all Components to an XML file
+ * \details Nothing is written if no Component has changed since this file was
+ *          loaded or saved.  Otherwise the Components are copied into an XML
+ *          document and the SaveManager writes it in the background.
+ * \see SaveManager
  */
 bool Components::Save() {
 	char buff[10] = {0};
 	xmlDocPtr doc = NULL;       /* document pointer */
 	xmlNodePtr root_node = NULL, section = NULL;/* node pointers */
 
+	if( !dirty ) {
+		LogMsg(INFO, "Not saving component (%s), it has not changed.", rootName.c_str());
+		return true;
+	}
+
 	doc = xmlNewDoc(BAD_CAST "1.0");
 	root_node = xmlNewNode(NULL, BAD_CAST rootName.c_str() );
 	xmlDocSetRootElement(doc, root_node);
@@ -283,17 +502,58 @@ bool Components::Save() {
 	}
 
 	LogMsg(INFO, "Saving component (%s) to file '%s'", rootName.c_str(), filename.c_str());
-	xmlChar *xmlbuff;
-	int buffersize;
-	xmlDocDumpFormatMemory( doc, &xmlbuff, &buffersize, 1 );
-	File saved = File( filename.c_str(), true );
-	if(saved.Write( (char *)xmlbuff, buffersize ) != true) {
-		LogMsg(ERR, "Could not save component\n");
-	}
-	//xmlSaveFormatFileEnc( filename.c_str(), doc, "ISO-8859-1", 1);
-	xmlFree(xmlbuff);
-	xmlFreeDoc( doc );
+	SaveManager::SaveDocument( filename, doc );
+	dirty = false;
 
 	return true;
 }
 
+
+/**\brief Write all Components to a binary buffer
+ * \details The Components are written in the order that they were loaded so
+ *          that references between them resolve the same way when read back.
+ * \returns false if any Component cannot be serialized.
+ */
+bool Components::SaveBinary( BinaryWriter& out ) {
+	out.WriteUint( static_cast<Uint32>( names.size() ) );
+	for( list<string>::iterator n = names.begin(); n != names.end(); ++n ) {
+		Component* component = components[*n];
+		out.WriteString( *n );
+		if( component->Serialize( out ) != true ) {
+			LogMsg(INFO, "The %s '%s' cannot be written to a binary cache.", componentName.c_str(), n->c_str() );
+			return false;
+		}
+	}
+	return true;
+}
+
+/**\brief Read Components written by SaveBinary
+ * \details On failure the Components that were already read are left in
+ *          this collection; call Clear() before loading them again.
+ */
+bool Components::LoadBinary( BinaryReader& in ) {
+	Uint32 count = in.ReadUint();
+	for( Uint32 i = 0; (i < count) && !in.Failed(); ++i ) {
+		Component* component = newComponent();
+		component->SetName( in.ReadString() );
+		if( (component->Deserialize( in ) != true) || in.Failed() ) {
+			LogMsg(ERR, "Could not read the %s '%s' from a binary cache.", componentName.c_str(), component->GetName().c_str() );
+			delete component;
+			return false;
+		}
+		Add( component );
+	}
+	dirty = false;
+	return !in.Failed();
+}
+
+/**\brief Delete every Component in this collection
+ */
+void Components::Clear() {
+	for( map<string,Component*>::iterator i = components.begin(); i != components.end(); ++i ) {
+		delete i->second;
+	}
+	components.clear();
+	names.clear();
+	dirty = true;
+}
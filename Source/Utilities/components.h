@@ -1,7 +1,7 @@
 /**\file			components.cpp
  * \author			Matt Zweig
  * \date			Created: Friday, February 26, 2010
- * \date			Modified: Friday, February 26, 2010
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -11,14 +11,34 @@
 #include "includes.h"
 #include "common.h"
 #include "Utilities/xml.h"
+#include "Utilities/binary.h"
+
+// Flags for a ComponentField
+#define FIELD_REQUIRED 1 ///< The Component is rejected without this field.
+#define FIELD_NESTED   2 ///< The field has child elements instead of text.
+
+typedef struct {
+	const char* tag; ///< The name of the child element.
+	int id; ///< Passed back to the Component when this field is parsed.
+	int flags; ///< FIELD_REQUIRED and FIELD_NESTED
+} ComponentField;
 
 class Component {
 	public:
 		Component();
+		virtual ~Component() {}
 		string GetName() const { return name; }
 		void SetName(string _name) { name = _name; }
-		virtual bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node ) = 0;
+		virtual bool FromXMLNode( xmlDocPtr doc, xmlNodePtr node );
 		virtual xmlNodePtr ToXMLNode(string componentName) = 0;
+		virtual bool Serialize( BinaryWriter& out ) { return false; }
+		virtual bool Deserialize( BinaryReader& in ) { return false; }
+
+		// Streaming parser
+		virtual const ComponentField* GetFields( void ) { return NULL; }
+		virtual bool ParseField( int field, const string& value ) { return false; }
+		virtual bool ParseNestedField( int field, xmlDocPtr doc, xmlNodePtr node ) { return false; }
+		virtual bool FinishFields( void ) { return true; }
 	protected:
 		string name;
 	private:
@@ -37,21 +57,32 @@ class Components {
 		bool Load(string filename, bool fileoptional=false, bool skipcorrupt=false);
 		bool Save();
 
-		void SetFileName( const string& filename ) { this->filename = filename; }
+		bool SaveBinary( BinaryWriter& out );
+		bool LoadBinary( BinaryReader& in );
+		void Clear();
+
+		void SetFileName( const string& filename ) { if( filename != this->filename ) dirty = true; this->filename = filename; }
 		string GetFileName( ) { return filename; }
+
+		// Components changed in place should be marked so that they are saved
+		void SetDirty( void ) { dirty = true; }
+		bool IsDirty( void ) { return dirty; }
 	protected:
 
-		Components() {};  ///< Protected default constuctor
+		Components(): dirty(false) {};  ///< Protected default constuctor
 		Components( const Components & ); ///< Protected copy constuctor
 		Components& operator= (const Components&); ///< Protected copy constuctor
 
 		virtual Component* newComponent() = 0;
 		bool ParseXMLNode( xmlDocPtr doc, xmlNodePtr node );
+		bool ParseXMLNode( xmlDocPtr doc, xmlNodePtr node, Component* component );
+		bool ParseStream( xmlTextReaderPtr reader, map<const xmlChar*,int>& index );
 		string filename;
 		string rootName;
 		string componentName;
 		map<string,Component*> components;
 		list<string> names;
+		bool dirty; ///< Changed since it was loaded or saved.
 };
 
 #endif // __h_components__
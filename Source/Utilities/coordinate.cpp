@@ -1,7 +1,7 @@
 /**\file			coordinate.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -9,16 +9,20 @@
 #include "includes.h"
 #include "Engine/camera.h"
 #include "Utilities/coordinate.h"
+#include "Utilities/random.h"
 #include "Utilities/trig.h"
 
 /**\class Coordinate
- * \brief Coordinates. */
+ * \brief Coordinates.
+ * \details A pair of floats.  The whole universe fits within a few hundred
+ *          thousand pixels of the center, where a float is still accurate to
+ *          a few hundredths of a pixel. */
 
 Coordinate::Coordinate() {
 	m_x = m_y = 0;
 }
 
-Coordinate::Coordinate( double x, double y ) {
+Coordinate::Coordinate( float x, float y ) {
 	m_x = x;
 	m_y = y;
 }
@@ -27,19 +31,19 @@ Coordinate::~Coordinate () {
 
 }
 
-double  Coordinate::GetX () const {
+float  Coordinate::GetX () const {
 	return ( m_x );
 }
 
-void  Coordinate::SetX ( double x ) {
+void  Coordinate::SetX ( float x ) {
 	m_x = x;
 }
 
-double  Coordinate::GetY () const {
+float  Coordinate::GetY () const {
 	return ( m_y );
 }
 
-void  Coordinate::SetY ( double y ) {
+void  Coordinate::SetY ( float y ) {
 	m_y = y;
 }
 
@@ -83,13 +87,11 @@ int Coordinate::GetScreenY() {
 float Coordinate::GetAngle() {
 	// 0 is right, 90 is up
 	// Due to the way coordinates are displayed, use negative Y
-	Trig *trig = Trig::Instance();
-	return static_cast<float>(trig->RadToDeg( static_cast<float>(atan2( static_cast<float>(-m_y)
-					,static_cast<float>( m_x ))) ));
+	return static_cast<float>( Trig::RadToDeg( Trig::Atan2( -m_y, m_x ) ) );
 }
 
 float Coordinate::GetMagnitude() {
-	return static_cast<float>(sqrt( m_y*m_y + m_x*m_x ));
+	return Trig::Sqrt( m_y*m_y + m_x*m_x );
 }
 
 ostream& operator<<(ostream &out, const Coordinate &c) {
@@ -98,7 +100,7 @@ ostream& operator<<(ostream &out, const Coordinate &c) {
 }
 
 // Ensures coordinates are within boundaries, if set
-void Coordinate::EnforceBoundaries( double top, double right, double bottom, double left ) {
+void Coordinate::EnforceBoundaries( float top, float right, float bottom, float left ) {
 	if( top != 0. ) {
 		if( m_y > 0. ) {
 			if( m_y > top ) m_y = top;
@@ -121,7 +123,7 @@ void Coordinate::EnforceBoundaries( double top, double right, double bottom, dou
 	}	
 }
 
-bool Coordinate::ViolatesBoundary( double top, double right, double bottom, double left ) {
+bool Coordinate::ViolatesBoundary( float top, float right, float bottom, float left ) {
 	if( m_x < left ) return( true );
 	if( m_x > right ) return( true );
 	if( m_y < top ) return( true );
@@ -130,7 +132,7 @@ bool Coordinate::ViolatesBoundary( double top, double right, double bottom, doub
 	return( false );
 }
 
-void Coordinate::EnforceMagnitude(double radius) {
+void Coordinate::EnforceMagnitude(float radius) {
 	// While the magnitude exceeds maximum, reduce X and Y by the same factor.
 	// This allows the momentum angle to continue to absorb changes from the
 	// accel angle even at max velocity.
@@ -147,51 +149,39 @@ Coordinate Coordinate::RotateBy( float angle ) {
 }
 
 Coordinate Coordinate::RotateTo( float newangle ) {
-	Trig *trig = Trig::Instance();
-	int angle = TO_INT( newangle );
+	int angle = TO_INT( newangle ); // Whole degrees
 	float radius = GetMagnitude();
-	m_x = trig->GetCos( angle )*radius;
-	m_y = -trig->GetSin( angle )*radius;
+	float s, c;
+	Trig::SinCos( Trig::DegToRad( static_cast<float>( angle ) ), &s, &c );
+	m_x = c*radius;
+	m_y = -s*radius;
 	return *this;
 }
 
+/**\brief A number from 0 up to 1 from the simulation's random stream.
+ */
 float randf()
 {
-	return (float)rand()/(float)RAND_MAX;
+	return Random::Stream( RANDOM_SIMULATION ).Float();
 }
 
+/**\brief A number from the normal distribution from the simulation's random stream.
+ */
 float gaussian()
 {
-	// from http://www.taygeta.com/random/gaussian.html
-	// Algorithm by Dr. Everett (Skip) Carter, Jr.
-
-	float x1, x2, w, y1;
-	static float y2;
-	static int use_last = 0;
-
-	if (use_last)		        /* use value from previous call */
-	{
-		y1 = y2;
-		use_last = 0;
-	}
-	else
-	{
-		do {
-			x1 = 2.0 * randf() - 1.0;
-			x2 = 2.0 * randf() - 1.0;
-			w = x1 * x1 + x2 * x2;
-		} while ( w >= 1.0 );
-
-		w = sqrt( (-2.0 * log( w ) ) / w );
-		y1 = x1 * w;
-		y2 = x2 * w;
-		use_last = 1;
-	}
+	return Random::Stream( RANDOM_SIMULATION ).Gaussian();
+}
 
-	return y1;
+/**\brief A Coordinate whose x and y are each from the normal distribution.
+ */
+Coordinate GaussianCoordinate( Random& random )
+{
+	float xy[2];
+	random.Gaussians( xy, 2 );
+	return Coordinate( xy[0], xy[1] );
 }
 
 Coordinate GaussianCoordinate()
 {
-	return Coordinate( gaussian(), gaussian() );
+	return GaussianCoordinate( Random::Stream( RANDOM_SIMULATION ) );
 }
@@ -1,7 +1,7 @@
 /**\file			coordinate.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -15,20 +15,20 @@
 class Coordinate {
 	public:
 		Coordinate();
-		Coordinate( double x, double y );
+		Coordinate( float x, float y );
 	
-		bool ViolatesBoundary( double top, double right, double bottom, double left );
-	 	void EnforceBoundaries( double top, double right, double bottom, double left );
-		void EnforceMagnitude( double radius);
+		bool ViolatesBoundary( float top, float right, float bottom, float left );
+	 	void EnforceBoundaries( float top, float right, float bottom, float left );
+		void EnforceMagnitude( float radius);
 		Coordinate RotateBy( float angle );
 		Coordinate RotateTo( float angle );
 	
 		~Coordinate();
 	
-		double  GetX () const;
-		double  GetY () const;
-		void  SetX ( double x );
-		void  SetY ( double y );
+		float  GetX () const;
+		float  GetY () const;
+		void  SetX ( float x );
+		void  SetY ( float y );
 	
 		/* Returns coords converted to screen universe by Camera class */
 	 	int GetScreenX();
@@ -37,7 +37,7 @@ class Coordinate {
 		float GetAngle();
 		float GetMagnitude();
 		inline float GetMagnitudeSquared() {
-			return static_cast<float>(m_y*m_y + m_x*m_x );
+			return m_y*m_y + m_x*m_x;
 		}
 	
 		// Make an SDL Rectangle from coordinates
@@ -46,14 +46,14 @@ class Coordinate {
 		// Use given dimensions
 		SDL_Rect  getRectWithDim ( int w, int h );
 	
-		Coordinate operator=(double a) {
+		Coordinate operator=(float a) {
 			m_x = a;
 			m_y = a;
 	
 			return *this;
 		}// end operator=
 	
-		bool operator==(double a) {
+		bool operator==(float a) {
 			if( m_x == a )
 				if( m_y == a )
 					return( true );
@@ -97,18 +97,18 @@ class Coordinate {
 			return Coordinate(m_x+a.m_x,m_y+a.m_y);
 		}
 	
-		Coordinate operator*(double r){
+		Coordinate operator*(float r){
 			return Coordinate(m_x*r,m_y*r);
 		}
-		Coordinate operator*=(double r){
+		Coordinate operator*=(float r){
 			m_x*=r;
 			m_y*=r;
 			return *this;
 		}
-		Coordinate operator/(double r){
+		Coordinate operator/(float r){
 			return Coordinate(m_x/r,m_y/r);
 		}
-		Coordinate operator/=(double r){
+		Coordinate operator/=(float r){
 			m_x/=r;
 			m_y/=r;
 			return *this;
@@ -120,13 +120,16 @@ class Coordinate {
 	
 	private:
 	 
-		double  m_x;
-		double  m_y;
+		float  m_x;
+		float  m_y;
 };
 
+class Random;
+
 float randf();
 float gaussian();
 
 Coordinate GaussianCoordinate();
+Coordinate GaussianCoordinate( Random& random );
 
 #endif // __h_coordinates__
@@ -1,12 +1,13 @@
 /**\file			file.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Monday, April 21, 2008
- * \date			Modified: Saturday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Low level interface for file access.
  * \details
  * Use filesystem for higher level access.*/
 
 #include "includes.h"
+#include "Utilities/archive.h"
 #include "Utilities/file.h"
 #include "Utilities/log.h"
 
@@ -17,18 +18,22 @@
 
 /** \class File
  *  \brief Low level file access abstraction through PhysicsFS.
+ *  \details Files that are in a mounted Archive are read straight from the
+ *           Archive's memory instead.  Use Map() to get at their contents
+ *           without a copy.  A file in the PhysFS write directory, for example
+ *           an edited simulation, still takes precedence over the Archive.
  */
 
 /**Creates empty file instance.*/
 File::File( void ):
-	fp(NULL), contentSize(0),validName("")
+	fp(NULL), contentSize(0),validName(""), view(NULL), viewPos(0), buffer(NULL)
 {
 	
 }
 
 /**Creates file instance linked to filename. \sa Open.*/
 File::File( const string& filename, bool writable ):
-	fp(NULL), contentSize(0), validName("")
+	fp(NULL), contentSize(0), validName(""), view(NULL), viewPos(0), buffer(NULL)
 {
 	if( writable )
 		OpenWrite( filename );
@@ -40,13 +45,23 @@ File::File( const string& filename, bool writable ):
  * \param filename The filename path.
  * \return true if successful, false otherwise.*/
 bool File::OpenRead( const string& filename ) {
-	if ( fp != NULL )
+	if ( (fp != NULL) || (view != NULL) )
 		this->Close();
 
 	const char *cName;
 
 	cName = filename.c_str();
 
+	// Use the Archive unless the file has been saved over
+	if( Archive::Find( filename, &view, &contentSize ) ) {
+		if( !InWriteDir( filename ) ) {
+			viewPos = 0;
+			validName.assign( filename );
+			return true;
+		}
+		view = NULL;
+	}
+
 	// Check for file existence
 	if( !File::Exists(filename) ){
 		LogMsg(WARN,"Could not open file for reading. File does not exist.\n");
@@ -102,6 +117,30 @@ bool File::OpenWrite( const string& filename ) {
 	return true;
 }
 
+/**Opens a file for writing at its end
+ * \param filename The filename path
+ * \return true if successful, false otherwise.*/
+bool File::OpenAppend( const string& filename ) {
+	if ( fp != NULL )
+		this->Close();
+
+	const char *cName;
+	cName = filename.c_str();
+#ifdef USE_PHYSICSFS
+	this->fp = PHYSFS_openAppend( cName );
+#else
+	this->fp = fopen( cName, "ab");
+#endif
+	if( fp == NULL ){
+		LogMsg(ERR,"Could not open file (%s) for appending: %s\n",cName,
+				PHYSFS_getLastError());
+		return false;
+	}
+	validName.assign( filename );
+
+	return true;
+}
+
 /**Returns the valid path to the file
  * \return path successful, NULL otherwise.*/
 string File::GetRelativePath(){
@@ -111,8 +150,13 @@ string File::GetRelativePath(){
 /**Returns the full path to the file
  * \return path successful.*/
 string File::GetAbsolutePath(){
-	string abs = PHYSFS_getRealDir( validName.c_str() );
+	const char *dir = PHYSFS_getRealDir( validName.c_str() );
+	if( dir == NULL ) {
+		LogMsg(ERR,"%s is only available from an archive and has no path.", validName.c_str() );
+		return validName;
+	}
 
+	string abs = dir;
 	abs += PHYSFS_getDirSeparator() + validName;
 
 	return abs;
@@ -123,6 +167,16 @@ string File::GetAbsolutePath(){
  * \param buffer Buffer to read bytes into.
  * \return true if successful, false otherwise.*/
 bool File::Read( long numBytes, char *buffer ){
+	if ( view != NULL ) {
+		if( (numBytes < 0) || (numBytes > contentSize - viewPos) ) {
+			LogMsg(ERR,"%s: Unable to read specified number of bytes.", validName.c_str() );
+			return false;
+		}
+		memcpy( buffer, view + viewPos, numBytes );
+		viewPos += numBytes;
+		return true;
+	}
+
 	if ( fp == NULL )
 		return false;
 
@@ -146,6 +200,12 @@ bool File::Read( long numBytes, char *buffer ){
  * for you, but you must explicitly free it by using "delete [] buffer"
  * \return Pointer to buffer, NULL otherwise.*/
 char *File::Read( void ){
+	if ( view != NULL ) {
+		char *fBuffer = new char[static_cast<Uint32>(contentSize)];
+		memcpy( fBuffer, view, contentSize );
+		return fBuffer;
+	}
+
 	if ( fp == NULL )
 		return NULL;
 
@@ -169,6 +229,18 @@ char *File::Read( void ){
 	}
 }
 
+/**Gets the whole file without copying it if possible.
+ * The contents belong to this File and are only valid until it is closed.
+ * \return Pointer to the contents, NULL otherwise.*/
+const char *File::Map( void ){
+	if ( view != NULL )
+		return view;
+
+	if ( buffer == NULL )
+		buffer = Read();
+	return buffer;
+}
+
 /**Writes buffer to file.
  * \param buffer The buffer to write
  * \param bufsize The size of the buffer in bytes
@@ -196,6 +268,9 @@ bool File::Write( char *buffer, const long bufsize ){
  * \return Offset in bytes from the beginning of the file.*/
 long File::Tell( void ){
 	long offset;
+	if ( view != NULL )
+		return viewPos;
+
 	offset = static_cast<long>(
 #ifdef USE_PHYSICSFS
 		PHYSFS_tell( fp )
@@ -215,6 +290,12 @@ long File::Tell( void ){
  * \return true if successful, false otherwise.*/
 bool File::Seek( long pos ){
 	int retval;
+	if ( view != NULL ) {
+		if( (pos < 0) || (pos > contentSize) )
+			return false;
+		viewPos = pos;
+		return true;
+	}
 	if ( fp == NULL )
 		return false;
 #ifdef USE_PHYSICSFS
@@ -262,9 +343,18 @@ File::~File() {
 /**Closes the file handle and frees associated buffer.
  * \return true if successful, false otherwise*/
 bool File::Close() {
+	delete [] buffer;
+	buffer = NULL;
+
 	if ( validName.compare( "" ) == 0 )
 		return NULL;
 
+	if ( view != NULL ) {
+		view = NULL;
+		contentSize = 0;
+		return true;
+	}
+
 	if ( fp == NULL )
 		return false;
 
@@ -280,6 +370,7 @@ bool File::Close() {
 			validName.c_str(), PHYSFS_getLastError());
 		return false;
 	}
+	fp = NULL;
 	contentSize = 0;
 
 	LogMsg(INFO, "File '%s' saved successfully.", validName.c_str());
@@ -290,6 +381,11 @@ bool File::Close() {
 bool File::Exists( const string& filename ) {
 	const char *cName;
 	cName = filename.c_str();
+	const char *data;
+	long size;
+	if( Archive::Find( filename, &data, &size ) ) {
+		return true;
+	}
 #ifdef USE_PHYSICSFS
 	if ( !PHYSFS_exists( cName ) ){
 		LogMsg(ERR,"%s: %s.", LastErrorMessage().c_str(), cName);
@@ -306,6 +402,21 @@ bool File::Exists( const string& filename ) {
 	return true;
 }
 
+/**Checks whether a file has been written to the write directory.
+ * \return true if it has, so it should be used rather than an Archive.*/
+bool File::InWriteDir( const string& filename ) {
+#ifdef USE_PHYSICSFS
+	const char *writeDir = PHYSFS_getWriteDir();
+	if( writeDir == NULL )
+		return false;
+	string path = string(writeDir) + PHYSFS_getDirSeparator() + filename;
+#else
+	string path = filename;
+#endif
+	struct stat fileStatus;
+	return stat( path.c_str(), &fileStatus ) == 0;
+}
+
 bool File::IsDir( const string& filename ) {
 	// TODO: determine if the filename is a directory
 	// This can be used for walking a directory tree
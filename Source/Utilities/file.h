@@ -1,7 +1,7 @@
 /**\file			file.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Monday, April 21, 2008
- * \date			Modified: Saturday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Low level interface for file access.
  * \details
  * Use filesystem for higher level access.*/
@@ -13,9 +13,8 @@
 
 #ifdef USE_PHYSICSFS
 #include <physfs.h>
-#else
-#include <sys/stat.h>
 #endif
+#include <sys/stat.h>
 
 class File {
 	public:
@@ -28,13 +27,16 @@ class File {
 
 		bool OpenRead( const string& filename );
 		bool OpenWrite( const string& filename );
+		bool OpenAppend( const string& filename );
 		char *Read( void );
+		const char *Map( void );
 		bool Write( char *buffer, const long bufsize );
 		long Tell( void );
 		bool Seek( long pos );
 		int SetBuffer( int bufSize );
 
 		static bool Exists( const string& filename );
+		static bool InWriteDir( const string& filename );
 		static bool IsDir( const string& filename );
 
 		string GetRelativePath();
@@ -50,6 +52,9 @@ class File {
 
 		long contentSize;		/** Number of bytes in the file. */
 		string validName;		/** Name of the file referenced (exists).*/
+		const char *view;		/** The contents, when the file is in an Archive.*/
+		long viewPos;			/** The read position within the view.*/
+		char *buffer;			/** The contents read by Map() when there is no view.*/
 };
 
 bool IsBigEndian();
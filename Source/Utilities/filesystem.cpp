@@ -1,13 +1,14 @@
 /**\file			filesystem.cpp
  * \author			Maoserr
  * \date			Created: Wednesday, November 18, 2009
- * \date			Modified: Wednesday, November 18, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Provides an abstraction to the file system
  * \details
  */
 
 #include "includes.h"
 
+#include "Utilities/archive.h"
 #include "Utilities/filesystem.h"
 #include "Utilities/log.h"
 
@@ -72,6 +73,18 @@ int Filesystem::PrependPath( const string& archivename ) {
 	return retval;
 }
 
+/**Maps a packed resource Archive so that it is searched before loose files
+ * \param filename The PhysFS path to the archive, for example "Resources.epk"
+ * \return True on success
+ * \sa Archive */
+bool Filesystem::MountArchive( const string &filename ) {
+	const char* dir = PHYSFS_getRealDir( filename.c_str() );
+	if( dir == NULL ) {
+		return false;
+	}
+	return Archive::Mount( string(dir) + PHYSFS_getDirSeparator() + filename );
+}
+
 /**Deletes a file from the filesystem
  * \param filename Filename relative to PHYSFS writedir to delete
  * \return True on success */
@@ -86,6 +99,40 @@ bool Filesystem::DeleteFile( const string &filename ) {
 	return true;
 }
 
+/**Renames a file, replacing any file that already has the new name
+ * \details PhysFS cannot rename files, so this works on the real paths under
+ *          the write directory.  The existing file is replaced atomically,
+ *          so it is never missing, even if Epiar crashes during the rename.
+ * \param from Filename relative to PHYSFS writedir to rename
+ * \param to The new filename relative to PHYSFS writedir
+ * \return True on success */
+bool Filesystem::Rename( const string &from, const string &to ) {
+	const char* writeDir = PHYSFS_getWriteDir();
+	if( writeDir == NULL ) {
+		LogMsg(ERR, "Could not rename file (%s): There is no write directory.", from.c_str() );
+		return false;
+	}
+
+	string separator = PHYSFS_getDirSeparator();
+	string realFrom = string(writeDir) + separator + from;
+	string realTo = string(writeDir) + separator + to;
+
+#ifdef _WIN32
+	// rename() will not replace an existing file on Windows.
+	if( !MoveFileExA( realFrom.c_str(), realTo.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) ) {
+		LogMsg(ERR, "Could not rename file (%s) to (%s): Error %lu", from.c_str(), to.c_str(), (unsigned long)GetLastError() );
+		return false;
+	}
+#else
+	if( rename( realFrom.c_str(), realTo.c_str() ) != 0 ) {
+		LogMsg(ERR, "Could not rename file (%s) to (%s): %s", from.c_str(), to.c_str(), strerror(errno) );
+		return false;
+	}
+#endif
+
+	return true;
+}
+
 /**Ensures no characters are in 'filename' that might cause issues
  * \param filename The filename/string to check
  * \return True if no dangerous characters are found, false if otherwise */
@@ -153,6 +200,16 @@ list<string> Filesystem::Enumerate( const string& path, const string &suffix )
 		PHYSFS_freeList(rc);
 		//return 1;
 	}
+
+	// Add the files that are only in an Archive
+	if( Archive::IsMounted() ) {
+		list<string> packed = Archive::Enumerate( path, suffix );
+		for( list<string>::iterator f = packed.begin(); f != packed.end(); ++f ) {
+			if( find( files.begin(), files.end(), *f ) == files.end() ) {
+				files.push_back( *f );
+			}
+		}
+	}
 	return files;
 }
 
@@ -189,6 +246,8 @@ void Filesystem::OutputArchivers( void ){
 int Filesystem::Close() {
 	int retval;
 
+	Archive::UnmountAll();
+
 	if ( (retval = PHYSFS_deinit()) == 0 )
 		LogMsg(ERR,"Error de-initializing PhysicsFS.\n%s",PHYSFS_getLastError());
 
@@ -271,6 +330,22 @@ list<string> Filesystem::Enumerate( const string& path, const string &suffix )
 	return files;
 }
 
+/**Maps a packed resource Archive so that it is searched before loose files
+ * \return True on success */
+bool Filesystem::MountArchive( const string &filename ) {
+	return Archive::Mount( filename );
+}
+
+/**Renames a file, replacing any file that already has the new name
+ * \return True on success */
+bool Filesystem::Rename( const string &from, const string &to ) {
+	if( rename( from.c_str(), to.c_str() ) != 0 ) {
+		remove( to.c_str() );
+		return rename( from.c_str(), to.c_str() ) == 0;
+	}
+	return true;
+}
+
 /**Prints the current version of PhysFS.*/
 void Filesystem::Version( void ){
 }
@@ -1,7 +1,7 @@
 /**\file			filesystem.h
  * \author			Maoserr
  * \date			Created: Wednesday, November 18, 2009
- * \date			Modified: Wednesday, November 18, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Provides an abstraction to the file system
  * \details
  */
@@ -24,11 +24,13 @@ class Filesystem {
 		static int Init( const char* argv0 );
 		static int AppendPath( const string &archivename );
 		static int PrependPath( const string &archivename );
+		static bool MountArchive( const string &filename );
 		static list<string> Enumerate( const string &path, const string &suffix="");
 		static void Version( void );
 		static void OutputArchivers( void );
 		static int Close( void );
 		static bool DeleteFile( const string &filename );
+		static bool Rename( const string &from, const string &to );
 		static bool FilenameIsSafe( const string &filename );
 	private:
 		static list<string> paths;
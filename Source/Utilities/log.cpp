@@ -1,7 +1,7 @@
 /**\file			log.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Sunday, June 4, 2006
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Main logging facilities for the codebase
  * \details
  */
@@ -11,11 +11,96 @@
 #include "Utilities/log.h"
 #include "Engine/hud.h"
 
+static Option<int> logOut( "options/log/out" );
+static Option<int> logAlert( "options/log/alert" );
+static Option<int> logXML( "options/log/xml" );
+static Option<int> logJSON( "options/log/json" );
+
+LogLevel Log::loglvl = ALL;
+
+#ifdef _WIN32
+static inline Uint32 LogCompareAndSwap( volatile Uint32 *value, Uint32 expected, Uint32 desired ) {
+	return (Uint32)InterlockedCompareExchange( (volatile LONG*)value, (LONG)desired, (LONG)expected );
+}
+static inline void LogIncrement( volatile Uint32 *value ) { InterlockedIncrement( (volatile LONG*)value ); }
+static inline void LogBarrier( void ) { MemoryBarrier(); }
+#else
+static inline Uint32 LogCompareAndSwap( volatile Uint32 *value, Uint32 expected, Uint32 desired ) {
+	return __sync_val_compare_and_swap( value, expected, desired );
+}
+static inline void LogIncrement( volatile Uint32 *value ) { __sync_fetch_and_add( value, 1 ); }
+static inline void LogBarrier( void ) { __sync_synchronize(); }
+#endif
+
+/**\brief Formats a time the same way as ctime(), but without a newline.*/
+static void FormatTime( time_t rawtime, char *buffer, size_t size ) {
+#ifdef _WIN32
+	struct tm *local = localtime( &rawtime ); // Thread local on Windows
+#else
+	struct tm localStorage;
+	struct tm *local = localtime_r( &rawtime, &localStorage );
+#endif
+	strftime( buffer, size, "%a %b %d %H:%M:%S %Y", local );
+}
+
+/**\brief Escapes text so that it can be placed inside an XML element.*/
+static string EscapeXML( const char *text ) {
+	string escaped;
+	for( ; *text; ++text ) {
+		switch( *text ) {
+			case '&': escaped += "&amp;"; break;
+			case '<': escaped += "&lt;"; break;
+			case '>': escaped += "&gt;"; break;
+			default: escaped += *text;
+		}
+	}
+	return escaped;
+}
+
+/**\brief Quotes and escapes text as a JSON string.*/
+static string EscapeJSON( const char *text ) {
+	string escaped = "\"";
+	for( ; *text; ++text ) {
+		unsigned char c = static_cast<unsigned char>( *text );
+		if( c == '"' || c == '\\' ) {
+			escaped += '\\';
+			escaped += *text;
+		} else if( c == '\n' ) {
+			escaped += "\\n";
+		} else if( c < 0x20 ) {
+			char code[8];
+			snprintf( code, sizeof(code), "\\u%04x", c );
+			escaped += code;
+		} else {
+			escaped += *text;
+		}
+	}
+	escaped += '"';
+	return escaped;
+}
+
 /**\class Log
- * \brief Main logging facilities for the code base. */
+ * \brief Main logging facilities for the code base.
+ * \details Messages are handed to a background writer through a fixed size
+ *          ring buffer, so logging never waits on the disk or the console.
+ *          Messages can be written to the console, to an XML file and to a
+ *          JSON lines file (one JSON object per message) at the same time.
+ *
+ *          The level is checked by the LogMsg macro before the arguments are
+ *          evaluated.  Messages above LOG_MAX_LEVEL are removed at compile
+ *          time, and messages above the level set with SetLevel() cost one
+ *          comparison.
+ */
 
-/**\brief Empty destructor.*/
+/**\brief Destructor.
+ * \details The program may end with exit() instead of returning from main(),
+ *          so the writer is stopped and the last messages are written here
+ *          before the ring is freed.
+ */
 Log::~Log(){
+	Close();
+	SDL_DestroyMutex( lock );
+	delete [] ring;
 }
 
 /**\brief Retrieves the current instance of the log class.*/
@@ -27,19 +112,20 @@ Log& Log::Instance( void ){
 /**\brief Allows changing of the log level dynamically (string version).*/
 bool Log::SetLevel( const string& _loglvl ){
 	// Check logging level
-	this->loglvl=this->ReverseLookUp( _loglvl );
-	if( this->loglvl == INVALID ){
+	LogLevel lvl = this->ReverseLookUp( _loglvl );
+	if( lvl == INVALID ){
 		LogMsg(DEBUG1,"Invalid logging level specified, reverting to default log level.");
-		this->loglvl=this->loglvldefault;
+		loglvl = this->loglvldefault;
 		return false;
 	}
+	loglvl = lvl;
 	return true;
 }
 
 /**\brief Allows changing of the log level dynamically ( enum version ).*/
 bool Log::SetLevel( LogLevel _loglvl ){
 	LogMsg(DEBUG1,"Changing Log Level from '%s' to '%s'.", lvlStrings[loglvl].c_str(), lvlStrings[_loglvl].c_str());
-	this->loglvl=_loglvl;
+	loglvl = _loglvl;
 	return true;
 }
 
@@ -74,98 +160,244 @@ void Log::Open() {
 		// Write the xml header
 		fprintf(fp, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n"	);
 		fprintf(fp, "<?xml-stylesheet type=\"text/xsl\" href=\"epiar.xsl\"?>\n" );
+		char timestamp[32];
+		FormatTime( time( NULL ), timestamp, sizeof(timestamp) );
 		fprintf(fp, "<debugSession time=\"%s\">\n", timestamp );
 	}	
 }
 
-/**\brief Frees the handle to the log file.*/
+/**\brief Opens the JSON lines log file.*/
+void Log::OpenJSON() {
+	string jsonFilename = logFilename.substr( 0, logFilename.size() - 4 ) + ".jsonl";
+	jsonfp = fopen( jsonFilename.c_str(), "wb" );
+	if( !jsonfp ) {
+		fprintf( stderr, "Could not open \"%s\" for debugging!", jsonFilename.c_str() );
+	}
+}
+
+/**\brief Blocks until every message logged so far has been written.*/
+void Log::Flush( void ) {
+	Uint32 target = enqueuePos;
+
+	if( running && configured ) {
+		// Give the writer a moment, but never wait forever on a stuck writer.
+		for( int i = 0; (i < 1000) && ((Sint32)(dequeuePos - target) < 0); ++i ) {
+			SDL_Delay( 1 );
+		}
+	} else {
+		SDL_LockMutex( lock );
+		Drain();
+		SDL_UnlockMutex( lock );
+	}
+}
+
+/**\brief Frees the handle to the log file.
+ * \details This is safe to call more than once.
+ */
 void Log::Close( void ) {
+	// Stop the writer and write what is left on this thread
+	if( writer ) {
+		running = false;
+		SDL_WaitThread( writer, NULL );
+		writer = NULL;
+	}
+	configured = true;
+	SDL_LockMutex( lock );
+	Drain();
+	SDL_UnlockMutex( lock );
+
 	if( fp ) {
 		fprintf(fp, "</debugSession>\n");
 		fclose( fp );
 	}
 	fp = NULL;
+	if( jsonfp ) {
+		fclose( jsonfp );
+	}
+	jsonfp = NULL;
 }
 
 /**\brief The real log function.
- * \todo The filtering is broken and should be refactored.
+ * \details This runs on the thread that logged the message, so it does as
+ *          little as possible: it formats the message into a free slot of
+ *          the ring buffer and returns.  Claiming a slot is lock free, so
+ *          threads never wait on each other or on the disk.
+ *
+ *          Everything else (timestamps, filtering, building the XML and JSON
+ *          and writing them) is done in batches by the writer thread.  The
+ *          message itself has to be formatted here because its arguments
+ *          may not outlive this call.
+ *
+ *          If the ring is full this waits for the writer to make room.  The
+ *          message is only dropped (and counted) if the writer is not making
+ *          progress.
  */
-void Log::realLog( LogLevel lvl, const string& func, const char *message, ... ) {
-	// Check log level
-	if( lvl < this->loglvl )
-		return;
+void Log::realLog( LogLevel lvl, const char *func, const char *message, ... ) {
+	va_list args;
+	LogEntry *entry;
+	Uint32 pos = enqueuePos;
+	int waited = 0;
+
+	// Claim a slot
+	while( true ) {
+		entry = &ring[ pos & (LOG_RING_SIZE - 1) ];
+		Sint32 diff = (Sint32)(entry->sequence - pos);
+		if( diff == 0 ) {
+			if( LogCompareAndSwap( &enqueuePos, pos, pos + 1 ) == pos ) {
+				break;
+			}
+		} else if( diff < 0 ) {
+			// The ring is full, so wait for the writer to catch up.
+			if( !running || !configured || (waited >= 1000) ) {
+				LogIncrement( &dropped );
+				return;
+			}
+			SDL_Delay( 1 );
+			++waited;
+		}
+		pos = enqueuePos;
+	}
 
-	// Check function filter
-	if( !this->funfilter.empty() ){
-		if( !func.find(this->funfilter) )
-			return;
+	entry->lvl = lvl;
+	entry->func = func;
+	entry->thread = SDL_ThreadID();
+	entry->time = time( NULL );
+	entry->ticks = SDL_GetTicks();
+
+	va_start( args, message );
+	vsnprintf( entry->message, sizeof(entry->message), message, args );
+	va_end( args );
+	entry->message[ sizeof(entry->message) - 1 ] = 0;
+
+	// Trim the final '\n' if necessary
+	size_t length = strlen( entry->message );
+	if( (length > 0) && (entry->message[ length - 1 ] == '\n') ) entry->message[ length - 1 ] = 0;
+
+	if( entry->thread == mainThread ) {
+		// The Options may only be read on the main thread.
+		if( Options::IsLoaded() ) {
+			toStdout = (logOut == 1);
+			toXML = (logXML == 1);
+			toJSON = (logJSON == 1);
+			configured = true;
+
+			if( logAlert == 1 ) {
+				Hud::Alert("%s - %s", lvlStrings[lvl].c_str(), entry->message );
+			}
+		}
 	}
 
-	// Check message filter
-	if( !this->filter.empty() ){
-		//if( !message.find( this->filter  ) )
-		//	return;
+	// Publish the message to the writer
+	LogBarrier();
+	entry->sequence = pos + 1;
+
+	// Make sure that the last words of a dying program are written
+	if( (lvl <= ERR) || !running ) {
+		Flush();
 	}
+}
 
-	va_list args;
-	time_t rawtime;
-	static char logBuffer[4096] = {0};
-	static queue<LogEntry> preOptionsBuffer;
+/**\brief The loop run by the writer thread.*/
+int Log::Writer( void *data ) {
+	Log* log = static_cast<Log*>( data );
+	while( log->running ) {
+		SDL_LockMutex( log->lock );
+		int written = log->Drain();
+		SDL_UnlockMutex( log->lock );
+		if( written == 0 ) {
+			SDL_Delay( LOG_WRITE_INTERVAL );
+		}
+	}
+	return 0;
+}
 
-	time( &rawtime );
+/**\brief Writes every message that is ready and flushes the sinks once.
+ * \details Messages logged before the Options are loaded are held back until
+ *          the Log knows where to write them.
+ * \returns The number of messages written.
+ */
+int Log::Drain( void ) {
+	int written = 0;
 
-	timestamp = ctime( &rawtime );
-	timestamp[ strlen(timestamp) - 1 ] = 0;
+	if( !configured ) {
+		return 0;
+	}
 
-	va_start( args, message );
-	vsnprintf( logBuffer, sizeof(logBuffer), message, args );
-	va_end( args );
+	while( true ) {
+		LogEntry *entry = &ring[ dequeuePos & (LOG_RING_SIZE - 1) ];
+		if( entry->sequence != dequeuePos + 1 ) {
+			break;
+		}
+		LogBarrier();
+		Write( entry );
+		entry->sequence = dequeuePos + LOG_RING_SIZE;
+		++dequeuePos;
+		++written;
+	}
 
-	// Trim the final '\n' if necessary
-	if( logBuffer[ strlen(logBuffer) - 1 ] == '\n' ) logBuffer[ strlen(logBuffer) - 1 ] = 0;
+	if( dropped != droppedReported ) {
+		Uint32 count = dropped;
+		fprintf( stderr, "%u log messages were dropped because the log could not keep up.\n", count - droppedReported );
+		droppedReported = count;
+	}
 
-	// Print the message
-	if( Options::IsLoaded() ) {
-		// We loop over a buffer as messages may be queued up from before Options::IsLoaded() == true
-		preOptionsBuffer.push( LogEntry(func, lvl, logBuffer) );
+	if( written > 0 ) {
+		if( toStdout ) fflush( stdout );
+		if( fp ) fflush( fp );
+		if( jsonfp ) fflush( jsonfp );
+	}
+	return written;
+}
 
-		while(!preOptionsBuffer.empty()) {
-			LogEntry entry = preOptionsBuffer.front();
-			preOptionsBuffer.pop();
+/**\brief Writes a single message to each sink.*/
+void Log::Write( LogEntry* entry ) {
+	// Check function filter
+	if( !funfilter.empty() && (strstr( entry->func, funfilter.c_str() ) == NULL) ) {
+		return;
+	}
+
+	// Check message filter
+	if( !filter.empty() && (strstr( entry->message, filter.c_str() ) == NULL) ) {
+		return;
+	}
 
-			if( OPTION(int, "options/log/out") == 1 ) {
+	if( toStdout ) {
 #ifndef _WIN32
-				StartTermColor( entry.lvl );
+		StartTermColor( entry->lvl );
 #endif
-				cout << entry.func << " (" << lvlStrings[entry.lvl] << ") - " << entry.message << endl;
+		printf( "%s (%s) - %s\n", entry->func, lvlStrings[entry->lvl].c_str(), entry->message );
 #ifndef _WIN32
-				EndTermColor( entry.lvl );
+		EndTermColor( entry->lvl );
 #endif
-			}
-	
-			if( OPTION(int, "options/log/alert") == 1 ) {
-				Hud::Alert("%s - %s", lvlStrings[entry.lvl].c_str(), entry.message.c_str());
-			}
-			
-			// Save the message to a file
-			if( OPTION(int, "options/log/xml") == 1 ) {
-	
-				if( fp==NULL ){
-					Log::Open();
-				}
-	
-				fprintf(fp, "<log>\n");
-				fprintf(fp, "\t<function>%s</function>\n", entry.func.c_str() );
-				fprintf(fp, "\t<type>%s</type>\n", lvlStrings[entry.lvl].c_str() );
-				fprintf(fp, "\t<time>%s</time>\n", timestamp );
-				fprintf(fp, "\t<message>%s</message>\n", entry.message.c_str() );
-				fprintf(fp, "</log>\n" );
-				fflush( fp );
-			}
+	}
+
+	// Save the message to a file
+	if( toXML ) {
+		if( fp == NULL ){
+			Log::Open();
+		}
+		if( fp ) {
+			char timestamp[32];
+			FormatTime( entry->time, timestamp, sizeof(timestamp) );
+			fprintf(fp, "<log>\n");
+			fprintf(fp, "\t<function>%s</function>\n", EscapeXML( entry->func ).c_str() );
+			fprintf(fp, "\t<type>%s</type>\n", lvlStrings[entry->lvl].c_str() );
+			fprintf(fp, "\t<time>%s</time>\n", timestamp );
+			fprintf(fp, "\t<message>%s</message>\n", EscapeXML( entry->message ).c_str() );
+			fprintf(fp, "</log>\n" );
+		}
+	}
+
+	// One JSON object per line
+	if( toJSON ) {
+		if( jsonfp == NULL ){
+			Log::OpenJSON();
+		}
+		if( jsonfp ) {
+			fprintf(jsonfp, "{\"time\":%ld,\"ticks\":%u,\"level\":\"%s\",\"thread\":%u,\"function\":%s,\"message\":%s}\n",
+				(long)entry->time, entry->ticks, lvlStrings[entry->lvl].c_str(), entry->thread,
+				EscapeJSON( entry->func ).c_str(), EscapeJSON( entry->message ).c_str() );
 		}
-	} else {
-		// Messages before the options are available
-		preOptionsBuffer.push( LogEntry(func, lvl, logBuffer) );
 	}
 }
 
@@ -231,6 +463,32 @@ Log::Log()
 	//printf("Logging to: '%s'\n",logFilename.c_str());
 
 	fp = NULL;
+	jsonfp = NULL;
+
+	// Every slot starts out ready for the first lap of the ring
+	ring = new LogEntry[LOG_RING_SIZE];
+	for( Uint32 i = 0; i < LOG_RING_SIZE; ++i ) {
+		ring[i].sequence = i;
+	}
+	enqueuePos = 0;
+	dequeuePos = 0;
+	dropped = 0;
+	droppedReported = 0;
+
+	configured = false;
+	toStdout = false;
+	toXML = false;
+	toJSON = false;
+
+	lock = SDL_CreateMutex();
+	mainThread = SDL_ThreadID();
+
+	running = true;
+	writer = SDL_CreateThread( Log::Writer, this );
+	if( writer == NULL ) {
+		// Messages will be written by Flush() and Close() instead.
+		running = false;
+	}
 }
 
 string Log::GetTimestamp( void ) {
@@ -1,7 +1,7 @@
 /**\file			log.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Sunday, June 4, 2006
- * \date			Modified: Sunday, November 22, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Main logging facilities for the codebase
  * \details
  */
@@ -24,14 +24,26 @@
 // compile out Logging facilities if needed for performance
 //#define DISABLE_LOGGING // Do not log anything
 //#define DISABLE_LOGGER // Print logs to stdout
+//#define LOG_MAX_LEVEL INFO // Compile out messages more verbose than this
+#ifndef LOG_MAX_LEVEL
+	#define LOG_MAX_LEVEL ALL
+#endif
 #if defined( DISABLE_LOGGING )
 	#define LogMsg(LVL,...)
 #elif defined( DISABLE_LOGGER )
 	#define LogMsg(LVL,...) printf( __VA_ARGS__ )
 #else
-	#define LogMsg(LVL,...) Log::Instance().realLog(LVL,__PRETTY_FUNCTION__,__VA_ARGS__)
+	// The level is checked before any arguments are evaluated
+	#define LogMsg(LVL,...) do { \
+		if( ((LVL) <= LOG_MAX_LEVEL) && Log::IsLogged(LVL) ) \
+			Log::Instance().realLog(LVL,__PRETTY_FUNCTION__,__VA_ARGS__); \
+	} while(0)
 #endif//ENABLE_LOGGING
 
+#define LOG_RING_SIZE 1024		// Messages waiting to be written, must be a power of two
+#define LOG_MESSAGE_SIZE 1024	// Longer messages are cut off
+#define LOG_WRITE_INTERVAL 25	// Milliseconds between batches of writes
+
 typedef enum {
 	INVALID = 0,		/**< Invalid log level, used for internal purposes.*/
 	NONE,			/**< No logging. */
@@ -53,6 +65,19 @@ typedef enum {
 	ALL             /**< This is always the highest Logging level.*/
 } LogLevel;
 
+/**\brief A single message waiting in the Log's ring buffer.
+ */
+class LogEntry {
+	public:
+		volatile Uint32 sequence; ///< Which lap of the ring this slot is ready for.
+		LogLevel lvl;
+		const char *func; ///< Always a string literal, so it can be kept.
+		Uint32 thread;
+		time_t time;
+		Uint32 ticks;
+		char message[LOG_MESSAGE_SIZE];
+};
+
 class Log {
 	public:
 		~Log();
@@ -63,20 +88,28 @@ class Log {
 		bool SetLevel( LogLevel _loglvl );
 		void SetFunFilter( const string& _funfilter );
 		void SetMsgFilter( const string& msgfilter );
+		void Flush( void );
 		void Close( void );
 		static string GetTimestamp( void );
 
-		void realLog( LogLevel lvl, const string& func, const char *message, ... );
+		static bool IsLogged( LogLevel lvl ) { return lvl <= loglvl; }
+
+		void realLog( LogLevel lvl, const char *func, const char *message, ... );
 
 	private:
 		Log();
 		Log(Log const&);
 		Log& operator=(Log const&);
 		void Open( void );
+		void OpenJSON( void );
 		LogLevel ReverseLookUp( const string& _lvl );
 
+		static int Writer( void *data );
+		int Drain( void );
+		void Write( LogEntry* entry );
+
 		map<LogLevel,string> lvlStrings;
-		LogLevel loglvl;
+		static LogLevel loglvl;
 		LogLevel loglvldefault;
 
 #ifndef _WIN32
@@ -92,21 +125,26 @@ class Log {
 		string filter;				/**< Message filter.*/
 		string funfilter;			/**< Function filter.*/
 
-		char *timestamp;
 		string logFilename;
 		FILE *fp; // pointer to the log
-};
+		FILE *jsonfp; // pointer to the JSON lines log
 
-class LogEntry {
-	public:
-		LogEntry( string func, LogLevel lvl, string message ) {
-			this->func = func;
-			this->lvl = lvl;
-			this->message = message;
-		}
-		LogLevel lvl;
-		string func;
-		string message;
+		LogEntry *ring;				/**< Messages that have not been written yet.*/
+		volatile Uint32 enqueuePos;	/**< The next slot that a message can claim.*/
+		volatile Uint32 dequeuePos;	/**< The next slot that will be written.*/
+		volatile Uint32 dropped;	/**< Messages lost because the ring was full.*/
+		Uint32 droppedReported;
+
+		// Where messages are written, copied from the Options by the main thread.
+		volatile bool configured;
+		volatile bool toStdout;
+		volatile bool toXML;
+		volatile bool toJSON;
+
+		SDL_Thread *writer;
+		volatile bool running;
+		SDL_mutex *lock;		/**< Only one thread may write at a time.*/
+		Uint32 mainThread;		/**< Only the main thread may raise Hud Alerts.*/
 };
 
 #endif // __H_LOG__
@@ -1,7 +1,7 @@
 /**\file			lua.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Saturday, January 5, 2008
- * \date			Modified: Saturday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Provides abilities to load, store, and run Lua scripts
  * \details
  * To be used in conjunction with various other subsystems, A.I., GUI, etc.
@@ -13,6 +13,7 @@
 #include "Utilities/file.h"
 #include "Utilities/lua.h"
 #include "Utilities/log.h"
+#include "Utilities/random.h"
 
 
 /**\class Lua
@@ -213,6 +214,65 @@ bool Lua::Close() {
 void Lua::RegisterFunctions() {
 	lua_atpanic(L, &Lua::ErrorCatch);
 
+	// Scripts draw from the engine's own random stream instead of rand()
+	static const luaL_Reg MathFunctions[] = {
+		{"random", &Lua::MathRandom},
+		{"randomseed", &Lua::MathRandomSeed},
+		{"gaussian", &Lua::MathGaussian},
+		{NULL, NULL}
+	};
+	luaL_register(L,"math",MathFunctions);
+	lua_pop(L,1);
+}
+
+/**\brief Replaces math.random with the RANDOM_LUA stream.
+ * \details This takes the same arguments as the standard math.random:
+ *  - math.random() is a number from 0 up to 1.
+ *  - math.random(m) is a whole number from 1 to m.
+ *  - math.random(m,n) is a whole number from m to n.
+ */
+int Lua::MathRandom(lua_State *L) {
+	Random& random = Random::Stream( RANDOM_LUA );
+	int low, high;
+	switch( lua_gettop(L) ) {
+		case 0:
+			lua_pushnumber(L, random.Float() );
+			return 1;
+		case 1:
+			low = 1;
+			high = luaL_checkint(L, 1);
+			break;
+		case 2:
+			low = luaL_checkint(L, 1);
+			high = luaL_checkint(L, 2);
+			break;
+		default:
+			return luaL_error(L, "wrong number of arguments");
+	}
+	luaL_argcheck(L, low <= high, lua_gettop(L), "interval is empty");
+	lua_pushinteger(L, random.Range( low, high ) );
+	return 1;
+}
+
+/**\brief Replaces math.randomseed so that it only restarts the RANDOM_LUA stream.
+ * \details Without a seed the stream goes back to the engine's seed.
+ */
+int Lua::MathRandomSeed(lua_State *L) {
+	if( lua_isnoneornil(L, 1) ) {
+		Random::Restart( RANDOM_LUA );
+	} else {
+		Random::Stream( RANDOM_LUA ).Seed( static_cast<Uint32>( luaL_checknumber(L, 1) ) );
+	}
+	return 0;
+}
+
+/**\brief math.gaussian([mean [, deviation]]) is a number from the normal distribution.
+ */
+int Lua::MathGaussian(lua_State *L) {
+	float mean = static_cast<float>( luaL_optnumber(L, 1, 0.0) );
+	float deviation = static_cast<float>( luaL_optnumber(L, 2, 1.0) );
+	lua_pushnumber(L, mean + deviation * Random::Stream( RANDOM_LUA ).Gaussian() );
+	return 1;
 }
 
 int Lua::ErrorCatch(lua_State *L) {
@@ -454,6 +514,304 @@ int Lua::ConvertFromXML( lua_State *L, xmlDocPtr doc, xmlNodePtr node )
 	return 2; // Key, Value
 }
 
+/**\brief The types of values in a binary Lua snapshot.
+ * \see Lua::SaveGlobal
+ */
+enum {
+	LUA_SNAPSHOT_NIL,
+	LUA_SNAPSHOT_FALSE,
+	LUA_SNAPSHOT_TRUE,
+	LUA_SNAPSHOT_NUMBER,
+	LUA_SNAPSHOT_STRING,
+	LUA_SNAPSHOT_TABLE,
+	LUA_SNAPSHOT_REFERENCE, ///< A table that was already written.
+	LUA_SNAPSHOT_FUNCTION   ///< A function, written by its global name.
+};
+
+/**\brief A table key, sorted so that equal tables are written the same way.
+ */
+struct LuaSnapshotKey {
+	bool isNumber;
+	lua_Number number;
+	string text;
+
+	bool operator< ( const LuaSnapshotKey& other ) const {
+		if( isNumber != other.isNumber ) return isNumber;
+		if( isNumber ) return number < other.number;
+		return text < other.text;
+	}
+};
+
+/**\brief Find the global name of every function.
+ * \details Functions are found as globals ("Name") and as fields of global
+ *          tables ("Table.field").  When a function has several names the
+ *          first one in order is used.
+ */
+static map<const void*,string> FindFunctionNames( lua_State *L ) {
+	map<const void*,string> names;
+	lua_pushnil(L);
+	while( lua_next(L, LUA_GLOBALSINDEX) ) {
+		if( lua_type(L, -2) == LUA_TSTRING ) {
+			string global = lua_tostring(L, -2);
+			if( lua_isfunction(L, -1) ) {
+				const void* f = lua_topointer(L, -1);
+				if( (names.find(f) == names.end()) || (global < names[f]) ) {
+					names[f] = global;
+				}
+			} else if( lua_istable(L, -1) && (global != "_G") ) {
+				lua_pushnil(L);
+				while( lua_next(L, -2) ) {
+					if( (lua_type(L, -2) == LUA_TSTRING) && lua_isfunction(L, -1) ) {
+						const void* f = lua_topointer(L, -1);
+						string field = global + "." + lua_tostring(L, -2);
+						if( (names.find(f) == names.end()) || (field < names[f]) ) {
+							names[f] = field;
+						}
+					}
+					lua_pop(L, 1);
+				}
+			}
+		}
+		lua_pop(L, 1);
+	}
+	return names;
+}
+
+/**\brief Push the function with a name found by FindFunctionNames.
+ * \details Pushes nil if there is no such function.
+ */
+static void PushFunctionByName( lua_State *L, const string& name ) {
+	string::size_type dot = name.find('.');
+	if( dot == string::npos ) {
+		lua_getglobal(L, name.c_str());
+	} else {
+		lua_getglobal(L, name.substr(0, dot).c_str());
+		if( lua_istable(L, -1) ) {
+			lua_getfield(L, -1, name.substr(dot + 1).c_str());
+		} else {
+			lua_pushnil(L);
+		}
+		lua_remove(L, -2);
+	}
+	if( !lua_isfunction(L, -1) ) {
+		LogMsg(WARN, "The Lua snapshot refers to the missing function '%s'.", name.c_str() );
+		lua_pop(L, 1);
+		lua_pushnil(L);
+	}
+}
+
+/**\brief Can this value be written to a snapshot?
+ */
+static bool CanSnapshot( lua_State *L, int index, map<const void*,string>& functions ) {
+	switch( lua_type(L, index) ) {
+		case LUA_TNIL:
+		case LUA_TBOOLEAN:
+		case LUA_TNUMBER:
+		case LUA_TSTRING:
+		case LUA_TTABLE:
+			return true;
+		case LUA_TFUNCTION:
+			return functions.find( lua_topointer(L, index) ) != functions.end();
+		default:
+			return false;
+	}
+}
+
+/**\brief Write one value to a snapshot.
+ * \details A table nested too deeply for the Lua stack is written as nil.
+ */
+static void SnapshotValue( lua_State *L, int index, BinaryWriter& out, map<const void*,string>& functions, map<const void*,Uint32>& tables ) {
+	size_t length;
+	const char* text;
+	if( index < 0 ) {
+		index = lua_gettop(L) + index + 1;
+	}
+
+	switch( lua_type(L, index) ) {
+		case LUA_TBOOLEAN:
+			out.WriteShort( lua_toboolean(L, index) ? LUA_SNAPSHOT_TRUE : LUA_SNAPSHOT_FALSE );
+			break;
+		case LUA_TNUMBER:
+			out.WriteShort( LUA_SNAPSHOT_NUMBER );
+			out.WriteDouble( lua_tonumber(L, index) );
+			break;
+		case LUA_TSTRING:
+			text = lua_tolstring(L, index, &length);
+			out.WriteShort( LUA_SNAPSHOT_STRING );
+			out.WriteString( string(text, length) );
+			break;
+		case LUA_TFUNCTION:
+			if( functions.find( lua_topointer(L, index) ) != functions.end() ) {
+				out.WriteShort( LUA_SNAPSHOT_FUNCTION );
+				out.WriteString( functions[lua_topointer(L, index)] );
+			} else {
+				out.WriteShort( LUA_SNAPSHOT_NIL );
+			}
+			break;
+		case LUA_TTABLE: {
+			const void* table = lua_topointer(L, index);
+			if( tables.find(table) != tables.end() ) {
+				out.WriteShort( LUA_SNAPSHOT_REFERENCE );
+				out.WriteUint( tables[table] );
+				break;
+			}
+			// A key and a value are pushed at each level
+			if( !lua_checkstack(L, 3) ) {
+				LogMsg(ERR, "A Lua table is nested too deeply to be written to a snapshot." );
+				out.WriteShort( LUA_SNAPSHOT_NIL );
+				break;
+			}
+			Uint32 reference = static_cast<Uint32>( tables.size() ) + 1;
+			tables[table] = reference;
+
+			// Only number and string keys are kept, in sorted order
+			vector<LuaSnapshotKey> keys;
+			lua_pushnil(L);
+			while( lua_next(L, index) ) {
+				int keyType = lua_type(L, -2);
+				if( ((keyType == LUA_TNUMBER) || (keyType == LUA_TSTRING)) && CanSnapshot(L, -1, functions) ) {
+					LuaSnapshotKey key;
+					key.isNumber = (keyType == LUA_TNUMBER);
+					key.number = key.isNumber ? lua_tonumber(L, -2) : 0;
+					if( !key.isNumber ) {
+						text = lua_tolstring(L, -2, &length);
+						key.text.assign(text, length);
+					}
+					keys.push_back( key );
+				}
+				lua_pop(L, 1);
+			}
+			sort( keys.begin(), keys.end() );
+
+			out.WriteShort( LUA_SNAPSHOT_TABLE );
+			out.WriteUint( keys.size() );
+			for( unsigned int k = 0; k < keys.size(); k++ ) {
+				if( keys[k].isNumber ) {
+					out.WriteShort( LUA_SNAPSHOT_NUMBER );
+					out.WriteDouble( keys[k].number );
+					lua_pushnumber(L, keys[k].number);
+				} else {
+					out.WriteShort( LUA_SNAPSHOT_STRING );
+					out.WriteString( keys[k].text );
+					lua_pushlstring(L, keys[k].text.data(), keys[k].text.size());
+				}
+				lua_rawget(L, index);
+				SnapshotValue(L, -1, out, functions, tables);
+				lua_pop(L, 1);
+			}
+			break;
+		}
+		default:
+			out.WriteShort( LUA_SNAPSHOT_NIL );
+			break;
+	}
+}
+
+/**\brief Read one value from a snapshot and push it.
+ * \param refs The index of a table of every table read so far.
+ * \return false if the snapshot is damaged.  Something is still pushed.
+ */
+static bool RestoreValue( lua_State *L, BinaryReader& in, int refs ) {
+	Sint16 tag = in.ReadShort();
+	if( in.Failed() ) {
+		lua_pushnil(L);
+		return false;
+	}
+
+	switch( tag ) {
+		case LUA_SNAPSHOT_NIL:
+			lua_pushnil(L);
+			break;
+		case LUA_SNAPSHOT_FALSE:
+		case LUA_SNAPSHOT_TRUE:
+			lua_pushboolean(L, tag == LUA_SNAPSHOT_TRUE);
+			break;
+		case LUA_SNAPSHOT_NUMBER:
+			lua_pushnumber(L, in.ReadDouble());
+			break;
+		case LUA_SNAPSHOT_STRING: {
+			string text = in.ReadString();
+			lua_pushlstring(L, text.data(), text.size());
+			break;
+		}
+		case LUA_SNAPSHOT_FUNCTION:
+			PushFunctionByName(L, in.ReadString());
+			break;
+		case LUA_SNAPSHOT_REFERENCE:
+			lua_rawgeti(L, refs, in.ReadUint());
+			if( !lua_istable(L, -1) ) {
+				return false;
+			}
+			break;
+		case LUA_SNAPSHOT_TABLE: {
+			// The table, a key and a value are pushed at each level
+			if( !lua_checkstack(L, 3) ) {
+				LogMsg(ERR, "A Lua table in the snapshot is nested too deeply to be read." );
+				lua_pushnil(L);
+				return false;
+			}
+			lua_newtable(L);
+			int table = lua_gettop(L);
+			lua_pushvalue(L, table);
+			lua_rawseti(L, refs, lua_objlen(L, refs) + 1);
+
+			Uint32 count = in.ReadUint();
+			for( Uint32 e = 0; e < count; e++ ) {
+				bool valid = RestoreValue(L, in, refs);
+				valid = RestoreValue(L, in, refs) && valid;
+				if( !valid || lua_isnil(L, -2) ) {
+					lua_pop(L, 2);
+					return false;
+				}
+				lua_rawset(L, table);
+			}
+			break;
+		}
+		default:
+			lua_pushnil(L);
+			return false;
+	}
+	return !in.Failed();
+}
+
+/**\brief Write a global Lua value into a compact binary snapshot.
+ * \details Tables are written with their keys sorted, so two tables with the
+ *          same contents are written the same way.  A table that appears more
+ *          than once is only written once, which also handles cycles.
+ *
+ *          Functions are written by their global name.  Coroutines, userdata
+ *          and functions without a global name can not be written, so table
+ *          entries holding them are left out.  Metatables are not written.
+ *          Tables nested too deeply for the Lua stack are written as nil.
+ * \see LoadGlobal
+ */
+void Lua::SaveGlobal( lua_State *L, const string& name, BinaryWriter& out ) {
+	map<const void*,string> functions = FindFunctionNames( L );
+	map<const void*,Uint32> tables;
+
+	lua_getglobal(L, name.c_str());
+	SnapshotValue(L, -1, out, functions, tables);
+	lua_pop(L, 1);
+}
+
+/**\brief Replace a global Lua value with one written by SaveGlobal.
+ * \details The global is only replaced if the whole value could be read.
+ */
+bool Lua::LoadGlobal( lua_State *L, const string& name, BinaryReader& in ) {
+	int top = lua_gettop(L);
+	lua_newtable(L);
+	int refs = lua_gettop(L);
+
+	if( RestoreValue(L, in, refs) != true ) {
+		LogMsg(ERR, "Could not restore the Lua value '%s'.", name.c_str() );
+		lua_settop(L, top);
+		return false;
+	}
+	lua_setglobal(L, name.c_str());
+	lua_settop(L, top);
+	return true;
+}
+
 //can be found here  http://www.lua.org/pil/24.2.3.html
 void Lua::stackDump (lua_State *L) {
 	int i;
@@ -1,7 +1,7 @@
 /**\file			lua.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Saturday, January 5, 2008
- * \date			Modified: Saturday, November 21, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Provides abilities to load, store, and run Lua scripts
  * \details
  * To be used in conjunction with various other subsystems, A.I., GUI, etc.
@@ -11,6 +11,7 @@
 #define __H_LUA__
 
 #include "includes.h"
+#include "Utilities/binary.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,10 +55,16 @@ class Lua {
 		static xmlNodePtr ConvertToXML( lua_State *L, int value_index, int key_index);
 		static int ConvertFromXML( lua_State *L, xmlDocPtr doc, xmlNodePtr tree );
 
+		static void SaveGlobal( lua_State *L, const string& name, BinaryWriter& out );
+		static bool LoadGlobal( lua_State *L, const string& name, BinaryReader& in );
+
 		static void stackDump(lua_State *L);
 
 	private:
 		static int ErrorCatch(lua_State *L);
+		static int MathRandom(lua_State *L);
+		static int MathRandomSeed(lua_State *L);
+		static int MathGaussian(lua_State *L);
 
 		// Internal variables
 		static lua_State *L;
@@ -1,7 +1,7 @@
 /**\file			options.cpp
  * \author			Matt Zweig
  * \date			Created:  Sunday, May 29, 2011
- * \date			Modified: Sunday, May 29, 2011
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Global Options
  * \details
  */
@@ -17,6 +17,34 @@ XMLFile *Options::defaults = NULL; ///< Static instance of the default option va
 /**\class Options
  * \brief Container and accessor of Game options
  *
+ * Options are stored as text in an XMLFile, so reading one by its path
+ * means searching for the node and parsing its value.  Code that reads an
+ * Option often should declare an Option handle once instead:
+ *
+ * \code
+ * static Option<int> soundButtons( "options/sound/buttons" );
+ * ...
+ * if( soundButtons ) UI::beep->Play();
+ * \endcode
+ *
+ * The handle parses the value the first time it is read and keeps it until
+ * that Option is Set again.
+ *
+ * \see Option
+ */
+
+/**\class OptionHandle
+ * \brief The untyped part of an Option handle.
+ * \details Every OptionHandle is registered with Options by its path, so
+ *          that changing an Option invalidates the value remembered by every
+ *          handle to it.
+ */
+
+/**\class Option
+ * \brief A typed handle to a single Option.
+ * \details Reading an Option handle only parses the Option when it has
+ *          changed since the last read.  Otherwise it is a plain reference to
+ *          the remembered value.
  */
 
 void Options::Initialize( const string& path )
@@ -29,6 +57,7 @@ void Options::Initialize( const string& path )
 	}
 	defaults = new XMLFile();
 	defaults->New( path + ".bac", "options" );
+	InvalidateAll();
 }
 
 void Options::Unlock()
@@ -63,6 +92,7 @@ void Options::AddDefault( const string& path, const string& value )
 	if( false == optionsfile->Has(path) )
 	{
 		optionsfile->Set(path,value);
+		Invalidate(path);
 		assert( value == Get(path) );
 	}
 }
@@ -76,6 +106,7 @@ void Options::AddDefault( const string& path, const float value )
 	if( false == optionsfile->Has(path) )
 	{
 		optionsfile->Set(path,value);
+		Invalidate(path);
 		assert( value == convertTo<float>(Get(path)) );
 	}
 }
@@ -89,6 +120,7 @@ void Options::AddDefault( const string& path, const int value )
 	if( false == optionsfile->Has(path) )
 	{
 		optionsfile->Set(path,value);
+		Invalidate(path);
 		assert( value == convertTo<int>(Get(path)) );
 	}
 }
@@ -96,6 +128,7 @@ void Options::AddDefault( const string& path, const int value )
 void Options::RestoreDefaults()
 {
 	optionsfile->Copy( defaults );
+	InvalidateAll();
 }
 
 string Options::Get( const string& path )
@@ -108,17 +141,77 @@ void Options::Set( const string& path, const string& value )
 {
 	assert( optionsfile );
 	optionsfile->Set( path, value );
+	Invalidate( path );
 }
 
 void Options::Set( const string& path, const float value )
 {
 	assert( optionsfile );
 	optionsfile->Set( path, value );
+	Invalidate( path );
 }
 
 void Options::Set( const string& path, const int value )
 {
 	assert( optionsfile );
 	optionsfile->Set( path, value );
+	Invalidate( path );
 }
 
+
+/**\brief Every OptionHandle, by path.
+ * \details This is created on first use since OptionHandles are often
+ *          static, and may be constructed before Options.
+ */
+map<string, list<OptionHandle*> >& Options::Handles()
+{
+	static map<string, list<OptionHandle*> > handles;
+	return handles;
+}
+
+/**\brief Forget the remembered value of every OptionHandle to path.
+ */
+void Options::Invalidate( const string& path )
+{
+	map<string, list<OptionHandle*> >::iterator found = Handles().find( path );
+	if( found == Handles().end() )
+	{
+		return;
+	}
+	for( list<OptionHandle*>::iterator h = found->second.begin(); h != found->second.end(); ++h )
+	{
+		(*h)->Invalidate();
+	}
+}
+
+/**\brief Forget the remembered value of every OptionHandle.
+ */
+void Options::InvalidateAll()
+{
+	map<string, list<OptionHandle*> >::iterator path;
+	for( path = Handles().begin(); path != Handles().end(); ++path )
+	{
+		for( list<OptionHandle*>::iterator h = path->second.begin(); h != path->second.end(); ++h )
+		{
+			(*h)->Invalidate();
+		}
+	}
+}
+
+/**\brief Register a handle to an Option.
+ * \details The Option does not need to exist yet, it is not read until the
+ *          handle is.
+ */
+OptionHandle::OptionHandle( const string& path )
+	:path( path )
+	,resolved( false )
+{
+	Options::Handles()[ path ].push_back( this );
+}
+
+/**\brief Unregister a handle to an Option.
+ */
+OptionHandle::~OptionHandle()
+{
+	Options::Handles()[ path ].remove( this );
+}
@@ -1,7 +1,7 @@
 /**\file			options.h
  * \author			Matt Zweig
  * \date			Created:  Sunday, May 29, 2011
- * \date			Modified: Sunday, May 29, 2011
+ * \date			Modified: Sunday, October 18, 2026
  * \brief			Global Options
  * \details
  */
@@ -12,10 +12,11 @@
 #include "Utilities/xml.h"
 #include "Utilities/string_convert.h"
 
-// To simply access options
-#define OPTION(T, path) ( convertTo<T>( Options::Get(path) ))
+// To simply change options (read them through an Option handle)
 #define SETOPTION(path, value) (Options::Set((path),(value)) )
 
+class OptionHandle;
+
 class Options
 {
 	public:
@@ -41,9 +42,47 @@ class Options
 
 
 	private:
+		friend class OptionHandle;
+
+		static map<string, list<OptionHandle*> >& Handles();
+		static void Invalidate( const string& path );
+		static void InvalidateAll();
+
 		static bool locked;
 		static XMLFile *optionsfile;
 		static XMLFile *defaults;
 };
 
+// An Option that remembers its value until the Option is changed
+class OptionHandle {
+	public:
+		OptionHandle( const string& path );
+		virtual ~OptionHandle();
+
+		const string& GetPath( void ) const { return path; }
+		void Invalidate( void ) { resolved = false; }
+
+	protected:
+		string path;
+		bool resolved;
+};
+
+template<class T>
+class Option : public OptionHandle {
+	public:
+		Option( const string& path ): OptionHandle( path ), value() {}
+
+		const T& Get( void ) {
+			if( !resolved ) {
+				value = convertTo<T>( Options::Get( path ) );
+				resolved = true;
+			}
+			return value;
+		}
+		operator const T&( void ) { return Get(); }
+
+	private:
+		T value;
+};
+
 #endif // __H_OPTIONS
@@ -0,0 +1,102 @@
+/**\file			pool.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Free lists for objects that are made and destroyed often
+ * \details
+ */
+
+#ifndef __H_POOL__
+#define __H_POOL__
+
+#include "includes.h"
+
+#define POOL_CHUNK 256 ///< Objects allocated together when a Pool runs out.
+
+/** Counts of how a Pool has been used. */
+typedef struct {
+	Uint32 allocations;	///< Objects handed out.
+	Uint32 chunks;		///< Allocations from the heap.
+	int live;			///< Objects in use right now.
+	int peak;			///< Most objects in use at once.
+} PoolStats;
+
+/**\class Pool
+ * \brief Hands out memory for objects of one type from a free list.
+ * \details Memory is taken from the heap POOL_CHUNK objects at a time.  When
+ *          an object is deleted its memory goes back on the free list and the
+ *          next object of the same type reuses it, so a type that is made and
+ *          destroyed every frame stops allocating once the Pool has grown to
+ *          the busiest moment.  The memory is never given back to the heap.
+ *
+ *          A class uses a Pool by forwarding its own operator new and
+ *          operator delete to Allocate and Free.  Classes derived from it are
+ *          larger than the blocks, so they fall through to the heap.
+ *
+ *          Pools are not thread safe.
+ * \see Projectile, Effect
+ */
+template<class T>
+class Pool {
+	public:
+		static void* Allocate( size_t size ) {
+			if( size != sizeof(T) ) {
+				return ::operator new( size );
+			}
+			if( available == NULL ) {
+				Grow();
+			}
+			Block* block = available;
+			available = block->next;
+
+			stats.allocations++;
+			stats.live++;
+			if( stats.live > stats.peak ) {
+				stats.peak = stats.live;
+			}
+			return block;
+		}
+
+		static void Free( void* memory, size_t size ) {
+			if( memory == NULL ) {
+				return;
+			}
+			if( size != sizeof(T) ) {
+				::operator delete( memory );
+				return;
+			}
+			Block* block = static_cast<Block*>( memory );
+			block->next = available;
+			available = block;
+			stats.live--;
+		}
+
+		static const PoolStats& GetStats( void ) { return stats; }
+		static void ResetStats( void ) { stats.allocations = 0; stats.chunks = 0; stats.peak = stats.live; }
+
+	private:
+		union Block {
+			Block* next;
+			char storage[sizeof(T)];
+			double alignDouble;
+			void* alignPointer;
+		};
+
+		static void Grow( void ) {
+			Block* chunk = static_cast<Block*>( ::operator new( sizeof(Block) * POOL_CHUNK ) );
+			for( int b = 0; b < POOL_CHUNK - 1; b++ ) {
+				chunk[b].next = &chunk[b + 1];
+			}
+			chunk[POOL_CHUNK - 1].next = available;
+			available = chunk;
+			stats.chunks++;
+		}
+
+		static Block* available;
+		static PoolStats stats;
+};
+
+template<class T> typename Pool<T>::Block* Pool<T>::available = NULL;
+template<class T> PoolStats Pool<T>::stats = { 0, 0, 0, 0 };
+
+#endif // __H_POOL__
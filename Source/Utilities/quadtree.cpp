@@ -1,7 +1,7 @@
 /**\file			quadtree.cpp
  * \author			Matt Zweig (thezweig@gmail.com)
  * \date			Created: Tuesday, November 24 2009
- * \date			Modified: Tuesday, November 24 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -195,16 +195,17 @@ list<Sprite *> *QuadTree::GetSprites() {
  *
  * \arg point The center of the search radius.
  * \arg distance The maximum search radius.
- * \arg nearby [out] The list of all Sprites found within the search radius.
+ * \arg nearby [out] The vector of all Sprites found within the search radius.
  * \arg type A DRAW_ORDER mask used to filter for desired Sprite types.
  *
- * The nearby list is passed down the recursive call-stack rather than returned at by each call.
- * This limits the malloc calls.
+ * The nearby vector is passed down the recursive call-stack rather than returned at by each call.
+ * This limits the malloc calls, and a vector that is reused between calls
+ * only allocates when more Sprites are found than ever before.
  *
  * \returns nothing.
  */
 
-void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *nearby, int type){
+void QuadTree::GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *nearby, int type){
 	// The Maximum range is when the center and point are on a 45 degree angle.
 	//   Root-2 of the radius + the distance
 	const float maxrange = V_SQRT2*radius + distance;
@@ -232,6 +233,15 @@ void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *n
 	}
 }
 
+/**\brief Find all Sprites within a certain distance of a point, into a list.
+ * \details This is the same search as above, for callers that want a list.
+ */
+void QuadTree::GetSpritesNear(Coordinate point, float distance, list<Sprite*> *nearby, int type){
+	vector<Sprite*> found;
+	GetSpritesNear( point, distance, &found, type );
+	nearby->insert( nearby->end(), found.begin(), found.end() );
+}
+
 /**\brief Find the Sprite that is closest to a known point.
  *
  * \arg obj The Sprite at the center of the search radius.
@@ -37,6 +37,7 @@ class QuadTree {
 
 		list<Sprite*> *GetSprites();
 		void GetSpritesNear(Coordinate point, float distance, list<Sprite*> *returnList, int type = DRAW_ORDER_ALL);
+		void GetSpritesNear(Coordinate point, float distance, vector<Sprite*> *returnList, int type = DRAW_ORDER_ALL);
 		Sprite* GetNearestSprite(Sprite* obj, float distance, int type = DRAW_ORDER_ALL);
 		list<Sprite*> *FixOutOfBounds();
 
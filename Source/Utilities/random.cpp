@@ -0,0 +1,165 @@
+/**\file			random.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Fast, seedable random numbers
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/random.h"
+
+/**\class Random
+ * \brief A small, fast random number generator.
+ * \details This is xoshiro128**, which keeps 16 bytes of state and needs only
+ *          shifts, rotations and one multiply per number.  Unlike rand(),
+ *          every generator is separate, so two generators with the same seed
+ *          always give the same numbers no matter what else is running.
+ *
+ *          The engine has one stream per subsystem (see RandomStream), all
+ *          seeded from one number by SeedAll().  A subsystem that needs its
+ *          own sequence, such as a Starfield with a fixed seed, can make a
+ *          Random of its own.
+ *
+ *          Scripts use the RANDOM_LUA stream through math.random.
+ *
+ * \see Replay
+ */
+
+Uint32 Random::seed = 0;
+Random Random::streams[RANDOM_STREAMS];
+
+static inline Uint32 rotl( Uint32 x, int k ) {
+	return (x << k) | (x >> (32 - k));
+}
+
+Random::Random( Uint32 seed ) {
+	Seed( seed );
+}
+
+/**\brief Restart the generator.
+ * \details The seed is spread over the whole state with SplitMix64 so that
+ *          similar seeds still give unrelated sequences.
+ */
+void Random::Seed( Uint32 seed ) {
+	Uint64 x = seed;
+	for( int i = 0; i < 4; i++ ) {
+		x += 0x9E3779B97F4A7C15ULL;
+		Uint64 z = x;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		z = z ^ (z >> 31);
+		state[i] = static_cast<Uint32>( z >> 32 );
+	}
+	hasSpare = false;
+	spare = 0.0f;
+}
+
+/**\brief The next 32 random bits.
+ */
+Uint32 Random::Next( void ) {
+	Uint32 result = rotl( state[1] * 5, 7 ) * 9;
+	Uint32 t = state[1] << 9;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotl( state[3], 11 );
+
+	return result;
+}
+
+/**\brief A whole number from 0 up to, but not including, max.
+ * \returns 0 when max is not positive.
+ */
+int Random::Int( int max ) {
+	if( max <= 0 ) {
+		return 0;
+	}
+	return static_cast<int>( (static_cast<Uint64>( Next() ) * static_cast<Uint32>( max )) >> 32 );
+}
+
+/**\brief A whole number from low to high, including both.
+ */
+int Random::Range( int low, int high ) {
+	if( high <= low ) {
+		return low;
+	}
+	return low + Int( high - low + 1 );
+}
+
+/**\brief A number from 0 up to, but not including, 1.
+ */
+float Random::Float( void ) {
+	return static_cast<float>( Next() >> 8 ) * (1.0f / 16777216.0f);
+}
+
+/**\brief A number from the normal distribution with a mean of 0 and a deviation of 1.
+ * \details This is Marsaglia's polar method, which makes two numbers at a
+ *          time and keeps the second one for the next call.
+ */
+float Random::Gaussian( void ) {
+	if( hasSpare ) {
+		hasSpare = false;
+		return spare;
+	}
+
+	float x1, x2, w;
+	do {
+		x1 = 2.0f * Float() - 1.0f;
+		x2 = 2.0f * Float() - 1.0f;
+		w = x1 * x1 + x2 * x2;
+	} while( (w >= 1.0f) || (w == 0.0f) );
+
+	w = sqrt( (-2.0f * log( w )) / w );
+	spare = x2 * w;
+	hasSpare = true;
+	return x1 * w;
+}
+
+/**\brief Fill an array with numbers from the normal distribution.
+ * \details This uses the Box-Muller transform.  The uniform numbers are drawn
+ *          first, then transformed in a loop without branches that the
+ *          compiler can vectorize, which is much faster than calling
+ *          Gaussian() for each number.
+ */
+void Random::Gaussians( float* out, int count ) {
+	int pairs = count / 2;
+	int i;
+
+	for( i = 0; i < pairs * 2; i++ ) {
+		out[i] = Float();
+	}
+
+	const float twoPi = 6.28318530718f;
+	for( i = 0; i < pairs; i++ ) {
+		float u1 = 1.0f - out[2 * i]; // (0,1] so that the log is finite
+		float u2 = out[2 * i + 1];
+		float r = sqrtf( -2.0f * logf( u1 ) );
+		out[2 * i] = r * cosf( twoPi * u2 );
+		out[2 * i + 1] = r * sinf( twoPi * u2 );
+	}
+
+	if( count % 2 ) {
+		out[count - 1] = Gaussian();
+	}
+}
+
+/**\brief Seed every stream from one number.
+ * \details Each stream starts from a different place, so the streams do not
+ *          repeat each other.
+ */
+void Random::SeedAll( Uint32 _seed ) {
+	seed = _seed;
+	for( int s = 0; s < RANDOM_STREAMS; s++ ) {
+		Restart( static_cast<RandomStream>( s ) );
+	}
+}
+
+/**\brief Put one stream back to where SeedAll() started it.
+ */
+void Random::Restart( RandomStream stream ) {
+	streams[stream].Seed( seed + 0x9E3779B9 * static_cast<Uint32>( stream + 1 ) );
+}
@@ -0,0 +1,52 @@
+/**\file			random.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Fast, seedable random numbers
+ * \details
+ */
+
+#ifndef __H_RANDOM__
+#define __H_RANDOM__
+
+#include "includes.h"
+
+/** Each subsystem draws from its own stream so that they do not disturb each other. */
+typedef enum {
+	RANDOM_SIMULATION,	/**< Game events such as jumps and asteroids. */
+	RANDOM_SHIPS,		/**< New Ships. */
+	RANDOM_GATES,		/**< Gate destinations. */
+	RANDOM_LUA,			/**< math.random in scripts. */
+	RANDOM_STARFIELD,	/**< The background stars. */
+	RANDOM_INTERFACE,	/**< Menus, splash screens and other things that are not part of the game. */
+	RANDOM_STREAMS		/**< The number of streams. */
+} RandomStream;
+
+class Random {
+	public:
+		Random( Uint32 seed = 0 );
+
+		void Seed( Uint32 seed );
+		Uint32 Next( void );
+
+		int Int( int max );
+		int Range( int low, int high );
+		float Float( void );
+		float Gaussian( void );
+		void Gaussians( float* out, int count );
+
+		static void SeedAll( Uint32 seed );
+		static void Restart( RandomStream stream );
+		static Uint32 GetSeed( void ) { return seed; }
+		static Random& Stream( RandomStream stream ) { return streams[stream]; }
+
+	private:
+		Uint32 state[4];
+		bool hasSpare; ///< Gaussians are made in pairs.
+		float spare;
+
+		static Uint32 seed;
+		static Random streams[RANDOM_STREAMS];
+};
+
+#endif // __H_RANDOM__
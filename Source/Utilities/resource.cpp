@@ -1,21 +1,25 @@
 /**\file			resource.cpp
  * \author			Matt Zweig
  * \date			Created: Saturday, December 19, 2009
- * \date			Modified: Saturday, December 19, 2009
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
 
 #include "includes.h"
+#include "Utilities/log.h"
+#include "Utilities/options.h"
 #include "Utilities/resource.h"
 
+static Option<long> resourceMemory( "options/resources/memory" );
+
 /** \class Resource
  *  \brief Memory Management Superclass used to prevent duplications
  *  \details The Resource class provides a simple way to use Memory efficiently
  *  without having duplicate instances of the same object.  Resources are
  *  stored using a key (usually a path) and a pointer to the concrete object
  *  allocated on the heap.  This key is then stored into a master lookup table
- *  (an STL map) so that it can be retrieved later.  From then on, any attempt
+ *  so that it can be retrieved later.  From then on, any attempt
  *  to access that object will not have to load the object.
  *
  *  All Resource subclasses should implement their own static "Get" function.
@@ -29,45 +33,218 @@
  *  can point to the same Resource.  For example, a model image might be stored
  *  as both the relative path and the model's name.
  *
- *  \note Currently, Resources are never freed.  The assumption here is that
- *  all Resouces will be used again in the lifetime of the game.  This may
- *  change in later versions of Epiar.
+ *  Keys are hashed, so a lookup only compares the full key of Resources
+ *  whose hashes collide.
+ *
+ *  Resources are freed when the cache grows past options/resources/memory
+ *  megabytes.  The least recently used Resources are freed first, but only
+ *  if nothing refers to them:
+ *
+ *  - A ResourceHandle retains its Resource for as long as it points to it.
+ *    Long lived owners, like a Model's Image, should use a ResourceHandle.
+ *
+ *  - A subclass::Get that returns a raw pointer must Pin the Resource, since
+ *    there is no way to know when that pointer is no longer used.  Pinned
+ *    Resources are never freed.
  *
  *  \warning There is only one main resource lookup table.  If different
  *  Resource subclasses attempt to use the same key for different objects then
  *  errors will occur.
  *
- *  \see Image, Ani, Sound
+ *  \see Image, Ani, Sound, Song, Font, ResourceHandle
  */
 
-/** \brief The Master Resource Map.
+/** \brief The Master Resource Map, from hashed keys to (key, Resource) pairs.
  *  \warning This map is shared by all Resource subclasses.
  */
-map<string, Resource*> Resource::values;
+multimap<Uint32, pair<string,Resource*> > Resource::values;
+
+/** \brief Every Resource stored in the Master Resource Map, once.
+ */
+set<Resource*> Resource::resident;
+
+/** \brief The sum of GetMemorySize() for every resident Resource.
+ */
+long Resource::usage = 0;
 
 /** \brief Empty Resource constructor.
  */
-Resource::Resource() {
+Resource::Resource()
+	:refs(0)
+	,pinned(false)
+	,lastUsed(0)
+	,counted(0)
+{
+}
+
+/** \brief Empty Resource destructor.
+ */
+Resource::~Resource() {
 }
 
 /** \brief Store a Resource given a Key and pointer.
- *  \warning, attempting to store multiple resources using the same key will
- *  cause the previous object to be lost.
- *  \TODO Ensure that keys are not reused for different Resource objects.
- *  \TODO Fix potential memory leak.
+ *  \details If the key is already in use, the previous object is kept.
+ *  Storing a Resource may free other, unused, Resources.
  */
 void Resource::Store(string key,Resource *res) {
 	assert(key != ""); // No Empty Keys!
-	values.insert(make_pair(key,res));
+	assert(res);
+
+	if( Get(key) != NULL ) {
+		return;
+	}
+
+	if( res->name.empty() ) {
+		res->name = key;
+	}
+	res->lastUsed = SDL_GetTicks();
+	values.insert( make_pair( Hash(key), make_pair(key,res) ) );
+	if( resident.insert( res ).second ) {
+		res->counted = res->GetMemorySize();
+		usage += res->counted;
+	}
+
+	Collect( res );
 }
 
 /** \brief Retrieve a stored Resource
  *  \returns The Resource pointer or NULL.
  */
-Resource* Resource::Get(string path) {
-	map<string,Resource*>::iterator val = values.find( path );
-	if( val != values.end() ){
-		return val->second;
-	} 
+Resource* Resource::Get(const string& path) {
+	typedef multimap<Uint32, pair<string,Resource*> >::iterator Iter;
+	pair<Iter,Iter> range = values.equal_range( Hash(path) );
+	for( Iter val = range.first; val != range.second; ++val ) {
+		if( val->second.first == path ) {
+			val->second.second->lastUsed = SDL_GetTicks();
+			return val->second.second;
+		}
+	}
 	return NULL;
 }
+
+/** \brief Start using this Resource.
+ *  \sa ResourceHandle
+ */
+void Resource::Retain( void ) {
+	refs++;
+	lastUsed = SDL_GetTicks();
+}
+
+/** \brief Stop using this Resource.
+ *  \details The Resource is not freed immediately.  It will be freed if the
+ *  cache grows too large before anything uses it again.
+ *  \sa ResourceHandle
+ */
+void Resource::Release( void ) {
+	assert( refs > 0 );
+	refs--;
+	lastUsed = SDL_GetTicks();
+}
+
+/** \brief Recount this Resource after its memory size has changed.
+ *  \details Subclasses call this whenever GetMemorySize() changes after the
+ *  Resource was stored, for example when a texture finishes uploading.
+ */
+void Resource::Resized( void ) {
+	if( resident.find( this ) == resident.end() ) {
+		return;
+	}
+	long size = GetMemorySize();
+	usage += size - counted;
+	counted = size;
+}
+
+/** \brief The number of bytes used by every stored Resource.
+ */
+long Resource::GetMemoryUsage( void ) {
+	return usage;
+}
+
+/** \brief Free unused Resources until the cache fits in its budget.
+ *  \param keep A Resource that must not be freed (usually the one being stored).
+ */
+void Resource::Collect( Resource* keep ) {
+	long limit = resourceMemory * 1024 * 1024;
+	if( limit <= 0 ) {
+		return;
+	}
+
+	if( usage <= limit ) {
+		return;
+	}
+
+	vector<Resource*> candidates;
+	for( set<Resource*>::iterator r = resident.begin(); r != resident.end(); ++r ) {
+		if( (*r != keep) && ((*r)->refs == 0) && !(*r)->pinned ) {
+			candidates.push_back( *r );
+		}
+	}
+	sort( candidates.begin(), candidates.end(), Resource::UsedBefore );
+
+	for( vector<Resource*>::iterator r = candidates.begin(); (r != candidates.end()) && (usage > limit); ++r ) {
+		LogMsg(DEBUG1, "Evicting %s '%s'.", (*r)->GetTypeName().c_str(), (*r)->name.c_str() );
+		Evict( *r );
+	}
+}
+
+/** \brief Remove every key for a Resource and free it.
+ */
+void Resource::Evict( Resource* res ) {
+	multimap<Uint32, pair<string,Resource*> >::iterator val = values.begin();
+	while( val != values.end() ) {
+		if( val->second.second == res ) {
+			values.erase( val++ );
+		} else {
+			++val;
+		}
+	}
+	if( resident.erase( res ) ) {
+		usage -= res->counted;
+	}
+	delete res;
+}
+
+/** \brief Describe every stored Resource, largest first.
+ *  \returns One line per Resource.
+ */
+list<string> Resource::Describe( void ) {
+	char line[256];
+	list<string> lines;
+
+	vector<Resource*> sorted( resident.begin(), resident.end() );
+	sort( sorted.begin(), sorted.end(), Resource::LargerThan );
+
+	for( vector<Resource*>::iterator r = sorted.begin(); r != sorted.end(); ++r ) {
+		snprintf( line, sizeof(line), "%8ld KB %-9s %3d%s %s",
+			(*r)->GetMemorySize() / 1024,
+			(*r)->GetTypeName().c_str(),
+			(*r)->refs,
+			(*r)->pinned ? "*" : " ",
+			(*r)->name.c_str() );
+		lines.push_back( line );
+	}
+	return lines;
+}
+
+/** \brief Hash a key (32 bit FNV-1a).
+ */
+Uint32 Resource::Hash( const string& key ) {
+	Uint32 hash = 2166136261u;
+	for( string::const_iterator c = key.begin(); c != key.end(); ++c ) {
+		hash ^= static_cast<unsigned char>( *c );
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/** \brief Sort Resources from least to most recently used.
+ */
+bool Resource::UsedBefore( Resource* a, Resource* b ) {
+	return a->lastUsed < b->lastUsed;
+}
+
+/** \brief Sort Resources from largest to smallest.
+ */
+bool Resource::LargerThan( Resource* a, Resource* b ) {
+	return a->GetMemorySize() > b->GetMemorySize();
+}
@@ -2,8 +2,8 @@
  * Filename      : resource.h
  * Author(s)     : Matt Zweig
  * Date Created  : Saturday, December 19, 2009
- * Last Modified : Saturday, December 19, 2009
- * Purpose       : 
+ * Last Modified : Sunday, October 18, 2026
+ * Purpose       :
  * Notes         :
  */
 
@@ -15,10 +15,74 @@
 class Resource{
 	public:
 		Resource();
+		virtual ~Resource();
 		static void Store(string key, Resource* res);
-		static Resource* Get(string path);
+		static Resource* Get(const string& path);
+
+		// Reference counting (see ResourceHandle)
+		void Retain( void );
+		void Release( void );
+		// Never evict this Resource
+		void Pin( void ) { pinned = true; }
+		// The first key this was stored with
+		const string& GetName( void ) { return name; }
+
+		// Describe this Resource
+		virtual string GetTypeName( void ) { return "Resource"; }
+		virtual long GetMemorySize( void ) { return 0; }
+
+		// The whole cache
+		static long GetMemoryUsage( void );
+		static void Collect( Resource* keep = NULL );
+		static list<string> Describe( void );
+
+	protected:
+		void Resized( void );
+
+	private:
+		static Uint32 Hash( const string& key );
+		static void Evict( Resource* res );
+		static bool UsedBefore( Resource* a, Resource* b );
+		static bool LargerThan( Resource* a, Resource* b );
+
+		static multimap<Uint32, pair<string,Resource*> > values;
+		static set<Resource*> resident;
+		static long usage; ///< The bytes counted for every resident Resource.
+
+		string name; ///< The first key this was stored with.
+		int refs; ///< The number of ResourceHandles using this.
+		bool pinned; ///< Raw pointers to this have been handed out.
+		Uint32 lastUsed; ///< Ticks when this was last looked up or retained.
+		long counted; ///< The bytes this added to usage.
+};
+
+/**\brief A reference counted pointer to a Resource.
+ * \details While any ResourceHandle points to a Resource, that Resource will
+ *          not be evicted from the cache.
+ */
+template<class T>
+class ResourceHandle {
+	public:
+		ResourceHandle(): res(NULL) {}
+		ResourceHandle( T* _res ): res(_res) { if( res ) res->Retain(); }
+		ResourceHandle( const ResourceHandle<T>& other ): res(other.res) { if( res ) res->Retain(); }
+		~ResourceHandle() { if( res ) res->Release(); }
+
+		ResourceHandle<T>& operator=( const ResourceHandle<T>& other ) { Reset( other.res ); return *this; }
+		ResourceHandle<T>& operator=( T* other ) { Reset( other ); return *this; }
+
+		T* operator->() const { return res; }
+		operator T*() const { return res; }
+		T* Get() const { return res; }
+
 	private:
-		static map<string,Resource*> values;
+		void Reset( T* other ) {
+			if( other ) other->Retain();
+			if( res ) res->Release();
+			res = other;
+		}
+
+		T* res;
 };
 
 #endif // __H_RESOURCE__
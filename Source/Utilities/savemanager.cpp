@@ -0,0 +1,265 @@
+/**\file			savemanager.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Background, crash safe writing of saved files
+ * \details
+ */
+
+#include "includes.h"
+#include "Utilities/savemanager.h"
+#include "Utilities/file.h"
+#include "Utilities/filesystem.h"
+#include "Utilities/log.h"
+
+/**\class SaveJob
+ * \brief A single write that is waiting for the SaveManager.
+ * \details A job either holds an XML document, which is serialized on the
+ *          writer thread, or a string that is written as it is.  The job owns
+ *          its document and frees it when it is deleted.
+ * \see SaveManager
+ */
+
+/**\class SaveManager
+ * \brief Writes saved games and edited simulations on a background thread.
+ * \details Saving is split in two.  The main thread takes a snapshot of the
+ *          game state by building an XML document, which is quick, and hands
+ *          it to SaveDocument().  The writer thread then does the slow part:
+ *          formatting the document and writing it to disk.
+ *
+ *          Whole files are never written in place.  They are written to a
+ *          temporary file next to the original which is then renamed over it,
+ *          so a crash during a save leaves either the old or the new file but
+ *          never half of one.
+ *
+ *          Jobs run in the order they were queued.  If a file is saved again
+ *          before its last save has started, the two saves are merged and the
+ *          file is only written once.
+ *
+ *          Small, frequent changes can be written with Append() instead of
+ *          rewriting the whole file.
+ *
+ *          When the writer thread is not running, every job is written as soon
+ *          as it is queued.
+ *
+ * \see Player::Save, Components::Save
+ */
+
+list<SaveJob*> SaveManager::queued;
+SDL_Thread* SaveManager::thread = NULL;
+SDL_mutex* SaveManager::lock = NULL;
+SDL_cond* SaveManager::wake = NULL;
+SDL_cond* SaveManager::done = NULL;
+int SaveManager::inflight = 0;
+bool SaveManager::running = false;
+
+SaveJob::~SaveJob() {
+	if( doc ) {
+		xmlFreeDoc( doc );
+	}
+}
+
+/**\brief Start the writer thread.
+ */
+bool SaveManager::Initialize( void ) {
+	if( lock == NULL ) {
+		lock = SDL_CreateMutex();
+		wake = SDL_CreateCond();
+		done = SDL_CreateCond();
+	}
+
+	running = true;
+	thread = SDL_CreateThread( SaveManager::Writer, NULL );
+	if( thread == NULL ) {
+		LogMsg(ERR, "Could not start the save thread: %s", SDL_GetError() );
+		running = false;
+		return false;
+	}
+
+	LogMsg(INFO, "Save Manager started." );
+	return true;
+}
+
+/**\brief Write everything that is still queued and stop the writer thread.
+ */
+void SaveManager::Shutdown( void ) {
+	if( lock == NULL ) {
+		return;
+	}
+
+	Flush();
+
+	SDL_LockMutex( lock );
+	running = false;
+	SDL_CondBroadcast( wake );
+	SDL_UnlockMutex( lock );
+
+	if( thread ) {
+		SDL_WaitThread( thread, NULL );
+		thread = NULL;
+	}
+}
+
+/**\brief Save an XML document, replacing the file.
+ * \details The SaveManager takes ownership of the document and frees it once
+ *          it has been written.  The caller must not change it afterwards.
+ */
+void SaveManager::SaveDocument( const string& filename, xmlDocPtr doc ) {
+	assert( doc );
+	SaveJob* job = new SaveJob( SAVE_REPLACE, filename );
+	job->doc = doc;
+	Queue( job );
+}
+
+/**\brief Replace a file with a string.
+ */
+void SaveManager::Replace( const string& filename, const string& contents ) {
+	SaveJob* job = new SaveJob( SAVE_REPLACE, filename );
+	job->contents = contents;
+	Queue( job );
+}
+
+/**\brief Add a string to the end of a file.
+ * \details The file is created if it does not exist yet.
+ */
+void SaveManager::Append( const string& filename, const string& contents ) {
+	SaveJob* job = new SaveJob( SAVE_APPEND, filename );
+	job->contents = contents;
+	Queue( job );
+}
+
+/**\brief Block until every queued job has been written.
+ */
+void SaveManager::Flush( void ) {
+	if( lock == NULL ) {
+		return;
+	}
+
+	SDL_LockMutex( lock );
+	while( running && (GetPending() > 0) ) {
+		SDL_CondWait( done, lock );
+	}
+	SDL_UnlockMutex( lock );
+}
+
+/**\brief The number of jobs that have not been written yet.
+ */
+int SaveManager::GetPending( void ) {
+	return static_cast<int>( queued.size() ) + inflight;
+}
+
+/**\brief Write a whole file without ever leaving it half written.
+ * \details The data is written to a temporary file first, which is then
+ *          renamed over the original.
+ */
+bool SaveManager::WriteFile( const string& filename, const char* data, long size ) {
+	string temporary = filename + ".tmp";
+
+	File saved;
+	if( (saved.OpenWrite( temporary ) != true)
+	 || (saved.Write( const_cast<char*>( data ), size ) != true)
+	 || (saved.Close() != true) ) {
+		LogMsg(ERR, "Could not write '%s'.", temporary.c_str() );
+		Filesystem::DeleteFile( temporary );
+		return false;
+	}
+
+	if( Filesystem::Rename( temporary, filename ) != true ) {
+		LogMsg(ERR, "Could not replace '%s'.", filename.c_str() );
+		return false;
+	}
+	return true;
+}
+
+/**\brief Add data to the end of a file.
+ */
+bool SaveManager::AppendFile( const string& filename, const char* data, long size ) {
+	File saved;
+	if( (saved.OpenAppend( filename ) != true)
+	 || (saved.Write( const_cast<char*>( data ), size ) != true) ) {
+		LogMsg(ERR, "Could not append to '%s'.", filename.c_str() );
+		return false;
+	}
+	return saved.Close();
+}
+
+/**\brief Hand a job to the writer thread.
+ * \details A job that replaces a file is merged with the last job for the
+ *          same file if that job also replaces it and has not started yet.
+ */
+void SaveManager::Queue( SaveJob* job ) {
+	if( !running ) {
+		Run( job );
+		delete job;
+		return;
+	}
+
+	SDL_LockMutex( lock );
+	if( job->kind == SAVE_REPLACE ) {
+		for( list<SaveJob*>::reverse_iterator j = queued.rbegin(); j != queued.rend(); ++j ) {
+			if( (*j)->filename != job->filename ) {
+				continue;
+			}
+			if( (*j)->kind == SAVE_REPLACE ) {
+				// Nothing can observe the older save, so swap in the newer one.
+				SaveJob* older = *j;
+				*j = job;
+				delete older;
+				SDL_UnlockMutex( lock );
+				return;
+			}
+			break;
+		}
+	}
+	queued.push_back( job );
+	SDL_CondSignal( wake );
+	SDL_UnlockMutex( lock );
+}
+
+/**\brief Serialize and write a single job.
+ * \details This is the only part of saving that touches the disk.
+ */
+void SaveManager::Run( SaveJob* job ) {
+	if( job->doc ) {
+		xmlChar *xmlbuff;
+		int buffersize;
+		xmlDocDumpFormatMemory( job->doc, &xmlbuff, &buffersize, 1 );
+		job->contents.assign( (char*)xmlbuff, buffersize );
+		xmlFree( xmlbuff );
+	}
+
+	if( job->kind == SAVE_APPEND ) {
+		AppendFile( job->filename, job->contents.data(), static_cast<long>( job->contents.size() ) );
+	} else {
+		WriteFile( job->filename, job->contents.data(), static_cast<long>( job->contents.size() ) );
+	}
+}
+
+/**\brief The loop run by the writer thread.
+ */
+int SaveManager::Writer( void *unused ) {
+	SaveJob* job;
+
+	SDL_LockMutex( lock );
+	while( running ) {
+		if( queued.empty() ) {
+			SDL_CondWait( wake, lock );
+			continue;
+		}
+
+		job = queued.front();
+		queued.pop_front();
+		++inflight;
+		SDL_UnlockMutex( lock );
+
+		Run( job );
+		delete job;
+
+		SDL_LockMutex( lock );
+		--inflight;
+		SDL_CondBroadcast( done );
+	}
+	SDL_UnlockMutex( lock );
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+/**\file			savemanager.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Background, crash safe writing of saved files
+ * \details
+ */
+
+#ifndef __H_SAVEMANAGER__
+#define __H_SAVEMANAGER__
+
+#include "includes.h"
+
+typedef enum {
+	SAVE_REPLACE,	/**< Replace the whole file. */
+	SAVE_APPEND		/**< Add to the end of the file. */
+} SaveJobKind;
+
+class SaveJob {
+	public:
+		SaveJob( SaveJobKind _kind, const string& _filename ): kind(_kind), filename(_filename), doc(NULL) {}
+		~SaveJob();
+
+		SaveJobKind kind;
+		string filename;
+		xmlDocPtr doc; ///< Serialized by the writer thread when set.
+		string contents; ///< Written as is when there is no doc.
+};
+
+class SaveManager {
+	public:
+		static bool Initialize( void );
+		static void Shutdown( void );
+
+		static void SaveDocument( const string& filename, xmlDocPtr doc );
+		static void Replace( const string& filename, const string& contents );
+		static void Append( const string& filename, const string& contents );
+		static void Flush( void );
+
+		static int GetPending( void );
+
+		static bool WriteFile( const string& filename, const char* data, long size );
+		static bool AppendFile( const string& filename, const char* data, long size );
+
+	private:
+		static int Writer( void *unused );
+		static void Queue( SaveJob* job );
+		static void Run( SaveJob* job );
+
+		static list<SaveJob*> queued;
+		static SDL_Thread* thread;
+		static SDL_mutex* lock;
+		static SDL_cond* wake;
+		static SDL_cond* done;
+		static int inflight;
+		static bool running;
+};
+
+#endif // __H_SAVEMANAGER__
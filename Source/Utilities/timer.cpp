@@ -1,7 +1,7 @@
 /**\file			timer.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -10,6 +10,8 @@
 #include "common.h"
 #include "Utilities/timer.h"
 
+static Option<Uint32> videoFPS( "options/video/fps" );
+
 /**\class Timer
  * \brief Timer class. */
 
@@ -23,14 +25,20 @@ Uint32 Timer::logicalFrameCount = 0;
 void Timer::Initialize( void ) {
 	lastLoopLength = 0;
 	lastLoopTick = SDL_GetTicks();
-	Uint32 fps = OPTION( Uint32, "options/video/fps" );
+	Uint32 fps = videoFPS;
 	if( fps == 0 ) fps = 30;
-	ticksPerFrame = 1000 / OPTION( Uint32, "options/video/fps" );
+	ticksPerFrame = 1000 / videoFPS;
 }
 
 int Timer::Update( void ) {
-	Uint32 tick = SDL_GetTicks();
+	return Update( SDL_GetTicks() );
+}
 
+/**\brief Advance the game clock to a tick that did not come from SDL.
+ * \details This is how a Replay runs the game on the clock it recorded.
+ * \return The number of logical updates to run.
+ */
+int Timer::Update( Uint32 tick ) {
 	lastLoopLength = tick - lastLoopTick;
 	lastLoopTick = tick;
 
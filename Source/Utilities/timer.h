@@ -1,7 +1,7 @@
 /**\file			timer.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Saturday, January 5, 2008
+ * \date			Modified: Sunday, October 18, 2026
  * \brief
  * \details
  */
@@ -17,6 +17,7 @@ class Timer {
 	public:
 		static void Initialize( void );
 		static int Update( void );
+		static int Update( Uint32 tick );
 		static void Delay( int waitMS );
 		static Uint32 GetTicks( void );
 		static Uint32 GetRealTicks( void );
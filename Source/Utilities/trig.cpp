@@ -1,8 +1,8 @@
 /**\file			trig.cpp
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
- * \brief
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Fast single precision math
  * \details
  */
 
@@ -11,67 +11,60 @@
 #include "Utilities/trig.h"
 
 /**\class Trig
- * \brief Trigonometry handling. */
-
-Trig *Trig::pInstance = 0;
+ * \brief Trigonometry handling.
+ * \details Everything is in floats, which is all the precision that drawing
+ *          and the simulation need.  Sine, cosine and atan2 are polynomials
+ *          instead of calls into the C library, and sqrt is the single
+ *          precision instruction.
+ *
+ *          The batch versions work on whole arrays.  Their loops have no
+ *          calls and no branches so that the compiler can vectorize them.
+ *
+ *          Angles are in radians unless a function says otherwise.
+ */
 
-Trig::Trig( void ) {
+/**\brief The sine and cosine of every angle in an array.
+ */
+void Trig::SinCos( const float *radians, float *s, float *c, int count ) {
 	int i;
-
-	convdr = M_PI / 180.;
-	convrd = 180. / M_PI;
-
-	for( i = -360; i < 360; i++ ) {
-		cosTable[i+360] = cos( (double)i * convdr );
-		sinTable[i+360] = sin( (double)i * convdr );
-		tanTable[i+360] = tan( (double)i * convdr );
+	for( i = 0; i < count; i++ ) {
+		SinCosReduced( radians[i], &s[i], &c[i] );
 	}
-}
-
-Trig *Trig::Instance( void ) {
-
-	if( pInstance == 0 ) {
-		pInstance = new Trig;
+	// Redo the rare angles that are too large to reduce
+	for( i = 0; i < count; i++ ) {
+		if( fabsf( radians[i] ) > TRIG_LARGE_ANGLE ) {
+			SinCos( radians[i], &s[i], &c[i] );
+		}
 	}
-
-	return( pInstance );
-}
-
-double Trig::DegToRad( int i ) {
-	return( i * convdr );
 }
 
-double Trig::DegToRad( double i ) {
-	return( i * convdr );
-}
-
-int Trig::RadToDeg( double i ) {
-	return( (int)(i * convrd) );
-}
-
-double Trig::GetCos( int ang ) {
-	return( cosTable[ang+360] );
-}
-
-double Trig::GetCos( double ang ) {
-	return( cos( ang ) );
-}
-
-double Trig::GetSin( int ang ) {
-	return( sinTable[ang+360] );
+/**\brief atan2 of every pair in two arrays.
+ */
+void Trig::Atan2( const float *y, const float *x, float *out, int count ) {
+	for( int i = 0; i < count; i++ ) {
+		out[i] = Atan2( y[i], x[i] );
+	}
 }
 
-double Trig::GetSin( double ang ) {
-	return( sin(ang) );
+/**\brief The length of every vector in two arrays.
+ */
+void Trig::Magnitude( const float *x, const float *y, float *out, int count ) {
+	for( int i = 0; i < count; i++ ) {
+		out[i] = sqrtf( x[i] * x[i] + y[i] * y[i] );
+	}
 }
 
-// rotates point (x, y) about point (ax, ay) and sets nx, ny to new point
-void Trig::RotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang ) {
-	float theta = atan2( y - ay, x - ax );
-	float dist = sqrt( ((x - ax)*(x-ax)) + ((y - ay)*(y-ay)) );
-	float ntheta = theta + ang;
-
-	*nx = ax + (dist * cos( ntheta ) );
-	*ny = ay - (dist * sin( ntheta ) );
+/**\brief Rotate many points about the same point by the same angle.
+ * \details The sine and cosine are only found once.
+ * \see RotatePoint
+ */
+void Trig::RotatePoints( const float *x, const float *y, int count, float ax, float ay, float *nx, float *ny, float ang ) {
+	float s, c;
+	SinCos( ang, &s, &c );
+	for( int i = 0; i < count; i++ ) {
+		float dx = x[i] - ax;
+		float dy = y[i] - ay;
+		nx[i] = ax + (dx * c - dy * s);
+		ny[i] = ay - (dy * c + dx * s);
+	}
 }
-
@@ -1,44 +1,108 @@
 /**\file			trig.h
  * \author			Chris Thielen (chris@epiar.net)
  * \date			Created: Unknown (2006?)
- * \date			Modified: Sunday, November 22, 2009
- * \brief
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Fast single precision math
  * \details
  */
 
 #ifndef __h_trig__
 #define __h_trig__
 
+#include "includes.h"
+
+#define TRIG_PI 3.14159265358979f
+#define TRIG_HALF_PI 1.57079632679490f
+#define TRIG_LARGE_ANGLE 100000.0f ///< Larger angles are given to the C library
+
 class Trig {
 	public:
-		static Trig *Instance();
+		static inline float DegToRad( float degrees ) { return degrees * (TRIG_PI / 180.0f); }
+		static inline int RadToDeg( float radians ) { return static_cast<int>( radians * (180.0f / TRIG_PI) ); }
 
-		double DegToRad( int i );
-		double DegToRad( double i );
-		int RadToDeg( double i );
+		static inline void SinCos( float radians, float *s, float *c );
+		static inline void SinCosReduced( float radians, float *s, float *c );
+		static inline float GetCos( float radians ) { float s, c; SinCos( radians, &s, &c ); return c; }
+		static inline float GetSin( float radians ) { float s, c; SinCos( radians, &s, &c ); return s; }
+		static inline float Atan2( float y, float x );
+		static inline float Sqrt( float x ) { return sqrtf( x ); }
 
-		double GetCos( int ang );
-		double GetCos( double ang );
-		double GetSin( int ang );
-		double GetSin( double ang );
+		static inline void RotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang );
 
-		void RotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang );
+		// Batches
+		static void SinCos( const float *radians, float *s, float *c, int count );
+		static void Atan2( const float *y, const float *x, float *out, int count );
+		static void Magnitude( const float *x, const float *y, float *out, int count );
+		static void RotatePoints( const float *x, const float *y, int count, float ax, float ay, float *nx, float *ny, float ang );
+};
 
-	protected:
-		Trig();
-		Trig( const Trig & );
-  		Trig& operator= (const Trig&);
+/**\brief The sine and cosine of an angle at once.
+ * \details The angle is reduced to within a quarter turn of 0 and then
+ *          Taylor polynomials are used, which are accurate to about 4e-7 up
+ *          to TRIG_LARGE_ANGLE.  Larger angles fall back to the C library.
+ */
+inline void Trig::SinCos( float radians, float *s, float *c ) {
+	if( fabsf( radians ) > TRIG_LARGE_ANGLE ) {
+		*s = sinf( radians );
+		*c = cosf( radians );
+		return;
+	}
+	SinCosReduced( radians, s, c );
+}
 
-	private:
-		static Trig *pInstance;
+/**\brief SinCos without the check for very large angles.
+ * \details This has no calls, so it can be vectorized.
+ */
+inline void Trig::SinCosReduced( float radians, float *s, float *c ) {
+	// Which quarter turn, and how far from it
+	float turns = radians * (2.0f / TRIG_PI);
+	int quadrant = static_cast<int>( turns + ((turns < 0.0f) ? -0.5f : 0.5f) );
+	// In float, quadrant * pi/2 loses more precision the larger the angle
+	float x = static_cast<float>( radians - quadrant * 1.57079632679489662 );
+	float x2 = x * x;
 
-		double convdr; // conversion factor from degrees to radians
-		double convrd; // conversion factor from radians to degrees
+	float sn = x + x * x2 * (-1.0f/6.0f + x2 * (1.0f/120.0f + x2 * (-1.0f/5040.0f)));
+	float cs = 1.0f + x2 * (-0.5f + x2 * (1.0f/24.0f + x2 * (-1.0f/720.0f + x2 * (1.0f/40320.0f))));
 
-		double sinTable[720];
-		double cosTable[720];
-		double tanTable[720];
-};
+	// Rotate the answer into the right quarter turn
+	float ss = (quadrant & 1) ? cs : sn;
+	float cc = (quadrant & 1) ? sn : cs;
+	*s = (quadrant & 2) ? -ss : ss;
+	*c = ((quadrant + 1) & 2) ? -cc : cc;
+}
+
+/**\brief The angle of a point from the x axis, like atan2().
+ * \details This is a polynomial accurate to about 2e-6 radians.
+ */
+inline float Trig::Atan2( float y, float x ) {
+	float ax = fabsf( x ), ay = fabsf( y );
+	float high = (ax > ay) ? ax : ay;
+	float low = (ax > ay) ? ay : ax;
+	if( high == 0.0f ) {
+		return 0.0f;
+	}
+
+	float a = low / high;
+	float s = a * a;
+	float r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f + s * (0.05265332f - s * 0.01172120f)))));
+
+	if( ay > ax ) r = TRIG_HALF_PI - r;
+	if( x < 0.0f ) r = TRIG_PI - r;
+	return (y < 0.0f) ? -r : r;
+}
+
+/**\brief Rotates point (x, y) about point (ax, ay) and sets nx, ny to new point.
+ * \details The y axis of the result points the other way, since this is used
+ *          to go from the world to the screen.
+ */
+inline void Trig::RotatePoint( float x, float y, float ax, float ay, float *nx, float *ny, float ang ) {
+	float s, c;
+	SinCos( ang, &s, &c );
+	float dx = x - ax;
+	float dy = y - ay;
+	*nx = ax + (dx * c - dy * s);
+	*ny = ay - (dy * c + dx * s);
+}
 
 // Turns an arbitrary angle into the smallest equivalent angle
 inline float normalizeAngle(float angle){
@@ -0,0 +1,253 @@
+/**\file			triggers.cpp
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Regions that report when Sprites enter and leave them
+ * \details
+ */
+
+#include "includes.h"
+#include "Sprites/sprite.h"
+#include "Utilities/quadtree.h"
+#include "Utilities/triggers.h"
+
+/**\class Triggers
+ * \brief Trigger volumes: circles that report when Sprites enter and leave.
+ * \details Something that wants to know when a ship reaches a place, like a
+ *          Gate, adds a volume with a TriggerListener instead of searching
+ *          for nearby ships every tick.
+ *
+ *          The volumes are indexed by the same quadrant grid as the
+ *          SpriteManager's QuadTrees.  Every tick the SpriteManager hands over
+ *          the Sprites that can set off a volume, the ships.  Each one is
+ *          only tested against the volumes in its own quadrant, and each
+ *          Sprite already inside a volume is tested to see if it has left.
+ *          The cost follows the number of ships, so volumes that nobody goes
+ *          near cost nothing.
+ *
+ *          A volume should not be larger than a quadrant.  Each Sprite is
+ *          only tested against the volumes of the quadrant that holds it,
+ *          so a larger volume is indexed into every quadrant it touches.
+ *
+ *          The events are collected first and sent once every Sprite has
+ *          been tested, in a fixed order, so a listener that moves a Sprite
+ *          does not change what the rest of the tick sees.
+ * \see SpriteManager::GetTriggers, Gate
+ */
+
+/**\brief No volumes.
+ */
+Triggers::Triggers():
+	nextID( 1 )
+{
+	ResetStats();
+}
+
+/**\brief Add a trigger volume.
+ * \param center The center of the volume.
+ * \param radius The radius of the volume.
+ * \param types The draw orders of the Sprites that set it off.
+ * \param listener Told when those Sprites enter and leave.
+ * \returns The id of the volume, which is never 0.
+ */
+int Triggers::Add( Coordinate center, float radius, int types, TriggerListener* listener ) {
+	assert( listener );
+	Volume& volume = volumes[nextID];
+	volume.center = center;
+	volume.radius = radius;
+	volume.types = types;
+	volume.listener = listener;
+	Index( nextID, true );
+	return nextID++;
+}
+
+/**\brief Move a trigger volume.
+ * \details Sprites that are no longer inside get their exit events on the
+ *          next Update.
+ */
+void Triggers::Move( int id, Coordinate center ) {
+	map<int,Volume>::iterator volume = volumes.find( id );
+	if( volume == volumes.end() ) {
+		return;
+	}
+	Index( id, false );
+	volume->second.center = center;
+	Index( id, true );
+}
+
+/**\brief Remove a trigger volume without sending any more events.
+ */
+void Triggers::Remove( int id ) {
+	if( volumes.find( id ) == volumes.end() ) {
+		return;
+	}
+	Index( id, false );
+	occupied.erase( id );
+	volumes.erase( id );
+}
+
+/**\brief Send the events for the Sprites that have entered or left a volume.
+ * \param movers The Sprites that may set off a volume.
+ */
+void Triggers::Update( lua_State *L, const list<Sprite*>& movers ) {
+	vector<Event> events;
+
+	// Sprites that have left a volume
+	for( set<int>::iterator o = occupied.begin(); o != occupied.end(); ) {
+		Volume& volume = volumes[*o];
+		vector<Sprite*>& inside = volume.occupants;
+		for( unsigned int s = 0; s < inside.size(); ) {
+			stats.checks++;
+			if( Inside( volume, inside[s] ) ) {
+				++s;
+				continue;
+			}
+			Event left = { *o, inside[s], false };
+			events.push_back( left );
+			inside.erase( inside.begin() + s );
+		}
+		if( inside.empty() ) {
+			occupied.erase( o++ );
+		} else {
+			++o;
+		}
+	}
+
+	// Sprites that have entered a volume
+	Enter( movers, &events );
+
+	for( unsigned int e = 0; e < events.size(); e++ ) {
+		// An earlier listener may have removed this volume
+		map<int,Volume>::iterator volume = volumes.find( events[e].trigger );
+		if( volume == volumes.end() ) {
+			continue;
+		}
+		if( events[e].entered ) {
+			stats.entered++;
+			volume->second.listener->Entered( events[e].trigger, events[e].sprite, L );
+		} else {
+			stats.exited++;
+			volume->second.listener->Exited( events[e].trigger, events[e].sprite, L );
+		}
+	}
+}
+
+/**\brief Forget a Sprite that is leaving the SpriteManager.
+ * \details No exit event is sent.
+ */
+void Triggers::Forget( Sprite* sprite ) {
+	for( set<int>::iterator o = occupied.begin(); o != occupied.end(); ) {
+		vector<Sprite*>& inside = volumes[*o].occupants;
+		inside.erase( remove( inside.begin(), inside.end(), sprite ), inside.end() );
+		if( inside.empty() ) {
+			occupied.erase( o++ );
+		} else {
+			++o;
+		}
+	}
+}
+
+/**\brief Forget every Sprite inside every volume.
+ * \details Sprites that are still inside get new enter events on the next
+ *          Update unless Settle is called.  This is used when every Sprite is
+ *          replaced at once.
+ */
+void Triggers::Reset( void ) {
+	for( set<int>::iterator o = occupied.begin(); o != occupied.end(); ++o ) {
+		volumes[*o].occupants.clear();
+	}
+	occupied.clear();
+}
+
+/**\brief Mark the Sprites that are inside a volume as its occupants.
+ * \details No enter events are sent.  This is used after every Sprite has
+ *          been replaced at once, so that Sprites that were already inside a
+ *          volume, such as ships resting in a Gate, do not set it off again.
+ */
+void Triggers::Settle( const list<Sprite*>& movers ) {
+	Enter( movers, NULL );
+}
+
+/**\brief Zero the counters.
+ */
+void Triggers::ResetStats( void ) {
+	stats.checks = 0;
+	stats.entered = 0;
+	stats.exited = 0;
+}
+
+/**\brief Find the Sprites that have entered a volume.
+ * \param events [out] The enter events to send, or NULL to send none.
+ */
+void Triggers::Enter( const list<Sprite*>& movers, vector<Event>* events ) {
+	if( cells.empty() ) {
+		return;
+	}
+	for( list<Sprite*>::const_iterator m = movers.begin(); m != movers.end(); ++m ) {
+		map<Coordinate, vector<int> >::iterator cell = cells.find( GetCell( (*m)->GetWorldPosition() ) );
+		if( cell == cells.end() ) {
+			continue;
+		}
+		int type = (*m)->GetDrawOrder();
+		for( unsigned int v = 0; v < cell->second.size(); v++ ) {
+			int id = cell->second[v];
+			Volume& volume = volumes[id];
+			if( (volume.types & type) == 0 ) {
+				continue;
+			}
+			stats.checks++;
+			if( !Inside( volume, *m )
+			 || (find( volume.occupants.begin(), volume.occupants.end(), *m ) != volume.occupants.end()) ) {
+				continue;
+			}
+			volume.occupants.push_back( *m );
+			occupied.insert( id );
+			if( events != NULL ) {
+				Event entered = { id, *m, true };
+				events->push_back( entered );
+			}
+		}
+	}
+}
+
+/**\brief The quadrant that holds a point.
+ * \details This matches SpriteManager::GetQuadrantCenter.
+ */
+Coordinate Triggers::GetCell( Coordinate point ) {
+	double cx, cy;
+	cx = floor( (point.GetX() + QUADRANTSIZE) / (QUADRANTSIZE * 2.0f) ) * QUADRANTSIZE * 2.0f;
+	cy = floor( (point.GetY() + QUADRANTSIZE) / (QUADRANTSIZE * 2.0f) ) * QUADRANTSIZE * 2.0f;
+	return Coordinate( cx, cy );
+}
+
+/**\brief Add a volume to, or remove it from, every quadrant that it touches.
+ */
+void Triggers::Index( int id, bool add ) {
+	Coordinate center = volumes[id].center;
+	Coordinate corner( volumes[id].radius, volumes[id].radius );
+	Coordinate low = GetCell( center - corner );
+	Coordinate high = GetCell( center + corner );
+	for( double x = low.GetX(); x <= high.GetX(); x += QUADRANTSIZE * 2.0f ) {
+		for( double y = low.GetY(); y <= high.GetY(); y += QUADRANTSIZE * 2.0f ) {
+			Coordinate key( x, y );
+			if( add ) {
+				cells[key].push_back( id );
+				continue;
+			}
+			map<Coordinate, vector<int> >::iterator cell = cells.find( key );
+			if( cell == cells.end() ) {
+				continue;
+			}
+			cell->second.erase( remove( cell->second.begin(), cell->second.end(), id ), cell->second.end() );
+			if( cell->second.empty() ) {
+				cells.erase( cell );
+			}
+		}
+	}
+}
+
+/**\brief Check if a Sprite is inside a volume.
+ */
+bool Triggers::Inside( const Volume& volume, Sprite* sprite ) {
+	return (sprite->GetWorldPosition() - volume.center).GetMagnitudeSquared() < volume.radius * volume.radius;
+}
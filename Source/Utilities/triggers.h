@@ -0,0 +1,85 @@
+/**\file			triggers.h
+ * \author			Epiar Development Team
+ * \date			Created: Sunday, October 18, 2026
+ * \date			Modified: Sunday, October 18, 2026
+ * \brief			Regions that report when Sprites enter and leave them
+ * \details
+ */
+
+#ifndef __H_TRIGGERS__
+#define __H_TRIGGERS__
+
+#include "includes.h"
+#include "Utilities/coordinate.h"
+
+class Sprite;
+
+/// The draw orders of the Sprites that can set off a volume.
+#define TRIGGER_MOVERS (DRAW_ORDER_SHIP|DRAW_ORDER_PLAYER)
+
+/**\brief Receives the events of a trigger volume.
+ * \details Listeners may move the Sprite or queue it for deletion, but must
+ *          not Detach it from the SpriteManager.
+ */
+class TriggerListener {
+	public:
+		virtual ~TriggerListener() {}
+		virtual void Entered( int trigger, Sprite* sprite, lua_State *L ) = 0;
+		virtual void Exited( int trigger, Sprite* sprite, lua_State *L ) {}
+};
+
+/** Counts of the work done by the trigger volumes. */
+typedef struct {
+	Uint32 checks;		///< Sprites tested against a volume.
+	Uint32 entered;		///< Enter events sent.
+	Uint32 exited;		///< Exit events sent.
+} TriggerStats;
+
+class Triggers {
+	public:
+		Triggers();
+
+		int Add( Coordinate center, float radius, int types, TriggerListener* listener );
+		void Move( int id, Coordinate center );
+		void Remove( int id );
+		int GetCount( void ) { return static_cast<int>( volumes.size() ); }
+
+		void Update( lua_State *L, const list<Sprite*>& movers );
+		void Forget( Sprite* sprite );
+		void Reset( void );
+		void Settle( const list<Sprite*>& movers );
+
+		const TriggerStats& GetStats( void ) { return stats; }
+		void ResetStats( void );
+
+	private:
+		/** A circle that Sprites of some types can enter. */
+		typedef struct {
+			Coordinate center;
+			float radius;
+			int types;					///< The draw orders that trigger it.
+			TriggerListener* listener;
+			vector<Sprite*> occupants;	///< The Sprites inside, in the order they entered.
+		} Volume;
+
+		/** An event waiting to be sent once every Sprite has been checked. */
+		typedef struct {
+			int trigger;
+			Sprite* sprite;
+			bool entered;
+		} Event;
+
+		void Enter( const list<Sprite*>& movers, vector<Event>* events );
+		static Coordinate GetCell( Coordinate point );
+		void Index( int id, bool add );
+		static bool Inside( const Volume& volume, Sprite* sprite );
+
+		map<int,Volume> volumes;
+		map<Coordinate, vector<int> > cells;	///< The volumes touching each quadrant.
+		set<int> occupied;						///< The volumes with Sprites inside.
+		int nextID;
+
+		TriggerStats stats;
+};
+
+#endif // __H_TRIGGERS__
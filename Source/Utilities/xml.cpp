@@ -1,7 +1,7 @@
 /**\file		xml.cpp
  * \author		Chris Thielen (chris@epiar.net)
  * \date		Created: Monday, April 21, 2008
- * \date		Modified: Saturday, November 21, 2009
+ * \date		Modified: Sunday, October 18, 2026
  * \brief       Interface with XML files
  * \details
  *
@@ -11,11 +11,40 @@
 #include "Utilities/file.h"
 #include "Utilities/log.h"
 #include "Utilities/xml.h"
+#include "Utilities/binary.h"
 #include "Utilities/components.h"
 
 /**\class XMLFile
  * \brief XML handling.
+ * \details Paths like "Skin/HUD/Map/Font" are looked up once and then
+ *          remembered.  Code that reads the same value often, such as every
+ *          frame, should Intern() the path once and pass the XMLPathID
+ *          instead.  The value is then found by index, parsed only the first
+ *          time, and returned by reference without allocating anything.
+ *
+ *          Set() forgets the remembered value, so the next read sees the
+ *          change.
+ *
+ *          The table of interned paths is shared and not locked, so paths
+ *          may only be interned, and XMLFiles only read by path, on the main
+ *          thread or during static initialization.
+ */
+
+/**\brief The table of interned paths.
+ * \details Paths are found with an open addressing hash table of FNV hashes.
+ *          Path IDs are never reused, so the table only grows.
  */
+namespace {
+	vector<string>& InternedPaths() {
+		static vector<string> paths;
+		return paths;
+	}
+
+	vector<XMLPathID>& InternedSlots() {
+		static vector<XMLPathID> slots( 256, 0 ); // 0 is an empty slot, so the slots hold id + 1
+		return slots;
+	}
+}
 
 XMLFile::XMLFile() {
 	xmlPtr = NULL;
@@ -30,6 +59,7 @@ bool XMLFile::New( const string& _filename, const string& rootName ) {
 	char buff[96] = {0};
 	assert( xmlPtr == NULL );
 	filename = _filename;
+	Forget();
 
 	LogMsg(INFO, "New XML File: %s", filename.c_str());
 
@@ -48,7 +78,7 @@ bool XMLFile::New( const string& _filename, const string& rootName ) {
 }
 
 bool XMLFile::Open( const string& filename ) {
-	char *buf = NULL;
+	const char *buf = NULL;
 	long bufSize = 0;
 	File xmlfile;
 
@@ -57,15 +87,15 @@ bool XMLFile::Open( const string& filename ) {
 		return( false );
 	}
 
-	buf = xmlfile.Read();
+	buf = xmlfile.Map();
 	bufSize = xmlfile.GetLength();
 	if( buf == NULL ) {
 		LogMsg(ERR, "Could not load XML from archive. Buffer failed to allocate." );
 		return( NULL );
 	}
 
+	Forget();
 	xmlPtr = xmlParseMemory( buf, bufSize );
-	delete [] buf;
 
 	this->filename.assign( filename );
 
@@ -117,27 +147,95 @@ bool XMLFile::Close() {
 	return( true );
 }
 
+/**\brief Get the ID of a path.
+ * \details The same path always has the same ID, in every XMLFile.  IDs
+ *          are small, dense numbers.
+ * \warning This is not locked.  Only call it from the main thread, or from
+ *          static initializers, which run before any other thread starts.
+ */
+XMLPathID XMLFile::Intern( const string& path ) {
+	vector<string>& paths = InternedPaths();
+	vector<XMLPathID>& slots = InternedSlots();
+
+	size_t mask = slots.size() - 1;
+	size_t slot = BinaryReader::Hash( path.data(), path.size() ) & mask;
+	while( slots[slot] != 0 ) {
+		if( paths[ slots[slot] - 1 ] == path ) {
+			return slots[slot] - 1;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	XMLPathID id = static_cast<XMLPathID>( paths.size() );
+	paths.push_back( path );
+	slots[slot] = id + 1;
+
+	// Keep the table at most half full
+	if( paths.size() * 2 > slots.size() ) {
+		vector<XMLPathID> grown( slots.size() * 2, 0 );
+		mask = grown.size() - 1;
+		for( size_t i = 0; i < paths.size(); ++i ) {
+			slot = BinaryReader::Hash( paths[i].data(), paths[i].size() ) & mask;
+			while( grown[slot] != 0 ) {
+				slot = (slot + 1) & mask;
+			}
+			grown[slot] = static_cast<XMLPathID>( i + 1 );
+		}
+		slots.swap( grown );
+	}
+	return id;
+}
+
+/**\brief Get the path that an ID was interned from.
+ */
+const string& XMLFile::PathName( XMLPathID id ) {
+	assert( id < InternedPaths().size() );
+	return InternedPaths()[id];
+}
+
 string XMLFile::Get( const string& path ) {
-	xmlNodePtr cur;
 	if( xmlPtr == NULL ) {
 		return "";
 	}
+	// FIXME: when optionsfile is being created, warning about missing paths causes a race condition
+	return Get( Intern( path ) );
+}
 
-	// Look for the Node
-	cur = FindNode( path );
-	if( cur ) { // Found the path
-		return NodeToString(xmlPtr,cur);;
-	} else {
-		// FIXME: when optionsfile is being created, this line causes a race condition
-		//LogMsg(WARN, "Could not find XML path '%s'.", path.c_str() );
-		return "";
+/**\brief Get the text at an interned path.
+ * \returns A reference that is valid for as long as this XMLFile.  Missing
+ *          paths are empty.  Read it again after a Set() to see the change.
+ */
+const string& XMLFile::Get( XMLPathID id ) {
+	return Lookup( id ).text;
+}
+
+/**\brief Get the value at an interned path as an int.
+ * \details The text is only converted the first time.
+ */
+const int& XMLFile::GetInt( XMLPathID id ) {
+	XMLCachedValue& value = Lookup( id );
+	if( !value.parsedInt ) {
+		value.intValue = atoi( value.text.c_str() );
+		value.parsedInt = true;
 	}
+	return value.intValue;
+}
+
+/**\brief Get the value at an interned path as a float.
+ * \details The text is only converted the first time.
+ */
+const float& XMLFile::GetFloat( XMLPathID id ) {
+	XMLCachedValue& value = Lookup( id );
+	if( !value.parsedFloat ) {
+		value.floatValue = static_cast<float>( atof( value.text.c_str() ) );
+		value.parsedFloat = true;
+	}
+	return value.floatValue;
 }
 
 void XMLFile::Set( const string& path, const string& value ) {
 	LogMsg(INFO,"Replacing Option['%s'] from '%s' to '%s'",path.c_str(),Get(path).c_str(),value.c_str());
-	xmlNodePtr p =  FindNode(path,true);
-	xmlNodeSetContent(p, BAD_CAST value.c_str() );
+	Store( path, value );
 	assert( value == Get(path));
 }
 
@@ -148,6 +246,12 @@ bool XMLFile::Has( const string& path ) {
 	return ( p != NULL );
 }
 
+/** \brief Check if a given interned path exists.
+ */
+bool XMLFile::Has( XMLPathID id ) {
+	return ( FindNode(id, false) != NULL );
+}
+
 void XMLFile::Set( const string& path, const float value ) {
 	// Convert the float to a string before saving it.
 	string stringvalue;
@@ -155,7 +259,7 @@ void XMLFile::Set( const string& path, const float value ) {
 	val_ss << value;
 	val_ss >> stringvalue;
 	LogMsg(INFO,"Replacing Option['%s'] from '%s' to '%s'",path.c_str(),Get(path).c_str(),stringvalue.c_str());
-	xmlNodeSetContent(FindNode(path,true), BAD_CAST stringvalue.c_str() );
+	Store( path, stringvalue );
 	assert( stringvalue == Get(path));
 }
 
@@ -166,11 +270,36 @@ void XMLFile::Set( const string& path, const int value ) {
 	val_ss << value;
 	val_ss >> stringvalue;
 	LogMsg(INFO,"Replacing Option['%s'] from '%s' to '%s'",path.c_str(),Get(path).c_str(),stringvalue.c_str());
-	xmlNodePtr p =  FindNode(path,true);
-	xmlNodeSetContent(p, BAD_CAST stringvalue.c_str() );
+	Store( path, stringvalue );
 	assert( stringvalue == Get(path));
 }
 
+/**\brief Write a value and forget what was remembered about it.
+ * \details A node can be reached by more than one path, since the root is
+ *          optional, so every path to the node is forgotten.  Creating a
+ *          missing node can also create its parents, so every remembered path
+ *          is forgotten in that case.
+ */
+void XMLFile::Store( const string& path, const string& value ) {
+	XMLPathID id = Intern( path );
+	bool existed = ( FindNode( id ) != NULL );
+	xmlNodePtr p = FindNode( id, true );
+	if( p == NULL ) {
+		return;
+	}
+	xmlNodeSetContent( p, BAD_CAST value.c_str() );
+
+	if( existed ) {
+		for( deque<XMLCachedValue>::iterator v = values.begin(); v != values.end(); ++v ) {
+			if( v->node == p ) {
+				*v = XMLCachedValue();
+			}
+		}
+	} else {
+		Forget();
+	}
+}
+
 bool XMLFile::Copy( XMLFile *other ) {
 	// Clear memoization
 	Forget();
@@ -209,24 +338,54 @@ vector<string> TokenizedString( const string& path, const string& tokens ) {
 	return tokenized;
 }
 
+/**\brief Forget every remembered node and value.
+ * \details The entries are reset rather than removed, so that references
+ *          returned by Get() stay valid.
+ */
 void XMLFile::Forget() {
-	values.clear();
+	for( deque<XMLCachedValue>::iterator v = values.begin(); v != values.end(); ++v ) {
+		*v = XMLCachedValue();
+	}
+}
+
+/**\brief Find the remembered node and text of an interned path.
+ * \details Entries are added to the end of a deque, so references to the
+ *          others stay valid.
+ */
+XMLCachedValue& XMLFile::Lookup( XMLPathID id ) {
+	if( id >= values.size() ) {
+		values.resize( id + 1 );
+	}
+	XMLCachedValue& value = values[id];
+	if( !value.loaded ) {
+		if( FindNode( id ) != NULL ) {
+			value.text = NodeToString( xmlPtr, value.node );
+		}
+		value.loaded = true;
+	}
+	return value;
 }
 
 xmlNodePtr XMLFile::FindNode( const string& path, bool createIfMissing ) {
+	return FindNode( Intern( path ), createIfMissing );
+}
+
+xmlNodePtr XMLFile::FindNode( XMLPathID id, bool createIfMissing ) {
 	xmlNodePtr cur,parent;
-	string tokens = "/";
-	vector<string> tokenized;
-	vector<string>::iterator iter;
+	const string& path = PathName( id );
 	string partialPath;
+	size_t start, end;
 
 	// Check previously memoized values
-	map<string,xmlNodePtr>::iterator val = values.find( path );
-	if( val != values.end() ){ // If we found it
+	if( id >= values.size() ) {
+		values.resize( id + 1 );
+	}
+	XMLCachedValue& val = values[id];
+	if( val.resolved ){ // If we found it
 		// Check that we don't return memoized NULL values when instructed to createIfMissing.
-		if( !((val->second==NULL) && createIfMissing) )
+		if( !((val.node==NULL) && createIfMissing) )
 		{
-			return val->second;
+			return val.node;
 		}
 	}
 
@@ -240,22 +399,22 @@ xmlNodePtr XMLFile::FindNode( const string& path, bool createIfMissing ) {
 		LogMsg(WARN, "XML file (%s) appears to be empty.", filename.c_str() );
 		return( (xmlNodePtr)NULL );
 	}
-	
-	tokenized = TokenizedString(path, tokens);
-	iter = tokenized.begin();
 
 	// The root is optional since it isn't a Child.
-	if( NodeNameIs(cur, tokenized.front().c_str()) ) {
-		++iter;
+	start = 0;
+	end = path.find( '/' );
+	partialPath.assign( path, 0, end );
+	if( NodeNameIs(cur, partialPath.c_str()) ) {
+		start = (end == string::npos) ? path.size() + 1 : end + 1;
 	}
 
-	// Walk the tokenized path
+	// Walk the path one name at a time
 	// If FirstChildNamed() doesn't find the path, it will return NULL
-	for(; iter != tokenized.end() && cur != NULL; ++iter) {
-		partialPath = *iter;
-		if( partialPath.find_first_of(tokens) != string::npos) {
-			continue;
-		}
+	while( (start <= path.size()) && (cur != NULL) ) {
+		end = path.find( '/', start );
+		partialPath.assign( path, start, (end == string::npos) ? string::npos : end - start );
+		start = (end == string::npos) ? path.size() + 1 : end + 1;
+
 		parent = cur;
 		cur = FirstChildNamed(parent, partialPath.c_str());
 		if( (createIfMissing) && (cur==NULL) )
@@ -265,7 +424,8 @@ xmlNodePtr XMLFile::FindNode( const string& path, bool createIfMissing ) {
 	}
 
 	// Memoize this result for later
-	values[path] = cur;
+	val.resolved = true;
+	val.node = cur;
 
 	return( cur );
 }
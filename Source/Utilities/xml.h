@@ -1,7 +1,7 @@
 /**\file		xml.h
  * \author		Chris Thielen (chris@epiar.net)
  * \date		Created: Monday, April 21, 2008
- * \date		Modified: Saturday, November 21, 2009
+ * \date		Modified: Sunday, October 18, 2026
  * \brief       Interface with XML files
  * \details
  *
@@ -13,6 +13,24 @@
 
 #include "includes.h"
 #include <zlib.h>
+#include <deque>
+
+// An interned path, see XMLFile::Intern
+typedef Uint32 XMLPathID;
+
+// The node and parsed values of one path in one XMLFile
+struct XMLCachedValue {
+	XMLCachedValue(): resolved(false), node(NULL), loaded(false), parsedInt(false), parsedFloat(false), intValue(0), floatValue(0.0f) {}
+
+	bool resolved; ///< The node has been looked up.
+	xmlNodePtr node; ///< NULL when the path does not exist.
+	bool loaded; ///< The text has been read from the node.
+	string text;
+	bool parsedInt;
+	bool parsedFloat;
+	int intValue;
+	float floatValue;
+};
 
 class XMLFile {
 	public:
@@ -28,12 +46,19 @@ class XMLFile {
 		void SetFileName( const string& _filename ) { filename = _filename; }
 		string GetFileName( ) { return filename; }
 
+		static XMLPathID Intern( const string& path );
+		static const string& PathName( XMLPathID id );
+
 		string Get( const string& path ); // cast/convert this to whatever return value you need
+		const string& Get( XMLPathID id );
+		const int& GetInt( XMLPathID id );
+		const float& GetFloat( XMLPathID id );
 		void Set( const string& path, const string& value ); // cast/convert this to whatever return value you need
 		void Set( const string& path, const float value ); // cast/convert this to whatever return value you need
 		void Set( const string& path, const int value ); // cast/convert this to whatever return value you need
 
 		bool Has( const string& path );
+		bool Has( XMLPathID id );
 
 		bool Copy( XMLFile *other );
 
@@ -42,10 +67,13 @@ class XMLFile {
 
 	private:
 		xmlDocPtr xmlPtr;
-		map<string,xmlNodePtr> values;
+		deque<XMLCachedValue> values; ///< Indexed by XMLPathID.
 		
 		void Forget();
+		void Store( const string& path, const string& value );
+		XMLCachedValue& Lookup( XMLPathID id );
 		xmlNodePtr FindNode( const string& path, bool createIfMissing=false );
+		xmlNodePtr FindNode( XMLPathID id, bool createIfMissing=false );
 };
 
 vector<string> TokenizedString(const string& path, const string& tokens);
@@ -2,7 +2,7 @@
  * \author		Chris Thielen (chris@epiar.net)
  * \author		and others.
  * \date		Created:	Saturday, January 5, 2008
- * \date		Modified:	Thursday, November 19, 2009
+ * \date		Modified:	Sunday, October 18, 2026
  * \brief		Common variables and defines.
  * \details
  *	This file contains some global variables, defines,
@@ -24,6 +24,7 @@ extern Font *BitType;
 extern Font *Serif;
 extern Font *Mono;
 
+// Read a skin value by path, or by an XMLPathID for values read often
 #define SKIN(path) (skinfile->Get(path) )
 
 #ifndef M_PI
@@ -12,15 +12,19 @@
 #include "includes.h"
 #include "common.h"
 #include "Audio/audio.h"
+#include "Engine/replay.h"
 #include "Tests/graphics.h"
 #include "Graphics/font.h"
 #include "Graphics/video.h"
 #include "menu.h"
 #include "UI/ui.h"
 #include "Utilities/argparser.h"
+#include "Utilities/assetmanager.h"
 #include "Utilities/filesystem.h"
 #include "Utilities/log.h"
+#include "Utilities/savemanager.h"
 #include "Utilities/lua.h"
+#include "Utilities/random.h"
 #include "Utilities/xml.h"
 #include "Utilities/timer.h"
 
@@ -28,6 +32,13 @@
 #include "Tests/tests.h"
 #endif // EPIAR_COMPILE_TESTS
 
+static Option<float> musicVolume( "options/sound/musicvolume" );
+static Option<float> soundVolume( "options/sound/soundvolume" );
+static Option<int> soundVoices( "options/sound/voices" );
+static Option<float> soundCullVolume( "options/sound/cull-volume" );
+static Option<int> loadingThreads( "options/loading/threads" );
+static Option<int> randomSeed( "options/random/seed" );
+
 // main configuration file, used through the tree (extern in common.h)
 XMLFile *skinfile = NULL;
 // main font used throughout the game
@@ -108,6 +119,9 @@ void Main_OS( int argc, char **argv ) {
 #endif //_WIN32
 
 	Filesystem::Init( argv[0] );
+
+	// Packed resources are read before loose files when they exist.
+	Filesystem::MountArchive( "Resources.epk" );
 }
 
 /** \brief Load the options files
@@ -121,6 +135,7 @@ void Main_Load_Settings() {
 
 	// Logging
 	Options::AddDefault( "options/log/xml", 0 );
+	Options::AddDefault( "options/log/json", 0 );
 	Options::AddDefault( "options/log/out", 0 );
 	Options::AddDefault( "options/log/alert", 0 );
 	Options::AddDefault( "options/log/ui", 0 );
@@ -132,6 +147,8 @@ void Main_Load_Settings() {
 	Options::AddDefault( "options/video/bpp", 32 );
 	Options::AddDefault( "options/video/fullscreen", 0 );
 	Options::AddDefault( "options/video/fps", 60 );
+	Options::AddDefault( "options/video/npot-textures", 1 );
+	Options::AddDefault( "options/video/texture-memory", 0 ); // Megabytes, 0 is unlimited
 
 	// Sound
 	Options::AddDefault( "options/sound/musicvolume", 0.5f );
@@ -141,12 +158,31 @@ void Main_Load_Settings() {
 	Options::AddDefault( "options/sound/engines", 1 );
 	Options::AddDefault( "options/sound/explosions", 1 );
 	Options::AddDefault( "options/sound/buttons", 1 );
+	Options::AddDefault( "options/sound/voices", 12 );
+	Options::AddDefault( "options/sound/cull-volume", 0.02f );
 
 	// Simultaion
 	Options::AddDefault( "options/simulation/starfield-density", 750 );
 	Options::AddDefault( "options/simulation/automatic-load", 0 );
 	Options::AddDefault( "options/simulation/random-universe", 0 );
 	Options::AddDefault( "options/simulation/random-seed", 0 );
+	Options::AddDefault( "options/simulation/binary-cache", 1 );
+	Options::AddDefault( "options/simulation/traffic-budget", 100 );
+	Options::AddDefault( "options/simulation/traffic-spawns", 1 );
+	Options::AddDefault( "options/simulation/traffic-distance", 16384.0f );
+
+	// Random numbers
+	Options::AddDefault( "options/random/seed", 0 ); // 0 picks a new seed every time
+
+	// Loading
+	Options::AddDefault( "options/loading/threads", 2 );
+	Options::AddDefault( "options/loading/upload-budget", 4 ); // Milliseconds per frame
+
+	// Resources
+	Options::AddDefault( "options/resources/memory", 256 ); // Megabytes, 0 is unlimited
+
+	// Saving
+	Options::AddDefault( "options/saves/journal", 1 );
 
 	// Timing
 	Options::AddDefault( "options/timing/screen-swap", 0 ); // FIXME, 0=disabled until the transition is better
@@ -159,6 +195,7 @@ void Main_Load_Settings() {
 	Options::AddDefault( "options/development/ships-worldmap", 0 );
 	Options::AddDefault( "options/development/debug-ai", 0 );
 	Options::AddDefault( "options/development/debug-ui", 0 );
+	Options::AddDefault( "options/development/disable-ui-cache", 0 );
 
 	// Allow the Options to be used
 	Options::Unlock();
@@ -213,11 +250,14 @@ void Main_Load_Settings() {
  */
 void Main_Init_Singletons() {
 	Audio::Instance().Initialize();
-	Audio::Instance().SetMusicVol ( OPTION(float,"options/sound/musicvolume") );
-	Audio::Instance().SetSoundVol ( OPTION(float,"options/sound/soundvolume") );
+	Audio::Instance().SetMusicVol ( musicVolume );
+	Audio::Instance().SetSoundVol ( soundVolume );
+	Audio::Instance().SetVoiceBudget( soundVoices, soundCullVolume );
 
 	Timer::Initialize();
 	Video::Initialize();
+	AssetManager::Initialize( loadingThreads );
+	SaveManager::Initialize();
 
 	SansSerif       = new Font( "Resources/Fonts/FreeSans.ttf" );
 	BitType         = new Font( "Resources/Fonts/visitor2.ttf" );
@@ -226,7 +266,9 @@ void Main_Init_Singletons() {
 
 	UI::Initialize("Main Screen");
 
-	srand ( time(NULL) );
+	Uint32 seed = randomSeed ? static_cast<Uint32>( randomSeed ) : static_cast<Uint32>( time(NULL) );
+	Random::SeedAll( seed );
+	LogMsg(INFO, "Random seed %u", seed );
 }
 
 /** \details
@@ -243,12 +285,16 @@ void Main_Close_Singletons( void ) {
 	delete Serif;
 	delete Mono;
 
+	AssetManager::Shutdown();
+	SaveManager::Shutdown();
+	Image::LogTextureMemory();
 	Video::Shutdown();
 	Audio::Instance().Shutdown();
 
 	// free the configuration file data
 	delete skinfile;
 
+	Replay::StopPlayback();
 	Filesystem::Close();
 	Log::Instance().Close();
 }
@@ -275,6 +321,8 @@ void Main_Parse_Args( int argc, char **argv ) {
 	argparser->SetOpt(LONGOPT, "windowed",       "Play in windowed mode");
 	argparser->SetOpt(LONGOPT, "nolog-xml",      "(Default) Disable logging messages to xml files.");
 	argparser->SetOpt(LONGOPT, "log-xml",        "Log messages to xml files.");
+	argparser->SetOpt(LONGOPT, "nolog-json",     "(Default) Disable logging messages to JSON lines files.");
+	argparser->SetOpt(LONGOPT, "log-json",       "Log messages to JSON lines files.");
 	argparser->SetOpt(LONGOPT, "log-out",        "(Default) Log messages to console.");
 	argparser->SetOpt(LONGOPT, "nolog-out",      "Disable logging messages to console.");
 	argparser->SetOpt(LONGOPT, "ships-worldmap", "Displays ships on the world map.");
@@ -285,6 +333,11 @@ void Main_Parse_Args( int argc, char **argv ) {
 
 	argparser->SetOpt(LONGOPT, "restore-defaults", "Restore options to default values.");
 
+	argparser->SetOpt(VALUEOPT, "record",        "Record the next game to a replay file.");
+	argparser->SetOpt(VALUEOPT, "replay",        "Play back a replay file instead of the menu.");
+	argparser->SetOpt(LONGOPT, "replay-fast",    "Play back the replay as quickly as possible.");
+	argparser->SetOpt(LONGOPT, "headless",       "Do not draw while playing back a replay.");
+
 #ifdef EPIAR_COMPILE_TESTS
 	argparser->SetOpt(VALUEOPT, "run-test",      "Run specified test");
 #endif // EPIAR_COMPILE_TESTS
@@ -323,6 +376,17 @@ void Main_Parse_Args( int argc, char **argv ) {
 	}
 #endif // EPIAR_COMPILE_TESTS
 
+	// Record or play back a game.
+	string recordname = argparser->HaveValue("record");
+	string replayname = argparser->HaveValue("replay");
+	if ( !(replayname.empty()) ) {
+		if( !Replay::StartPlayback( replayname, argparser->HaveLong("replay-fast"), argparser->HaveLong("headless") ) ) {
+			exit( 1 );
+		}
+	} else if ( !(recordname.empty()) ) {
+		Replay::StartRecording( recordname );
+	}
+
 	// Override OPTION values.
 
 	// Following are cumulative options (I.E. you can have multiple of them)
@@ -337,6 +401,8 @@ void Main_Parse_Args( int argc, char **argv ) {
 	   SETOPTION("options/development/ships-worldmap",1);
 	if      ( argparser->HaveOpt("log-xml") ) 	{ SETOPTION("options/log/xml", 1);}
 	else if ( argparser->HaveOpt("nolog-xml") ) 	{ SETOPTION("options/log/xml", 0);}
+	if      ( argparser->HaveOpt("log-json") ) 	{ SETOPTION("options/log/json", 1);}
+	else if ( argparser->HaveOpt("nolog-json") ) 	{ SETOPTION("options/log/json", 0);}
 	if      ( argparser->HaveOpt("log-out") ) 	{ SETOPTION("options/log/out", 1);}
 	else if ( argparser->HaveOpt("nolog-out") ) 	{ SETOPTION("options/log/out", 0);}
 
@@ -7,13 +7,20 @@
  */
 
 #include "includes.h"
+#include "Engine/replay.h"
 #include "Engine/simulation.h"
 #include "menu.h"
 #include "UI/ui.h"
 #include "UI/widgets.h"
+#include "Utilities/assetmanager.h"
 #include "Utilities/filesystem.h"
+#include "Utilities/random.h"
 #include "Utilities/timer.h"
 
+static Option<int> automaticLoad( "options/simulation/automatic-load" );
+static Option<Uint32> uploadBudget( "options/loading/upload-budget" );
+static Option<int> soundButtons( "options/sound/buttons" );
+
 bool Menu::quitSignal = false;
 
 Simulation Menu::simulation;
@@ -30,7 +37,7 @@ Picture *Menu::options = NULL;
 Picture *Menu::exit = NULL;
 Picture *Menu::continueButton = NULL;
 
-//if(OPTION(int, "options/sound/buttons")) Sound::Get( "Resources/Audio/Interface/28853__junggle__btn043.ogg" )->Play();
+//if(soundButtons) Sound::Get( "Resources/Audio/Interface/28853__junggle__btn043.ogg" )->Play();
 
 /**\class Menu
  *  \brief Epiar's Main Menu
@@ -43,7 +50,8 @@ Picture *Menu::continueButton = NULL;
  *  The Main Menu will launch the Simulation with a new or loaded Player.
  *  It can also edit simulations and option.
  *
- *  The Main Menu can be skipped by enabling the "automatic-load" option.
+ *  The Main Menu can be skipped by enabling the "automatic-load" option, or
+ *  by playing back a Replay.
  *
  */
 
@@ -60,7 +68,14 @@ void Menu::Main_Menu( void )
 	Players *players = Players::Instance();
 	players->Load( "Resources/Definitions/saved-games.xml", true, true);
 
-	if( OPTION(int,"options/simulation/automatic-load") )
+	if( Replay::IsPlaying() )
+	{
+		ReplayGame();
+		LogMsg(INFO,"Replay Complete. Quitting Epiar.");
+		return;
+	}
+
+	if( automaticLoad )
 	{
 		if( AutoLoad() )
 		{
@@ -84,6 +99,8 @@ void Menu::Main_Menu( void )
 		Video::PostDraw();
 		Video::Update();
 
+		AssetManager::Update( uploadBudget );
+
 		if( Input::HandleSpecificEvent( events, InputEvent( KEY, KEYTYPED, SDLK_ESCAPE ) ) ) {
 			quitSignal = true;
 		}
@@ -122,6 +139,59 @@ bool Menu::AutoLoad()
 	return false;
 }
 
+/** Run the Simulation and Player that a Replay was recorded with
+ * \note When the replay ends, the game will quit.
+ * \details The universe options are only changed while the replay runs, so
+ *          watching a replay does not change the saved options.
+ * \returns true if the replay was played.
+ */
+bool Menu::ReplayGame()
+{
+	string oldRandomUniverse = Options::Get( "options/simulation/random-universe" );
+	string oldRandomSeed = Options::Get( "options/simulation/random-seed" );
+	int seed = Replay::GetUniverseSeed();
+
+	SETOPTION( "options/simulation/random-universe", (seed != 0) );
+	SETOPTION( "options/simulation/random-seed", seed );
+
+	bool played = RunReplay();
+
+	SETOPTION( "options/simulation/random-universe", oldRandomUniverse );
+	SETOPTION( "options/simulation/random-seed", oldRandomSeed );
+	return played;
+}
+
+/** Load, setup and run the Simulation of a Replay
+ * \returns true if the replay was played.
+ */
+bool Menu::RunReplay()
+{
+	string simName = Replay::GetSimulationName();
+	string playerName = Replay::GetPlayerName();
+
+	if( !simulation.Load( simName ) )
+	{
+		LogMsg(ERR,"Failed to load the Simulation '%s' successfully", simName.c_str() );
+		return false;
+	}
+	if( !simulation.SetupToRun() )
+	{
+		LogMsg(ERR,"Failed to setup the Simulation '%s' successfully.", simName.c_str() );
+		return false;
+	}
+
+	// The snapshot replaces the Player's ships, but the Player must exist
+	if( Players::Instance()->PlayerExists( playerName ) ) {
+		simulation.LoadPlayer( playerName );
+	} else {
+		simulation.CreateDefaultPlayer( playerName );
+		Lua::Call("intro");
+	}
+
+	simulation.Run();
+	return true;
+}
+
 /** Create the Basic Main Menu
  *  \details The Splash Screen is random.
  */
@@ -139,7 +209,7 @@ void Menu::SetupGUI()
 	};
 
 	int numScreens = (sizeof(splashScreens) / sizeof(splashScreens[0]));
-	int screenNum = rand();
+	int screenNum = Random::Stream( RANDOM_INTERFACE ).Int( numScreens );
 	menuSplash = Image::Get( splashScreens[(screenNum+0) % numScreens] );
 	gameSplash = Image::Get( splashScreens[(screenNum+1) % numScreens] );
 	editSplash = Image::Get( splashScreens[(screenNum+2) % numScreens] );
@@ -351,7 +421,7 @@ void Menu::CreateEditWindow()
 	}
 
 	char seed[20];
-	snprintf(seed, sizeof(seed), "%d", rand() );
+	snprintf(seed, sizeof(seed), "%d", Random::Stream( RANDOM_INTERFACE ).Int( RAND_MAX ) );
 
 	Window *editorWnd = NULL;
 	UI::Add( editorWnd = (new Window(250, 300, "Editor"))
@@ -466,7 +536,7 @@ void Menu::CreateNewPlayer( )
 	int israndom = ((Checkbox*)UI::Search("/Window'New Game'/Frame/Checkbox'Random Universe'/"))->IsChecked();
 	int seed = atoi( ((Textbox*)UI::Search("/Window'New Game'/Frame/Textbox'Random Universe Seed'/"))->GetText().c_str() );
 
-	if(OPTION(int, "options/sound/buttons")) Sound::Get( "Resources/Audio/Interface/28853__junggle__btn043.ogg" )->Play();
+	if(soundButtons) Sound::Get( "Resources/Audio/Interface/28853__junggle__btn043.ogg" )->Play();
 
 	if(players->PlayerExists(playerName)) {
 		Dialogs::Alert("A player with that name exists.");
@@ -491,7 +561,7 @@ void Menu::CreateNewPlayer( )
 void Menu::RandomizeSeed( )
 {
 	char seed[20];
-	snprintf(seed, sizeof(seed), "%d", rand() );
+	snprintf(seed, sizeof(seed), "%d", Random::Stream( RANDOM_INTERFACE ).Int( RAND_MAX ) );
 	Widget *widget = UI::Search("/Window'New Game'/Frame/Textbox'Random Universe Seed'/");
 	if( widget && widget->GetMask() == WIDGET_TEXTBOX )
 	{
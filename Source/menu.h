@@ -40,6 +40,8 @@ class Menu {
 
 	// Skip straight to the Game
 	static bool AutoLoad( void );
+	static bool ReplayGame( void );
+	static bool RunReplay( void );
 
 	// GUI Setup and Actions
 	static void SetupGUI();
@@ -11,17 +11,37 @@
 
 import os
 import sys
+import math
+import zlib
 import struct
 from optparse import OptionParser
 
 ##	The version value should be changed whenever the Animation format changes
 __version__ = 1
 
+##	The version of packed atlas .ani files
+__atlas_version__ = 2
+
+##	Atlas flag: The pixels are zlib compressed
+ATLAS_COMPRESSED = 1
+
+##	Pixels of padding around each frame in an atlas
+#
+#	The padding repeats the frame's edge pixels, so that linear filtering at
+#	the edge of a frame never samples its neighbours.
+ATLAS_GUTTER = 1
+
 USAGE = """
 pass .ani files to unpack into folders:
 	%prog [ANIMATION ...]
 or pass folders fo construct .ani files:
 	%prog [FOLDER ..]
+or pass folders or .ani files to construct atlas .ani files:
+	%prog --atlas [FOLDER|ANIMATION ..]
+
+Atlas .ani files (version 2) store every frame in a single sheet so that
+Epiar can load them with one read and one texture.  Creating or unpacking
+them requires the Python Imaging Library.
 
 Animation Folders should contain:
 	*.png files
@@ -42,6 +62,8 @@ def Parse():
 	# Printing
 	parser.add_option("-p", "--packed", dest='format', action='store_const', const='file', help="Create packed .ani files")
 	parser.add_option("-u", "--unpacked", dest='format', action='store_const', const='folder', help="Create unpacked Animation folders")
+	parser.add_option("-a", "--atlas", dest='format', action='store_const', const='atlas', help="Create packed atlas .ani files")
+	parser.add_option("-z", "--uncompressed", default=False, action="store_true", help="Do not compress atlas .ani files")
 	# Printing
 	parser.add_option("-v", "--verbose", default=False, action="store_true", help="Lots of output")
 	parser.add_option("-q", "--quiet", dest='verbose', action="store_true", help="No output")
@@ -120,12 +142,15 @@ class Animation:
 		file = open(filename,'rb')
 		# Get header
 		self.version = ord( file.read(1) )
-		if self.version != __version__:
-			print "WARNING: version %d is unknown!" % self.version
 		self.count = ord( file.read(1) )
 		self.delay = ord( file.read(1) )
 		self.order = []
 		self.frames = {}
+		if self.version == __atlas_version__:
+			self.fromAtlas(file)
+			return
+		if self.version != __version__:
+			print "WARNING: version %d is unknown!" % self.version
 		# Get each png
 		for i in range(self.count):
 			size = struct.unpack("I", file.read(4))[0]
@@ -134,6 +159,27 @@ class Animation:
 			self.order.append(framename)
 			self.frames[framename] = data
 
+	##	Collect Animation data from the rest of an atlas .ani file
+	def fromAtlas(self, file):
+		Image = requireImaging()
+		flags, width, height = struct.unpack("<BHH", file.read(5))
+		regions = []
+		for i in range(self.count):
+			regions.append( struct.unpack("<HHHH", file.read(8)) )
+		rawsize, storedsize = struct.unpack("<II", file.read(8))
+		pixels = file.read(storedsize)
+		if flags & ATLAS_COMPRESSED:
+			pixels = zlib.decompress(pixels)
+		if len(pixels) != rawsize:
+			print "ERROR: The atlas should have %d bytes of pixels, not %d." % (rawsize, len(pixels))
+			sys.exit(6)
+		sheet = Image.frombytes("RGBA", (width, height), pixels)
+		for i,(x,y,w,h) in enumerate(regions):
+			framename = "%s_%03d.png" % (self.name, i)
+			self.order.append(framename)
+			self.frames[framename] = encodePNG( sheet.crop((x, y, x+w, y+h)) )
+		self.version = __version__
+
 	##	Collect Animation data from an unpacked folder
 	def fromFolder(self, foldername ):
 		if not os.path.exists(foldername):
@@ -209,6 +255,56 @@ class Animation:
 			file . write( frame ) 
 		file.close()
 
+	##	Create an atlas .ani file
+	#
+	#	Every frame is placed in a grid cell as large as the largest frame plus
+	#	a gutter on each side.  The number of columns is chosen so that the
+	#	power of two sheet wastes the least space, and is as square as possible.
+	#	The UV table holds the frame without its gutter.
+	def toAtlasFile(self, verbose=False, force=False, compress=True):
+		""" Save an animation as an atlas file """
+		Image = requireImaging()
+		filename = self.name
+		filename += ".ani"
+		if os.path.exists( filename ):
+			if force:
+				forceRemove( filename )
+			else:
+				print "ERROR: File %s already exists. Use '--force' to overwrite." % filename
+				sys.exit(4)
+		if verbose:
+			print "Creating Atlas Animation file: %s" % filename
+		images = [ decodePNG(self.frames[framename]) for framename in self.order ]
+		cellw = max( [ image.size[0] for image in images ] ) + 2 * ATLAS_GUTTER
+		cellh = max( [ image.size[1] for image in images ] ) + 2 * ATLAS_GUTTER
+		columns, width, height = packGrid( len(images), cellw, cellh )
+		if width > 32767 or height > 32767:
+			print "ERROR: The %d frames of %s do not fit in an atlas." % (len(images), filename)
+			sys.exit(7)
+		sheet = Image.new("RGBA", (width, height), (0, 0, 0, 0))
+		regions = []
+		for i,image in enumerate(images):
+			x = (i % columns) * cellw
+			y = (i // columns) * cellh
+			sheet.paste( addGutter(image, ATLAS_GUTTER), (x, y) )
+			regions.append( (x + ATLAS_GUTTER, y + ATLAS_GUTTER, image.size[0], image.size[1]) )
+		pixels = sheet.tobytes()
+		flags = 0
+		stored = pixels
+		if compress:
+			flags |= ATLAS_COMPRESSED
+			stored = zlib.compress(pixels, 9)
+		if verbose:
+			print "Atlas: %dx%d, %d columns, %1.2f kb" % (width, height, columns, len(stored)/1024.0)
+		file = open( filename, "wb")
+		file . write( struct.pack("BBB", __atlas_version__, self.count, self.delay ) )
+		file . write( struct.pack("<BHH", flags, width, height ) )
+		for region in regions:
+			file . write( struct.pack("<HHHH", *region) )
+		file . write( struct.pack("<II", len(pixels), len(stored)) )
+		file . write( stored )
+		file.close()
+
 	##	Create an unpacked folder
 	def toFolder(self, verbose=False, force=False):
 		""" Save an animation as a folder """
@@ -258,6 +354,65 @@ class Animation:
 		orderfile . close()
 
 
+##	Import the Python Imaging Library, which is only needed for atlas files
+def requireImaging():
+	try:
+		from PIL import Image
+	except ImportError:
+		print "ERROR: Atlas animations require the Python Imaging Library."
+		sys.exit(8)
+	return Image
+
+##	Decode png data into an RGBA Image
+def decodePNG(data):
+	from io import BytesIO
+	Image = requireImaging()
+	return Image.open( BytesIO(data) ).convert("RGBA")
+
+##	Encode an Image as png data
+def encodePNG(image):
+	from io import BytesIO
+	buf = BytesIO()
+	image.save(buf, "PNG")
+	return buf.getvalue()
+
+##	Surround an Image with copies of its edge pixels
+def addGutter(image, gutter):
+	Image = requireImaging()
+	w, h = image.size
+	padded = Image.new("RGBA", (w + 2*gutter, h + 2*gutter), (0, 0, 0, 0))
+	padded.paste( image, (gutter, gutter) )
+	if gutter <= 0:
+		return padded
+	# Stretch the left and right columns, then the whole top and bottom rows
+	# so that the corners are filled too.
+	padded.paste( image.crop((0, 0, 1, h)).resize((gutter, h)), (0, gutter) )
+	padded.paste( image.crop((w-1, 0, w, h)).resize((gutter, h)), (gutter + w, gutter) )
+	padded.paste( padded.crop((0, gutter, w + 2*gutter, gutter + 1)).resize((w + 2*gutter, gutter)), (0, 0) )
+	padded.paste( padded.crop((0, gutter + h - 1, w + 2*gutter, gutter + h)).resize((w + 2*gutter, gutter)), (0, gutter + h) )
+	return padded
+
+##	Returns the next highest power of two
+def powerOfTwo(num):
+	c = 1
+	while c < num:
+		c *= 2
+	return c
+
+##	Choose the grid for count cells that needs the smallest power of two sheet
+#
+#	Returns (columns, width, height)
+def packGrid(count, cellw, cellh):
+	best = None
+	for columns in range(1, count+1):
+		rows = int( math.ceil( count / float(columns) ) )
+		width = powerOfTwo( columns * cellw )
+		height = powerOfTwo( rows * cellh )
+		# Prefer square sheets when the area is the same
+		if best is None or (width * height, max(width, height)) < (best[1] * best[2], max(best[1], best[2])):
+			best = (columns, width, height)
+	return best
+
 ##	The normal execution path of this script
 #
 #	This gathers user supplied paths and converts each one.
@@ -282,6 +437,10 @@ def main():
 				if opts.verbose:
 					print "Using the .ani file format..."
 				ani.toFile(verbose=opts.verbose, force=opts.force)
+			elif opts.format == 'atlas':
+				if opts.verbose:
+					print "Using the atlas .ani file format..."
+				ani.toAtlasFile(verbose=opts.verbose, force=opts.force, compress=not opts.uncompressed)
 			elif opts.format == 'folder':
 				if opts.verbose:
 					print "Using the Animation folder format..."
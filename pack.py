@@ -0,0 +1,118 @@
+#!/usr/bin/env python
+
+##	Simple tool for building packed resource (.epk) archives
+#
+#	Epiar can read its images, animations and xml files out of a single
+#	memory mapped archive instead of opening each file separately.  This
+#	script builds that archive from the Resources folder.
+#
+#	@author Epiar Development Team
+
+import os
+import sys
+import struct
+from optparse import OptionParser
+
+##	The magic number at the start of every archive ("EPK1")
+ARCHIVE_MAGIC = 0x314B5045
+
+##	The version value should be changed whenever the archive format changes
+__version__ = 1
+
+##	The contents of every file start on this boundary
+ALIGNMENT = 16
+
+##	Folders that are packed by default
+#
+#	Audio, Fonts and Scripts are loaded by their real path, and Definitions
+#	holds the player's own files, so none of those can come from an archive.
+FOLDERS = ["Animations", "Art", "Graphics", "Simulation", "Skin"]
+
+##	Types of files that are packed
+SUFFIXES = [".png", ".ani", ".xml"]
+
+USAGE = """
+build Resources.epk from the Resources folder:
+	%prog
+or choose the folders and output:
+	%prog -o OUTPUT.epk [FOLDER ...]
+
+Folders are relative to the directory that holds Resources, and every file
+is stored under the same name that Epiar uses to open it, for example
+Resources/Skin/skin.xml.  Files in the user's Definitions folder still
+override the archive.
+"""
+
+## Parse command line options
+def Parse():
+	parser = OptionParser(USAGE)
+	parser.add_option("-o", "--output", default="Resources.epk", help="The archive to write.")
+	parser.add_option("-r", "--root", default=".", help="The directory that holds Resources.")
+	parser.add_option("-v", "--verbose", default=False, action="store_true", help="List each packed file.")
+	return parser.parse_args()
+
+##	Find every file that should be packed
+#
+#	The names are sorted by their bytes since Epiar finds files with a
+#	binary search that compares them with memcmp.
+def Gather(root, folders):
+	names = []
+	for folder in folders:
+		for path, dirs, files in os.walk(os.path.join(root, folder)):
+			dirs[:] = [d for d in dirs if not d.startswith('.')]
+			for name in files:
+				if name.startswith('.') or os.path.splitext(name)[1].lower() not in SUFFIXES:
+					continue
+				relative = os.path.relpath(os.path.join(path, name), root)
+				names.append(relative.replace(os.sep, '/').encode('utf-8'))
+	return sorted(set(names))
+
+##	Write the archive
+#
+#	The layout is: a header, the contents of each file, the index, and then
+#	the names.  Every number is a little endian 32 bit integer.
+def Pack(root, names, output, verbose=False):
+	header = struct.calcsize("<IIII")
+	data = []
+	offset = header
+	for name in names:
+		f = open(os.path.join(root, name.decode('utf-8')), 'rb')
+		contents = f.read()
+		f.close()
+		padding = (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT
+		offset += padding
+		data.append((padding, offset, contents))
+		offset += len(contents)
+		if verbose:
+			print("%8d %s" % (len(contents), name.decode('utf-8')))
+
+	indexOffset = offset + (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT
+	nameOffset = indexOffset + struct.calcsize("<IIII") * len(names)
+
+	out = open(output, 'wb')
+	out.write(struct.pack("<IIII", ARCHIVE_MAGIC, __version__, len(names), indexOffset))
+	for padding, position, contents in data:
+		out.write(b'\0' * padding)
+		out.write(contents)
+	out.write(b'\0' * (indexOffset - offset))
+	for name, (padding, position, contents) in zip(names, data):
+		out.write(struct.pack("<IIII", nameOffset, len(name), position, len(contents)))
+		nameOffset += len(name)
+	for name in names:
+		out.write(name)
+	out.close()
+
+##	The normal execution path of this script
+def main():
+	(opts,args) = Parse()
+	folders = [os.path.join("Resources", f) for f in FOLDERS]
+	if args:
+		folders = args
+
+	names = Gather(opts.root, folders)
+	Pack(opts.root, names, opts.output, opts.verbose)
+	print("Packed %d files into %s." % (len(names), opts.output))
+
+# This is the 'pythonic' way of calling main
+if __name__ == "__main__":
+	main()